@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_arena_api.h>
+
+#include "core/analyze.h"
+#include "core/compiler.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct arena_t arena_t;
+
+CT_BEGIN_API
+
+/// @defgroup pool Pool allocation
+/// @brief Size class allocator for small fixed size objects
+/// a pool rounds small allocations up to a size class and serves them from
+/// slabs requested from a parent arena, each slab only holds a single size class.
+/// freed memory is kept on a per size class free list and reused by later allocations.
+/// allocations larger than @ref CT_POOL_MAX_SIZE are forwarded to the parent arena.
+/// @ingroup memory
+/// @{
+
+/// @brief the default size of each slab requested from the parent arena
+#define CT_POOL_SLAB_SIZE (64U * 1024U)
+
+/// @brief the largest allocation served from a slab
+#define CT_POOL_MAX_SIZE (256U)
+
+/// @brief memory usage of a pool
+typedef struct pool_stats_t
+{
+    /// @brief the number of slabs held by the pool
+    size_t slabs;
+
+    /// @brief the total number of bytes requested from the parent arena for slabs
+    size_t reserved;
+
+    /// @brief the number of bytes handed out from slabs and not yet freed
+    size_t used;
+} pool_stats_t;
+
+/// @brief create a new pool allocator
+/// @pre @p slab_size must be greater than 0
+/// @pre @p parent must not be NULL
+///
+/// @param name the name of the pool
+/// @param slab_size the size of each slab requested from @p parent
+/// @param parent the arena to allocate slabs and large allocations from
+///
+/// @return the pool allocator
+RET_NOTNULL
+CT_ARENA_API arena_t *pool_new(
+    IN_STRING const char *name,
+    IN_DOMAIN(>, 0) size_t slab_size,
+    IN_NOTNULL arena_t *parent);
+
+/// @brief release all slabs held by a pool and the pool itself
+/// @warning large allocations forwarded to the parent arena are not released
+/// @pre @p arena must have been created with @ref pool_new
+///
+/// @param arena the pool to delete
+CT_ARENA_API void pool_delete(STA_RELEASE arena_t *arena);
+
+/// @brief get the memory usage of a pool
+/// @pre @p arena must have been created with @ref pool_new
+///
+/// @param arena the pool to query
+///
+/// @return the memory usage of the pool
+CT_NODISCARD
+CT_ARENA_API pool_stats_t pool_stats(IN_NOTNULL const arena_t *arena);
+
+/// @brief check if an arena is a pool
+///
+/// @param arena the arena to check
+///
+/// @return true if @p arena was created with @ref pool_new
+CT_NODISCARD CT_PUREFN
+CT_ARENA_API bool arena_is_pool(IN_NOTNULL const arena_t *arena);
+
+/// @} // pool
+
+CT_END_API
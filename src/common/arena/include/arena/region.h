@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_arena_api.h>
+
+#include "core/analyze.h"
+#include "core/compiler.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct arena_t arena_t;
+
+CT_BEGIN_API
+
+/// @defgroup region Region allocation
+/// @brief Chunked bump pointer allocator
+/// a region carves allocations out of large chunks requested from a parent arena.
+/// freeing memory is a no-op unless it is the most recent allocation, and
+/// reallocating the most recent allocation grows it in place when the chunk has room.
+/// all memory in a region is released at once with @ref region_reset or @ref region_delete,
+/// or back to a checkpoint taken with @ref arena_mark using @ref arena_release_to.
+/// @ingroup memory
+/// @{
+
+/// @brief the default size of each chunk requested from the parent arena
+#define CT_REGION_CHUNK_SIZE (1024U * 1024U)
+
+/// @brief memory usage of a region
+typedef struct region_stats_t
+{
+    /// @brief the number of chunks held by the region
+    size_t chunks;
+
+    /// @brief the total number of bytes requested from the parent arena
+    size_t reserved;
+
+    /// @brief the number of bytes currently handed out, including headers and padding
+    size_t used;
+} region_stats_t;
+
+/// @brief create a new region allocator
+/// @pre @p chunk_size must be greater than 0
+/// @pre @p parent must not be NULL
+///
+/// @param name the name of the region
+/// @param chunk_size the size of each chunk requested from @p parent
+/// @param parent the arena to allocate chunks from
+///
+/// @return the region allocator
+RET_NOTNULL
+CT_ARENA_API arena_t *region_new(
+    IN_STRING const char *name,
+    IN_DOMAIN(>, 0) size_t chunk_size,
+    IN_NOTNULL arena_t *parent);
+
+/// @brief release all memory allocated from a region
+/// the region keeps one chunk around to serve future allocations.
+/// @warning all pointers allocated from @p arena are invalid after this call
+/// @pre @p arena must have been created with @ref region_new
+///
+/// @param arena the region to reset
+CT_ARENA_API void region_reset(IN_NOTNULL arena_t *arena);
+
+/// @brief release all memory held by a region and the region itself
+/// @pre @p arena must have been created with @ref region_new
+///
+/// @param arena the region to delete
+CT_ARENA_API void region_delete(STA_RELEASE arena_t *arena);
+
+/// @brief get the memory usage of a region
+/// @pre @p arena must have been created with @ref region_new
+///
+/// @param arena the region to query
+///
+/// @return the memory usage of the region
+CT_NODISCARD
+CT_ARENA_API region_stats_t region_stats(IN_NOTNULL const arena_t *arena);
+
+/// @brief a checkpoint in a region
+/// @warning this is an opaque type, do not access its members directly
+typedef struct arena_mark_t
+{
+    /// @brief the bump cursor when the mark was taken
+    void *cursor;
+
+    /// @brief the first chunk epoch created after the mark
+    size_t epoch;
+
+    /// @brief the bump usage when the mark was taken
+    size_t used;
+} arena_mark_t;
+
+/// @brief take a checkpoint of a region
+/// allocations made before the mark are frozen in place, they will
+/// not be grown or released in place by later reallocs or frees.
+/// @pre @p arena must have been created with @ref region_new
+///
+/// @param arena the region to mark
+///
+/// @return the checkpoint
+CT_NODISCARD
+CT_ARENA_API arena_mark_t arena_mark(IN_NOTNULL arena_t *arena);
+
+/// @brief release everything allocated from a region since a checkpoint
+/// marks taken after @p mark are invalidated, earlier marks stay valid.
+/// one released chunk is kept back so repeatedly rewinding to the same mark
+/// does not go back to the parent arena every time.
+/// @warning all pointers allocated from @p arena after @p mark are invalid after this call
+/// @warning resetting the region invalidates all marks
+/// @pre @p arena must have been created with @ref region_new
+/// @pre @p mark must have been taken from @p arena
+///
+/// @param arena the region to rewind
+/// @param mark the checkpoint to rewind to
+CT_ARENA_API void arena_release_to(IN_NOTNULL arena_t *arena, arena_mark_t mark);
+
+/// @brief check if an arena is a region
+///
+/// @param arena the arena to check
+///
+/// @return true if @p arena was created with @ref region_new
+CT_NODISCARD CT_PUREFN
+CT_ARENA_API bool arena_is_region(IN_NOTNULL const arena_t *arena);
+
+/// @} // region
+
+CT_END_API
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_arena_api.h>
+
+#include "core/analyze.h"
+#include "core/compiler.h"
+
+#include <stdbool.h>
+
+typedef struct arena_t arena_t;
+
+CT_BEGIN_API
+
+/// @defgroup shared Shared allocation
+/// @brief Thread safe wrapper around another arena
+/// a shared arena forwards every operation to a parent arena while holding a lock,
+/// so arenas that are not thread safe can be used from multiple threads at once.
+/// the lock is only held for the duration of each call to the parent.
+/// @ingroup memory
+/// @{
+
+/// @brief create a new shared arena
+/// @pre @p parent must not be NULL
+/// @warning the parent must not be used directly while the shared arena is in use
+///
+/// @param name the name of the shared arena
+/// @param parent the arena to forward allocations to
+///
+/// @return the shared arena
+RET_NOTNULL
+CT_ARENA_API arena_t *shared_new(
+    IN_STRING const char *name,
+    IN_NOTNULL arena_t *parent);
+
+/// @brief release a shared arena
+/// memory allocated through the shared arena is still owned by the parent arena.
+/// @pre @p arena must have been created with @ref shared_new
+///
+/// @param arena the shared arena to delete
+CT_ARENA_API void shared_delete(STA_RELEASE arena_t *arena);
+
+/// @brief check if an arena is a shared arena
+///
+/// @param arena the arena to check
+///
+/// @return true if @p arena was created with @ref shared_new
+CT_NODISCARD CT_PUREFN
+CT_ARENA_API bool arena_is_shared(IN_NOTNULL const arena_t *arena);
+
+/// @} // shared
+
+CT_END_API
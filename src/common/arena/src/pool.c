@@ -0,0 +1,304 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "arena/pool.h"
+#include "arena/arena.h"
+
+#include "base/panic.h"
+#include "base/util.h"
+
+#include "core/macros.h"
+
+#include <stdint.h>
+
+/// size classes are multiples of the granule, which is also the alignment of every slot.
+/// slabs only hold slots of a single size class so objects of the same size are packed
+/// together, freed slots are threaded onto a free list through their first word.
+
+#define POOL_GRANULE (sizeof(void*) * 2)
+#define POOL_CLASSES (CT_POOL_MAX_SIZE / POOL_GRANULE)
+
+CT_STATIC_ASSERT(CT_POOL_MAX_SIZE % (sizeof(void*) * 2) == 0, "pool max size must be a multiple of the granule");
+
+typedef struct pool_slot_t
+{
+    struct pool_slot_t *next;
+} pool_slot_t;
+
+typedef struct pool_slab_t
+{
+    struct pool_slab_t *next;
+
+    /// the size of the allocation from the parent arena
+    size_t size;
+
+    /// the size class of every slot in this slab
+    size_t index;
+} pool_slab_t;
+
+typedef struct pool_class_t
+{
+    /// slots that have been freed and can be reused
+    pool_slot_t *free;
+
+    /// the unused part of the most recent slab for this class
+    char *cursor;
+    char *end;
+} pool_class_t;
+
+typedef struct pool_t
+{
+    arena_t arena;
+    arena_t *parent;
+
+    size_t slab_size;
+
+    /// every slab in the pool, used for lookups when the size is unknown
+    pool_slab_t *slabs;
+
+    pool_class_t classes[POOL_CLASSES];
+
+    size_t used;
+} pool_t;
+
+static size_t get_class_index(size_t size)
+{
+    size_t granules = (CT_MAX(size, 1) + POOL_GRANULE - 1) / POOL_GRANULE;
+    return granules - 1;
+}
+
+static size_t get_class_size(size_t index)
+{
+    return (index + 1) * POOL_GRANULE;
+}
+
+static char *slab_begin(pool_slab_t *slab)
+{
+    return (char*)CT_ALIGN_POW2((uintptr_t)(slab + 1), POOL_GRANULE);
+}
+
+static char *slab_end(pool_slab_t *slab)
+{
+    return (char*)slab + slab->size;
+}
+
+static pool_slab_t *find_slab(pool_t *pool, const void *ptr)
+{
+    for (pool_slab_t *slab = pool->slabs; slab != NULL; slab = slab->next)
+    {
+        const char *it = ptr;
+        if (it >= slab_begin(slab) && it < slab_end(slab))
+            return slab;
+    }
+
+    return NULL;
+}
+
+/// find the size class of an allocation
+/// returns false if the allocation was forwarded to the parent arena
+static bool pool_lookup(pool_t *pool, const void *ptr, size_t size, size_t *index)
+{
+    if (size != CT_ALLOC_SIZE_UNKNOWN)
+    {
+        if (size > CT_POOL_MAX_SIZE) return false;
+
+        *index = get_class_index(size);
+        return true;
+    }
+
+    pool_slab_t *slab = find_slab(pool, ptr);
+    if (slab == NULL) return false;
+
+    *index = slab->index;
+    return true;
+}
+
+static bool pool_grow(pool_t *pool, size_t index)
+{
+    size_t size = CT_MAX(pool->slab_size, sizeof(pool_slab_t) + POOL_GRANULE + get_class_size(index));
+    pool_slab_t *slab = ARENA_OPT_MALLOC(size, pool->arena.name, NULL, pool->parent);
+    if (slab == NULL) return false;
+
+    slab->next = pool->slabs;
+    slab->size = size;
+    slab->index = index;
+    pool->slabs = slab;
+
+    pool_class_t *class = &pool->classes[index];
+    class->cursor = slab_begin(slab);
+    class->end = slab_end(slab);
+
+    return true;
+}
+
+static void *pool_malloc(size_t size, void *user)
+{
+    pool_t *pool = user;
+
+    if (size > CT_POOL_MAX_SIZE)
+        return arena_opt_malloc(size, pool->parent);
+
+    size_t index = get_class_index(size);
+    size_t cell = get_class_size(index);
+    pool_class_t *class = &pool->classes[index];
+
+    if (class->free != NULL)
+    {
+        pool_slot_t *slot = class->free;
+        class->free = slot->next;
+        pool->used += cell;
+        return slot;
+    }
+
+    if (cell > (size_t)(class->end - class->cursor))
+    {
+        if (!pool_grow(pool, index))
+            return NULL;
+    }
+
+    void *ptr = class->cursor;
+    class->cursor += cell;
+    pool->used += cell;
+
+    return ptr;
+}
+
+static void pool_release(pool_t *pool, void *ptr, size_t index)
+{
+    pool_class_t *class = &pool->classes[index];
+    pool_slot_t *slot = ptr;
+    slot->next = class->free;
+    class->free = slot;
+
+    pool->used -= get_class_size(index);
+}
+
+static void pool_free(void *ptr, size_t size, void *user)
+{
+    pool_t *pool = user;
+
+    size_t index;
+    if (!pool_lookup(pool, ptr, size, &index))
+    {
+        arena_opt_free(ptr, size, pool->parent);
+        return;
+    }
+
+    pool_release(pool, ptr, index);
+}
+
+static void *pool_realloc(void *ptr, size_t new_size, size_t old_size, void *user)
+{
+    pool_t *pool = user;
+
+    size_t index;
+    if (!pool_lookup(pool, ptr, old_size, &index))
+    {
+        if (new_size > CT_POOL_MAX_SIZE)
+            return arena_opt_realloc(ptr, new_size, old_size, pool->parent);
+
+        // shrinking a large allocation into a size class
+        void *out = pool_malloc(new_size, pool);
+        if (out == NULL) return NULL;
+
+        ctu_memcpy(out, ptr, new_size);
+        arena_opt_free(ptr, old_size, pool->parent);
+        return out;
+    }
+
+    size_t cell = get_class_size(index);
+    if (new_size <= cell) return ptr;
+
+    void *out = pool_malloc(new_size, pool);
+    if (out == NULL) return NULL;
+
+    ctu_memcpy(out, ptr, cell);
+    pool_release(pool, ptr, index);
+
+    return out;
+}
+
+static pool_t *get_pool(const arena_t *arena)
+{
+    CTASSERT(arena != NULL);
+    CTASSERTF(arena_is_pool(arena), "arena %s is not a pool", arena->name);
+
+    return arena->user;
+}
+
+STA_DECL
+arena_t *pool_new(const char *name, size_t slab_size, arena_t *parent)
+{
+    CTASSERT(name != NULL);
+    CTASSERT(slab_size > 0);
+    CTASSERT(parent != NULL);
+
+    pool_t *pool = ARENA_MALLOC(sizeof(pool_t), name, NULL, parent);
+
+    arena_t arena = {
+        .name = name,
+        .fn_malloc = pool_malloc,
+        .fn_realloc = pool_realloc,
+        .fn_free = pool_free,
+        .user = pool,
+    };
+
+    pool->arena = arena;
+    pool->parent = parent;
+    pool->slab_size = slab_size;
+    pool->slabs = NULL;
+    pool->used = 0;
+
+    for (size_t i = 0; i < POOL_CLASSES; i++)
+    {
+        pool_class_t *class = &pool->classes[i];
+        class->free = NULL;
+        class->cursor = NULL;
+        class->end = NULL;
+    }
+
+    return &pool->arena;
+}
+
+STA_DECL
+void pool_delete(arena_t *arena)
+{
+    pool_t *pool = get_pool(arena);
+
+    pool_slab_t *slab = pool->slabs;
+    while (slab != NULL)
+    {
+        pool_slab_t *next = slab->next;
+        arena_free(slab, slab->size, pool->parent);
+        slab = next;
+    }
+
+    arena_free(pool, sizeof(pool_t), pool->parent);
+}
+
+STA_DECL
+pool_stats_t pool_stats(const arena_t *arena)
+{
+    pool_t *pool = get_pool(arena);
+
+    pool_stats_t stats = {
+        .slabs = 0,
+        .reserved = 0,
+        .used = pool->used,
+    };
+
+    for (pool_slab_t *slab = pool->slabs; slab != NULL; slab = slab->next)
+    {
+        stats.slabs += 1;
+        stats.reserved += slab->size;
+    }
+
+    return stats;
+}
+
+STA_DECL
+bool arena_is_pool(const arena_t *arena)
+{
+    CTASSERT(arena != NULL);
+
+    return arena->fn_malloc == pool_malloc;
+}
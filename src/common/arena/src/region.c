@@ -0,0 +1,443 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "arena/region.h"
+#include "arena/arena.h"
+
+#include "base/panic.h"
+#include "base/util.h"
+
+#include "core/macros.h"
+
+#include <stdint.h>
+
+/// every allocation is preceded by a header holding its usable capacity.
+/// the header is placed so that the pointer handed out is aligned to REGION_ALIGN.
+/// the low bit of the header marks allocations that own a dedicated chunk.
+
+typedef size_t region_header_t;
+
+#define REGION_ALIGN (sizeof(void*) * 2)
+#define REGION_HEADER sizeof(region_header_t)
+#define REGION_LARGE_FLAG ((region_header_t)1)
+
+CT_STATIC_ASSERT(REGION_HEADER < REGION_ALIGN, "region header must be smaller than the alignment");
+
+typedef struct region_chunk_t
+{
+    struct region_chunk_t *prev;
+    struct region_chunk_t *next;
+
+    /// the pointer and size of the allocation from the parent arena
+    void *base;
+    size_t size;
+
+    /// when this chunk was created relative to other chunks in the region
+    /// chunks are always linked newest first
+    size_t epoch;
+} region_chunk_t;
+
+typedef struct region_t
+{
+    arena_t arena;
+    arena_t *parent;
+
+    size_t chunk_size;
+
+    /// allocations larger than this get their own chunk
+    size_t large_threshold;
+
+    /// chunks used for bump allocation, the head is the active chunk
+    region_chunk_t *chunks;
+
+    /// chunks that each hold a single large allocation
+    region_chunk_t *large;
+
+    /// a chunk kept back by @a arena_release_to to avoid
+    /// returning to the parent arena on every checkpoint
+    region_chunk_t *spare;
+
+    char *cursor;
+    char *end;
+
+    /// the most recent bump allocation, can be grown or freed in place
+    void *last;
+
+    /// the epoch of the next chunk to be created
+    size_t epoch;
+
+    /// bytes handed out from bump chunks
+    size_t used;
+
+    /// bytes handed out from large chunks
+    size_t large_used;
+} region_t;
+
+static size_t get_footprint(size_t size)
+{
+    return CT_ALIGN_POW2(size + REGION_HEADER, REGION_ALIGN);
+}
+
+static region_header_t *get_header(void *ptr)
+{
+    return (region_header_t*)((char*)ptr - REGION_HEADER);
+}
+
+static size_t get_capacity(void *ptr)
+{
+    return *get_header(ptr) & ~REGION_LARGE_FLAG;
+}
+
+/// get the first address in a chunk where a header can be placed
+static char *chunk_begin(region_chunk_t *chunk)
+{
+    uintptr_t data = (uintptr_t)(chunk + 1) + REGION_HEADER;
+    return (char*)(CT_ALIGN_POW2(data, REGION_ALIGN) - REGION_HEADER);
+}
+
+static char *chunk_end(region_chunk_t *chunk)
+{
+    return (char*)chunk->base + chunk->size;
+}
+
+static void chunk_link(region_t *region, region_chunk_t **list, region_chunk_t *chunk)
+{
+    chunk->epoch = region->epoch++;
+    chunk->prev = NULL;
+    chunk->next = *list;
+    if (*list != NULL)
+        (*list)->prev = chunk;
+
+    *list = chunk;
+}
+
+static void chunk_unlink(region_chunk_t **list, region_chunk_t *chunk)
+{
+    if (chunk->prev != NULL)
+        chunk->prev->next = chunk->next;
+    else
+        *list = chunk->next;
+
+    if (chunk->next != NULL)
+        chunk->next->prev = chunk->prev;
+}
+
+static void chunk_release_all(region_t *region, region_chunk_t *chunk)
+{
+    while (chunk != NULL)
+    {
+        region_chunk_t *next = chunk->next;
+        arena_free(chunk->base, chunk->size, region->parent);
+        chunk = next;
+    }
+}
+
+static void region_activate(region_t *region, region_chunk_t *chunk)
+{
+    region->cursor = chunk_begin(chunk);
+    region->end = chunk_end(chunk);
+    region->last = NULL;
+}
+
+static bool region_grow(region_t *region, size_t footprint)
+{
+    size_t size = CT_MAX(region->chunk_size, footprint + sizeof(region_chunk_t) + REGION_ALIGN);
+    region_chunk_t *chunk = region->spare;
+    if (chunk != NULL && chunk->size >= size)
+    {
+        region->spare = NULL;
+        chunk_link(region, &region->chunks, chunk);
+        region_activate(region, chunk);
+        return true;
+    }
+
+    chunk = ARENA_OPT_MALLOC(size, region->arena.name, NULL, region->parent);
+    if (chunk == NULL) return false;
+
+    chunk->base = chunk;
+    chunk->size = size;
+    chunk_link(region, &region->chunks, chunk);
+    region_activate(region, chunk);
+
+    return true;
+}
+
+static void *region_alloc_large(region_t *region, size_t footprint)
+{
+    // the chunk header is placed directly before the allocation header
+    // so the chunk can be found again when the allocation is released
+    size_t size = footprint + sizeof(region_chunk_t) + REGION_ALIGN;
+    char *base = ARENA_OPT_MALLOC(size, region->arena.name, NULL, region->parent);
+    if (base == NULL) return NULL;
+
+    uintptr_t data = (uintptr_t)base + sizeof(region_chunk_t) + REGION_HEADER;
+    char *ptr = (char*)CT_ALIGN_POW2(data, REGION_ALIGN);
+
+    region_chunk_t *chunk = (region_chunk_t*)(ptr - REGION_HEADER) - 1;
+    chunk->base = base;
+    chunk->size = size;
+    chunk_link(region, &region->large, chunk);
+
+    *get_header(ptr) = (footprint - REGION_HEADER) | REGION_LARGE_FLAG;
+    region->large_used += footprint;
+
+    return ptr;
+}
+
+static void region_free_large(region_t *region, void *ptr)
+{
+    region_chunk_t *chunk = (region_chunk_t*)get_header(ptr) - 1;
+    region->large_used -= get_capacity(ptr) + REGION_HEADER;
+
+    chunk_unlink(&region->large, chunk);
+    arena_free(chunk->base, chunk->size, region->parent);
+}
+
+static void *region_malloc(size_t size, void *user)
+{
+    region_t *region = user;
+    size_t footprint = get_footprint(size);
+
+    if (footprint > region->large_threshold)
+        return region_alloc_large(region, footprint);
+
+    if (footprint > (size_t)(region->end - region->cursor))
+    {
+        if (!region_grow(region, footprint))
+            return NULL;
+    }
+
+    char *ptr = region->cursor + REGION_HEADER;
+    region->cursor += footprint;
+    region->last = ptr;
+    region->used += footprint;
+
+    *get_header(ptr) = footprint - REGION_HEADER;
+
+    return ptr;
+}
+
+static void region_free(void *ptr, size_t size, void *user)
+{
+    CT_UNUSED(size);
+
+    region_t *region = user;
+    region_header_t header = *get_header(ptr);
+
+    if (header & REGION_LARGE_FLAG)
+    {
+        region_free_large(region, ptr);
+        return;
+    }
+
+    // only the most recent allocation can be given back
+    if (ptr != region->last) return;
+
+    region->cursor = (char*)get_header(ptr);
+    region->used -= header + REGION_HEADER;
+    region->last = NULL;
+}
+
+static void *region_realloc(void *ptr, size_t new_size, size_t old_size, void *user)
+{
+    CT_UNUSED(old_size);
+
+    region_t *region = user;
+    size_t capacity = get_capacity(ptr);
+
+    // shrinking or growing within the padding never moves
+    if (new_size <= capacity) return ptr;
+
+    if (ptr == region->last)
+    {
+        size_t footprint = get_footprint(new_size);
+        char *header = (char*)get_header(ptr);
+        if (footprint <= (size_t)(region->end - header))
+        {
+            region->cursor = header + footprint;
+            region->used += footprint - (capacity + REGION_HEADER);
+            *get_header(ptr) = footprint - REGION_HEADER;
+            return ptr;
+        }
+    }
+
+    void *out = region_malloc(new_size, region);
+    if (out == NULL) return NULL;
+
+    ctu_memcpy(out, ptr, capacity);
+    region_free(ptr, capacity, region);
+
+    return out;
+}
+
+static region_t *get_region(const arena_t *arena)
+{
+    CTASSERT(arena != NULL);
+    CTASSERTF(arena_is_region(arena), "arena %s is not a region", arena->name);
+
+    return arena->user;
+}
+
+STA_DECL
+arena_t *region_new(const char *name, size_t chunk_size, arena_t *parent)
+{
+    CTASSERT(name != NULL);
+    CTASSERT(chunk_size > 0);
+    CTASSERT(parent != NULL);
+
+    region_t *region = ARENA_MALLOC(sizeof(region_t), name, NULL, parent);
+
+    arena_t arena = {
+        .name = name,
+        .fn_malloc = region_malloc,
+        .fn_realloc = region_realloc,
+        .fn_free = region_free,
+        .user = region,
+    };
+
+    region->arena = arena;
+    region->parent = parent;
+    region->chunk_size = chunk_size;
+    region->large_threshold = chunk_size / 4;
+    region->chunks = NULL;
+    region->large = NULL;
+    region->spare = NULL;
+    region->cursor = NULL;
+    region->end = NULL;
+    region->last = NULL;
+    region->epoch = 0;
+    region->used = 0;
+    region->large_used = 0;
+
+    return &region->arena;
+}
+
+STA_DECL
+void region_reset(arena_t *arena)
+{
+    region_t *region = get_region(arena);
+
+    chunk_release_all(region, region->large);
+    region->large = NULL;
+
+    region_chunk_t *head = region->chunks;
+    if (head != NULL)
+    {
+        chunk_release_all(region, head->next);
+        head->next = NULL;
+        region_activate(region, head);
+    }
+
+    region->used = 0;
+    region->large_used = 0;
+}
+
+STA_DECL
+void region_delete(arena_t *arena)
+{
+    region_t *region = get_region(arena);
+
+    chunk_release_all(region, region->large);
+    chunk_release_all(region, region->chunks);
+    chunk_release_all(region, region->spare);
+
+    arena_free(region, sizeof(region_t), region->parent);
+}
+
+STA_DECL
+region_stats_t region_stats(const arena_t *arena)
+{
+    region_t *region = get_region(arena);
+
+    region_stats_t stats = {
+        .chunks = 0,
+        .reserved = 0,
+        .used = region->used + region->large_used,
+    };
+
+    for (region_chunk_t *chunk = region->chunks; chunk != NULL; chunk = chunk->next)
+    {
+        stats.chunks += 1;
+        stats.reserved += chunk->size;
+    }
+
+    for (region_chunk_t *chunk = region->large; chunk != NULL; chunk = chunk->next)
+    {
+        stats.chunks += 1;
+        stats.reserved += chunk->size;
+    }
+
+    if (region->spare != NULL)
+    {
+        stats.chunks += 1;
+        stats.reserved += region->spare->size;
+    }
+
+    return stats;
+}
+
+STA_DECL
+arena_mark_t arena_mark(arena_t *arena)
+{
+    region_t *region = get_region(arena);
+
+    // allocations made before the mark must not move the cursor
+    // once the mark has been taken
+    region->last = NULL;
+
+    arena_mark_t mark = {
+        .cursor = region->cursor,
+        .epoch = region->epoch,
+        .used = region->used,
+    };
+
+    return mark;
+}
+
+STA_DECL
+void arena_release_to(arena_t *arena, arena_mark_t mark)
+{
+    region_t *region = get_region(arena);
+    CTASSERTF(mark.epoch <= region->epoch, "mark is newer than region %s", arena->name);
+
+    // every chunk created after the mark can be released entirely
+    while (region->large != NULL && region->large->epoch >= mark.epoch)
+    {
+        region_chunk_t *chunk = region->large;
+        char *ptr = (char*)(chunk + 1) + REGION_HEADER;
+        region_free_large(region, ptr);
+    }
+
+    while (region->chunks != NULL && region->chunks->epoch >= mark.epoch)
+    {
+        region_chunk_t *chunk = region->chunks;
+        chunk_unlink(&region->chunks, chunk);
+
+        // keep the largest chunk around for the next allocations after the mark
+        if (region->spare == NULL || region->spare->size < chunk->size)
+        {
+            region_chunk_t *old = region->spare;
+            chunk->next = NULL;
+            region->spare = chunk;
+            chunk = old;
+        }
+
+        if (chunk != NULL)
+        {
+            arena_free(chunk->base, chunk->size, region->parent);
+        }
+    }
+
+    // then rewind the chunk that was active when the mark was taken
+    region->cursor = mark.cursor;
+    region->end = (region->chunks != NULL) ? chunk_end(region->chunks) : NULL;
+    region->last = NULL;
+    region->used = mark.used;
+}
+
+STA_DECL
+bool arena_is_region(const arena_t *arena)
+{
+    CTASSERT(arena != NULL);
+
+    return arena->fn_malloc == region_malloc;
+}
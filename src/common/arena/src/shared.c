@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "arena/shared.h"
+#include "arena/arena.h"
+
+#include "base/panic.h"
+#include "base/spinlock.h"
+
+// allocations are short and rarely contended, so a spin lock
+// is cheaper than going through the os for a mutex
+
+typedef struct shared_t
+{
+    arena_t arena;
+    arena_t *parent;
+
+    spinlock_t lock;
+} shared_t;
+
+static void *shared_malloc(size_t size, void *user)
+{
+    shared_t *shared = user;
+
+    spinlock_acquire(&shared->lock);
+    void *ptr = arena_opt_malloc(size, shared->parent);
+    spinlock_release(&shared->lock);
+
+    return ptr;
+}
+
+static void *shared_realloc(void *ptr, size_t new_size, size_t old_size, void *user)
+{
+    shared_t *shared = user;
+
+    spinlock_acquire(&shared->lock);
+    void *out = arena_opt_realloc(ptr, new_size, old_size, shared->parent);
+    spinlock_release(&shared->lock);
+
+    return out;
+}
+
+static void shared_free(void *ptr, size_t size, void *user)
+{
+    shared_t *shared = user;
+
+    spinlock_acquire(&shared->lock);
+    arena_opt_free(ptr, size, shared->parent);
+    spinlock_release(&shared->lock);
+}
+
+static void shared_rename(const void *ptr, const char *name, void *user)
+{
+    shared_t *shared = user;
+
+    spinlock_acquire(&shared->lock);
+    arena_rename(ptr, name, shared->parent);
+    spinlock_release(&shared->lock);
+}
+
+static void shared_reparent(const void *ptr, const void *parent, void *user)
+{
+    shared_t *shared = user;
+
+    spinlock_acquire(&shared->lock);
+    arena_reparent(ptr, parent, shared->parent);
+    spinlock_release(&shared->lock);
+}
+
+static shared_t *get_shared(const arena_t *arena)
+{
+    CTASSERT(arena != NULL);
+    CTASSERTF(arena_is_shared(arena), "arena %s is not a shared arena", arena->name);
+
+    return arena->user;
+}
+
+STA_DECL
+arena_t *shared_new(const char *name, arena_t *parent)
+{
+    CTASSERT(name != NULL);
+    CTASSERT(parent != NULL);
+
+    shared_t *shared = ARENA_MALLOC(sizeof(shared_t), name, NULL, parent);
+
+    arena_t arena = {
+        .name = name,
+        .fn_malloc = shared_malloc,
+        .fn_realloc = shared_realloc,
+        .fn_free = shared_free,
+        .fn_rename = shared_rename,
+        .fn_reparent = shared_reparent,
+        .user = shared,
+    };
+
+    shared->arena = arena;
+    shared->parent = parent;
+    spinlock_t lock = CT_SPINLOCK_INIT;
+    shared->lock = lock;
+
+    return &shared->arena;
+}
+
+STA_DECL
+void shared_delete(arena_t *arena)
+{
+    shared_t *shared = get_shared(arena);
+
+    arena_free(shared, sizeof(shared_t), shared->parent);
+}
+
+STA_DECL
+bool arena_is_shared(const arena_t *arena)
+{
+    CTASSERT(arena != NULL);
+
+    return arena->fn_malloc == shared_malloc;
+}
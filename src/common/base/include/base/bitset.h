@@ -102,6 +102,98 @@ CT_BASE_API void bitset_reset(bitset_t set);
 CT_PUREFN
 CT_BASE_API size_t bitset_len(bitset_t set);
 
+/// @brief intersect two bitsets, `dst &= src`
+/// @pre @p dst and @p src are the same size
+///
+/// @param dst the bitset to modify
+/// @param src the bitset to intersect with
+///
+/// @return true if @p dst changed
+CT_BASE_API bool bitset_and(bitset_t dst, bitset_t src);
+
+/// @brief union two bitsets, `dst |= src`
+/// @pre @p dst and @p src are the same size
+///
+/// @param dst the bitset to modify
+/// @param src the bitset to union with
+///
+/// @return true if @p dst changed
+CT_BASE_API bool bitset_or(bitset_t dst, bitset_t src);
+
+/// @brief remove the bits of one bitset from another, `dst &= ~src`
+/// @pre @p dst and @p src are the same size
+///
+/// @param dst the bitset to modify
+/// @param src the bits to remove
+///
+/// @return true if @p dst changed
+CT_BASE_API bool bitset_andnot(bitset_t dst, bitset_t src);
+
+/// @brief toggle the bits of one bitset in another, `dst ^= src`
+/// @pre @p dst and @p src are the same size
+///
+/// @param dst the bitset to modify
+/// @param src the bits to toggle
+///
+/// @return true if @p dst changed
+CT_BASE_API bool bitset_xor(bitset_t dst, bitset_t src);
+
+/// @brief count the number of set bits in a bitset
+///
+/// @param set the bitset to count
+///
+/// @return the number of set bits
+CT_PUREFN
+CT_BASE_API size_t bitset_count(bitset_t set);
+
+/// @brief find the next set bit
+///
+/// @param set the bitset to scan
+/// @param start the index to start scanning from
+///
+/// @return the index of the next set bit at or after @p start, or SIZE_MAX if there are none
+CT_PUREFN
+CT_BASE_API size_t bitset_find_next(bitset_t set, size_t start);
+
+/// @brief an iterator over the set bits of a bitset
+/// @warning this is an internal type and should not be used directly
+typedef struct bitset_iter_t
+{
+    /// @brief the bitset being iterated
+    bitset_t set;
+
+    /// @brief the byte offset of @a word in the bitset
+    size_t offset;
+
+    /// @brief the remaining set bits of the current word
+    uint64_t word;
+} bitset_iter_t;
+
+/// @brief create an iterator over the set bits of a bitset
+/// @note modifying the bitset while iterating is invalid
+///
+/// @param set the bitset to iterate
+///
+/// @return the iterator
+CT_NODISCARD
+CT_BASE_API bitset_iter_t bitset_iter(bitset_t set);
+
+/// @brief check if an iterator has more set bits
+///
+/// @param iter the iterator to check
+///
+/// @return true if there are more set bits
+CT_PUREFN
+CT_BASE_API bool bitset_has_next(IN_NOTNULL const bitset_iter_t *iter);
+
+/// @brief get the index of the next set bit
+/// @pre @a bitset_has_next(iter) is true
+///
+/// @param iter the iterator to advance
+///
+/// @return the index of the set bit
+CT_BASE_API size_t bitset_next(IN_NOTNULL bitset_iter_t *iter);
+
 /// @}
 
 CT_END_API
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_base_api.h>
+
+#include "core/analyze.h"
+
+CT_BEGIN_API
+
+/// @defgroup spinlock Spin locks
+/// @ingroup base
+/// @brief Locks for short critical sections below the os layer
+/// waiters pause the cpu while they spin, and give up their
+/// time slice if the lock stays held for a while.
+/// @{
+
+/// @brief a spin lock
+/// @warning this is an internal type and should not be used directly
+typedef struct spinlock_t
+{
+    volatile long locked;
+} spinlock_t;
+
+/// @brief initialize an unlocked spin lock
+#define CT_SPINLOCK_INIT { 0 }
+
+/// @brief take a spin lock, waiting until it is free
+///
+/// @param lock the lock to take
+CT_BASE_API void spinlock_acquire(IN_NOTNULL spinlock_t *lock);
+
+/// @brief release a spin lock taken with @ref spinlock_acquire
+///
+/// @param lock the lock to release
+CT_BASE_API void spinlock_release(IN_NOTNULL spinlock_t *lock);
+
+/// @}
+
+CT_END_API
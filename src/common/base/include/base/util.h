@@ -35,6 +35,7 @@ CT_NODISCARD CT_CONSTFN
 CT_BASE_API ctu_hash_t ctu_ptrhash(const void *ptr);
 
 /// @brief hash a string
+/// @note the result is the same as @ref text_hash over the same characters
 ///
 /// @param str the string to hash
 ///
@@ -50,6 +51,16 @@ CT_BASE_API ctu_hash_t str_hash(IN_STRING const char *str);
 CT_NODISCARD CT_PUREFN
 CT_BASE_API ctu_hash_t text_hash(text_view_t text);
 
+/// @brief hash a string with a provided length and seed
+/// different seeds produce unrelated hashes for the same text
+///
+/// @param text the string to hash
+/// @param seed the seed to mix into the hash
+///
+/// @return the hash
+CT_NODISCARD CT_PUREFN
+CT_BASE_API ctu_hash_t text_hash_seeded(text_view_t text, ctu_hash_t seed);
+
 // stdlib wrappers
 
 /// @brief check if a character is a letter
@@ -8,6 +8,28 @@
 
 #include <limits.h>
 
+#if CT_CC_MSVC
+#   include <intrin.h>
+#endif
+
+// long sets are processed 32 bytes at a time with avx2. when the
+// compiler isnt already targeting avx2 the cpu is checked at runtime.
+#if defined(__AVX2__)
+#   define BITSET_USE_AVX2 1
+#   include <immintrin.h>
+#elif (CT_CC_GNU || CT_CC_CLANG) && (defined(__x86_64__) || defined(__i386__))
+#   define BITSET_USE_AVX2 1
+#   define BITSET_DETECT_AVX2 1
+#   include <immintrin.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#   define BITSET_BIG_ENDIAN 1
+#endif
+
+// sets shorter than this are not worth the avx2 setup
+#define BITSET_AVX2_MIN_BYTES 128
+
 typedef unsigned char bitset_word_t;
 
 #define BITSET_WORD_MAX (UCHAR_MAX)
@@ -157,3 +179,334 @@ size_t bitset_len(bitset_t set)
 
     return set.words * WORD_SIZE;
 }
+
+// bulk operations work on 64 bits at a time, the bitset itself is
+// byte addressed so chunks are loaded with memcpy to avoid alignment issues
+
+static uint64_t load_chunk(const bitset_word_t *ptr)
+{
+    uint64_t chunk;
+    ctu_memcpy(&chunk, ptr, sizeof(uint64_t));
+    return chunk;
+}
+
+static void store_chunk(bitset_word_t *ptr, uint64_t chunk)
+{
+    ctu_memcpy(ptr, &chunk, sizeof(uint64_t));
+}
+
+// load up to 8 bytes so that bit n of the set is bit n of the result
+static uint64_t load_bits(const bitset_word_t *ptr, size_t len)
+{
+    uint64_t chunk = 0;
+    ctu_memcpy(&chunk, ptr, CT_MIN(len, sizeof(uint64_t)));
+#if BITSET_BIG_ENDIAN
+    chunk = CT_BSWAP_U64(chunk);
+#endif
+    return chunk;
+}
+
+#if CT_CC_MSVC
+// portable popcount for targets without a usable intrinsic
+CT_CONSTFN
+static size_t swar_popcount(uint64_t chunk)
+{
+    chunk = chunk - ((chunk >> 1) & 0x5555555555555555ULL);
+    chunk = (chunk & 0x3333333333333333ULL) + ((chunk >> 2) & 0x3333333333333333ULL);
+    chunk = (chunk + (chunk >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (size_t)((chunk * 0x0101010101010101ULL) >> 56);
+}
+#endif
+
+#if CT_CC_MSVC && defined(_M_X64)
+// __popcnt64 emits popcnt unconditionally, so check the cpu first
+static bool has_popcnt(void)
+{
+    static int gHasPopcnt = -1;
+    if (gHasPopcnt < 0)
+    {
+        int info[4];
+        __cpuid(info, 1);
+        gHasPopcnt = (info[2] & (1 << 23)) != 0;
+    }
+
+    return gHasPopcnt;
+}
+#endif
+
+static size_t chunk_popcount(uint64_t chunk)
+{
+#if CT_CC_MSVC && defined(_M_X64)
+    return has_popcnt() ? (size_t)__popcnt64(chunk) : swar_popcount(chunk);
+#elif CT_CC_MSVC
+    return swar_popcount(chunk);
+#else
+    return (size_t)__builtin_popcountll(chunk);
+#endif
+}
+
+CT_CONSTFN
+static size_t chunk_first(uint64_t chunk)
+{
+#if CT_CC_MSVC && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, chunk);
+    return index;
+#elif CT_CC_MSVC
+    // _BitScanForward64 only exists on 64 bit targets
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)chunk))
+        return index;
+
+    _BitScanForward(&index, (unsigned long)(chunk >> 32));
+    return index + 32;
+#else
+    return (size_t)__builtin_ctzll(chunk);
+#endif
+}
+
+static void check_same_size(bitset_t dst, bitset_t src)
+{
+    CTASSERT(dst.data != NULL);
+    CTASSERT(src.data != NULL);
+    CTASSERTF(dst.words == src.words, "bitset size mismatch %zu != %zu", dst.words, src.words);
+}
+
+#define SCALAR_LOOP(DST, SRC, START, LEN, DIFF, EXPR) \
+    do { \
+        size_t i_ = (START); \
+        for (; i_ + sizeof(uint64_t) <= (LEN); i_ += sizeof(uint64_t)) \
+        { \
+            uint64_t a = load_chunk((DST) + i_); \
+            uint64_t b = load_chunk((SRC) + i_); \
+            uint64_t r = (EXPR); \
+            (DIFF) |= r ^ a; \
+            store_chunk((DST) + i_, r); \
+        } \
+        for (; i_ < (LEN); i_++) \
+        { \
+            uint64_t a = (DST)[i_]; \
+            uint64_t b = (SRC)[i_]; \
+            uint64_t r = (EXPR) & BITSET_WORD_MAX; \
+            (DIFF) |= r ^ a; \
+            (DST)[i_] = (bitset_word_t)r; \
+        } \
+    } while (0)
+
+#if BITSET_USE_AVX2
+
+#if BITSET_DETECT_AVX2
+#   define AVX2_TARGET __attribute__((target("avx2")))
+
+static bool has_avx2(void)
+{
+    static int gHasAvx2 = -1;
+    if (gHasAvx2 < 0)
+    {
+        __builtin_cpu_init();
+        gHasAvx2 = __builtin_cpu_supports("avx2");
+    }
+
+    return gHasAvx2;
+}
+#else
+#   define AVX2_TARGET
+
+static bool has_avx2(void)
+{
+    return true;
+}
+#endif
+
+static bool use_avx2(size_t len)
+{
+    return len >= BITSET_AVX2_MIN_BYTES && has_avx2();
+}
+
+// apply an operation to the 32 byte blocks of a set, returns the number of bytes processed
+#define AVX2_OP(NAME, EXPR) \
+    AVX2_TARGET \
+    static size_t avx2_##NAME(bitset_word_t *dst, const bitset_word_t *src, size_t len, uint64_t *diff) \
+    { \
+        __m256i changed = _mm256_setzero_si256(); \
+        size_t i = 0; \
+        for (; i + sizeof(__m256i) <= len; i += sizeof(__m256i)) \
+        { \
+            __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i)); \
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + i)); \
+            __m256i r = (EXPR); \
+            changed = _mm256_or_si256(changed, _mm256_xor_si256(r, a)); \
+            _mm256_storeu_si256((__m256i*)(dst + i), r); \
+        } \
+        *diff |= !_mm256_testz_si256(changed, changed); \
+        return i; \
+    }
+
+AVX2_OP(and, _mm256_and_si256(a, b))
+AVX2_OP(or, _mm256_or_si256(a, b))
+AVX2_OP(andnot, _mm256_andnot_si256(b, a))
+AVX2_OP(xor, _mm256_xor_si256(a, b))
+
+// count each nibble with a 16 entry table and sum the bytes of every
+// 8 byte lane with sad, the lane totals are added up at the end
+AVX2_TARGET
+static size_t avx2_count(const bitset_word_t *data, size_t len)
+{
+    const __m256i table = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    );
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + sizeof(__m256i) <= len; i += sizeof(__m256i))
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i lo = _mm256_and_si256(v, nibble);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, lo), _mm256_shuffle_epi8(table, hi));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, zero));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, total);
+    size_t count = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t))
+        count += chunk_popcount(load_chunk(data + i));
+
+    for (; i < len; i++)
+        count += chunk_popcount(data[i]);
+
+    return count;
+}
+
+#   define AVX2_APPLY(NAME, DST, SRC, LEN, DIFF) \
+        (use_avx2(LEN) ? avx2_##NAME(DST, SRC, LEN, &(DIFF)) : 0)
+#else
+#   define AVX2_APPLY(NAME, DST, SRC, LEN, DIFF) 0
+#endif
+
+#define BITSET_OP(NAME, EXPR) \
+    STA_DECL \
+    bool bitset_##NAME(bitset_t dst, bitset_t src) \
+    { \
+        check_same_size(dst, src); \
+        bitset_word_t *d = bitset_start(dst); \
+        const bitset_word_t *s = bitset_start(src); \
+        uint64_t diff = 0; \
+        size_t start = AVX2_APPLY(NAME, d, s, dst.words, diff); \
+        SCALAR_LOOP(d, s, start, dst.words, diff, EXPR); \
+        return diff != 0; \
+    }
+
+BITSET_OP(and, a & b)
+BITSET_OP(or, a | b)
+BITSET_OP(andnot, a & ~b)
+BITSET_OP(xor, a ^ b)
+
+STA_DECL
+size_t bitset_count(bitset_t set)
+{
+    const bitset_word_t *data = bitset_start(set);
+    size_t len = set.words;
+
+#if BITSET_USE_AVX2
+    if (use_avx2(len))
+        return avx2_count(data, len);
+#endif
+
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t))
+        count += chunk_popcount(load_chunk(data + i));
+
+    for (; i < len; i++)
+        count += chunk_popcount(data[i]);
+
+    return count;
+}
+
+// find the first set bit at or after the byte offset
+static size_t find_from(bitset_t set, size_t offset, uint64_t chunk)
+{
+    const bitset_word_t *data = bitset_start(set);
+
+    while (chunk == 0)
+    {
+        offset += sizeof(uint64_t);
+        if (offset >= set.words)
+            return SIZE_MAX;
+
+        chunk = load_bits(data + offset, set.words - offset);
+    }
+
+    return offset * WORD_SIZE + chunk_first(chunk);
+}
+
+STA_DECL
+size_t bitset_find_next(bitset_t set, size_t start)
+{
+    if (start >= bitset_len(set))
+        return SIZE_MAX;
+
+    // start from the chunk containing the bit and mask off everything before it
+    size_t offset = word_index(start);
+    uint64_t chunk = load_bits(bitset_start(set) + offset, set.words - offset);
+    chunk &= ~(uint64_t)0 << word_offset(start);
+
+    return find_from(set, offset, chunk);
+}
+
+// load the next chunk with any set bits into the iterator
+static void iter_advance(bitset_iter_t *iter)
+{
+    const bitset_word_t *data = bitset_start(iter->set);
+
+    while (iter->word == 0)
+    {
+        iter->offset += sizeof(uint64_t);
+        if (iter->offset >= iter->set.words)
+            return;
+
+        iter->word = load_bits(data + iter->offset, iter->set.words - iter->offset);
+    }
+}
+
+STA_DECL
+bitset_iter_t bitset_iter(bitset_t set)
+{
+    bitset_iter_t iter = {
+        .set = set,
+        .offset = 0,
+        .word = load_bits(bitset_start(set), set.words)
+    };
+
+    iter_advance(&iter);
+
+    return iter;
+}
+
+STA_DECL
+bool bitset_has_next(const bitset_iter_t *iter)
+{
+    CTASSERT(iter != NULL);
+
+    return iter->word != 0;
+}
+
+STA_DECL
+size_t bitset_next(bitset_iter_t *iter)
+{
+    CTASSERT(bitset_has_next(iter));
+
+    size_t index = iter->offset * WORD_SIZE + chunk_first(iter->word);
+
+    // clear the lowest set bit
+    iter->word &= iter->word - 1;
+    iter_advance(iter);
+
+    return index;
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "base/spinlock.h"
+
+#include "base/panic.h"
+
+#include "core/compiler.h"
+
+#if CT_OS_WINDOWS
+#   include "core/win32.h"
+#else
+#   include <sched.h>
+#endif
+
+#if CT_CC_MSVC
+#   include <intrin.h>
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// how many times to pause before yielding to another thread
+#define SPIN_LIMIT 64
+
+static bool lock_held(const spinlock_t *lock)
+{
+#if CT_CC_MSVC
+    return lock->locked != 0;
+#else
+    return __atomic_load_n(&lock->locked, __ATOMIC_RELAXED) != 0;
+#endif
+}
+
+static bool lock_try(spinlock_t *lock)
+{
+#if CT_CC_MSVC
+    return _InterlockedExchange(&lock->locked, 1) == 0;
+#else
+    return __atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE) == 0;
+#endif
+}
+
+static void cpu_pause(void)
+{
+#if CT_CC_MSVC
+    YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static void thread_yield(void)
+{
+#if CT_OS_WINDOWS
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+STA_DECL
+void spinlock_acquire(spinlock_t *lock)
+{
+    CTASSERT(lock != NULL);
+
+    size_t spins = 0;
+    while (!lock_try(lock))
+    {
+        // only read while the lock is held so waiters dont
+        // keep taking the cache line away from the owner
+        while (lock_held(lock))
+        {
+            if (spins < SPIN_LIMIT)
+            {
+                spins += 1;
+                cpu_pause();
+            }
+            else
+            {
+                thread_yield();
+            }
+        }
+    }
+}
+
+STA_DECL
+void spinlock_release(spinlock_t *lock)
+{
+    CTASSERT(lock != NULL);
+
+#if CT_CC_MSVC
+    _InterlockedExchange(&lock->locked, 0);
+#else
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+#endif
+}
@@ -6,6 +6,10 @@
 #include <stdint.h>
 #include <string.h>
 
+#if CT_CC_MSVC
+#   include <intrin.h>
+#endif
+
 STA_DECL
 bool is_path_special(const char *path)
 {
@@ -25,19 +29,128 @@ ctu_hash_t ctu_ptrhash(const void *ptr)
     return key & SIZE_MAX;
 }
 
-STA_DECL
-ctu_hash_t str_hash(const char *str)
+// string hashing is wyhash, it reads 8 bytes at a time and mixes them
+// with a 64x64->128 bit multiply. long keys are hashed as three
+// independent lanes so the multiplies can overlap.
+
+static const uint64_t kHashSecret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+static void hash_mum(uint64_t *lhs, uint64_t *rhs)
 {
-    CTASSERT(str != NULL);
+#if defined(__SIZEOF_INT128__)
+    __uint128_t result = (__uint128_t)*lhs * *rhs;
+    *lhs = (uint64_t)result;
+    *rhs = (uint64_t)(result >> 64);
+#elif CT_CC_MSVC && defined(_M_X64)
+    *lhs = _umul128(*lhs, *rhs, rhs);
+#else
+    uint64_t ha = *lhs >> 32, hb = *rhs >> 32;
+    uint64_t la = (uint32_t)*lhs, lb = (uint32_t)*rhs;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    *lhs = lo;
+    *rhs = hi;
+#endif
+}
+
+static uint64_t hash_mix(uint64_t lhs, uint64_t rhs)
+{
+    hash_mum(&lhs, &rhs);
+    return lhs ^ rhs;
+}
 
-    size_t hash = 0;
+static uint64_t hash_read8(const uint8_t *ptr)
+{
+    uint64_t result;
+    memcpy(&result, ptr, sizeof(uint64_t));
+    return result;
+}
+
+static uint64_t hash_read4(const uint8_t *ptr)
+{
+    uint32_t result;
+    memcpy(&result, ptr, sizeof(uint32_t));
+    return result;
+}
+
+// read 1 to 3 bytes
+static uint64_t hash_read3(const uint8_t *ptr, size_t len)
+{
+    return (((uint64_t)ptr[0]) << 16) | (((uint64_t)ptr[len >> 1]) << 8) | ptr[len - 1];
+}
 
-    while (*str)
+static uint64_t hash_bytes(const uint8_t *ptr, size_t len, uint64_t seed)
+{
+    uint64_t a, b;
+    seed ^= hash_mix(seed ^ kHashSecret[0], kHashSecret[1]);
+
+    if (len <= 16)
     {
-        hash = (hash << 5) - hash + *str++;
+        if (len >= 4)
+        {
+            size_t offset = (len >> 3) << 2;
+            a = (hash_read4(ptr) << 32) | hash_read4(ptr + offset);
+            b = (hash_read4(ptr + len - 4) << 32) | hash_read4(ptr + len - 4 - offset);
+        }
+        else if (len > 0)
+        {
+            a = hash_read3(ptr, len);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
     }
+    else
+    {
+        size_t i = len;
+        if (i > 48)
+        {
+            uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = hash_mix(hash_read8(ptr) ^ kHashSecret[1], hash_read8(ptr + 8) ^ seed);
+                see1 = hash_mix(hash_read8(ptr + 16) ^ kHashSecret[2], hash_read8(ptr + 24) ^ see1);
+                see2 = hash_mix(hash_read8(ptr + 32) ^ kHashSecret[3], hash_read8(ptr + 40) ^ see2);
+                ptr += 48;
+                i -= 48;
+            } while (i > 48);
+
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16)
+        {
+            seed = hash_mix(hash_read8(ptr) ^ kHashSecret[1], hash_read8(ptr + 8) ^ seed);
+            i -= 16;
+            ptr += 16;
+        }
+
+        a = hash_read8(ptr + i - 16);
+        b = hash_read8(ptr + i - 8);
+    }
+
+    a ^= kHashSecret[1];
+    b ^= seed;
+    hash_mum(&a, &b);
 
-    return hash;
+    return hash_mix(a ^ kHashSecret[0] ^ len, b ^ kHashSecret[1]);
+}
+
+STA_DECL
+ctu_hash_t str_hash(const char *str)
+{
+    CTASSERT(str != NULL);
+
+    return (ctu_hash_t)hash_bytes((const uint8_t*)str, strlen(str), 0);
 }
 
 STA_DECL
@@ -45,13 +158,15 @@ ctu_hash_t text_hash(text_view_t text)
 {
     CTASSERT(text.text != NULL);
 
-    ctu_hash_t hash = 0;
-    for (size_t i = 0; i < text.length; i++)
-    {
-        hash = (hash << 5) - hash + text.text[i];
-    }
+    return (ctu_hash_t)hash_bytes((const uint8_t*)text.text, text.length, 0);
+}
+
+STA_DECL
+ctu_hash_t text_hash_seeded(text_view_t text, ctu_hash_t seed)
+{
+    CTASSERT(text.text != NULL);
 
-    return hash;
+    return (ctu_hash_t)hash_bytes((const uint8_t*)text.text, text.length, seed);
 }
 
 STA_DECL
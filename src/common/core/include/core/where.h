@@ -11,15 +11,34 @@ typedef uint_fast64_t ctu_line_t;
 /// @brief a column number
 typedef uint_fast64_t ctu_column_t;
 
+/// @brief a byte offset into a source file
+typedef uint32_t ctu_offset_t;
+
 /// @brief format specifier for @a ctu_line_t
 #define PRI_LINE PRIuFAST64
 
 /// @brief format specifier for @a ctu_column_t
 #define PRI_COLUMN PRIuFAST64
 
-/// @brief a location inside a scanner
-/// locations are inclusive and 0-based
+/// @brief format specifier for @a ctu_offset_t
+#define PRI_OFFSET PRIu32
+
+/// @brief a span of text inside a scanner
+/// spans are byte offsets into the source of the scanner.
+/// line and column information is only resolved from them when needed
+/// @see location_t
 typedef struct where_t
+{
+    /// @brief the offset of the first byte of the span
+    ctu_offset_t offset;
+
+    /// @brief the number of bytes in the span
+    ctu_offset_t length;
+} where_t;
+
+/// @brief a resolved line and column range inside a source file
+/// locations are 0-based, the last column is one past the end of the span
+typedef struct location_t
 {
     /// @brief the first line of the location
     ctu_line_t first_line;
@@ -32,4 +51,4 @@ typedef struct where_t
 
     /// @brief the last column of the location
     ctu_column_t last_column;
-} where_t;
+} location_t;
@@ -37,6 +37,19 @@ CT_FS_API void fs_delete(STA_RELEASE fs_t *fs);
 CT_NODISCARD
 CT_FS_API fs_t *fs_physical(IN_STRING const char *root, IN_NOTNULL arena_t *arena);
 
+/// @brief create a filesystem interface to a physical location on disk with buffered writes
+/// files opened for writing are wrapped in @a io_buffered, so many small writes
+/// reach the disk as a few large ones.
+/// @note the returned files must be closed for their last writes to reach the disk
+///
+/// @param root the root directory to mount this filesystem on
+/// @param buffer the size of the write buffer for each open file
+/// @param arena the arena to allocate from
+///
+/// @return a filesystem interface, or NULL if the filesystem failed to mount
+CT_NODISCARD
+CT_FS_API fs_t *fs_physical_buffered(IN_STRING const char *root, size_t buffer, IN_NOTNULL arena_t *arena);
+
 /// @brief create a virtual filesystem interface
 ///
 /// @param name the name of the vfs
@@ -121,6 +134,8 @@ typedef struct sync_result_t
 
 /// @brief synchronize 2 filesystems
 /// copies all folders and files from @p src to @p dst
+/// files in @p dst that already have the same contents are not written to,
+/// so their modification times are kept. copies to disk happen on several threads.
 ///
 /// @param dst the destination filesystem
 /// @param src the source filesystem
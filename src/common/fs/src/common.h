@@ -33,6 +33,10 @@ typedef struct inode_result_t
 typedef fs_inode_t *(*fs_query_node_t)(fs_t *fs, const fs_inode_t *node, const char *name);
 typedef io_t *(*fs_query_file_t)(fs_t *fs, fs_inode_t *node, os_access_t flags);
 
+/// @brief get the path of a file on disk
+/// @return the path, or NULL if the file is not on disk
+typedef const char *(*fs_native_path_t)(fs_t *fs, fs_inode_t *node);
+
 typedef inode_result_t (*fs_file_create_t)(fs_t *fs, fs_inode_t *node, const char *name);
 typedef os_error_t (*fs_file_delete_t)(fs_t *fs, fs_inode_t *node, const char *name);
 
@@ -54,6 +58,9 @@ typedef struct fs_callbacks_t
 
     fs_query_file_t pfn_query_file;
 
+    /// optional, only provided by filesystems backed by real files
+    fs_native_path_t pfn_native_path;
+
     fs_dir_create_t pfn_create_dir;
     fs_dir_delete_t pfn_delete_dir;
 
@@ -12,10 +12,15 @@
 #include "std/vector.h"
 #include "std/str.h"
 #include "std/map.h"
+#include "std/typed/vector.h"
 
 #include "base/util.h"
 #include "base/panic.h"
 
+#include "core/macros.h"
+
+#include <string.h>
+
 static vector_t *path_split(const char *path, arena_t *arena)
 {
     return str_split(path, "/", arena);
@@ -427,73 +432,309 @@ os_error_t fs_dir_delete(fs_t *fs, const char *path)
 
 // fs sync
 
-static os_error_t sync_file(fs_t *dst_fs, fs_t *src_fs, fs_inode_t *dst_node, fs_inode_t *src_node)
+// the most threads fs_sync copies files on
+#define SYNC_MAX_THREADS 8
+
+/// @brief a file copied to a destination on disk
+typedef struct sync_file_t
 {
-    CTASSERT(inode_is(dst_node, eOsNodeFile));
-    CTASSERT(inode_is(src_node, eOsNodeFile));
+    /// @brief the name of the file, reported if it fails to sync
+    const char *name;
 
-    os_error_t err = eOsSuccess;
-    io_t *src_io = impl_query_file(src_fs, src_node, eOsAccessRead);
-    io_t *dst_io = impl_query_file(dst_fs, dst_node, eOsAccessWrite | eOsAccessTruncate);
+    /// @brief the path of the destination on disk
+    const char *dst_path;
+
+    /// @brief the path of the source on disk, NULL if the source is not on disk
+    const char *src_path;
+
+    /// @brief the source when it is not on disk, kept open until the copy is done
+    io_t *src_io;
+    const void *data;
+    size_t size;
+
+    /// @brief the result of the copy
+    os_error_t error;
+} sync_file_t;
+
+typedef struct sync_t
+{
+    fs_t *dst;
+    fs_t *src;
+
+    /// @brief files waiting to be copied to disk
+    typevec_t *files;
+} sync_t;
+
+typedef struct sync_worker_t
+{
+    os_thread_t thread;
+
+    typevec_t *files;
+    size_t first;
+    size_t step;
+} sync_worker_t;
+
+static const char *impl_native_path(fs_t *fs, fs_inode_t *node)
+{
+    CTASSERT(inode_is(node, eOsNodeFile));
+
+    if (fs->cb->pfn_native_path == NULL)
+        return NULL;
+
+    return fs->cb->pfn_native_path(fs, node);
+}
+
+// everything below here until sync_dir only uses the os api
+// so that it is safe to run on worker threads
+
+static bool contents_match(os_file_t *file, const void *data, size_t size)
+{
+    size_t actual = 0;
+    if (os_file_size(file, &actual) != eOsSuccess || actual != size)
+        return false;
+
+    if (size == 0)
+        return true;
+
+    os_mapping_t mapping = { 0 };
+    if (os_file_map(file, eOsProtectRead, size, &mapping) != eOsSuccess)
+        return false;
+
+    bool result = memcmp(os_mapping_data(&mapping), data, size) == 0;
+    (void)os_unmap(&mapping);
+
+    return result;
+}
+
+// check if a file on disk already holds data
+static bool file_matches(const char *path, const void *data, size_t size)
+{
+    os_file_t file = { 0 };
+    if (os_file_open(path, eOsAccessRead, &file) != eOsSuccess)
+        return false;
+
+    bool result = contents_match(&file, data, size);
+    (void)os_file_close(&file);
 
-    if ((err = io_error(src_io)) != eOsSuccess)
+    return result;
+}
+
+static os_error_t write_file(const char *path, const void *data, size_t size)
+{
+    os_file_t file = { 0 };
+    os_error_t err = os_file_open(path, eOsAccessWrite | eOsAccessTruncate, &file);
+    if (err != eOsSuccess)
+        return err;
+
+    if (size > 0)
     {
-        goto cleanup;
+        size_t written = 0;
+        err = os_file_write(&file, data, size, &written);
     }
 
-    if ((err = io_error(dst_io)) != eOsSuccess)
+    os_error_t closed = os_file_close(&file);
+    return (err != eOsSuccess) ? err : closed;
+}
+
+// copy between two files on disk, letting the os move the data when it can
+static os_error_t copy_native(const char *dst, const char *src)
+{
+    os_file_t file = { 0 };
+    os_error_t err = os_file_open(src, eOsAccessRead, &file);
+    if (err != eOsSuccess)
+        return err;
+
+    bool same = false;
+    size_t size = 0;
+    err = os_file_size(&file, &size);
+
+    if (err == eOsSuccess && size == 0)
+    {
+        same = file_matches(dst, "", 0);
+    }
+    else if (err == eOsSuccess)
     {
-        goto cleanup;
+        os_mapping_t mapping = { 0 };
+        err = os_file_map(&file, eOsProtectRead, size, &mapping);
+        if (err == eOsSuccess)
+        {
+            same = file_matches(dst, os_mapping_data(&mapping), size);
+            (void)os_unmap(&mapping);
+        }
     }
 
-    size_t size = io_size(src_io);
-    if (size > 0)
+    (void)os_file_close(&file);
+
+    if (err != eOsSuccess || same)
+        return err;
+
+    return os_file_copy(dst, src);
+}
+
+static void sync_native(sync_file_t *file)
+{
+    if (file->src_path != NULL)
+    {
+        file->error = copy_native(file->dst_path, file->src_path);
+    }
+    else if (!file_matches(file->dst_path, file->data, file->size))
+    {
+        file->error = write_file(file->dst_path, file->data, file->size);
+    }
+}
+
+static os_exitcode_t sync_worker(void *arg)
+{
+    sync_worker_t *worker = arg;
+
+    size_t len = typevec_len(worker->files);
+    for (size_t i = worker->first; i < len; i += worker->step)
+    {
+        sync_native(typevec_offset(worker->files, i));
+    }
+
+    return 0;
+}
+
+static void sync_native_files(typevec_t *files)
+{
+    size_t len = typevec_len(files);
+    size_t count = CT_MIN(len, SYNC_MAX_THREADS);
+
+    sync_worker_t workers[SYNC_MAX_THREADS];
+    bool started[SYNC_MAX_THREADS];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        sync_worker_t worker = {
+            .files = files,
+            .first = i,
+            .step = count,
+        };
+
+        workers[i] = worker;
+
+        // the first share is copied on this thread
+        started[i] = (i > 0) && os_thread_init(&workers[i].thread, "fs_sync", sync_worker, &workers[i]) == eOsSuccess;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!started[i])
+        {
+            sync_worker(&workers[i]);
+            continue;
+        }
+
+        os_status_t status = 0;
+        os_error_t err = os_thread_join(&workers[i].thread, &status);
+        CTASSERTF(err == eOsSuccess, "failed to join fs_sync worker %zu", i);
+    }
+}
+
+// copies into a filesystem that isnt on disk happen on this thread
+static os_error_t sync_file(fs_t *dst_fs, fs_inode_t *dst_node, const void *data, size_t size)
+{
+    io_t *dst_io = impl_query_file(dst_fs, dst_node, eOsAccessRead);
+    bool same = (io_error(dst_io) == eOsSuccess) && (io_size(dst_io) == size)
+        && (size == 0 || memcmp(io_map(dst_io, eOsProtectRead), data, size) == 0);
+
+    io_close(dst_io);
+
+    if (same)
+        return eOsSuccess;
+
+    dst_io = impl_query_file(dst_fs, dst_node, eOsAccessWrite | eOsAccessTruncate);
+
+    os_error_t err = io_error(dst_io);
+    if (err == eOsSuccess && size > 0)
     {
-        const void *data = io_map(src_io, eOsProtectRead);
-        CTASSERTF(data != NULL, "failed to map file during sync (path = %s)", io_name(src_io));
         io_write(dst_io, data, size);
+        err = io_error(dst_io);
     }
 
-cleanup:
     // TODO: do we care about the error from closing the io?
     io_close(dst_io);
+    return err;
+}
+
+static os_error_t sync_add_file(sync_t *sync, fs_inode_t *dst_node, fs_inode_t *src_node)
+{
+    CTASSERT(inode_is(dst_node, eOsNodeFile));
+    CTASSERT(inode_is(src_node, eOsNodeFile));
+
+    sync_file_t file = {
+        .name = src_node->name,
+        .dst_path = impl_native_path(sync->dst, dst_node),
+    };
+
+    // both files are on disk, the os can copy between them directly
+    if (file.dst_path != NULL)
+    {
+        file.src_path = impl_native_path(sync->src, src_node);
+        if (file.src_path != NULL)
+        {
+            typevec_push(sync->files, &file);
+            return eOsSuccess;
+        }
+    }
+
+    io_t *src_io = impl_query_file(sync->src, src_node, eOsAccessRead);
+    os_error_t err = io_error(src_io);
+    if (err != eOsSuccess)
+    {
+        io_close(src_io);
+        return err;
+    }
+
+    size_t size = io_size(src_io);
+    const void *data = (size > 0) ? io_map(src_io, eOsProtectRead) : "";
+    CTASSERTF(data != NULL, "failed to map file during sync (path = %s)", io_name(src_io));
+
+    if (file.dst_path != NULL)
+    {
+        file.src_io = src_io;
+        file.data = data;
+        file.size = size;
+        typevec_push(sync->files, &file);
+        return eOsSuccess;
+    }
+
+    err = sync_file(sync->dst, dst_node, data, size);
     io_close(src_io);
     return err;
 }
 
-static sync_result_t sync_dir(fs_t *dst, fs_t *src, fs_inode_t *dst_node, fs_inode_t *src_node)
+static sync_result_t sync_dir(sync_t *sync, fs_inode_t *dst_node, fs_inode_t *src_node)
 {
     fs_iter_t *iter;
     os_error_t err = eOsSuccess;
 
-    err = fs_iter_begin(src, src_node, &iter);
+    err = fs_iter_begin(sync->src, src_node, &iter);
     if (err != eOsSuccess)
     {
         sync_result_t result = { .path = NULL };
         return result;
     }
 
+    sync_result_t result = { .path = NULL };
+
     fs_inode_t *child;
-    while (fs_iter_next(iter, &child) == eOsSuccess)
+    while (result.path == NULL && fs_iter_next(iter, &child) == eOsSuccess)
     {
-        fs_inode_t *other = get_inode_for(dst, dst_node, child->name, child->type);
+        fs_inode_t *other = get_inode_for(sync->dst, dst_node, child->name, child->type);
         if (other == NULL)
         {
-            sync_result_t result = { .path = child->name };
-            return result;
+            result.path = child->name;
         }
-
-        if (child->type == eOsNodeDir)
+        else if (child->type == eOsNodeDir)
         {
-            sync_dir(dst, src, other, child);
+            result = sync_dir(sync, other, child);
         }
         else if (child->type == eOsNodeFile)
         {
-            if (sync_file(dst, src, other, child) != eOsSuccess)
-            {
-                sync_result_t result = { .path = child->name };
-                return result;
-            }
+            if (sync_add_file(sync, other, child) != eOsSuccess)
+                result.path = child->name;
         }
         else
         {
@@ -503,7 +744,6 @@ static sync_result_t sync_dir(fs_t *dst, fs_t *src, fs_inode_t *dst_node, fs_ino
 
     fs_iter_end(iter);
 
-    sync_result_t result = { .path = NULL };
     return result;
 }
 
@@ -513,7 +753,30 @@ sync_result_t fs_sync(fs_t *dst, fs_t *src)
     CTASSERT(dst != NULL);
     CTASSERT(src != NULL);
 
-    return sync_dir(dst, src, dst->root, src->root);
+    typevec_t files = typevec_make(sizeof(sync_file_t), 64, dst->arena);
+    sync_t sync = {
+        .dst = dst,
+        .src = src,
+        .files = &files,
+    };
+
+    // walking the filesystems allocates, so only the copies to disk are parallel
+    sync_result_t result = sync_dir(&sync, dst->root, src->root);
+
+    sync_native_files(sync.files);
+
+    size_t len = typevec_len(sync.files);
+    for (size_t i = 0; i < len; i++)
+    {
+        sync_file_t *file = typevec_offset(sync.files, i);
+        if (file->src_io != NULL)
+            io_close(file->src_io);
+
+        if (file->error != eOsSuccess && result.path == NULL)
+            result.path = file->name;
+    }
+
+    return result;
 }
 
 STA_DECL
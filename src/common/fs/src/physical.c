@@ -16,6 +16,7 @@
 typedef struct physical_t
 {
     const char *root; ///< absolute path to root directory
+    size_t buffer; ///< size of the write buffer for opened files, 0 if unbuffered
 } physical_t;
 
 typedef struct physical_inode_t
@@ -48,6 +49,21 @@ static const char *get_absolute(fs_t *fs, const fs_inode_t *node, const char *pa
     return str_format(fs->arena, "%s" CT_NATIVE_PATH_SEPARATOR "%s" CT_NATIVE_PATH_SEPARATOR "%s", self->root, dir->path, path);
 }
 
+static const char *get_node_absolute(fs_t *fs, const fs_inode_t *node)
+{
+    CTASSERT(fs != NULL);
+
+    const physical_t *self = fs_data(fs);
+    const physical_inode_t *dir = inode_data((fs_inode_t*)node);
+
+    if (is_path_special(dir->path))
+    {
+        return self->root;
+    }
+
+    return str_format(fs->arena, "%s" CT_NATIVE_PATH_SEPARATOR "%s", self->root, dir->path);
+}
+
 static const char *get_relative(const fs_inode_t *node, const char *path, arena_t *arena)
 {
     const physical_inode_t *dir = inode_data((fs_inode_t*)node);
@@ -124,8 +140,20 @@ static fs_inode_t *pfs_query_node(fs_t *fs, const fs_inode_t *self, const char *
 
 static io_t *pfs_query_file(fs_t *fs, fs_inode_t *self, os_access_t flags)
 {
-    const char *absolute = get_absolute(fs, self, NULL);
-    return io_file(absolute, flags, fs->arena);
+    const physical_t *pfs = fs_data(fs);
+    const char *absolute = get_node_absolute(fs, self);
+    io_t *io = io_file(absolute, flags, fs->arena);
+
+    // leave failed files unwrapped so the caller can see the error
+    if (pfs->buffer == 0 || !(flags & eOsAccessWrite) || io_error(io) != eOsSuccess)
+        return io;
+
+    return io_buffered(io, pfs->buffer, fs->arena);
+}
+
+static const char *pfs_native_path(fs_t *fs, fs_inode_t *self)
+{
+    return get_node_absolute(fs, self);
 }
 
 static inode_result_t pfs_file_create(fs_t *fs, fs_inode_t *self, const char *name)
@@ -172,7 +200,7 @@ static os_error_t pfs_file_delete(fs_t *fs, fs_inode_t *self, const char *name)
 
 static os_error_t pfs_iter_begin(fs_t *fs, const fs_inode_t *dir, fs_iter_t *iter)
 {
-    const char *absolute = get_absolute(fs, dir, NULL);
+    const char *absolute = get_node_absolute(fs, dir);
     os_iter_t *data = iter_data(iter);
     return os_iter_begin(absolute, data);
 }
@@ -196,6 +224,7 @@ static os_error_t pfs_iter_end(fs_iter_t *iter)
 static const fs_callbacks_t kPhysicalInterface = {
     .pfn_query_node = pfs_query_node,
     .pfn_query_file = pfs_query_file,
+    .pfn_native_path = pfs_native_path,
 
     .pfn_create_dir = pfs_dir_create,
     .pfn_delete_dir = pfs_dir_delete,
@@ -211,8 +240,7 @@ static const fs_callbacks_t kPhysicalInterface = {
     .inode_size = sizeof(physical_inode_t),
 };
 
-STA_DECL
-fs_t *fs_physical(const char *root, arena_t *arena)
+static fs_t *physical_new(const char *root, size_t buffer, arena_t *arena)
 {
     CTASSERT(root != NULL);
 
@@ -227,7 +255,8 @@ fs_t *fs_physical(const char *root, arena_t *arena)
     }
 
     physical_t self = {
-        .root = root
+        .root = root,
+        .buffer = buffer
     };
 
     physical_inode_t inode = {
@@ -236,3 +265,17 @@ fs_t *fs_physical(const char *root, arena_t *arena)
 
     return fs_new(&inode, &kPhysicalInterface, &self, sizeof(physical_t), arena);
 }
+
+STA_DECL
+fs_t *fs_physical(const char *root, arena_t *arena)
+{
+    return physical_new(root, 0, arena);
+}
+
+STA_DECL
+fs_t *fs_physical_buffered(const char *root, size_t buffer, arena_t *arena)
+{
+    CTASSERT(buffer > 0);
+
+    return physical_new(root, buffer, arena);
+}
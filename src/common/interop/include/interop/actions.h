@@ -5,6 +5,8 @@
 
 #include "core/analyze.h"
 
+#include <stddef.h>
+
 CT_BEGIN_API
 
 typedef struct where_t where_t;
@@ -18,8 +20,8 @@ typedef struct scan_t scan_t;
 /// @see https://ftp.gnu.org/old-gnu/Manuals/flex-2.5.4/html_node/flex_14.html
 ///
 /// @param where a pointer to the current location
-/// @param text current source text
-CT_INTEROP_API void flex_action(INOUT_NOTNULL where_t *where, IN_STRING const char *text);
+/// @param length the length of the current token
+CT_INTEROP_API void flex_action(INOUT_NOTNULL where_t *where, size_t length);
 
 /// @brief retrevies more input for flex
 ///
@@ -24,11 +24,12 @@ CT_BEGIN_API
 /// @note this should be created via the @a CT_CALLBACKS macro
 typedef struct scan_callbacks_t
 {
-    int (*init)(scan_t *extra, void *scanner);                   ///< yylex_init_extra
-    int (*parse)(void *scanner, scan_t *extra);                  ///< yyparse
-    void *(*scan)(const char *text, size_t size, void *scanner); ///< yy_scan_bytes
-    void (*destroy_buffer)(void *buffer, void *scanner);         ///< yy_delete_buffer
-    void (*destroy)(void *scanner);                              ///< yylex_destroy
+    int (*init)(scan_t *extra, void *scanner);                      ///< yylex_init_extra
+    int (*parse)(void *scanner, scan_t *extra);                     ///< yyparse
+    void *(*scan)(const char *text, size_t size, void *scanner);    ///< yy_scan_bytes
+    void *(*scan_in_place)(char *base, size_t size, void *scanner); ///< yy_scan_buffer, optional
+    void (*destroy_buffer)(void *buffer, void *scanner);            ///< yy_delete_buffer
+    void (*destroy)(void *scanner);                                 ///< yylex_destroy
 } scan_callbacks_t;
 
 /// @def CT_CALLBACKS(id, prefix)
@@ -54,6 +55,10 @@ typedef struct scan_callbacks_t
                   scan_path((scan_t *)scanner));                                                \
         return prefix##_scan_bytes(text, (int)size, scanner);                                   \
     }                                                                                           \
+    static void *prefix##_##id##_scan_in_place(char *base, size_t size, void *scanner)          \
+    {                                                                                           \
+        return prefix##_scan_buffer(base, size, scanner);                                       \
+    }                                                                                           \
     static void prefix##_##id##_destroy_buffer(void *buffer, void *scanner)                     \
     {                                                                                           \
         prefix##_delete_buffer((YY_BUFFER_STATE)buffer, scanner);                               \
@@ -66,6 +71,7 @@ typedef struct scan_callbacks_t
         .init = prefix##_##id##_##init,                                                         \
         .parse = prefix##_##id##_parse,                                                         \
         .scan = prefix##_##id##_scan,                                                           \
+        .scan_in_place = prefix##_##id##_scan_in_place,                                         \
         .destroy_buffer = prefix##_##id##_destroy_buffer,                                       \
         .destroy = prefix##_##id##_destroy,                                                     \
     }
@@ -10,7 +10,7 @@
 
 /// track source locations inside flex and bison
 #ifndef YY_USER_ACTION
-#   define YY_USER_ACTION flex_action(yylloc, yytext);
+#   define YY_USER_ACTION flex_action(yylloc, yyleng);
 #endif
 
 /// read input for flex and bison
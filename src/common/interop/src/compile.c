@@ -2,6 +2,13 @@
 
 #include "interop/compile.h"
 
+#include "core/macros.h"
+#include "io/io.h"
+#include "os/os.h"
+
+// flex scans a buffer in place when it ends with two nul bytes
+#define SCAN_PADDING 2
+
 static parse_result_t parse_error(parse_error_t result, int error)
 {
     parse_result_t res = {
@@ -22,6 +29,35 @@ static parse_result_t parse_value(void *tree)
     return res;
 }
 
+// flex writes into the text it scans, so scanning the source mapping
+// directly needs a private copy on write mapping with room for the
+// terminators. anything that cannot provide one is copied instead.
+static void *scan_begin(scan_t *scan, const scan_callbacks_t *callbacks, void *scanner, os_mapping_t *mapping)
+{
+    text_view_t text = scan_source(scan);
+
+    if (callbacks->scan_in_place != NULL && !scan_is_builtin(scan))
+    {
+        if (io_map_private(scan->io, SCAN_PADDING, mapping))
+        {
+            return callbacks->scan_in_place(os_mapping_data(mapping), text.length + SCAN_PADDING, scanner);
+        }
+    }
+
+    return callbacks->scan(text.text, text.length, scanner);
+}
+
+static void scan_end(scan_t *scan, os_mapping_t *mapping)
+{
+    CT_UNUSED(scan);
+
+    if (!os_mapping_active(mapping))
+        return;
+
+    os_error_t err = os_unmap(mapping);
+    CTASSERTF(err == eOsSuccess, "failed to unmap %s (%s)", scan_path(scan), os_error_string(err, scan_get_arena(scan)));
+}
+
 STA_DECL
 parse_result_t scan_buffer(scan_t *scan, const scan_callbacks_t *callbacks)
 {
@@ -38,21 +74,24 @@ parse_result_t scan_buffer(scan_t *scan, const scan_callbacks_t *callbacks)
         return parse_error(eParseInitError, err);
     }
 
-    text_view_t text = scan_source(scan);
-    state = callbacks->scan(text.text, text.length, scanner);
+    os_mapping_t mapping = { 0 };
+    state = scan_begin(scan, callbacks, scanner, &mapping);
     if (state == NULL)
     {
+        scan_end(scan, &mapping);
         return parse_error(eParseScanError, err);
     }
 
     err = callbacks->parse(scanner, scan);
     if (err != 0)
     {
+        scan_end(scan, &mapping);
         return parse_error(eParseReject, err);
     }
 
     callbacks->destroy_buffer(state, scanner);
     callbacks->destroy(scanner);
+    scan_end(scan, &mapping);
 
     void *tree = scan_get(scan);
     return parse_value(tree);
@@ -10,29 +10,13 @@
 #include <limits.h>
 
 STA_DECL
-void flex_action(where_t *where, const char *text)
+void flex_action(where_t *where, size_t length)
 {
     CTASSERT(where != NULL);
-    CTASSERT(text != NULL);
 
-    where_t tmp = *where;
-    tmp.first_line = tmp.last_line;
-    tmp.first_column = tmp.last_column;
-
-    for (int i = 0; text[i]; i++)
-    {
-        if (text[i] == '\n')
-        {
-            tmp.last_line += 1;
-            tmp.last_column = 0;
-        }
-        else
-        {
-            tmp.last_column += 1;
-        }
-    }
-
-    *where = tmp;
+    // the next token starts where the last one ended
+    where->offset += where->length;
+    where->length = (ctu_offset_t)length;
 }
 
 STA_DECL
@@ -65,19 +49,14 @@ void flex_update(where_t *where, const where_t *offsets, int steps)
         where_t rhs1 = offsets[1];
         where_t rhsn = offsets[steps];
 
-        where_t tmp = {
-            .first_line = rhs1.first_line,
-            .first_column = rhs1.first_column,
-            .last_line = rhsn.last_line,
-            .last_column = rhsn.last_column,
-        };
-
-        *where = tmp;
+        where->offset = rhs1.offset;
+        where->length = (rhsn.offset + rhsn.length) - rhs1.offset;
     }
     else
     {
+        // empty rules are an empty span at the end of the previous symbol
         where_t rhs = offsets[0];
-        where->last_line = rhs.last_line;
-        where->last_column = rhs.last_column;
+        where->offset = rhs.offset + rhs.length;
+        where->length = 0;
     }
 }
@@ -75,6 +75,24 @@ typedef size_t (*io_seek_t)(io_t *self, size_t offset);
 /// @return the backing memory
 typedef void *(*io_map_t)(io_t *self, os_protect_t protect);
 
+/// @brief io private map callback
+/// map an io objects backing data into private memory followed by zeroed padding
+///
+/// @param self the io object
+/// @param padding the number of zero bytes required after the data
+/// @param mapping the mapping to fill
+///
+/// @return an error code if the data could not be mapped
+typedef os_error_t (*io_map_private_t)(io_t *self, size_t padding, os_mapping_t *mapping);
+
+/// @brief io flush callback
+/// write any data held by the io object to its backing storage
+///
+/// @param self the io object
+///
+/// @return an error code if the data could not be written
+typedef os_error_t (*io_flush_t)(io_t *self);
+
 /// @brief io close callback
 /// destroy an io objects backing data and any associated resources
 ///
@@ -109,6 +127,14 @@ typedef struct io_callbacks_t
     /// must always be provided
     io_map_t fn_map;
 
+    /// @brief private map callback
+    /// optional if the backing data cannot be mapped privately
+    io_map_private_t fn_map_private;
+
+    /// @brief flush callback
+    /// optional if writes are never held back
+    io_flush_t fn_flush;
+
     /// @brief close callback
     /// optional if backing data does not require lifetime management
     io_close_t fn_close;
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+#pragma once
+
+// for sizeof(io_t)
+#include "io/impl.h" // IWYU pragma: export
+
+CT_BEGIN_API
+
+/// @ingroup io_impl
+/// @{
+
+/// @brief a write buffer in front of another io object
+/// @warning this is an internal structure and should not be used directly
+typedef struct io_buffered_impl_t
+{
+    /// @brief the io object writes are flushed to
+    io_t *inner;
+
+    /// @brief pending writes
+    char *data;
+
+    /// @brief the number of pending bytes
+    size_t used;
+
+    /// @brief total size of data
+    size_t capacity;
+} io_buffered_impl_t;
+
+#define IO_BUFFERED_SIZE (sizeof(io_buffered_impl_t) + sizeof(io_t))
+
+/// @}
+
+CT_END_API
@@ -12,10 +12,12 @@
 // for the size macros
 #if STA_PRESENT
 #   include "io/impl/buffer.h"
+#   include "io/impl/buffered.h"
 #   include "io/impl/file.h"
 #   include "io/impl/view.h"
 #endif
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdarg.h>
 
@@ -25,6 +27,7 @@ CT_BEGIN_API
 /// @{
 
 typedef struct io_t io_t;
+typedef struct strbuf_t strbuf_t;
 
 /// @brief destroy an IO object and free its memory
 ///
@@ -78,6 +81,22 @@ CT_IO_API io_t *io_memory(IN_STRING const char *name, const void *data, size_t s
 CT_NODISCARD CT_ALLOC(io_free)
 CT_IO_API io_t *io_blob(IN_STRING const char *name, size_t size, os_access_t flags, IN_NOTNULL arena_t *arena);
 
+/// @brief create a buffered writer in front of another IO object
+/// small writes are collected in a buffer of @p capacity bytes and written to
+/// @p inner in one go when the buffer fills, when @a io_flush is called, or
+/// when the buffered object is closed. writes larger than the buffer go straight
+/// to @p inner. reading, seeking, sizing, and mapping flush the buffer first.
+/// @note closing the buffered object also closes @p inner
+/// @pre @p inner must have been created with the @a eOsAccessWrite flag
+///
+/// @param inner the io object to write to
+/// @param capacity the size of the buffer
+/// @param arena the arena to allocate from
+///
+/// @return the io object
+CT_NODISCARD CT_ALLOC(io_free)
+CT_IO_API io_t *io_buffered(IN_NOTNULL io_t *inner, size_t capacity, IN_NOTNULL arena_t *arena);
+
 /// @brief create a readonly IO object for a given view of memory
 /// @pre @p data must point to a valid memory region of @p size bytes
 ///
@@ -219,6 +238,7 @@ STA_PRINTF(2, 3)
 CT_IO_API size_t io_printf(IN_NOTNULL io_t *io, STA_FORMAT_STRING const char *fmt, ...);
 
 /// @brief vprintf to an io object
+/// the output is formatted in small chunks and written as it is produced
 /// @pre the io object must have been created with the @a eOsAccessWrite flag
 ///
 /// @param io the io object
@@ -228,6 +248,23 @@ CT_IO_API size_t io_printf(IN_NOTNULL io_t *io, STA_FORMAT_STRING const char *fm
 /// @return the number of bytes actually written
 CT_IO_API size_t io_vprintf(IN_NOTNULL io_t *io, IN_STRING const char *fmt, va_list args);
 
+/// @brief write any data held back by an io object
+/// objects that do not hold back writes do nothing
+///
+/// @param io the io object
+///
+/// @return an error code if the data could not be written
+CT_IO_API os_error_t io_flush(IN_NOTNULL io_t *io);
+
+/// @brief write the contents of a string builder to an io object
+/// @pre the io object must have been created with the @a eOsAccessWrite flag
+///
+/// @param io the io object
+/// @param buf the string builder to write
+///
+/// @return the number of bytes actually written
+CT_IO_API size_t io_write_strbuf(IN_NOTNULL io_t *io, IN_NOTNULL const strbuf_t *buf);
+
 /// @brief get the name of an io object
 ///
 /// @param io the io object
@@ -267,6 +304,19 @@ CT_IO_API size_t io_seek(IN_NOTNULL io_t *io, size_t offset);
 CT_NODISCARD
 CT_IO_API void *io_map(IN_NOTNULL io_t *io, os_protect_t protect);
 
+/// @brief map an io object into private memory followed by zeroed padding
+/// the memory is readable and writable, but writes never reach the io object.
+/// useful for scanners that write terminators into their input.
+/// @note release the mapping with @a os_unmap
+///
+/// @param io the io object to map from
+/// @param padding the number of zero bytes required after the contents
+/// @param mapping the mapping to fill
+///
+/// @return true if the contents were mapped, false if they cannot be mapped privately
+CT_NODISCARD
+CT_IO_API bool io_map_private(IN_NOTNULL io_t *io, size_t padding, OUT_NOTNULL os_mapping_t *mapping);
+
 /// @brief get the last error from the io object
 ///
 /// @param io the io object
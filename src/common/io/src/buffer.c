@@ -30,8 +30,10 @@ static size_t mem_write(io_t *self, const void *src, size_t size)
     mem->used = CT_MAX(mem->used, mem->offset + size);
     if (mem->offset + size > mem->total)
     {
-        mem->data = arena_realloc(mem->data, mem->offset + size, mem->total, self->arena);
-        mem->total = mem->offset + size;
+        // grow geometrically so many small writes dont each reallocate
+        size_t total = CT_MAX(mem->total * 2, mem->offset + size);
+        mem->data = arena_realloc(mem->data, total, mem->total, self->arena);
+        mem->total = total;
     }
 
     ctu_memcpy(mem->data + mem->offset, src, size);
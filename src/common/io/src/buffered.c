@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "io/impl.h"
+#include "io/impl/buffered.h"
+#include "os/os.h"
+
+#include "arena/arena.h"
+
+#include "base/util.h"
+#include "base/panic.h"
+
+static io_buffered_impl_t *buffered_data(io_t *self)
+{
+    return io_data(self);
+}
+
+// an inner write that stops short without an error of its own is out of space
+static os_error_t write_error(io_t *inner, size_t written, size_t size)
+{
+    os_error_t err = io_error(inner);
+    if (err == eOsSuccess && written != size)
+        return eOsTooSmall;
+
+    return err;
+}
+
+// write the pending data to the inner object without flushing it
+static os_error_t buffered_drain(io_t *self)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+    if (impl->used == 0)
+        return eOsSuccess;
+
+    size_t written = io_write(impl->inner, impl->data, impl->used);
+    self->error = write_error(impl->inner, written, impl->used);
+
+    if (self->error == eOsSuccess)
+    {
+        impl->used = 0;
+    }
+    else if (written < impl->used)
+    {
+        // keep whatever the inner object did not accept
+        impl->used -= written;
+        ctu_memmove(impl->data, impl->data + written, impl->used);
+    }
+
+    return self->error;
+}
+
+static size_t buffered_read(io_t *self, void *dst, size_t size)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+    if (buffered_drain(self) != eOsSuccess) return SIZE_MAX;
+
+    return io_read(impl->inner, dst, size);
+}
+
+static size_t buffered_write(io_t *self, const void *src, size_t size)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+
+    if (impl->used + size > impl->capacity)
+    {
+        if (buffered_drain(self) != eOsSuccess) return SIZE_MAX;
+
+        // anything that would fill the buffer on its own skips it
+        if (size >= impl->capacity)
+        {
+            size_t written = io_write(impl->inner, src, size);
+            self->error = write_error(impl->inner, written, size);
+            return written;
+        }
+    }
+
+    ctu_memcpy(impl->data + impl->used, src, size);
+    impl->used += size;
+
+    return size;
+}
+
+static size_t buffered_size(io_t *self)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+    if (buffered_drain(self) != eOsSuccess) return SIZE_MAX;
+
+    return io_size(impl->inner);
+}
+
+static size_t buffered_seek(io_t *self, size_t offset)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+    if (buffered_drain(self) != eOsSuccess) return SIZE_MAX;
+
+    return io_seek(impl->inner, offset);
+}
+
+static void *buffered_map(io_t *self, os_protect_t protect)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+    if (buffered_drain(self) != eOsSuccess) return NULL;
+
+    return io_map(impl->inner, protect);
+}
+
+static os_error_t buffered_flush(io_t *self)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+
+    os_error_t err = buffered_drain(self);
+    if (err != eOsSuccess)
+        return err;
+
+    return io_flush(impl->inner);
+}
+
+static os_error_t buffered_close(io_t *self)
+{
+    io_buffered_impl_t *impl = buffered_data(self);
+
+    os_error_t err = buffered_drain(self);
+
+    arena_free(impl->data, impl->capacity, self->arena);
+    impl->data = NULL;
+    impl->capacity = 0;
+
+    os_error_t closed = io_close(impl->inner);
+
+    return (err != eOsSuccess) ? err : closed;
+}
+
+static const io_callbacks_t kBufferedCallbacks = {
+    .fn_read = buffered_read,
+    .fn_write = buffered_write,
+
+    .fn_get_size = buffered_size,
+    .fn_seek = buffered_seek,
+
+    .fn_map = buffered_map,
+    .fn_flush = buffered_flush,
+    .fn_close = buffered_close,
+
+    .size = sizeof(io_buffered_impl_t),
+};
+
+///
+/// public allocating api
+///
+
+STA_DECL
+io_t *io_buffered(io_t *inner, size_t capacity, arena_t *arena)
+{
+    CTASSERT(inner != NULL);
+    CTASSERT(capacity > 0);
+    CTASSERTF(inner->flags & eOsAccessWrite, "cannot io_buffered(%s). flags did not include eOsAccessWrite", io_name(inner));
+
+    io_buffered_impl_t impl = {
+        .inner = inner,
+        .data = ARENA_MALLOC(capacity, "io_buffered", inner, arena),
+        .used = 0,
+        .capacity = capacity
+    };
+
+    return io_new(&kBufferedCallbacks, inner->flags, io_name(inner), &impl, arena);
+}
@@ -5,6 +5,8 @@
 
 #include "core/macros.h"
 
+#include "os/os.h"
+
 #include <stdio.h>
 
 static size_t cout_write(io_t *self, const void *src, size_t size)
@@ -19,6 +21,13 @@ static size_t cout_fwrite(io_t *self, const char *fmt, va_list args)
     return vfprintf(stdout, fmt, args);
 }
 
+static os_error_t cout_flush(io_t *self)
+{
+    CT_UNUSED(self);
+    (void)fflush(stdout);
+    return eOsSuccess;
+}
+
 static size_t cerr_write(io_t *self, const void *src, size_t size)
 {
     CT_UNUSED(self);
@@ -31,16 +40,25 @@ static size_t cerr_fwrite(io_t *self, const char *fmt, va_list args)
     return vfprintf(stderr, fmt, args);
 }
 
+static os_error_t cerr_flush(io_t *self)
+{
+    CT_UNUSED(self);
+    (void)fflush(stderr);
+    return eOsSuccess;
+}
+
 // TODO: find a way to simplify this down to a single io_t
 
 static const io_callbacks_t kConsoleOutCallbacks = {
     .fn_write = cout_write,
     .fn_fwrite = cout_fwrite,
+    .fn_flush = cout_flush,
 };
 
 static const io_callbacks_t kConsoleErrorCallbacks = {
     .fn_write = cerr_write,
     .fn_fwrite = cerr_fwrite,
+    .fn_flush = cerr_flush,
 };
 
 static io_t gConsoleOutIo = {
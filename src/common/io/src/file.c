@@ -72,6 +72,13 @@ static void *fd_map(io_t *self, os_protect_t protect)
     return os_mapping_data(&file->mapping);
 }
 
+static os_error_t fd_map_private(io_t *self, size_t padding, os_mapping_t *mapping)
+{
+    io_file_impl_t *file = fd_data(self);
+
+    return os_file_map_private(&file->file, padding, mapping);
+}
+
 static os_error_t fd_close(io_t *self)
 {
     io_file_impl_t *file = fd_data(self);
@@ -95,6 +102,7 @@ static const io_callbacks_t kFileCallbacks = {
     .fn_seek = fd_seek,
 
     .fn_map = fd_map,
+    .fn_map_private = fd_map_private,
     .fn_close = fd_close,
 
     .size = sizeof(io_file_impl_t),
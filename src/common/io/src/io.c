@@ -6,6 +6,7 @@
 #include "os/os.h"
 #include "base/panic.h"
 #include "std/str.h"
+#include "std/strbuf.h"
 #include "arena/arena.h"
 
 static os_error_t impl_close(io_t *io)
@@ -75,6 +76,19 @@ size_t io_printf(io_t *io, const char *fmt, ...)
     return size;
 }
 
+typedef struct io_stream_t
+{
+    io_t *io;
+    size_t written;
+} io_stream_t;
+
+// write each formatted chunk as it is produced
+static void io_stream_write(void *user, const char *text, size_t len)
+{
+    io_stream_t *stream = user;
+    stream->written += io_write(stream->io, text, len);
+}
+
 STA_DECL
 size_t io_vprintf(io_t *io, const char *fmt, va_list args)
 {
@@ -86,8 +100,31 @@ size_t io_vprintf(io_t *io, const char *fmt, va_list args)
         return cb->fn_fwrite(io, fmt, args);
     }
 
-    text_t text = text_vformat(io->arena, fmt, args);
-    return io_write(io, text.text, text.length);
+    io_stream_t stream = { .io = io, .written = 0 };
+    (void)str_vstream(io_stream_write, &stream, io->arena, fmt, args);
+
+    return stream.written;
+}
+
+STA_DECL
+os_error_t io_flush(io_t *io)
+{
+    CTASSERT(io != NULL);
+
+    if (io->cb->fn_flush == NULL)
+        return eOsSuccess;
+
+    return io->cb->fn_flush(io);
+}
+
+STA_DECL
+size_t io_write_strbuf(io_t *io, const strbuf_t *buf)
+{
+    text_view_t view = strbuf_view(buf);
+    if (view.length == 0)
+        return 0;
+
+    return io_write(io, view.text, view.length);
 }
 
 STA_DECL
@@ -140,6 +177,19 @@ void *io_map(io_t *io, os_protect_t protect)
     return io->cb->fn_map(io, protect);
 }
 
+STA_DECL
+bool io_map_private(io_t *io, size_t padding, os_mapping_t *mapping)
+{
+    CTASSERT(io != NULL);
+    CTASSERT(mapping != NULL);
+    CTASSERTF(io->flags & eOsAccessRead, "io_map_private(%s) flags not readable", io_name(io));
+
+    if (io->cb->fn_map_private == NULL)
+        return false;
+
+    return io->cb->fn_map_private(io, padding, mapping) == eOsSuccess;
+}
+
 STA_DECL
 os_error_t io_error(const io_t *io)
 {
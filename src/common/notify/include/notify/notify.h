@@ -18,6 +18,7 @@ CT_BEGIN_API
 
 typedef struct node_t node_t;
 typedef struct typevec_t typevec_t;
+typedef struct segvec_t segvec_t;
 typedef struct vector_t vector_t;
 typedef struct arena_t arena_t;
 typedef struct set_t set_t;
@@ -93,12 +94,14 @@ RET_NOTNULL CT_NODISCARD
 CT_NOTIFY_API logger_t *logger_new(IN_NOTNULL arena_t *arena);
 
 /// @brief get the events from the logger
+/// events never move once they are reported, so pointers to them stay
+/// valid until @a logger_reset
 ///
 /// @param logs the logger
 ///
 /// @return the events
 RET_NOTNULL CT_NODISCARD
-CT_NOTIFY_API typevec_t *logger_get_events(IN_NOTNULL const logger_t *logs);
+CT_NOTIFY_API segvec_t *logger_get_events(IN_NOTNULL const logger_t *logs);
 
 /// @brief check if the logger has any fatal errors
 ///
@@ -115,6 +118,14 @@ CT_NOTIFY_API bool logger_has_errors(IN_NOTNULL const logger_t *logs, notify_rul
 /// @param logs the logger
 CT_NOTIFY_API void logger_reset(IN_NOTNULL logger_t *logs);
 
+/// @brief append all events from one logger to another
+/// events are copied in the order they were reported, their messages
+/// and segments are still owned by the arena of @p src.
+///
+/// @param dst the logger to append to
+/// @param src the logger to copy events from
+CT_NOTIFY_API void logger_append(IN_NOTNULL logger_t *dst, IN_NOTNULL const logger_t *src);
+
 RET_NOTNULL CT_NODISCARD
 CT_NOTIFY_API arena_t *logger_get_arena(IN_NOTNULL const logger_t *logs);
 
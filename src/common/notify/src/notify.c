@@ -7,6 +7,7 @@
 
 #include "std/set.h"
 #include "std/str.h"
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 #include "std/vector.h"
 
@@ -14,7 +15,8 @@ typedef struct logger_t
 {
     arena_t *arena;
 
-    typevec_t *messages;
+    /// @note segvec_t<event_t>, event builders point into this
+    segvec_t *messages;
 } logger_t;
 
 STA_DECL
@@ -25,7 +27,7 @@ logger_t *logger_new(arena_t *arena)
     logger_t *logs = ARENA_MALLOC(sizeof(logger_t), "logger", NULL, arena);
 
     logs->arena = arena;
-    logs->messages = typevec_new(sizeof(event_t), 8, arena);
+    logs->messages = segvec_new(sizeof(event_t), 8, arena);
 
     ARENA_IDENTIFY(logs->messages, "messages", logs, arena);
 
@@ -33,7 +35,7 @@ logger_t *logger_new(arena_t *arena)
 }
 
 STA_DECL
-typevec_t *logger_get_events(const logger_t *logs)
+segvec_t *logger_get_events(const logger_t *logs)
 {
     CTASSERT(logs != NULL);
 
@@ -47,16 +49,13 @@ bool logger_has_errors(const logger_t *logs, notify_rules_t rules)
     CTASSERT(rules.ignored_warnings != NULL);
     CTASSERT(rules.warnings_as_errors != NULL);
 
-    const typevec_t *events = logger_get_events(logs);
-    size_t len = typevec_len(events);
-
-    for (size_t i = 0; i < len; i++)
+    segvec_iter_t iter = segvec_iter(logger_get_events(logs));
+    while (segvec_has_next(&iter))
     {
-        event_t event;
-        typevec_get(events, i, &event);
+        const event_t *event = segvec_next(&iter);
 
-        const diagnostic_t *diagnostic = event.diagnostic;
-        CTASSERTF(diagnostic != NULL, "event %zu has no diagnostic", i);
+        const diagnostic_t *diagnostic = event->diagnostic;
+        CTASSERTF(diagnostic != NULL, "event `%s` has no diagnostic", event->message);
 
         switch (diagnostic->severity)
         {
@@ -90,7 +89,21 @@ void logger_reset(logger_t *logs)
 {
     CTASSERT(logs != NULL);
 
-    typevec_reset(logs->messages);
+    segvec_reset(logs->messages);
+}
+
+STA_DECL
+void logger_append(logger_t *dst, const logger_t *src)
+{
+    CTASSERT(dst != NULL);
+    CTASSERT(src != NULL);
+
+    segvec_iter_t iter = segvec_iter(src->messages);
+    while (segvec_has_next(&iter))
+    {
+        const event_t *event = segvec_next(&iter);
+        segvec_push(dst->messages, event);
+    }
 }
 
 STA_DECL
@@ -131,7 +144,7 @@ event_builder_t msg_vnotify(logger_t *logs, const diagnostic_t *diagnostic, cons
         .notes = NULL,
     };
 
-    event_t *result = typevec_push(logs->messages, &event);
+    event_t *result = segvec_push(logs->messages, &event);
     event_builder_t builder = {
         .event = result,
         .arena = logs->arena
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_os_api.h>
+
+#include "core/analyze.h"
+#include "core/compiler.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+CT_BEGIN_API
+
+/// @defgroup os_atomic Atomics
+/// @brief Portable atomic integers
+/// every operation is sequentially consistent, pointers
+/// can be stored by casting them to and from intptr_t.
+/// @ingroup os
+/// @{
+
+/// @brief an atomic integer
+/// @warning do not access the value directly, use the os_atomic functions
+typedef struct os_atomic_t
+{
+    volatile intptr_t value;
+} os_atomic_t;
+
+/// @brief initialize an atomic integer
+///
+/// @param v the initial value
+#define CT_OS_ATOMIC_INIT(v) { (v) }
+
+/// @brief read an atomic integer
+///
+/// @param atomic the atomic to read
+///
+/// @return the current value
+CT_NODISCARD
+CT_OS_API intptr_t os_atomic_load(IN_NOTNULL const os_atomic_t *atomic);
+
+/// @brief write an atomic integer
+///
+/// @param atomic the atomic to write
+/// @param value the new value
+CT_OS_API void os_atomic_store(IN_NOTNULL os_atomic_t *atomic, intptr_t value);
+
+/// @brief replace the value of an atomic integer
+///
+/// @param atomic the atomic to write
+/// @param value the new value
+///
+/// @return the previous value
+CT_OS_API intptr_t os_atomic_exchange(IN_NOTNULL os_atomic_t *atomic, intptr_t value);
+
+/// @brief replace the value of an atomic integer if it has an expected value
+/// when the value does not match @p expected is updated to the current value
+///
+/// @param atomic the atomic to write
+/// @param expected the value the atomic must have
+/// @param desired the new value
+///
+/// @return true if the value was replaced
+CT_OS_API bool os_atomic_compare_exchange(
+    IN_NOTNULL os_atomic_t *atomic,
+    INOUT_NOTNULL intptr_t *expected,
+    intptr_t desired);
+
+/// @brief add to an atomic integer
+///
+/// @param atomic the atomic to add to
+/// @param value the value to add, may be negative
+///
+/// @return the previous value
+CT_OS_API intptr_t os_atomic_fetch_add(IN_NOTNULL os_atomic_t *atomic, intptr_t value);
+
+/// @} // os_atomic
+
+CT_END_API
@@ -100,6 +100,10 @@ CT_NORETURN CT_OS_API os_thread_exit(os_status_t status);
 /// @return the current thread id
 CT_OS_API os_thread_id_t os_get_thread_id(void);
 
+/// @ingroup os_thread
+/// @brief give up the rest of the current threads time slice
+CT_OS_API void os_thread_yield(void);
+
 /// @brief abort the program
 CT_NORETURN CT_OS_API os_abort(void);
 
@@ -13,6 +13,7 @@ typedef struct dirent *os_inode_impl_t;
 typedef DIR *os_iter_impl_t;
 typedef pthread_t os_thread_impl_t;
 typedef pthread_mutex_t os_mutex_impl_t;
+typedef pthread_cond_t os_cond_impl_t;
 
 typedef struct os_mapping_t
 {
@@ -10,6 +10,7 @@ typedef WIN32_FIND_DATA os_inode_impl_t;
 typedef HANDLE os_iter_impl_t;
 typedef HANDLE os_thread_impl_t;
 typedef CRITICAL_SECTION os_mutex_impl_t;
+typedef CONDITION_VARIABLE os_cond_impl_t;
 
 typedef struct os_mapping_t
 {
@@ -100,6 +100,18 @@ typedef struct os_mutex_t
     os_mutex_impl_t impl;
 } os_mutex_t;
 
+/// @ingroup os_thread
+/// @brief a condition variable handle
+/// @warning do not access the condition variable handle directly, it is platform specific
+typedef struct os_cond_t
+{
+    // used by os_common
+    const char *name;
+
+    // used by os_native
+    os_cond_impl_t impl;
+} os_cond_t;
+
 /// @ingroup os_dl
 /// @{
 
@@ -362,6 +374,22 @@ CT_OS_API os_error_t os_file_map(
         size_t size,
         OUT_NOTNULL os_mapping_t *mapping);
 
+/// @brief map a whole file into private memory followed by zeroed padding
+/// the mapping is readable and writable, but writes are never written back
+/// to the file. at least @p padding zero bytes follow the file contents.
+/// @note release the mapping with @a os_unmap
+///
+/// @param file the file to map
+/// @param padding the number of zero bytes required after the contents
+/// @param mapping the mapping to fill
+///
+/// @return an error if the file could not be mapped
+RET_INSPECT
+CT_OS_API os_error_t os_file_map_private(
+        IN_NOTNULL os_file_t *file,
+        size_t padding,
+        OUT_NOTNULL os_mapping_t *mapping);
+
 /// @brief unmap a file from memory
 /// @note invalidates all memory pointers returned by @a os_mapping_data
 ///
@@ -423,6 +451,82 @@ CT_OS_API bool os_thread_cmpid(
     IN_NOTNULL const os_thread_t *thread,
     os_thread_id_t id);
 
+/// @brief create a mutex
+///
+/// @param mutex the mutex to initialize
+/// @param name the name of the mutex
+///
+/// @return 0 on success, error otherwise
+RET_INSPECT
+CT_OS_API os_error_t os_mutex_init(
+    OUT_NOTNULL os_mutex_t *mutex,
+    IN_STRING const char *name);
+
+/// @brief destroy a mutex
+/// @pre @p mutex must not be locked
+///
+/// @param mutex the mutex to destroy
+CT_OS_API void os_mutex_destroy(STA_RELEASE os_mutex_t *mutex);
+
+/// @brief lock a mutex, waiting until it is available
+/// mutexes are not recursive, locking a mutex held by
+/// the current thread is an error
+///
+/// @param mutex the mutex to lock
+CT_OS_API void os_mutex_lock(IN_NOTNULL os_mutex_t *mutex);
+
+/// @brief unlock a mutex
+/// @pre @p mutex must be locked by the current thread
+///
+/// @param mutex the mutex to unlock
+CT_OS_API void os_mutex_unlock(IN_NOTNULL os_mutex_t *mutex);
+
+/// @brief get the name of a mutex
+///
+/// @param mutex the mutex to get the name of
+///
+/// @return the name of the mutex
+CT_NODISCARD CT_PUREFN
+CT_OS_API const char *os_mutex_name(IN_NOTNULL const os_mutex_t *mutex);
+
+/// @brief create a condition variable
+///
+/// @param cond the condition variable to initialize
+/// @param name the name of the condition variable
+///
+/// @return 0 on success, error otherwise
+RET_INSPECT
+CT_OS_API os_error_t os_cond_init(
+    OUT_NOTNULL os_cond_t *cond,
+    IN_STRING const char *name);
+
+/// @brief destroy a condition variable
+/// @pre no threads may be waiting on @p cond
+///
+/// @param cond the condition variable to destroy
+CT_OS_API void os_cond_destroy(STA_RELEASE os_cond_t *cond);
+
+/// @brief wait for a condition variable to be signalled
+/// @p mutex is released while waiting and locked again before returning.
+/// waits may wake up spuriously, so the condition must be checked again
+/// @pre @p mutex must be locked by the current thread
+///
+/// @param cond the condition variable to wait on
+/// @param mutex the mutex protecting the condition
+CT_OS_API void os_cond_wait(
+    IN_NOTNULL os_cond_t *cond,
+    IN_NOTNULL os_mutex_t *mutex);
+
+/// @brief wake up one thread waiting on a condition variable
+///
+/// @param cond the condition variable to signal
+CT_OS_API void os_cond_signal(IN_NOTNULL os_cond_t *cond);
+
+/// @brief wake up all threads waiting on a condition variable
+///
+/// @param cond the condition variable to broadcast
+CT_OS_API void os_cond_broadcast(IN_NOTNULL os_cond_t *cond);
+
 /// @}
 
 /// @}
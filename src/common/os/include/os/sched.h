@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_os_api.h>
+
+#include "os/atomic.h"
+
+#include <stddef.h>
+
+typedef struct arena_t arena_t;
+
+CT_BEGIN_API
+
+/// @defgroup os_sched Task scheduling
+/// @brief Work stealing task scheduler
+/// a scheduler owns a fixed set of worker threads, each with its own deque of tasks.
+/// workers run tasks from the bottom of their own deque and steal from the top of
+/// other deques when they run out. tasks spawned by threads that are not workers
+/// go into a shared deque that every worker steals from.
+/// threads waiting on a task group run tasks while they wait, so tasks may
+/// spawn and wait on nested groups without running out of workers.
+/// @ingroup os
+/// @{
+
+/// @brief a task scheduler
+typedef struct os_sched_t os_sched_t;
+
+/// @brief a group of tasks that can be waited on together
+typedef struct os_task_group_t os_task_group_t;
+
+/// @brief the body of a task
+typedef void (*os_task_fn_t)(void *arg);
+
+/// @brief the body of a parallel loop
+/// called with a subrange of the loop, @p first is inclusive and @p last is exclusive
+typedef void (*os_range_fn_t)(size_t first, size_t last, void *arg);
+
+/// @brief a spawned task
+/// tasks are not copied by the scheduler, the memory for a task
+/// must stay valid until the group it was spawned in has been waited on
+/// @warning do not access the task directly
+typedef struct os_task_t
+{
+    os_task_fn_t fn;
+    void *arg;
+    os_task_group_t *group;
+} os_task_t;
+
+/// @brief a group of tasks that can be waited on together
+/// @warning do not access the group directly
+typedef struct os_task_group_t
+{
+    os_sched_t *sched;
+
+    /// the number of tasks spawned in this group that have not finished
+    os_atomic_t pending;
+} os_task_group_t;
+
+/// @brief create a new scheduler
+/// if a worker thread fails to start the scheduler runs with fewer workers,
+/// tasks still complete as threads waiting on them run them.
+/// @pre @p workers must be greater than 0
+///
+/// @param workers the number of worker threads to start
+/// @param arena the arena to allocate the scheduler and its deques from
+///
+/// @return the scheduler
+RET_NOTNULL
+CT_OS_API os_sched_t *os_sched_new(
+    IN_DOMAIN(>, 0) size_t workers,
+    IN_NOTNULL arena_t *arena);
+
+/// @brief stop all workers and release a scheduler
+/// @pre every task group using @p sched must have been waited on
+///
+/// @param sched the scheduler to delete
+CT_OS_API void os_sched_delete(STA_RELEASE os_sched_t *sched);
+
+/// @brief get the number of worker threads running in a scheduler
+///
+/// @param sched the scheduler
+///
+/// @return the number of workers that started
+CT_NODISCARD
+CT_OS_API size_t os_sched_workers(IN_NOTNULL const os_sched_t *sched);
+
+/// @brief initialize a task group
+///
+/// @param group the group to initialize
+/// @param sched the scheduler to run tasks in the group on
+CT_OS_API void os_task_group_init(
+    OUT_NOTNULL os_task_group_t *group,
+    IN_NOTNULL os_sched_t *sched);
+
+/// @brief spawn a task in a group
+/// the task may start running before this returns
+///
+/// @param group the group to add the task to
+/// @param task storage for the task, must outlive the group
+/// @param fn the task body
+/// @param arg the argument to pass to @p fn
+CT_OS_API void os_task_group_spawn(
+    IN_NOTNULL os_task_group_t *group,
+    OUT_NOTNULL os_task_t *task,
+    IN_NOTNULL os_task_fn_t fn,
+    void *arg);
+
+/// @brief wait for every task in a group to finish
+/// the calling thread runs queued tasks until the group is done,
+/// these may belong to other groups. when nothing is queued it sleeps
+/// until the group finishes or more tasks are queued.
+///
+/// @param group the group to wait on
+CT_OS_API void os_task_group_wait(IN_NOTNULL os_task_group_t *group);
+
+/// @brief run a loop over a range in parallel
+/// the range is split in half until each part is at most @p grain long,
+/// parts are run as tasks in @p sched. returns once the whole range is done.
+/// @pre @p first must not be greater than @p last
+/// @pre @p grain must be greater than 0
+///
+/// @param sched the scheduler to run the loop on
+/// @param first the first index of the range
+/// @param last one past the last index of the range
+/// @param grain the largest part of the range to run as a single task
+/// @param fn the loop body
+/// @param arg the argument to pass to @p fn
+CT_OS_API void os_parallel_for(
+    IN_NOTNULL os_sched_t *sched,
+    size_t first,
+    size_t last,
+    IN_DOMAIN(>, 0) size_t grain,
+    IN_NOTNULL os_range_fn_t fn,
+    void *arg);
+
+/// @} // os_sched
+
+CT_END_API
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "os/atomic.h"
+
+#include "base/panic.h"
+
+#if CT_CC_MSVC
+#   include "core/win32.h"
+
+#   if defined(_WIN64)
+#      define ATOMIC_EXCHANGE InterlockedExchange64
+#      define ATOMIC_COMPARE_EXCHANGE InterlockedCompareExchange64
+#      define ATOMIC_EXCHANGE_ADD InterlockedExchangeAdd64
+#   else
+#      define ATOMIC_EXCHANGE InterlockedExchange
+#      define ATOMIC_COMPARE_EXCHANGE InterlockedCompareExchange
+#      define ATOMIC_EXCHANGE_ADD InterlockedExchangeAdd
+#   endif
+#endif
+
+STA_DECL
+intptr_t os_atomic_load(const os_atomic_t *atomic)
+{
+    CTASSERT(atomic != NULL);
+
+#if CT_CC_MSVC
+    // a compare exchange that never succeeds is a full barrier read
+    return ATOMIC_COMPARE_EXCHANGE((volatile intptr_t*)&atomic->value, 0, 0);
+#else
+    return __atomic_load_n(&atomic->value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+STA_DECL
+void os_atomic_store(os_atomic_t *atomic, intptr_t value)
+{
+    CTASSERT(atomic != NULL);
+
+#if CT_CC_MSVC
+    ATOMIC_EXCHANGE(&atomic->value, value);
+#else
+    __atomic_store_n(&atomic->value, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+STA_DECL
+intptr_t os_atomic_exchange(os_atomic_t *atomic, intptr_t value)
+{
+    CTASSERT(atomic != NULL);
+
+#if CT_CC_MSVC
+    return ATOMIC_EXCHANGE(&atomic->value, value);
+#else
+    return __atomic_exchange_n(&atomic->value, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+STA_DECL
+bool os_atomic_compare_exchange(os_atomic_t *atomic, intptr_t *expected, intptr_t desired)
+{
+    CTASSERT(atomic != NULL);
+    CTASSERT(expected != NULL);
+
+#if CT_CC_MSVC
+    intptr_t prev = ATOMIC_COMPARE_EXCHANGE(&atomic->value, desired, *expected);
+    if (prev == *expected)
+        return true;
+
+    *expected = prev;
+    return false;
+#else
+    return __atomic_compare_exchange_n(&atomic->value, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+STA_DECL
+intptr_t os_atomic_fetch_add(os_atomic_t *atomic, intptr_t value)
+{
+    CTASSERT(atomic != NULL);
+
+#if CT_CC_MSVC
+    return ATOMIC_EXCHANGE_ADD(&atomic->value, value);
+#else
+    return __atomic_fetch_add(&atomic->value, value, __ATOMIC_SEQ_CST);
+#endif
+}
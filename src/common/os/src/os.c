@@ -145,6 +145,35 @@ os_error_t os_file_map(os_file_t *file, os_protect_t protect, size_t size, os_ma
     return err;
 }
 
+STA_DECL
+os_error_t os_file_map_private(os_file_t *file, size_t padding, os_mapping_t *mapping)
+{
+    CTASSERT(file != NULL);
+    CTASSERT(mapping != NULL);
+
+    size_t size = 0;
+    os_error_t err = os_file_size(file, &size);
+    if (err != eOsSuccess)
+    {
+        return err;
+    }
+
+    if (size == 0)
+    {
+        return eOsTooSmall;
+    }
+
+    mapping->size = size + padding;
+    void *ptr = impl_file_map_private(file, size, padding, mapping);
+    if (ptr == CT_OS_INVALID_MAPPING)
+    {
+        return impl_last_error();
+    }
+
+    mapping->view = ptr;
+    return eOsSuccess;
+}
+
 STA_DECL
 os_error_t os_unmap(os_mapping_t *mapping)
 {
@@ -480,3 +509,11 @@ bool os_thread_cmpid(const os_thread_t *thread, os_thread_id_t id)
 
     return thread->id == id;
 }
+
+STA_DECL
+const char *os_mutex_name(const os_mutex_t *mutex)
+{
+    CTASSERT(mutex != NULL);
+
+    return mutex->name;
+}
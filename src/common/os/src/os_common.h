@@ -46,6 +46,7 @@ CT_LOCAL bool impl_file_close(os_file_impl_t impl);
 
 // file mapping
 CT_LOCAL void *impl_file_map(os_file_t *file, os_protect_t protect, size_t size, os_mapping_t *map);
+CT_LOCAL void *impl_file_map_private(os_file_t *file, size_t size, size_t padding, os_mapping_t *map);
 CT_LOCAL os_error_t impl_unmap(os_mapping_t *map);
 
 // iteration
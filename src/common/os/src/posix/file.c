@@ -1,5 +1,10 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
+// for copy_file_range and sendfile
+#if defined(__linux__)
+#   define _GNU_SOURCE
+#endif
+
 #include "os/os.h"
 #include "os_common.h"
 
@@ -11,9 +16,21 @@
 #include <errno.h>
 #include <unistd.h>
 
+#include <fcntl.h>
+
 #include <sys/mman.h>
 #include <sys/stat.h>
 
+#if defined(__linux__)
+#   include <sys/sendfile.h>
+#endif
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#   define OS_USE_COPY_FILE_RANGE 1
+#else
+#   define OS_USE_COPY_FILE_RANGE 0
+#endif
+
 static const char *get_access(os_access_t access)
 {
     switch (access)
@@ -34,6 +51,95 @@ static const char *get_access(os_access_t access)
     }
 }
 
+// copy size bytes between file descriptors, starting at their current offsets
+static os_error_t copy_fd(int dst, int src, size_t size)
+{
+    size_t done = 0;
+
+#if OS_USE_COPY_FILE_RANGE
+    // the data never leaves the kernel, and some filesystems share the extents
+    while (done < size)
+    {
+        ssize_t copied = copy_file_range(src, NULL, dst, NULL, size - done, 0);
+        if (copied <= 0) break;
+
+        done += (size_t)copied;
+    }
+#endif
+
+#if defined(__linux__)
+    // copy_file_range is not supported across every pair of filesystems
+    while (done < size)
+    {
+        ssize_t copied = sendfile(dst, src, NULL, size - done);
+        if (copied <= 0) break;
+
+        done += (size_t)copied;
+    }
+#endif
+
+    char buffer[0x4000];
+    while (done < size)
+    {
+        ssize_t count = read(src, buffer, sizeof(buffer));
+        if (count < 0) return errno;
+
+        // the source shrank after it was stat'd, a partial copy is not a copy
+        if (count == 0) return EIO;
+
+        for (ssize_t offset = 0; offset < count;)
+        {
+            ssize_t written = write(dst, buffer + offset, (size_t)(count - offset));
+            if (written < 0) return errno;
+
+            offset += written;
+        }
+
+        done += (size_t)count;
+    }
+
+    return 0;
+}
+
+CT_LOCAL os_error_t impl_copyfile(const char *dst, const char *src)
+{
+    CTASSERT(dst != NULL);
+    CTASSERT(src != NULL);
+
+    int in = open(src, O_RDONLY);
+    if (in < 0)
+    {
+        return errno;
+    }
+
+    struct stat info;
+    if (fstat(in, &info) != 0)
+    {
+        os_error_t err = errno;
+        close(in);
+        return err;
+    }
+
+    int out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, info.st_mode & 0777);
+    if (out < 0)
+    {
+        os_error_t err = errno;
+        close(in);
+        return err;
+    }
+
+    os_error_t err = copy_fd(out, in, (size_t)info.st_size);
+
+    if (close(out) != 0 && err == 0)
+    {
+        err = errno;
+    }
+
+    close(in);
+
+    return err;
+}
+
 STA_DECL
 os_error_t os_file_exists(const char *path)
 {
@@ -119,7 +225,7 @@ os_error_t os_file_write(os_file_t *file, const void *buffer, size_t size, size_
     }
 
     *actual = written;
-    return errno;
+    return 0;
 }
 
 STA_DECL
@@ -224,7 +330,36 @@ CT_LOCAL void *impl_file_map(os_file_t *file, os_protect_t protect, size_t size,
     int prot = get_mmap_prot(protect);
 
     int fd = fileno(file->impl);
-    return mmap(NULL, size, prot, MAP_PRIVATE, fd, 0);
+    void *view = mmap(NULL, size, prot, MAP_PRIVATE, fd, 0);
+    return (view == MAP_FAILED) ? CT_OS_INVALID_MAPPING : view;
+}
+
+CT_LOCAL void *impl_file_map_private(os_file_t *file, size_t size, size_t padding, os_mapping_t *mapping)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t total = ((size + padding + page - 1) / page) * page;
+
+    // reserve zeroed memory for the contents and padding, then place the
+    // file over the front of it. the tail of the last file page is zero
+    // filled, and any whole pages after it belong to the reservation.
+    void *base = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        return CT_OS_INVALID_MAPPING;
+    }
+
+    int fd = fileno(file->impl);
+    void *view = mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        int err = errno;
+        munmap(base, total);
+        errno = err;
+        return CT_OS_INVALID_MAPPING;
+    }
+
+    mapping->size = total;
+    return view;
 }
 
 CT_LOCAL os_error_t impl_unmap(os_mapping_t *map)
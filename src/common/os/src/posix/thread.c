@@ -3,6 +3,8 @@
 
 #include "base/panic.h"
 
+#include <sched.h>
+
 static void *thread_fn(void *arg)
 {
     os_thread_t *thread = arg;
@@ -57,3 +59,102 @@ os_thread_id_t os_get_thread_id(void)
 {
     return pthread_self();
 }
+
+void os_thread_yield(void)
+{
+    sched_yield();
+}
+
+///
+/// mutexes
+///
+
+STA_DECL
+os_error_t os_mutex_init(os_mutex_t *mutex, const char *name)
+{
+    CTASSERT(mutex != NULL);
+    CTASSERT(name != NULL);
+
+    mutex->name = name;
+
+    return pthread_mutex_init(&mutex->impl, NULL);
+}
+
+STA_DECL
+void os_mutex_destroy(os_mutex_t *mutex)
+{
+    CTASSERT(mutex != NULL);
+
+    int err = pthread_mutex_destroy(&mutex->impl);
+    CTASSERTF(err == 0, "failed to destroy mutex %s (%d)", mutex->name, err);
+}
+
+STA_DECL
+void os_mutex_lock(os_mutex_t *mutex)
+{
+    CTASSERT(mutex != NULL);
+
+    int err = pthread_mutex_lock(&mutex->impl);
+    CTASSERTF(err == 0, "failed to lock mutex %s (%d)", mutex->name, err);
+}
+
+STA_DECL
+void os_mutex_unlock(os_mutex_t *mutex)
+{
+    CTASSERT(mutex != NULL);
+
+    int err = pthread_mutex_unlock(&mutex->impl);
+    CTASSERTF(err == 0, "failed to unlock mutex %s (%d)", mutex->name, err);
+}
+
+///
+/// condition variables
+///
+
+STA_DECL
+os_error_t os_cond_init(os_cond_t *cond, const char *name)
+{
+    CTASSERT(cond != NULL);
+    CTASSERT(name != NULL);
+
+    cond->name = name;
+
+    return pthread_cond_init(&cond->impl, NULL);
+}
+
+STA_DECL
+void os_cond_destroy(os_cond_t *cond)
+{
+    CTASSERT(cond != NULL);
+
+    int err = pthread_cond_destroy(&cond->impl);
+    CTASSERTF(err == 0, "failed to destroy condition %s (%d)", cond->name, err);
+}
+
+STA_DECL
+void os_cond_wait(os_cond_t *cond, os_mutex_t *mutex)
+{
+    CTASSERT(cond != NULL);
+    CTASSERT(mutex != NULL);
+
+    int err = pthread_cond_wait(&cond->impl, &mutex->impl);
+    CTASSERTF(err == 0, "failed to wait on condition %s (%d)", cond->name, err);
+}
+
+STA_DECL
+void os_cond_signal(os_cond_t *cond)
+{
+    CTASSERT(cond != NULL);
+
+    int err = pthread_cond_signal(&cond->impl);
+    CTASSERTF(err == 0, "failed to signal condition %s (%d)", cond->name, err);
+}
+
+STA_DECL
+void os_cond_broadcast(os_cond_t *cond)
+{
+    CTASSERT(cond != NULL);
+
+    int err = pthread_cond_broadcast(&cond->impl);
+    CTASSERTF(err == 0, "failed to broadcast condition %s (%d)", cond->name, err);
+}
@@ -0,0 +1,544 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "os/sched.h"
+#include "os/os.h"
+
+#include "arena/arena.h"
+#include "base/panic.h"
+
+/// each deque is a chase-lev deque. the owner pushes and takes at the bottom
+/// while thieves take from the top, only the last task needs a compare exchange.
+/// the shared deque used by threads outside the scheduler has its owner side
+/// serialized by a mutex so any thread can push to it.
+
+// the number of tasks a deque can hold before it grows, must be a power of 2
+#define DEQUE_INITIAL_SIZE 64
+
+typedef struct deque_buffer_t
+{
+    // buffers that have been replaced, a thief may still be reading
+    // from them so they are kept until the scheduler is deleted
+    struct deque_buffer_t *prev;
+
+    // always a power of 2
+    size_t size;
+
+    // os_task_t*
+    os_atomic_t slots[];
+} deque_buffer_t;
+
+typedef struct sched_deque_t
+{
+    os_atomic_t top;
+    os_atomic_t bottom;
+
+    // deque_buffer_t*
+    os_atomic_t buffer;
+} sched_deque_t;
+
+typedef struct sched_worker_t
+{
+    os_thread_t thread;
+
+    // set once thread is written, other workers may look
+    // for this worker while later ones are still starting
+    os_atomic_t started;
+
+    os_sched_t *sched;
+    size_t index;
+
+    sched_deque_t deque;
+} sched_worker_t;
+
+typedef struct os_sched_t
+{
+    arena_t *arena;
+
+    // guards the arena, sleeping workers and waiting threads
+    os_mutex_t lock;
+    os_cond_t wake;
+
+    // signalled when a group finishes or a task is queued
+    os_cond_t done;
+
+    // tasks spawned from threads that are not workers
+    os_mutex_t inbox_lock;
+    sched_deque_t inbox;
+
+    // the number of tasks sitting in deques
+    os_atomic_t queued;
+
+    // the number of workers waiting on wake
+    os_atomic_t sleepers;
+
+    // the number of threads waiting on done
+    os_atomic_t waiters;
+
+    os_atomic_t stopping;
+
+    STA_FIELD_SIZE(count) sched_worker_t *workers;
+    size_t count;
+} os_sched_t;
+
+static deque_buffer_t *buffer_new(size_t size, deque_buffer_t *prev, arena_t *arena)
+{
+    size_t bytes = sizeof(deque_buffer_t) + sizeof(os_atomic_t) * size;
+    deque_buffer_t *buffer = ARENA_MALLOC(bytes, "deque", NULL, arena);
+    buffer->prev = prev;
+    buffer->size = size;
+
+    return buffer;
+}
+
+static os_atomic_t *buffer_slot(deque_buffer_t *buffer, intptr_t index)
+{
+    return &buffer->slots[(size_t)index & (buffer->size - 1)];
+}
+
+static void deque_init(sched_deque_t *deque, arena_t *arena)
+{
+    deque_buffer_t *buffer = buffer_new(DEQUE_INITIAL_SIZE, NULL, arena);
+
+    os_atomic_store(&deque->top, 0);
+    os_atomic_store(&deque->bottom, 0);
+    os_atomic_store(&deque->buffer, (intptr_t)buffer);
+}
+
+static void deque_delete(sched_deque_t *deque, arena_t *arena)
+{
+    deque_buffer_t *buffer = (deque_buffer_t*)os_atomic_load(&deque->buffer);
+    while (buffer != NULL)
+    {
+        deque_buffer_t *prev = buffer->prev;
+        arena_free(buffer, sizeof(deque_buffer_t) + sizeof(os_atomic_t) * buffer->size, arena);
+        buffer = prev;
+    }
+}
+
+static deque_buffer_t *deque_grow(os_sched_t *sched, deque_buffer_t *buffer, intptr_t top, intptr_t bottom)
+{
+    os_mutex_lock(&sched->lock);
+    deque_buffer_t *grown = buffer_new(buffer->size * 2, buffer, sched->arena);
+    os_mutex_unlock(&sched->lock);
+
+    for (intptr_t i = top; i < bottom; i++)
+    {
+        os_atomic_store(buffer_slot(grown, i), os_atomic_load(buffer_slot(buffer, i)));
+    }
+
+    return grown;
+}
+
+// only called by the owner of the deque
+static void deque_push(os_sched_t *sched, sched_deque_t *deque, os_task_t *task)
+{
+    intptr_t bottom = os_atomic_load(&deque->bottom);
+    intptr_t top = os_atomic_load(&deque->top);
+    deque_buffer_t *buffer = (deque_buffer_t*)os_atomic_load(&deque->buffer);
+
+    if (bottom - top >= (intptr_t)buffer->size)
+    {
+        buffer = deque_grow(sched, buffer, top, bottom);
+        os_atomic_store(&deque->buffer, (intptr_t)buffer);
+    }
+
+    os_atomic_store(buffer_slot(buffer, bottom), (intptr_t)task);
+    os_atomic_store(&deque->bottom, bottom + 1);
+}
+
+// only called by the owner of the deque
+static os_task_t *deque_take(sched_deque_t *deque)
+{
+    intptr_t bottom = os_atomic_load(&deque->bottom) - 1;
+    deque_buffer_t *buffer = (deque_buffer_t*)os_atomic_load(&deque->buffer);
+    os_atomic_store(&deque->bottom, bottom);
+
+    intptr_t top = os_atomic_load(&deque->top);
+    if (top > bottom)
+    {
+        os_atomic_store(&deque->bottom, bottom + 1);
+        return NULL;
+    }
+
+    os_task_t *task = (os_task_t*)os_atomic_load(buffer_slot(buffer, bottom));
+    if (top == bottom)
+    {
+        // the last task may be stolen at the same time
+        if (!os_atomic_compare_exchange(&deque->top, &top, top + 1))
+            task = NULL;
+
+        os_atomic_store(&deque->bottom, bottom + 1);
+    }
+
+    return task;
+}
+
+static os_task_t *deque_steal(sched_deque_t *deque)
+{
+    intptr_t top = os_atomic_load(&deque->top);
+    intptr_t bottom = os_atomic_load(&deque->bottom);
+    if (top >= bottom)
+        return NULL;
+
+    deque_buffer_t *buffer = (deque_buffer_t*)os_atomic_load(&deque->buffer);
+    os_task_t *task = (os_task_t*)os_atomic_load(buffer_slot(buffer, top));
+
+    if (!os_atomic_compare_exchange(&deque->top, &top, top + 1))
+        return NULL;
+
+    return task;
+}
+
+static sched_worker_t *find_worker(os_sched_t *sched)
+{
+    os_thread_id_t id = os_get_thread_id();
+    for (size_t i = 0; i < sched->count; i++)
+    {
+        sched_worker_t *worker = &sched->workers[i];
+        if (os_atomic_load(&worker->started) && os_thread_cmpid(&worker->thread, id))
+            return worker;
+    }
+
+    return NULL;
+}
+
+// take from our own deque first, then steal starting from the next worker along
+static os_task_t *find_task(os_sched_t *sched, sched_worker_t *self)
+{
+    if (self != NULL)
+    {
+        os_task_t *task = deque_take(&self->deque);
+        if (task != NULL) return task;
+    }
+
+    size_t start = (self != NULL) ? self->index + 1 : 0;
+    for (size_t i = 0; i < sched->count; i++)
+    {
+        sched_worker_t *victim = &sched->workers[(start + i) % sched->count];
+        if (victim == self) continue;
+
+        os_task_t *task = deque_steal(&victim->deque);
+        if (task != NULL) return task;
+    }
+
+    return deque_steal(&sched->inbox);
+}
+
+static void run_task(os_sched_t *sched, os_task_t *task)
+{
+    os_atomic_fetch_add(&sched->queued, -1);
+
+    // the task may be released as soon as the group is done
+    os_task_group_t *group = task->group;
+    task->fn(task->arg);
+
+    // the group may be released once pending reaches zero, so it
+    // must not be touched after this. waiters count themselves before
+    // checking pending, so either they see zero or we see them
+    if (os_atomic_fetch_add(&group->pending, -1) == 1 && os_atomic_load(&sched->waiters) > 0)
+    {
+        os_mutex_lock(&sched->lock);
+        os_cond_broadcast(&sched->done);
+        os_mutex_unlock(&sched->lock);
+    }
+}
+
+static void sched_push(os_sched_t *sched, os_task_t *task)
+{
+    // counted before it is visible so a thief never sees a negative count
+    os_atomic_fetch_add(&sched->queued, 1);
+
+    sched_worker_t *worker = find_worker(sched);
+    if (worker != NULL)
+    {
+        deque_push(sched, &worker->deque, task);
+    }
+    else
+    {
+        os_mutex_lock(&sched->inbox_lock);
+        deque_push(sched, &sched->inbox, task);
+        os_mutex_unlock(&sched->inbox_lock);
+    }
+
+    // workers and waiters only block after checking the queue under the
+    // lock, so taking it here means the signal cannot be missed
+    bool sleepers = os_atomic_load(&sched->sleepers) > 0;
+    bool waiters = os_atomic_load(&sched->waiters) > 0;
+    if (sleepers || waiters)
+    {
+        os_mutex_lock(&sched->lock);
+        if (sleepers) os_cond_signal(&sched->wake);
+        if (waiters) os_cond_signal(&sched->done);
+        os_mutex_unlock(&sched->lock);
+    }
+}
+
+// returns false once the scheduler is stopping
+static bool sched_sleep(os_sched_t *sched)
+{
+    os_mutex_lock(&sched->lock);
+    os_atomic_fetch_add(&sched->sleepers, 1);
+
+    while (os_atomic_load(&sched->queued) == 0 && !os_atomic_load(&sched->stopping))
+    {
+        os_cond_wait(&sched->wake, &sched->lock);
+    }
+
+    os_atomic_fetch_add(&sched->sleepers, -1);
+    bool running = !os_atomic_load(&sched->stopping);
+    os_mutex_unlock(&sched->lock);
+
+    return running;
+}
+
+static os_exitcode_t sched_worker(void *arg)
+{
+    sched_worker_t *worker = arg;
+    os_sched_t *sched = worker->sched;
+
+    while (true)
+    {
+        os_task_t *task = find_task(sched, worker);
+        if (task != NULL)
+        {
+            run_task(sched, task);
+            continue;
+        }
+
+        if (!sched_sleep(sched))
+            break;
+    }
+
+    return 0;
+}
+
+STA_DECL
+os_sched_t *os_sched_new(size_t workers, arena_t *arena)
+{
+    CTASSERT(workers > 0);
+    CTASSERT(arena != NULL);
+
+    os_sched_t *sched = ARENA_MALLOC(sizeof(os_sched_t), "sched", NULL, arena);
+    sched->arena = arena;
+
+    os_error_t err = os_mutex_init(&sched->lock, "sched");
+    CTASSERTF(err == eOsSuccess, "failed to create scheduler lock (%s)", os_error_string(err, arena));
+
+    err = os_mutex_init(&sched->inbox_lock, "sched inbox");
+    CTASSERTF(err == eOsSuccess, "failed to create scheduler inbox lock (%s)", os_error_string(err, arena));
+
+    err = os_cond_init(&sched->wake, "sched wake");
+    CTASSERTF(err == eOsSuccess, "failed to create scheduler condition (%s)", os_error_string(err, arena));
+
+    err = os_cond_init(&sched->done, "sched done");
+    CTASSERTF(err == eOsSuccess, "failed to create scheduler condition (%s)", os_error_string(err, arena));
+
+    deque_init(&sched->inbox, arena);
+    os_atomic_store(&sched->queued, 0);
+    os_atomic_store(&sched->sleepers, 0);
+    os_atomic_store(&sched->waiters, 0);
+    os_atomic_store(&sched->stopping, 0);
+
+    sched->workers = ARENA_MALLOC(sizeof(sched_worker_t) * workers, "workers", sched, arena);
+    sched->count = workers;
+
+    // every worker is set up before any start so they can steal from each other
+    for (size_t i = 0; i < workers; i++)
+    {
+        sched_worker_t *worker = &sched->workers[i];
+        os_atomic_store(&worker->started, 0);
+        worker->sched = sched;
+        worker->index = i;
+        deque_init(&worker->deque, arena);
+    }
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        sched_worker_t *worker = &sched->workers[i];
+        bool started = os_thread_init(&worker->thread, "sched", sched_worker, worker) == eOsSuccess;
+        os_atomic_store(&worker->started, started);
+    }
+
+    return sched;
+}
+
+STA_DECL
+void os_sched_delete(os_sched_t *sched)
+{
+    CTASSERT(sched != NULL);
+    CTASSERTF(os_atomic_load(&sched->queued) == 0, "deleting a scheduler with queued tasks");
+
+    os_mutex_lock(&sched->lock);
+    os_atomic_store(&sched->stopping, 1);
+    os_cond_broadcast(&sched->wake);
+    os_mutex_unlock(&sched->lock);
+
+    arena_t *arena = sched->arena;
+
+    for (size_t i = 0; i < sched->count; i++)
+    {
+        sched_worker_t *worker = &sched->workers[i];
+        if (os_atomic_load(&worker->started))
+        {
+            os_status_t status = 0;
+            os_error_t err = os_thread_join(&worker->thread, &status);
+            CTASSERTF(err == eOsSuccess, "failed to join scheduler worker %zu", i);
+        }
+
+        deque_delete(&worker->deque, arena);
+    }
+
+    deque_delete(&sched->inbox, arena);
+
+    os_cond_destroy(&sched->done);
+    os_cond_destroy(&sched->wake);
+    os_mutex_destroy(&sched->inbox_lock);
+    os_mutex_destroy(&sched->lock);
+
+    arena_free(sched->workers, sizeof(sched_worker_t) * sched->count, arena);
+    arena_free(sched, sizeof(os_sched_t), arena);
+}
+
+STA_DECL
+size_t os_sched_workers(const os_sched_t *sched)
+{
+    CTASSERT(sched != NULL);
+
+    size_t started = 0;
+    for (size_t i = 0; i < sched->count; i++)
+    {
+        if (os_atomic_load(&sched->workers[i].started))
+            started += 1;
+    }
+
+    return started;
+}
+
+///
+/// task groups
+///
+
+STA_DECL
+void os_task_group_init(os_task_group_t *group, os_sched_t *sched)
+{
+    CTASSERT(group != NULL);
+    CTASSERT(sched != NULL);
+
+    group->sched = sched;
+    os_atomic_store(&group->pending, 0);
+}
+
+STA_DECL
+void os_task_group_spawn(os_task_group_t *group, os_task_t *task, os_task_fn_t fn, void *arg)
+{
+    CTASSERT(group != NULL);
+    CTASSERT(task != NULL);
+    CTASSERT(fn != NULL);
+
+    task->fn = fn;
+    task->arg = arg;
+    task->group = group;
+
+    os_atomic_fetch_add(&group->pending, 1);
+    sched_push(group->sched, task);
+}
+
+STA_DECL
+void os_task_group_wait(os_task_group_t *group)
+{
+    CTASSERT(group != NULL);
+
+    os_sched_t *sched = group->sched;
+    sched_worker_t *self = find_worker(sched);
+
+    while (os_atomic_load(&group->pending) > 0)
+    {
+        os_task_t *task = find_task(sched, self);
+        if (task != NULL)
+        {
+            run_task(sched, task);
+            continue;
+        }
+
+        // the remaining tasks are running on other threads, sleep
+        // until one of them finishes the group or queues more work
+        os_mutex_lock(&sched->lock);
+        os_atomic_fetch_add(&sched->waiters, 1);
+
+        while (os_atomic_load(&group->pending) > 0 && os_atomic_load(&sched->queued) == 0)
+        {
+            os_cond_wait(&sched->done, &sched->lock);
+        }
+
+        os_atomic_fetch_add(&sched->waiters, -1);
+        os_mutex_unlock(&sched->lock);
+    }
+}
+
+///
+/// parallel loops
+///
+
+typedef struct sched_range_t
+{
+    os_task_t task;
+    os_sched_t *sched;
+
+    size_t first;
+    size_t last;
+    size_t grain;
+
+    os_range_fn_t fn;
+    void *arg;
+} sched_range_t;
+
+// the upper half is spawned and the lower half run here, so
+// each level of the split only needs storage on this stack
+static void run_range(void *arg)
+{
+    sched_range_t *range = arg;
+    if (range->last - range->first <= range->grain)
+    {
+        range->fn(range->first, range->last, range->arg);
+        return;
+    }
+
+    size_t middle = range->first + (range->last - range->first) / 2;
+
+    sched_range_t upper = *range;
+    upper.first = middle;
+
+    sched_range_t lower = *range;
+    lower.last = middle;
+
+    os_task_group_t group;
+    os_task_group_init(&group, range->sched);
+    os_task_group_spawn(&group, &upper.task, run_range, &upper);
+
+    run_range(&lower);
+
+    os_task_group_wait(&group);
+}
+
+STA_DECL
+void os_parallel_for(os_sched_t *sched, size_t first, size_t last, size_t grain, os_range_fn_t fn, void *arg)
+{
+    CTASSERT(sched != NULL);
+    CTASSERTF(first <= last, "invalid range [%zu, %zu)", first, last);
+    CTASSERT(grain > 0);
+    CTASSERT(fn != NULL);
+
+    if (first == last)
+        return;
+
+    sched_range_t range = {
+        .sched = sched,
+        .first = first,
+        .last = last,
+        .grain = grain,
+        .fn = fn,
+        .arg = arg,
+    };
+
+    run_range(&range);
+}
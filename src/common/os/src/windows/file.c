@@ -317,6 +317,51 @@ CT_LOCAL void *impl_file_map(os_file_t *file, os_protect_t protect, size_t size,
     return view;
 }
 
+CT_LOCAL void *impl_file_map_private(os_file_t *file, size_t size, size_t padding, os_mapping_t *mapping)
+{
+    // views cannot extend past the end of a file opened for reading,
+    // so the padding has to fit in the zero filled tail of the last page
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    size_t tail = size % info.dwPageSize;
+    if (tail == 0 || info.dwPageSize - tail < padding)
+    {
+        SetLastError(ERROR_NOT_SUPPORTED);
+        return NULL;
+    }
+
+    HANDLE handle = CreateFileMappingA(
+        /* hFile = */ file->impl,
+        /* lpFileMappingAttributes = */ NULL,
+        /* flProtect = */ PAGE_WRITECOPY,
+        /* dwMaximumSizeHigh = */ 0,
+        /* dwMaximumSizeLow = */ 0,
+        /* lpName = */ NULL);
+
+    if (handle == NULL)
+    {
+        return NULL;
+    }
+
+    LPVOID view = MapViewOfFile(
+        /* hFileMappingObject = */ handle,
+        /* dwDesiredAccess = */ FILE_MAP_COPY,
+        /* dwFileOffsetHigh = */ 0,
+        /* dwFileOffsetLow = */ 0,
+        /* dwNumberOfBytesToMap = */ 0);
+
+    if (view == NULL)
+    {
+        CloseHandle(handle);
+        return NULL;
+    }
+
+    mapping->handle = handle;
+
+    return view;
+}
+
 CT_LOCAL os_error_t impl_unmap(os_mapping_t *map)
 {
     if (!UnmapViewOfFile(map->view))
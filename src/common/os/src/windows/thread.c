@@ -70,3 +70,98 @@ os_thread_id_t os_get_thread_id(void)
 {
     return GetCurrentThreadId();
 }
+
+void os_thread_yield(void)
+{
+    SwitchToThread();
+}
+
+///
+/// mutexes
+///
+
+STA_DECL
+os_error_t os_mutex_init(os_mutex_t *mutex, const char *name)
+{
+    CTASSERT(mutex != NULL);
+    CTASSERT(name != NULL);
+
+    mutex->name = name;
+    InitializeCriticalSection(&mutex->impl);
+
+    return eOsSuccess;
+}
+
+STA_DECL
+void os_mutex_destroy(os_mutex_t *mutex)
+{
+    CTASSERT(mutex != NULL);
+
+    DeleteCriticalSection(&mutex->impl);
+}
+
+STA_DECL
+void os_mutex_lock(os_mutex_t *mutex)
+{
+    CTASSERT(mutex != NULL);
+
+    EnterCriticalSection(&mutex->impl);
+}
+
+STA_DECL
+void os_mutex_unlock(os_mutex_t *mutex)
+{
+    CTASSERT(mutex != NULL);
+
+    LeaveCriticalSection(&mutex->impl);
+}
+
+///
+/// condition variables
+///
+
+STA_DECL
+os_error_t os_cond_init(os_cond_t *cond, const char *name)
+{
+    CTASSERT(cond != NULL);
+    CTASSERT(name != NULL);
+
+    cond->name = name;
+    InitializeConditionVariable(&cond->impl);
+
+    return eOsSuccess;
+}
+
+STA_DECL
+void os_cond_destroy(os_cond_t *cond)
+{
+    CTASSERT(cond != NULL);
+
+    // condition variables do not need to be destroyed on windows
+}
+
+STA_DECL
+void os_cond_wait(os_cond_t *cond, os_mutex_t *mutex)
+{
+    CTASSERT(cond != NULL);
+    CTASSERT(mutex != NULL);
+
+    BOOL ok = SleepConditionVariableCS(&cond->impl, &mutex->impl, INFINITE);
+    CTASSERTF(ok, "failed to wait on condition %s (%lu)", cond->name, GetLastError());
+}
+
+STA_DECL
+void os_cond_signal(os_cond_t *cond)
+{
+    CTASSERT(cond != NULL);
+
+    WakeConditionVariable(&cond->impl);
+}
+
+STA_DECL
+void os_cond_broadcast(os_cond_t *cond)
+{
+    CTASSERT(cond != NULL);
+
+    WakeAllConditionVariable(&cond->impl);
+}
@@ -24,7 +24,8 @@ typedef struct node_t
     /// @brief the scanner that this node is in
     const scan_t *scan;
 
-    /// @brief the location of this node
+    /// @brief the span of this node inside its source file
+    /// line and column are resolved from this when reporting diagnostics
     where_t where;
 } node_t;
 
@@ -39,11 +40,11 @@ CT_SCAN_API extern const where_t kNowhere;
 CT_NODISCARD CT_PUREFN
 CT_SCAN_API const scan_t *node_get_scan(IN_NOTNULL const node_t *node);
 
-/// @brief get the location of a node inside its source file
+/// @brief get the span of a node inside its source file
 ///
-/// @param node the node to get the location of
+/// @param node the node to get the span of
 ///
-/// @return the location of @p node
+/// @return the span of @p node
 CT_NODISCARD CT_PUREFN
 CT_SCAN_API where_t node_get_location(IN_NOTNULL const node_t *node);
 
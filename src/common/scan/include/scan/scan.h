@@ -128,6 +128,7 @@ CT_SCAN_API size_t scan_read(
     size_t size);
 
 /// @brief create a scanner from an io source
+/// @pre the source is at most UINT32_MAX bytes, spans in a @a where_t are 32 bits
 ///
 /// @param language the language of the source
 /// @param io the io source to use
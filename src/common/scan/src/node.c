@@ -5,7 +5,7 @@
 #include "base/panic.h"
 #include "arena/arena.h"
 
-const where_t kNowhere = { 0, 0, 0, 0 };
+const where_t kNowhere = { 0, 0 };
 
 STA_DECL
 node_t *node_builtin(const char *name, arena_t *arena)
@@ -9,6 +9,8 @@
 #include "arena/arena.h"
 #include "io/io.h"
 
+#include <stdint.h>
+
 static scan_t *scan_new(const char *language, const char *path, io_t *io, arena_t *arena)
 {
     CTASSERT(language != NULL);
@@ -133,6 +135,9 @@ scan_t *scan_io(const char *language, io_t *io, arena_t *arena)
 
     CTASSERTF(region != NULL, "failed to map %s of size %zu (%s)", path, size, os_error_string(io_error(io), arena));
 
+    // every location in the source must fit in a where_t
+    CTASSERTF(size <= UINT32_MAX, "source %s is %zu bytes, sources are limited to %u bytes", path, size, UINT32_MAX);
+
     scan_t *self = scan_new(language, path, io, arena);
 
     self->mapped = text_view_make(region, size);
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_std_api.h>
+
+#include "core/analyze.h"
+#include "core/text.h"
+#include "core/types.h"
+
+#include "std/typeinfo.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+CT_BEGIN_API
+
+typedef struct arena_t arena_t;
+
+/// @defgroup atom Interned strings
+/// @ingroup standard
+/// @brief Canonical interned strings
+/// an atom is a null terminated string that is stored exactly once in an atom table.
+/// two atoms from the same table are equal if and only if their pointers are equal.
+/// atoms are prefixed with their hash and length so neither needs to be recomputed.
+/// interning is safe to call from multiple threads at once.
+/// @{
+
+/// @brief an atom table
+typedef struct atom_table_t atom_table_t;
+
+/// @brief create a new atom table
+/// @note atoms are never released until the arena backing the table is
+///
+/// @param size the initial number of atoms the table can hold without growing
+/// @param arena the arena to allocate from
+///
+/// @return the new atom table
+CT_NODISCARD
+CT_STD_API atom_table_t *atom_table_new(IN_DOMAIN(>, 0) size_t size, IN_NOTNULL arena_t *arena);
+
+/// @brief get the number of atoms in a table
+///
+/// @param table the table to query
+///
+/// @return the number of unique atoms in @p table
+CT_NODISCARD
+CT_STD_API size_t atom_table_count(IN_NOTNULL atom_table_t *table);
+
+/// @brief intern a string
+///
+/// @param table the table to intern into
+/// @param text the string to intern
+///
+/// @return the canonical atom for @p text
+CT_NODISCARD
+CT_STD_API const char *atom_intern(IN_NOTNULL atom_table_t *table, IN_STRING const char *text);
+
+/// @brief intern a string with a known length
+/// @note @p text does not need to be null terminated, the atom always is
+///
+/// @param table the table to intern into
+/// @param text the text to intern
+///
+/// @return the canonical atom for @p text
+CT_NODISCARD
+CT_STD_API const char *atom_intern_text(IN_NOTNULL atom_table_t *table, text_view_t text);
+
+/// @brief get the precomputed hash of an atom
+/// @pre @p atom must have been returned by @ref atom_intern or @ref atom_intern_text
+///
+/// @param atom the atom
+///
+/// @return the hash of @p atom, this is the same as @ref str_hash
+CT_NODISCARD CT_PUREFN
+CT_STD_API ctu_hash_t atom_hash(IN_NOTNULL const char *atom);
+
+/// @brief get the length of an atom
+/// @pre @p atom must have been returned by @ref atom_intern or @ref atom_intern_text
+///
+/// @param atom the atom
+///
+/// @return the length of @p atom, not including the null terminator
+CT_NODISCARD CT_PUREFN
+CT_STD_API size_t atom_length(IN_NOTNULL const char *atom);
+
+/// @brief type information for an atom
+/// hashing reads the precomputed hash and equality is pointer equality
+/// @warning every key used with this type info must be an atom from the same table
+CT_STD_API extern const hash_info_t kTypeInfoAtom;
+
+/// @} // atom
+
+CT_END_API
@@ -27,11 +27,22 @@ typedef struct vector_t vector_t;
 /// the map interface provides a @a map_new and a @a map_optimal function for performance reasons.
 /// its recommended to use @a map_optimal if you have an estimate of the number of elements in the map.
 ///
+/// by default the map keeps its entries in a dense array in insertion order,
+/// an open addressed robin hood table indexes into it. iteration walks the dense
+/// array so it visits entries in the order they were first inserted, this keeps
+/// output that depends on iteration order reproducible between runs.
+/// the older separately chained map can be selected at configure time with
+/// `-Dmap_impl=chained`, it does not preserve insertion order.
+/// CTU_MAP_ORDERED in ctu_core_config.h is 1 when maps preserve insertion order.
+///
 /// @{
 
 /// @brief a single node in a map
 typedef struct bucket_t bucket_t;
 
+/// @brief a slot in the index table of a map
+typedef struct map_slot_t map_slot_t;
+
 /// @brief an unordered hash map
 /// @warning this is an opaque type, do not access its members directly aside from 0-initializing it.
 typedef struct map_t
@@ -39,17 +50,31 @@ typedef struct map_t
     /// @brief the arena this map allocates from
     arena_t *arena;
 
+    /// @brief pool for chained buckets, layered on @a arena
+    /// created when the first collision happens
+    /// only used by the chained implementation
+    arena_t *pool;
+
     /// @brief the hash function for this map
     hash_info_t info;
 
     /// @brief the number of top level buckets
+    /// with the default implementation this is the number of index slots, always a power of 2
     STA_FIELD_RANGE(>, 0) size_t size;
 
     /// @brief the number of buckets used
     STA_FIELD_RANGE(<, size) size_t used;
 
     /// @brief bucket data
-    STA_FIELD_SIZE(size) bucket_t *data;
+    /// with the default implementation these are the entries in insertion order
+    bucket_t *data;
+
+    /// @brief the index table, only used by the default implementation
+    STA_FIELD_SIZE(size) map_slot_t *slots;
+
+    /// @brief the number of entries appended to @a data, including deleted entries
+    /// only used by the default implementation
+    size_t length;
 } map_t;
 
 /// @brief an empty map
@@ -131,6 +156,7 @@ CT_STD_API bool map_contains(IN_NOTNULL const map_t *map, IN_NOTNULL const void
 
 /// @brief delete a key-value pair from a map
 /// @note this does no memory management, it only removes the key-value pair from the map
+/// @note setting the key again afterwards places it at the end of the iteration order
 ///
 /// @param map the map to delete the key-value pair from
 /// @param key the key to delete
@@ -139,6 +165,7 @@ CT_STD_API bool map_contains(IN_NOTNULL const map_t *map, IN_NOTNULL const void
 CT_STD_API bool map_delete(IN_NOTNULL map_t *map, IN_NOTNULL const void *key);
 
 /// @brief collect all the values from a map into a vector
+/// the values are in iteration order
 ///
 /// @param map the map to collect the values from
 ///
@@ -147,7 +174,7 @@ CT_NODISCARD
 CT_STD_API vector_t *map_values(IN_NOTNULL map_t *map);
 
 /// @brief collect all key-value pairs in a map into a vector
-/// returns a typevec_t<map_entry_t>
+/// returns a typevec_t<map_entry_t> in iteration order
 ///
 /// @param map the map to collect the key-value pairs from
 ///
@@ -182,15 +209,16 @@ typedef struct map_entry_t
 typedef struct map_iter_t
 {
     const map_t *map;   ///< the map being iterated over
-    size_t index; ///< current top level bucket index
+    size_t index; ///< current top level bucket index, or the entry after @a next
 
     bucket_t *bucket; ///< the current bucket
-    bucket_t *next;   ///< the next bucket in the chain
+    bucket_t *next;   ///< the bucket after @a bucket
 } map_iter_t;
 
 /// @brief create a new map iterator
 /// @warning iterators are invalidated by any operation that modifies the map.
-/// @note iteration order is unspecified.
+/// @note entries are visited in insertion order, unless the map was configured
+///       with `-Dmap_impl=chained` where the order is unspecified.
 ///
 /// @param map the map to iterate over
 ///
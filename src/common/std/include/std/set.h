@@ -15,12 +15,13 @@ typedef struct arena_t arena_t;
 /// @defgroup hash_set Unordered set
 /// @ingroup standard
 /// @brief Hash set
+/// an open addressed set that probes the control bytes of 16 slots at once.
 /// @{
 
 /// @brief an unordered hash set
 typedef struct set_t set_t;
 
-/// @brief a single node in a set
+/// @brief a single slot in a set
 typedef struct item_t item_t;
 
 /// @brief create a new set
@@ -42,6 +43,22 @@ CT_STD_API set_t *set_new(IN_DOMAIN(>, 0) size_t size, hash_info_t info, IN_NOTN
 /// @return the key that was added, or the existing key if it already exists
 CT_STD_API const void *set_add(IN_NOTNULL set_t *set, IN_NOTNULL const void *key);
 
+/// @brief add many keys to a set
+/// the set is grown at most once rather than as each key is added
+/// @pre every key in @p keys is not NULL
+///
+/// @param set the set to add the keys to
+/// @param keys the keys to add
+/// @param count the number of keys in @p keys
+CT_STD_API void set_add_many(IN_NOTNULL set_t *set, STA_READS(count) const void *const *keys, size_t count);
+
+/// @brief add every key in one set to another
+/// @pre both sets must use the same type info
+///
+/// @param set the set to add the keys to
+/// @param other the set to take the keys from
+CT_STD_API void set_union(IN_NOTNULL set_t *set, IN_NOTNULL const set_t *other);
+
 /// @brief check if a set contains a key
 /// @pre @p key is not NULL
 ///
@@ -67,6 +84,14 @@ CT_STD_API void set_delete(IN_NOTNULL set_t *set, IN_NOTNULL const void *key);
 CT_NODISCARD CT_PUREFN
 CT_STD_API bool set_empty(IN_NOTNULL set_t *set);
 
+/// @brief get the number of keys in a set
+///
+/// @param set the set to check
+///
+/// @return the number of keys in @p set
+CT_NODISCARD CT_PUREFN
+CT_STD_API size_t set_count(IN_NOTNULL const set_t *set);
+
 /// @brief clear all keys from a set
 ///
 /// @param set the set to clear
@@ -77,7 +102,7 @@ CT_STD_API void set_reset(IN_NOTNULL set_t *set);
 typedef struct set_iter_t
 {
     set_t *set; ///< the set to iterate over
-    size_t index; ///< the current bucket index
+    size_t index; ///< the slot after @a next
 
     item_t *current; ///< the current item
     item_t *next; ///< the next item
@@ -54,6 +54,29 @@ CT_STD_API size_t str_vsprintf(STA_WRITES(len) char *str, size_t len, IN_STRING
 STA_PRINTF(3, 4)
 CT_STD_API size_t str_sprintf(STA_WRITES(len) char *str, size_t len, STA_FORMAT_STRING const char *fmt, ...);
 
+/// @brief a sink for formatted text
+///
+/// @param user the user data passed to @a str_vstream
+/// @param text the formatted text, not nul terminated
+/// @param len the length of @p text
+typedef void (*str_stream_t)(void *user, STA_READS(len) const char *text, size_t len);
+
+/// @brief format a string in chunks
+///
+/// format a string with a va_list and printf-like syntax, passing the output
+/// to @p fn in chunks as it is formatted. the chunks are formatted into a buffer
+/// on the stack, when stb_sprintf is available this never allocates. otherwise
+/// output that does not fit on the stack is formatted a second time into @p arena.
+///
+/// @param fn the function to pass each chunk to
+/// @param user the user data to pass to @p fn
+/// @param arena the arena to allocate long output in
+/// @param fmt the format string
+/// @param args the arguments to format
+///
+/// @return the total number of characters formatted
+CT_STD_API size_t str_vstream(IN_NOTNULL str_stream_t fn, void *user, IN_NOTNULL arena_t *arena, IN_STRING const char *fmt, va_list args);
+
 /// @brief format a string
 ///
 /// format a string with printf-like syntax into a text buffer.
@@ -399,6 +422,39 @@ CT_STD_API char str_tolower(char c);
 CT_NODISCARD CT_CONSTFN
 CT_STD_API char str_toupper(char c);
 
+/// @brief instruction sets the string search functions can use
+typedef enum str_isa_t
+{
+    eStrIsaScalar,
+    eStrIsaSse2,
+    eStrIsaAvx2,
+    eStrIsaNeon,
+
+    eStrIsaCount
+} str_isa_t;
+
+/// @brief get the instruction set the string search functions are using
+/// the best one supported by the cpu is chosen at startup
+///
+/// @return the instruction set in use
+CT_STD_API str_isa_t str_get_isa(void);
+
+/// @brief force the string search functions to use an instruction set
+/// @note this is intended for tests and benchmarks
+///
+/// @param isa the instruction set to use
+///
+/// @return true if @p isa is supported and now in use
+CT_STD_API bool str_set_isa(str_isa_t isa);
+
+/// @brief get the name of an instruction set
+///
+/// @param isa the instruction set
+///
+/// @return the name of @p isa
+CT_NODISCARD CT_CONSTFN
+CT_STD_API const char *str_isa_name(str_isa_t isa);
+
 /// @brief check if two strings are equal
 ///
 /// @param lhs the left hand side of the comparison
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_std_api.h>
+
+#include "core/analyze.h"
+#include "core/text.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+
+CT_BEGIN_API
+
+typedef struct arena_t arena_t;
+
+/// @defgroup string_builder String builder
+/// @ingroup standard
+/// @brief Append only string builder
+///
+/// builds a string in place rather than formatting and joining
+/// many temporary strings. the contents are always nul terminated.
+/// @{
+
+/// @brief a growable string
+/// @warning this is an opaque type, do not access its members directly.
+typedef struct strbuf_t
+{
+    arena_t *arena;
+
+    /// @brief the number of bytes allocated, including the nul terminator
+    size_t size;
+
+    /// @brief the length of the string
+    size_t used;
+
+    /// @brief the string
+    STA_FIELD_SIZE(size) char *data;
+} strbuf_t;
+
+/// @brief initialize a string builder
+///
+/// @param buf the builder to initialize
+/// @param size the initial capacity of the builder
+/// @param arena the arena to allocate from
+CT_STD_API void strbuf_init(OUT_NOTNULL strbuf_t *buf, size_t size, IN_NOTNULL arena_t *arena);
+
+/// @brief create a new string builder on the heap
+///
+/// @param size the initial capacity of the builder
+/// @param arena the arena to allocate from
+///
+/// @return the new builder
+CT_NODISCARD
+CT_STD_API strbuf_t *strbuf_new(size_t size, IN_NOTNULL arena_t *arena);
+
+/// @brief get the length of the built string
+///
+/// @param buf the builder
+///
+/// @return the length of the string
+CT_NODISCARD CT_PUREFN
+CT_STD_API size_t strbuf_len(IN_NOTNULL const strbuf_t *buf);
+
+/// @brief get the built string
+/// @warning the string is invalidated by the next append
+///
+/// @param buf the builder
+///
+/// @return the nul terminated string
+CT_NODISCARD CT_PUREFN
+CT_STD_API const char *strbuf_data(IN_NOTNULL const strbuf_t *buf);
+
+/// @brief get a view of the built string
+/// @warning the view is invalidated by the next append
+///
+/// @param buf the builder
+///
+/// @return a view of the string
+CT_NODISCARD CT_PUREFN
+CT_STD_API text_view_t strbuf_view(IN_NOTNULL const strbuf_t *buf);
+
+/// @brief copy the built string into an arena
+///
+/// @param buf the builder
+/// @param arena the arena to allocate the copy in
+///
+/// @return the copy
+CT_NODISCARD
+CT_STD_API char *strbuf_dup(IN_NOTNULL const strbuf_t *buf, IN_NOTNULL arena_t *arena);
+
+/// @brief empty the builder, keeping its storage
+///
+/// @param buf the builder
+CT_STD_API void strbuf_reset(IN_NOTNULL strbuf_t *buf);
+
+/// @brief shorten the built string
+/// @pre @p len <= @a strbuf_len(buf)
+///
+/// @param buf the builder
+/// @param len the new length
+CT_STD_API void strbuf_truncate(IN_NOTNULL strbuf_t *buf, size_t len);
+
+/// @brief append a character
+///
+/// @param buf the builder
+/// @param c the character to append
+CT_STD_API void strbuf_append_char(IN_NOTNULL strbuf_t *buf, char c);
+
+/// @brief append a string
+///
+/// @param buf the builder
+/// @param str the string to append
+CT_STD_API void strbuf_append(IN_NOTNULL strbuf_t *buf, IN_STRING const char *str);
+
+/// @brief append a string of known length
+///
+/// @param buf the builder
+/// @param str the string to append
+/// @param len the length of @p str
+CT_STD_API void strbuf_appendn(IN_NOTNULL strbuf_t *buf, STA_READS(len) const char *str, size_t len);
+
+/// @brief append formatted text
+///
+/// @param buf the builder
+/// @param fmt the format string
+/// @param ... the arguments to format
+///
+/// @return the number of bytes appended
+STA_PRINTF(2, 3)
+CT_STD_API size_t strbuf_printf(IN_NOTNULL strbuf_t *buf, STA_FORMAT_STRING const char *fmt, ...);
+
+/// @brief append formatted text with a va_list
+///
+/// @param buf the builder
+/// @param fmt the format string
+/// @param args the arguments to format
+///
+/// @return the number of bytes appended
+CT_STD_API size_t strbuf_vprintf(IN_NOTNULL strbuf_t *buf, IN_STRING const char *fmt, va_list args);
+
+/// @}
+
+CT_END_API
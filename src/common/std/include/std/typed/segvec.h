@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <ctu_std_api.h>
+
+#include "core/analyze.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+CT_BEGIN_API
+
+typedef struct arena_t arena_t;
+
+/// @defgroup segmented_vector Segmented vector
+/// @ingroup standard
+/// @brief Typed vector with stable element addresses
+///
+/// elements are stored in segments that double in size, once an element
+/// is pushed it is never moved. pointers returned by @a segvec_push and
+/// @a segvec_offset stay valid until the vector is reset.
+/// @{
+
+/// @brief A segmented vector with a fixed type size.
+/// @warning this is an opaque type, do not access its members directly aside from 0-initializing it.
+typedef struct segvec_t
+{
+    arena_t *arena;
+
+    /// @brief log2 of the number of elements in the first segment.
+    size_t shift;
+
+    /// @brief The number of elements used.
+    size_t used;
+
+    /// @brief The size of each element.
+    size_t width;
+
+    /// @brief The number of segments allocated.
+    size_t count;
+
+    /// @brief The number of entries in @a segments.
+    size_t capacity;
+
+    /// @brief The segments, segment n holds (1 << shift) << n elements.
+    STA_FIELD_SIZE(capacity) void **segments;
+} segvec_t;
+
+/// @brief a cursor over the elements of a segmented vector
+/// @warning pushing to the vector while iterating is invalid
+typedef struct segvec_iter_t
+{
+    const segvec_t *vec;
+
+    /// @brief the segment @a cursor is in
+    size_t segment;
+
+    /// @brief the next element
+    char *cursor;
+
+    /// @brief the end of the used part of the current segment
+    char *end;
+} segvec_iter_t;
+
+/// @brief initialize a segmented vector
+///
+/// @param vec the vector to initialize
+/// @param width the size of the type
+/// @param len the expected length of the vector, sizes the first segment
+/// @param arena the arena to allocate from
+CT_STD_API void segvec_init(IN_NOTNULL segvec_t *vec, IN_DOMAIN(>, 0) size_t width, size_t len, IN_NOTNULL arena_t *arena);
+
+/// @brief create a new segmented vector on the heap
+///
+/// @param width the size of the type
+/// @param len the expected length of the vector, sizes the first segment
+/// @param arena the arena to allocate from
+///
+/// @return the new vector
+CT_NODISCARD
+CT_STD_API segvec_t *segvec_new(IN_DOMAIN(>, 0) size_t width, size_t len, IN_NOTNULL arena_t *arena);
+
+/// @brief get the length of a segmented vector
+///
+/// @param vec the vector to get the length of
+/// @return the length of the vector
+CT_NODISCARD CT_PUREFN
+CT_STD_API size_t segvec_len(IN_NOTNULL const segvec_t *vec);
+
+/// @brief push a value onto the vector
+/// this copies @a width bytes from @p src to the end of the vector
+///
+/// @param vec the vector to push the value onto
+/// @param src the value to push
+///
+/// @return a pointer to the pushed value, valid until @a segvec_reset
+CT_STD_API void *segvec_push(IN_NOTNULL segvec_t *vec, IN_NOTNULL const void *src);
+
+/// @brief get a pointer to the value at the given index
+/// @pre @p index < @a segvec_len(vec)
+///
+/// @param vec the vector to get the value from
+/// @param index the index to get the value from
+/// @return a pointer to the value, valid until @a segvec_reset
+CT_NODISCARD CT_PUREFN
+CT_STD_API void *segvec_offset(IN_NOTNULL const segvec_t *vec, size_t index);
+
+/// @brief get an element from the vector
+/// @pre @p index < @a segvec_len(vec)
+///
+/// @param vec the vector to get the value from
+/// @param index the index to get the value from
+/// @param dst the destination to copy the value to
+CT_STD_API void segvec_get(IN_NOTNULL const segvec_t *vec, size_t index, STA_WRITES(vec->width) void *dst);
+
+/// @brief set an element in the vector
+/// @pre @p index < @a segvec_len(vec)
+///
+/// @param vec the vector to set the value in
+/// @param index the index to set the value at
+/// @param src the value to set
+CT_STD_API void segvec_set(IN_NOTNULL segvec_t *vec, size_t index, IN_NOTNULL const void *src);
+
+/// @brief reset a vector
+/// the segments are kept and reused by later pushes
+/// @warning this invalidates all pointers into the vector
+///
+/// @param vec the vector to reset
+CT_STD_API void segvec_reset(IN_NOTNULL segvec_t *vec);
+
+/// @brief create a cursor over a segmented vector
+///
+/// @param vec the vector to iterate over
+///
+/// @return the cursor
+CT_NODISCARD
+CT_STD_API segvec_iter_t segvec_iter(IN_NOTNULL const segvec_t *vec);
+
+/// @brief check if a cursor has more elements
+///
+/// @param iter the cursor to check
+///
+/// @return true if there are more elements
+CT_NODISCARD CT_PUREFN
+CT_STD_API bool segvec_has_next(IN_NOTNULL const segvec_iter_t *iter);
+
+/// @brief get the next element from a cursor
+/// @pre @a segvec_has_next(iter) is true
+///
+/// @param iter the cursor to advance
+///
+/// @return a pointer to the element
+CT_NODISCARD
+CT_STD_API void *segvec_next(IN_NOTNULL segvec_iter_t *iter);
+
+/// @}
+
+CT_END_API
@@ -59,6 +59,70 @@ CT_STD_API vector_t *vector_new(size_t size, IN_NOTNULL arena_t *arena);
 CT_NODISCARD
 CT_STD_API vector_t *vector_of(size_t len, IN_NOTNULL arena_t *arena);
 
+/// @brief the number of inline slots in a @a smallvec_t
+#define CT_SMALLVEC_SIZE 4
+
+/// @brief inline storage for a short vector
+/// most argument and parameter lists are only a handful of elements long,
+/// this lets them live on the stack or inside the node that owns them.
+/// use @a smallvec_of to get a vector backed by this storage.
+typedef struct smallvec_t
+{
+    void *header[4];
+    void *slots[CT_SMALLVEC_SIZE];
+} smallvec_t;
+
+/// @brief get the number of bytes required to place a vector
+///
+/// @param capacity the number of elements the vector can hold
+///
+/// @return the size of the storage required by @a vector_place
+CT_NODISCARD CT_CONSTFN
+CT_STD_API size_t vector_place_size(size_t capacity);
+
+/// @brief create a vector inside caller provided storage
+/// @note the vector moves into @p arena if it grows past @p capacity,
+///       @a vector_delete does nothing until then.
+/// @pre @p buffer is at least @a vector_place_size(capacity) bytes and pointer aligned
+///
+/// @param buffer the storage to place the vector in
+/// @param capacity the number of elements @p buffer can hold
+/// @param len the initial length of the vector
+/// @param arena the arena to allocate from if the vector grows
+///
+/// @return the placed vector
+CT_NODISCARD
+CT_STD_API vector_t *vector_place(
+    STA_WRITES(vector_place_size(capacity)) void *buffer,
+    size_t capacity,
+    size_t len,
+    IN_NOTNULL arena_t *arena);
+
+/// @brief copy a vector into caller provided storage
+/// @pre @p buffer is at least @a vector_place_size(vector_len(vector)) bytes
+///
+/// @param buffer the storage to place the copy in
+/// @param vector the vector to copy
+/// @param arena the arena to allocate from if the copy grows
+///
+/// @return the placed copy
+CT_NODISCARD
+CT_STD_API vector_t *vector_place_copy(
+    IN_NOTNULL void *buffer,
+    IN_NOTNULL const vector_t *vector,
+    IN_NOTNULL arena_t *arena);
+
+/// @brief create a vector with a specified length in small vector storage
+/// falls back to @a vector_of if @p len does not fit inline
+///
+/// @param storage the inline storage to use
+/// @param len the initial length of the vector
+/// @param arena the arena to allocate from
+///
+/// @return a new vector
+CT_NODISCARD
+CT_STD_API vector_t *smallvec_of(IN_NOTNULL smallvec_t *storage, size_t len, IN_NOTNULL arena_t *arena);
+
 /// @brief create a new vector with a single initial value
 ///
 /// this is equivalent to
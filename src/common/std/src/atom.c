@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "std/atom.h"
+
+#include "arena/arena.h"
+#include "arena/region.h"
+#include "base/panic.h"
+#include "base/spinlock.h"
+#include "base/util.h"
+
+#include "core/macros.h"
+
+// the size of each chunk of atom text requested from the arena
+#define ATOM_CHUNK_SIZE (64U * 1024U)
+
+/// every atom is preceded by this header, the text follows it directly
+typedef struct atom_header_t
+{
+    ctu_hash_t hash;
+    size_t length;
+} atom_header_t;
+
+typedef struct atom_table_t
+{
+    arena_t *arena; ///< the arena the slots are allocated from
+    arena_t *storage; ///< region holding the atom text
+
+    /// open addressed slots, always a power of 2 in size
+    STA_FIELD_SIZE(size) const char **slots;
+    size_t size;
+    size_t used;
+
+    /// guards every other field
+    spinlock_t lock;
+} atom_table_t;
+
+static const atom_header_t *get_header(const char *atom)
+{
+    return (const atom_header_t*)atom - 1;
+}
+
+// the smallest power of 2 with room for size atoms under the load factor
+static size_t get_slot_count(size_t size)
+{
+    size_t count = 16;
+    while (count * 3 <= size * 4)
+        count *= 2;
+
+    return count;
+}
+
+static const char **slots_new(size_t size, atom_table_t *table)
+{
+    const char **slots = ARENA_MALLOC(sizeof(const char*) * size, "atom_slots", table, table->arena);
+    ctu_memset(slots, 0, sizeof(const char*) * size);
+    return slots;
+}
+
+static void table_grow(atom_table_t *table)
+{
+    size_t size = table->size * 2;
+    size_t mask = size - 1;
+    const char **slots = slots_new(size, table);
+
+    for (size_t i = 0; i < table->size; i++)
+    {
+        const char *atom = table->slots[i];
+        if (atom == NULL) continue;
+
+        size_t index = get_header(atom)->hash & mask;
+        while (slots[index] != NULL)
+            index = (index + 1) & mask;
+
+        slots[index] = atom;
+    }
+
+    arena_free(table->slots, sizeof(const char*) * table->size, table->arena);
+    table->slots = slots;
+    table->size = size;
+}
+
+static const char *atom_new(atom_table_t *table, text_view_t text, ctu_hash_t hash)
+{
+    atom_header_t *header = ARENA_MALLOC(sizeof(atom_header_t) + text.length + 1, "atom", table, table->storage);
+    header->hash = hash;
+    header->length = text.length;
+
+    char *atom = (char*)(header + 1);
+    ctu_memcpy(atom, text.text, text.length);
+    atom[text.length] = '\0';
+
+    return atom;
+}
+
+static bool atom_matches(const char *atom, text_view_t text, ctu_hash_t hash)
+{
+    const atom_header_t *header = get_header(atom);
+    if (header->hash != hash) return false;
+
+    text_view_t view = { .text = atom, .length = header->length };
+    return text_equal(view, text);
+}
+
+STA_DECL
+atom_table_t *atom_table_new(size_t size, arena_t *arena)
+{
+    CTASSERT(size > 0);
+    CTASSERT(arena != NULL);
+
+    atom_table_t *table = ARENA_MALLOC(sizeof(atom_table_t), "atom_table", NULL, arena);
+    table->arena = arena;
+    table->storage = region_new("atoms", ATOM_CHUNK_SIZE, arena);
+    table->size = get_slot_count(size);
+    table->used = 0;
+    table->slots = slots_new(table->size, table);
+    spinlock_t lock = CT_SPINLOCK_INIT;
+    table->lock = lock;
+
+    ARENA_REPARENT(table->storage, table, arena);
+
+    return table;
+}
+
+STA_DECL
+size_t atom_table_count(atom_table_t *table)
+{
+    CTASSERT(table != NULL);
+
+    spinlock_acquire(&table->lock);
+    size_t count = table->used;
+    spinlock_release(&table->lock);
+
+    return count;
+}
+
+STA_DECL
+const char *atom_intern(atom_table_t *table, const char *text)
+{
+    CTASSERT(text != NULL);
+
+    text_view_t view = { .text = text, .length = ctu_strlen(text) };
+    return atom_intern_text(table, view);
+}
+
+STA_DECL
+const char *atom_intern_text(atom_table_t *table, text_view_t text)
+{
+    CTASSERT(table != NULL);
+    CTASSERT(text.text != NULL);
+
+    // hash before taking the lock to keep the critical section short
+    ctu_hash_t hash = text_hash(text);
+
+    spinlock_acquire(&table->lock);
+
+    size_t mask = table->size - 1;
+    size_t index = hash & mask;
+    const char *atom = NULL;
+    while ((atom = table->slots[index]) != NULL)
+    {
+        if (atom_matches(atom, text, hash))
+        {
+            spinlock_release(&table->lock);
+            return atom;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    atom = atom_new(table, text, hash);
+    table->slots[index] = atom;
+    table->used += 1;
+
+    // keep the load factor under 3/4
+    if (table->used * 4 >= table->size * 3)
+        table_grow(table);
+
+    spinlock_release(&table->lock);
+
+    return atom;
+}
+
+STA_DECL
+ctu_hash_t atom_hash(const char *atom)
+{
+    CTASSERT(atom != NULL);
+
+    return get_header(atom)->hash;
+}
+
+STA_DECL
+size_t atom_length(const char *atom)
+{
+    CTASSERT(atom != NULL);
+
+    return get_header(atom)->length;
+}
+
+static ctu_hash_t info_atom_hash(const void *key)
+{
+    return get_header(key)->hash;
+}
+
+static bool info_atom_equal(const void *lhs, const void *rhs)
+{
+    return lhs == rhs;
+}
+
+const hash_info_t kTypeInfoAtom = {
+    .size = sizeof(const char*),
+    .hash = info_atom_hash,
+    .equals = info_atom_equal,
+};
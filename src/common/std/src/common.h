@@ -2,10 +2,15 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "core/compiler.h"
 #include "core/types.h"
 
+// open addressed tables select slots by masking the low bits of a hash,
+// many of our hash functions have poorly distributed low bits so they are mixed first
+CT_LOCAL ctu_hash_t info_mix_hash(ctu_hash_t hash);
+
 CT_LOCAL ctu_hash_t info_ptr_hash(const void *key);
 CT_LOCAL bool info_ptr_equal(const void *lhs, const void *rhs);
 
@@ -14,3 +19,21 @@ CT_LOCAL bool info_str_equal(const void *lhs, const void *rhs);
 
 CT_LOCAL ctu_hash_t info_text_hash(const void *key);
 CT_LOCAL bool info_text_equal(const void *lhs, const void *rhs);
+
+// string kernels, the fastest implementation the cpu supports is picked at startup
+typedef struct str_simd_t
+{
+    // offset of the first sub in str or SIZE_MAX
+    size_t (*find)(const char *str, size_t len, const char *sub, size_t sublen);
+
+    // offset of the last sub in str or SIZE_MAX
+    size_t (*rfind)(const char *str, size_t len, const char *sub, size_t sublen);
+
+    // offset of the first byte in str that is also in set or SIZE_MAX
+    size_t (*find_any)(const char *str, size_t len, const char *set, size_t setlen);
+
+    // length of the prefix of str that doesnt need escaping
+    size_t (*clean_prefix)(const char *str, size_t len);
+} str_simd_t;
+
+CT_LOCAL const str_simd_t *str_simd(void);
@@ -4,35 +4,62 @@
 #include "base/panic.h"
 #include "arena/arena.h"
 
-#include "std/str.h"
+#include "core/macros.h"
+
 #include "std/vector.h"
 
 #include "std/typed/vector.h"
 
 #include "common.h"
 
-// TODO: add quadratic probing and robin hood hashing
+#include <stdint.h>
+
+// entries are stored in a dense array in insertion order.
+// an open addressed index table maps hashes to positions in that array,
+// it uses robin hood hashing, slots that are further from their ideal
+// position take the place of slots that are closer to theirs.
+// this keeps probe sequences short and lets lookups stop early.
+// deleting leaves a hole in the entry array and shifts following index
+// slots back rather than leaving tombstones. holes are compacted away
+// the next time the entry array fills up.
+
+// 75% load factor on the index table
+#define MAP_LOAD_NUM (3)
+#define MAP_LOAD_DEN (4)
+
+// smallest number of index slots a map is created with
+#define MAP_MIN_SIZE (4)
 
-// 90% load factor before resizing
-#define MAP_LOAD_FACTOR (90)
+// index of a slot that does not point to an entry
+#define MAP_EMPTY_SLOT SIZE_MAX
 
 /**
- * a bucket in a hashmap
+ * an entry in a hashmap
  */
 typedef struct bucket_t
 {
-    const void *key;       ///< the key
-    void *value;           ///< any pointer value
-    struct bucket_t *next; ///< the next bucket in the chain
+    const void *key;  ///< the key, NULL if this entry was deleted
+    void *value;      ///< any pointer value
+    ctu_hash_t hash;  ///< the hash of the key
 } bucket_t;
 
-static bucket_t gEmptyBucket = {0};
+/**
+ * a slot in the index table
+ */
+typedef struct map_slot_t
+{
+    ctu_hash_t hash; ///< the hash of the entry this slot points to
+    size_t index;    ///< the index of the entry, MAP_EMPTY_SLOT if this slot is empty
+} map_slot_t;
+
+static map_slot_t gEmptySlot = { .hash = 0, .index = MAP_EMPTY_SLOT };
 
 // TODO: this is a bit of a bodge, but using extern const values
 // in a static initializer isn't possible in C
 
 const map_t kEmptyMap = {
     .arena = NULL,
+    .pool = NULL,
     .info = {
         .size = sizeof(void *),
         .hash = info_ptr_hash,
@@ -40,43 +67,59 @@ const map_t kEmptyMap = {
     },
     .size = 1,
     .used = 0,
-    .data = &gEmptyBucket,
+    .data = NULL,
+    .slots = &gEmptySlot,
+    .length = 0,
 };
 
-// generic map functions
+static size_t next_pow2(size_t size)
+{
+    size_t result = MAP_MIN_SIZE;
+    while (result < size)
+        result *= 2;
+
+    return result;
+}
 
-static bucket_t *impl_bucket_new(const void *key, void *value, arena_t *arena)
+// the number of entries a map can hold before the index table is full
+CT_CONSTFN
+static size_t get_capacity(size_t size)
 {
-    bucket_t *entry = ARENA_MALLOC(sizeof(bucket_t), "bucket", NULL, arena);
-    entry->key = key;
-    entry->value = value;
-    entry->next = NULL;
-    return entry;
+    return (size * MAP_LOAD_NUM) / MAP_LOAD_DEN;
 }
 
 CT_HOTFN CT_PUREFN
-static bucket_t *map_get_bucket(map_t *map, ctu_hash_t hash)
+static size_t get_mask(const map_t *map)
 {
-    size_t index = hash % map->size;
-    return &map->data[index];
+    return map->size - 1;
 }
 
+// how far a slot is from the position its hash wants
 CT_HOTFN CT_PUREFN
-static const bucket_t *map_get_bucket_const(const map_t *map, ctu_hash_t hash)
+static size_t get_distance(const map_t *map, const map_slot_t *slot, size_t index)
 {
-    size_t index = hash % map->size;
-    return &map->data[index];
+    return (index - (slot->hash & get_mask(map))) & get_mask(map);
 }
 
-static void clear_keys(bucket_t *buckets, size_t size)
+static void clear_slots(map_slot_t *slots, size_t size)
 {
     for (size_t i = 0; i < size; i++)
     {
-        buckets[i].key = NULL;
-        buckets[i].next = NULL;
+        slots[i].index = MAP_EMPTY_SLOT;
     }
 }
 
+static void map_alloc_data(map_t *map, size_t size)
+{
+    map->size = size;
+    map->used = 0;
+    map->length = 0;
+    map->data = ARENA_MALLOC(sizeof(bucket_t) * get_capacity(size), "entries", map, map->arena);
+    map->slots = ARENA_MALLOC(sizeof(map_slot_t) * size, "slots", map, map->arena);
+
+    clear_slots(map->slots, size);
+}
+
 STA_DECL
 void map_init(map_t *map, size_t size, hash_info_t info, arena_t *arena)
 {
@@ -90,13 +133,11 @@ void map_init(map_t *map, size_t size, hash_info_t info, arena_t *arena)
 
     map_t tmp = {
         .arena = arena,
+        .pool = NULL,
         .info = info,
-        .size = size,
-        .used = 0,
-        .data = ARENA_MALLOC(sizeof(bucket_t) * size, "buckets", NULL, arena),
     };
 
-    clear_keys(tmp.data, size);
+    map_alloc_data(&tmp, next_pow2(size));
 
     *map = tmp;
 }
@@ -114,23 +155,29 @@ map_t *map_new(size_t size, hash_info_t info, arena_t *arena)
 {
     map_t *map = ARENA_MALLOC(sizeof(map_t), "map", NULL, arena);
     map_init(map, size, info, arena);
-    ARENA_IDENTIFY(map->data, "buckets", map, arena);
+    ARENA_IDENTIFY(map->data, "entries", map, arena);
+    ARENA_IDENTIFY(map->slots, "slots", map, arena);
 
     return map;
 }
 
-#define MAP_FOREACH_APPLY(self, item, ...)      \
-    do                                          \
-    {                                           \
-        for (size_t i = 0; i < self->size; i++) \
-        {                                       \
-            bucket_t *item = &self->data[i];    \
-            while (item && item->key)           \
-            {                                   \
-                __VA_ARGS__;                    \
-                item = item->next;              \
-            }                                   \
-        }                                       \
+STA_DECL
+map_t *map_optimal(size_t size, hash_info_t info, arena_t *arena)
+{
+    // enough slots to hold size entries without resizing
+    size_t slots = (size * MAP_LOAD_DEN) / MAP_LOAD_NUM + 1;
+    return map_new(slots, info, arena);
+}
+
+#define MAP_FOREACH_APPLY(self, item, ...)        \
+    do                                            \
+    {                                             \
+        for (size_t i = 0; i < self->length; i++) \
+        {                                         \
+            bucket_t *item = &self->data[i];      \
+            if (item->key == NULL) continue;      \
+            __VA_ARGS__;                          \
+        }                                         \
     } while (0)
 
 STA_DECL
@@ -138,7 +185,7 @@ vector_t *map_values(map_t *map)
 {
     CTASSERT(map != NULL);
 
-    vector_t *result = vector_new(map->size, map->arena);
+    vector_t *result = vector_new(CT_MAX(map->used, 1), map->arena);
 
     MAP_FOREACH_APPLY(map, entry, {
         vector_push(&result, entry->value);
@@ -147,7 +194,7 @@ vector_t *map_values(map_t *map)
     return result;
 }
 
-static map_entry_t map_entry_new(const char *key, void *value)
+static map_entry_t map_entry_new(const void *key, void *value)
 {
     map_entry_t entry = {
         .key = key,
@@ -162,7 +209,7 @@ typevec_t *map_entries(map_t *map)
 {
     CTASSERT(map != NULL);
 
-    typevec_t *result = typevec_new(sizeof(map_entry_t), map->size, map->arena);
+    typevec_t *result = typevec_new(sizeof(map_entry_t), CT_MAX(map->used, 1), map->arena);
 
     MAP_FOREACH_APPLY(map, entry, {
         map_entry_t item = map_entry_new(entry->key, entry->value);
@@ -177,10 +224,7 @@ size_t map_count(const map_t *map)
 {
     CTASSERT(map != NULL);
 
-    size_t count = 0;
-    MAP_FOREACH_APPLY(map, entry, { count++; });
-
-    return count;
+    return map->used;
 }
 
 // info functions
@@ -189,7 +233,7 @@ CT_HOTFN
 static ctu_hash_t impl_key_hash(const map_t *map, const void *key)
 {
     const hash_info_t *info = &map->info;
-    return info->hash(key);
+    return info_mix_hash(info->hash(key));
 }
 
 CT_HOTFN
@@ -199,95 +243,87 @@ static bool impl_key_equal(const map_t *map, const void *lhs, const void *rhs)
     return info->equals(lhs, rhs);
 }
 
+// find the slot pointing to key, or NULL if it is not in the map
 CT_HOTFN
-static const bucket_t *impl_bucket_get_const(const map_t *map, const void *key)
-{
-    ctu_hash_t hash = impl_key_hash(map, key);
-    return map_get_bucket_const(map, hash);
-}
-
-CT_HOTFN
-static bucket_t *impl_bucket_get(map_t *map, const void *key)
-{
-    ctu_hash_t hash = impl_key_hash(map, key);
-    return map_get_bucket(map, hash);
-}
-
-static bool impl_entry_exists(const map_t *map, const bucket_t *bucket, const void *key)
+static map_slot_t *impl_find(const map_t *map, const void *key, ctu_hash_t hash)
 {
-    CTASSERT(bucket != NULL);
+    size_t mask = get_mask(map);
+    size_t index = hash & mask;
 
-    if (impl_key_equal(map, bucket->key, key))
-        return true;
-
-    if (bucket->next != NULL)
-        return impl_entry_exists(map, bucket->next, key);
-
-    return false;
-}
+    for (size_t distance = 0; ; distance++)
+    {
+        map_slot_t *slot = &map->slots[index];
+        if (slot->index == MAP_EMPTY_SLOT)
+            return NULL;
 
-// delete a bucket and reparent the next bucket
-static void impl_delete_bucket(bucket_t *previous, bucket_t *entry)
-{
-    CTASSERT(entry != NULL);
+        // any slot for key would have displaced this one
+        if (get_distance(map, slot, index) < distance)
+            return NULL;
 
-    entry->key = NULL;
-    entry->value = NULL;
+        if (slot->hash == hash && impl_key_equal(map, map->data[slot->index].key, key))
+            return slot;
 
-    if (previous != NULL)
-    {
-        previous->next = entry->next;
+        index = (index + 1) & mask;
     }
 }
 
-static bool impl_insert_into_bucket(map_t *map, bucket_t *bucket, const void *key, void *value)
+// place a slot for an entry that is known not to be in the index
+CT_HOTFN
+static void impl_insert_slot(map_t *map, map_slot_t slot)
 {
-    if (bucket->key == NULL)
+    size_t mask = get_mask(map);
+    size_t index = slot.hash & mask;
+    size_t distance = 0;
+
+    while (true)
     {
-        // track this as a new entry
-        map->used += 1;
+        map_slot_t *it = &map->slots[index];
+        if (it->index == MAP_EMPTY_SLOT)
+        {
+            *it = slot;
+            return;
+        }
 
-        bucket->key = key;
-        bucket->value = value;
-        return true;
-    }
+        size_t existing = get_distance(map, it, index);
+        if (existing < distance)
+        {
+            map_slot_t tmp = *it;
+            *it = slot;
+            slot = tmp;
+            distance = existing;
+        }
 
-    if (impl_key_equal(map, bucket->key, key))
-    {
-        bucket->value = value;
-        return true;
+        index = (index + 1) & mask;
+        distance += 1;
     }
-
-    return false;
 }
 
-CT_HOTFN
-static void impl_resize(map_t *map, size_t new_size)
+// rebuild the map with new_size index slots, this also
+// compacts away any entries that have been deleted
+static void impl_rebuild(map_t *map, size_t new_size)
 {
     bucket_t *old_data = map->data;
+    map_slot_t *old_slots = map->slots;
     size_t old_size = map->size;
+    size_t old_length = map->length;
 
-    // TODO: maybe resize the old data instead of allocating new data
-    map->size = new_size;
-    map->used = 0;
-    map->data = ARENA_MALLOC(sizeof(bucket_t) * new_size, "buckets", map, map->arena);
-    clear_keys(map->data, new_size);
+    map_alloc_data(map, new_size);
 
-    for (size_t i = 0; i < old_size; i++)
+    // the stored hashes mean keys never need to be rehashed
+    for (size_t i = 0; i < old_length; i++)
     {
-        bucket_t *entry = &old_data[i];
-        while (entry != NULL)
-        {
-            if (entry->key != NULL)
-            {
-                map_set(map, entry->key, entry->value);
-            }
+        bucket_t entry = old_data[i];
+        if (entry.key == NULL) continue;
 
-            entry = entry->next;
-        }
+        map_slot_t slot = { .hash = entry.hash, .index = map->length };
+        map->data[map->length++] = entry;
+        impl_insert_slot(map, slot);
     }
 
-    arena_free(old_data, sizeof(bucket_t) * old_size, map->arena);
+    map->used = map->length;
+
+    arena_free(old_data, sizeof(bucket_t) * get_capacity(old_size), map->arena);
+    arena_free(old_slots, sizeof(map_slot_t) * old_size, map->arena);
 }
 
 STA_DECL CT_HOTFN
@@ -296,28 +332,30 @@ void map_set(map_t *map, const void *key, void *value)
     CTASSERT(map != NULL);
     CTASSERT(key != NULL);
 
-    // if we are over the load factor, resize the map
-    if ((map->used * 100 / map->size) > MAP_LOAD_FACTOR)
-        impl_resize(map, map->size * 2);
+    ctu_hash_t hash = impl_key_hash(map, key);
+    map_slot_t *slot = impl_find(map, key, hash);
+    if (slot != NULL)
+    {
+        map->data[slot->index].value = value;
+        return;
+    }
 
-    // follow the chain
-    bucket_t *bucket = impl_bucket_get(map, key);
-    while (true)
+    // once the entry array is full grow the map, unless enough
+    // entries have been deleted that compacting them frees up space
+    size_t capacity = get_capacity(map->size);
+    if (map->length >= capacity)
     {
-        if (impl_insert_into_bucket(map, bucket, key, value))
-            return;
+        bool grow = (map->used + 1) * MAP_LOAD_DEN > capacity * MAP_LOAD_NUM;
+        impl_rebuild(map, grow ? map->size * 2 : map->size);
+    }
 
-        if (bucket->next == NULL)
-        {
-            map->used += 1;
+    bucket_t entry = { .key = key, .value = value, .hash = hash };
+    map_slot_t new_slot = { .hash = hash, .index = map->length };
 
-            bucket->next = impl_bucket_new(key, value, map->arena);
-            ARENA_REPARENT(bucket->next, bucket, map->arena);
-            return;
-        }
+    map->data[map->length++] = entry;
+    map->used += 1;
 
-        bucket = bucket->next;
-    }
+    impl_insert_slot(map, new_slot);
 }
 
 STA_DECL CT_HOTFN
@@ -335,16 +373,8 @@ void *map_get_default(const map_t *map, const void *key, void *other)
     CTASSERT(map != NULL);
     CTASSERT(key != NULL);
 
-    const bucket_t *bucket = impl_bucket_get_const(map, key);
-    while (bucket != NULL)
-    {
-        if (bucket->key != NULL && impl_key_equal(map, bucket->key, key))
-            return bucket->value;
-
-        bucket = bucket->next;
-    }
-
-    return other;
+    const map_slot_t *slot = impl_find(map, key, impl_key_hash(map, key));
+    return (slot != NULL) ? map->data[slot->index].value : other;
 }
 
 STA_DECL
@@ -353,8 +383,7 @@ bool map_contains(const map_t *map, const void *key)
     CTASSERT(map != NULL);
     CTASSERT(key != NULL);
 
-    const bucket_t *bucket = impl_bucket_get_const(map, key);
-    return impl_entry_exists(map, bucket, key);
+    return impl_find(map, key, impl_key_hash(map, key)) != NULL;
 }
 
 STA_DECL
@@ -363,23 +392,32 @@ bool map_delete(map_t *map, const void *key)
     CTASSERT(map != NULL);
     CTASSERT(key != NULL);
 
-    bucket_t *entry = impl_bucket_get(map, key);
-    bucket_t *previous = entry;
+    map_slot_t *slot = impl_find(map, key, impl_key_hash(map, key));
+    if (slot == NULL)
+        return false;
 
-    while (entry != NULL)
+    // leave a hole in the entries, unless this was the last one
+    size_t entry = slot->index;
+    map->data[entry].key = NULL;
+    map->data[entry].value = NULL;
+    if (entry + 1 == map->length)
+        map->length -= 1;
+
+    // shift every following displaced slot back by one
+    size_t mask = get_mask(map);
+    size_t index = (size_t)(slot - map->slots);
+    size_t next = (index + 1) & mask;
+    while (map->slots[next].index != MAP_EMPTY_SLOT && get_distance(map, &map->slots[next], next) > 0)
     {
-        if (entry->key != NULL && impl_key_equal(map, entry->key, key))
-        {
-            map->used -= 1;
-            impl_delete_bucket(previous, entry);
-            return true;
-        }
-
-        previous = entry;
-        entry = entry->next;
+        map->slots[index] = map->slots[next];
+        index = next;
+        next = (next + 1) & mask;
     }
 
-    return false;
+    map->slots[index].index = MAP_EMPTY_SLOT;
+    map->used -= 1;
+
+    return true;
 }
 
 STA_DECL
@@ -388,67 +426,27 @@ void map_reset(map_t *map)
     CTASSERT(map != NULL);
 
     map->used = 0;
-    clear_keys(map->data, map->size);
+    map->length = 0;
+    clear_slots(map->slots, map->size);
 }
 
 // iteration
 
-CT_PUREFN
-static bucket_t *map_next_in_chain(bucket_t *entry)
+static bucket_t *map_find_next_bucket(const map_t *map, size_t *index)
 {
-    if (entry == NULL || entry->key == NULL)
-    {
-        return NULL;
-    }
-
-    while (entry->next != NULL)
-    {
-        entry = entry->next;
-
-        if (entry->key != NULL)
-        {
-            return entry;
-        }
-    }
-
-    return NULL;
-}
-
-/**
- * @brief get the next bucket for an iterator
- *
- * @param map the map being iterated
- * @param index the current toplevel bucket index
- * @param previous the previous bucket that was returned
- * @return bucket_t* the next bucket or NULL if there are no more buckets
- */
-static bucket_t *map_find_next_bucket(const map_t *map, size_t *index, bucket_t *previous)
-{
-    bucket_t *entry = map_next_in_chain(previous);
-    if (entry != NULL)
-    {
-        return entry;
-    }
-
     size_t i = *index;
 
-    while (i < map->size)
+    while (i < map->length)
     {
-        entry = &map->data[i++];
+        bucket_t *entry = &map->data[i++];
         if (entry->key != NULL)
         {
             *index = i;
             return entry;
         }
-
-        entry = map_next_in_chain(entry);
-        if (entry != NULL)
-        {
-            *index = i;
-            return entry;
-        }
     }
 
+    *index = i;
     return NULL;
 }
 
@@ -459,8 +457,8 @@ map_iter_t map_iter(const map_t *map)
 
     size_t index = 0;
 
-    bucket_t *bucket = map_find_next_bucket(map, &index, NULL);
-    bucket_t *next = map_find_next_bucket(map, &index, bucket);
+    bucket_t *bucket = map_find_next_bucket(map, &index);
+    bucket_t *next = map_find_next_bucket(map, &index);
 
     map_iter_t iter = {
         .map = map,
@@ -483,7 +481,7 @@ map_entry_t map_next(map_iter_t *iter)
     };
 
     iter->bucket = iter->next;
-    iter->next = map_find_next_bucket(iter->map, &iter->index, iter->next);
+    iter->next = map_find_next_bucket(iter->map, &iter->index);
 
     return entry;
 }
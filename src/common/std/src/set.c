@@ -5,262 +5,475 @@
 
 #include "arena/arena.h"
 #include "base/panic.h"
+#include "base/util.h"
+
+#include "core/macros.h"
+
+#include "common.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SET_USE_SSE2 1
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define SET_USE_NEON 1
+#   include <arm_neon.h>
+#endif
+
+#if CT_CC_MSVC
+#   include <intrin.h>
+#endif
+
+// open addressing with a byte of control data per slot.
+// slots are split into groups of SET_GROUP_WIDTH, the control bytes of a
+// whole group are compared against a key at once with simd instructions.
+// a control byte is either empty, deleted, or holds the low 7 bits of the
+// hash of the key in that slot. the remaining hash bits select the first group.
+
+#define SET_GROUP_WIDTH (16)
+
+#define CTRL_EMPTY ((ctrl_t)0x80)
+#define CTRL_DELETED ((ctrl_t)0xFE)
+
+// 87.5% of slots can be filled before resizing
+#define SET_LOAD_NUM (7)
+#define SET_LOAD_DEN (8)
+
+typedef uint8_t ctrl_t;
+
+/// one bit per slot in a group
+typedef uint32_t group_mask_t;
 
 /**
- * @brief a node in a chain of set entries
+ * @brief a slot in a set
  */
 typedef struct item_t
 {
-    const void *key;     ///< the key to this bucket
-    struct item_t *next; ///< the next bucket in the chain
+    const void *key; ///< the key in this slot, only valid if the slot is full
 } item_t;
 
 typedef struct set_t
 {
     arena_t *arena; ///< the arena this set is allocated in
     hash_info_t info;
-    STA_FIELD_RANGE(0, SIZE_MAX) size_t size;   ///< the number of buckets
-    STA_FIELD_SIZE(size) item_t *items; ///< the buckets
+    STA_FIELD_RANGE(SET_GROUP_WIDTH, SIZE_MAX) size_t size; ///< the number of slots, always a power of 2
+    size_t used; ///< the number of keys in the set
+    size_t growth; ///< the number of empty slots that can be filled before resizing
+    STA_FIELD_SIZE(size) ctrl_t *ctrl; ///< control bytes
+    STA_FIELD_SIZE(size) item_t *items; ///< the slots
 } set_t;
 
-static item_t *item_new(const char *key, arena_t *arena)
+// group operations
+
+CT_CONSTFN
+static size_t mask_first(group_mask_t mask)
 {
-    item_t *item = ARENA_MALLOC(sizeof(item_t), "item", NULL, arena);
-    item->key = key;
-    item->next = NULL;
-    return item;
+#if CT_CC_MSVC
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return (size_t)__builtin_ctz(mask);
+#endif
 }
 
-static item_t *get_bucket_from_hash(set_t *set, size_t hash)
+#if SET_USE_NEON
+// neon has no movemask, narrow each lane to a single bit and sum them
+static group_mask_t neon_movemask(uint8x16_t value)
 {
-    size_t index = hash % set->size;
-    return &set->items[index];
+    static const uint8_t kBits[SET_GROUP_WIDTH] = {
+        1, 2, 4, 8, 16, 32, 64, 128,
+        1, 2, 4, 8, 16, 32, 64, 128
+    };
+
+    uint8x16_t bits = vandq_u8(value, vld1q_u8(kBits));
+    uint8x8_t lo = vget_low_u8(bits);
+    uint8x8_t hi = vget_high_u8(bits);
+
+    lo = vpadd_u8(lo, lo);
+    lo = vpadd_u8(lo, lo);
+    lo = vpadd_u8(lo, lo);
+
+    hi = vpadd_u8(hi, hi);
+    hi = vpadd_u8(hi, hi);
+    hi = vpadd_u8(hi, hi);
+
+    return (group_mask_t)vget_lane_u8(lo, 0) | ((group_mask_t)vget_lane_u8(hi, 0) << 8);
 }
+#endif
 
-static void clear_items(set_t *set)
+// find every slot in a group with a control byte equal to tag
+CT_HOTFN
+static group_mask_t group_match(const ctrl_t *group, ctrl_t tag)
 {
-    for (size_t i = 0; i < set->size; i++)
+#if SET_USE_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (group_mask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)tag)));
+#elif SET_USE_NEON
+    return neon_movemask(vceqq_u8(vld1q_u8(group), vdupq_n_u8(tag)));
+#else
+    group_mask_t mask = 0;
+    for (size_t i = 0; i < SET_GROUP_WIDTH; i++)
     {
-        item_t *item = &set->items[i];
-        item->key = NULL;
-        item->next = NULL;
+        if (group[i] == tag) mask |= (1u << i);
     }
+    return mask;
+#endif
 }
 
-STA_DECL
-set_t *set_new(size_t size, hash_info_t info, arena_t *arena)
+// find every slot in a group that does not hold a key
+CT_HOTFN
+static group_mask_t group_match_free(const ctrl_t *group)
 {
-    CTASSERT(size > 0);
-    CTASSERT(arena != NULL);
+#if SET_USE_SSE2
+    // empty and deleted are the only control bytes with the top bit set
+    return (group_mask_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#elif SET_USE_NEON
+    return neon_movemask(vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(group)), vdupq_n_s8(0)));
+#else
+    group_mask_t mask = 0;
+    for (size_t i = 0; i < SET_GROUP_WIDTH; i++)
+    {
+        if (group[i] & 0x80) mask |= (1u << i);
+    }
+    return mask;
+#endif
+}
 
-    set_t *set = ARENA_MALLOC(sizeof(set_t), "set", NULL, arena);
-    set->arena = arena;
-    set->info = info;
-    set->size = size;
-    set->items = ARENA_MALLOC(sizeof(item_t) * size, "items", set, arena);
+CT_HOTFN
+static group_mask_t group_match_full(const ctrl_t *group)
+{
+    return ~group_match_free(group) & ((1u << SET_GROUP_WIDTH) - 1);
+}
 
-    clear_items(set);
+// slot helpers
 
-    return set;
+static size_t get_slot_count(size_t size)
+{
+    // keep the table large enough to hold size keys under the load factor
+    size_t count = SET_GROUP_WIDTH;
+    while (count * SET_LOAD_NUM < size * SET_LOAD_DEN)
+        count *= 2;
+
+    return count;
 }
 
-static item_t *impl_get_bucket(set_t *set, const void *key)
+static size_t get_growth(size_t size)
 {
-    hash_info_t info = set->info;
-    CTASSERT(info.hash != NULL);
+    return (size * SET_LOAD_NUM) / SET_LOAD_DEN;
+}
 
-    size_t hash = info.hash(key);
-    return get_bucket_from_hash(set, hash);
+static size_t get_group_mask(const set_t *set)
+{
+    return (set->size / SET_GROUP_WIDTH) - 1;
 }
 
-static bool impl_keys_equal(const set_t *set, const void *lhs, const void *rhs)
+CT_CONSTFN
+static ctrl_t get_tag(ctu_hash_t hash)
 {
-    hash_info_t info = set->info;
-    CTASSERT(info.equals != NULL);
+    return (ctrl_t)(hash & 0x7F);
+}
 
-    return info.equals(lhs, rhs);
+CT_PUREFN
+static size_t get_first_group(const set_t *set, ctu_hash_t hash)
+{
+    return (hash >> 7) & get_group_mask(set);
 }
 
-STA_DECL
-const void *set_add(set_t *set, const void *key)
+static void set_alloc_slots(set_t *set, size_t size)
+{
+    set->size = size;
+    set->used = 0;
+    set->growth = get_growth(size);
+    set->ctrl = ARENA_MALLOC(sizeof(ctrl_t) * size, "ctrl", set, set->arena);
+    set->items = ARENA_MALLOC(sizeof(item_t) * size, "items", set, set->arena);
+
+    ctu_memset(set->ctrl, CTRL_EMPTY, sizeof(ctrl_t) * size);
+}
+
+static void set_free_slots(set_t *set, ctrl_t *ctrl, item_t *items, size_t size)
+{
+    arena_free(ctrl, sizeof(ctrl_t) * size, set->arena);
+    arena_free(items, sizeof(item_t) * size, set->arena);
+}
+
+CT_HOTFN
+static ctu_hash_t impl_key_hash(const set_t *set, const void *key)
+{
+    const hash_info_t *info = &set->info;
+    return info_mix_hash(info->hash(key));
+}
+
+CT_HOTFN
+static bool impl_keys_equal(const set_t *set, const void *lhs, const void *rhs)
+{
+    const hash_info_t *info = &set->info;
+    return info->equals(lhs, rhs);
+}
+
+// find the slot holding key, or SIZE_MAX if it is not in the set
+CT_HOTFN
+static size_t impl_find(const set_t *set, const void *key, ctu_hash_t hash)
 {
-    item_t *item = impl_get_bucket(set, key);
+    ctrl_t tag = get_tag(hash);
+    size_t mask = get_group_mask(set);
+    size_t group = get_first_group(set, hash);
 
+    // there is always at least one empty slot so this will terminate
     while (true)
     {
-        if (item->key == NULL)
-        {
-            item->key = key;
-            return key;
-        }
+        size_t base = group * SET_GROUP_WIDTH;
+        const ctrl_t *ctrl = set->ctrl + base;
 
-        if (impl_keys_equal(set, item->key, key))
+        group_mask_t match = group_match(ctrl, tag);
+        while (match != 0)
         {
-            return item->key;
-        }
+            size_t index = base + mask_first(match);
+            if (impl_keys_equal(set, set->items[index].key, key))
+                return index;
 
-        if (item->next != NULL)
-        {
-            item = item->next;
+            match &= match - 1;
         }
-        else
-        {
-            item->next = item_new(key, set->arena);
-            ARENA_REPARENT(item->next, item, set->arena);
-            return key;
-        }
-    }
 
-    CT_NEVER("unreachable");
+        // a key is never placed past a group with an empty slot
+        if (group_match(ctrl, CTRL_EMPTY) != 0)
+            return SIZE_MAX;
+
+        group = (group + 1) & mask;
+    }
 }
 
-STA_DECL
-bool set_contains(const set_t *set, const void *key)
+// find a slot for a key that is known not to be in the set
+CT_HOTFN
+static size_t impl_find_free(const set_t *set, ctu_hash_t hash)
 {
-    item_t *item = impl_get_bucket((set_t*)set, key);
+    size_t mask = get_group_mask(set);
+    size_t group = get_first_group(set, hash);
 
     while (true)
     {
-        if (item->key == NULL)
-        {
-            return false;
-        }
+        size_t base = group * SET_GROUP_WIDTH;
+        group_mask_t slots = group_match_free(set->ctrl + base);
+        if (slots != 0)
+            return base + mask_first(slots);
 
-        if (impl_keys_equal(set, item->key, key))
-        {
-            return true;
-        }
+        group = (group + 1) & mask;
+    }
+}
 
-        if (item->next != NULL)
-        {
-            item = item->next;
-        }
-        else
+static void impl_place(set_t *set, const void *key, ctu_hash_t hash)
+{
+    size_t index = impl_find_free(set, hash);
+
+    // reusing a deleted slot does not use up any growth
+    if (set->ctrl[index] == CTRL_EMPTY)
+        set->growth -= 1;
+
+    set->ctrl[index] = get_tag(hash);
+    set->items[index].key = key;
+    set->used += 1;
+}
+
+static void impl_resize(set_t *set, size_t size)
+{
+    ctrl_t *old_ctrl = set->ctrl;
+    item_t *old_items = set->items;
+    size_t old_size = set->size;
+
+    set_alloc_slots(set, size);
+
+    for (size_t base = 0; base < old_size; base += SET_GROUP_WIDTH)
+    {
+        group_mask_t full = group_match_full(old_ctrl + base);
+        while (full != 0)
         {
-            return false;
+            const void *key = old_items[base + mask_first(full)].key;
+            impl_place(set, key, impl_key_hash(set, key));
+
+            full &= full - 1;
         }
     }
 
-    CT_NEVER("unreachable");
+    set_free_slots(set, old_ctrl, old_items, old_size);
+}
+
+// make sure count more keys can be added without resizing
+static void impl_reserve(set_t *set, size_t count)
+{
+    if (count <= set->growth)
+        return;
+
+    // when tombstones used up the growth rehashing at the same size clears them
+    size_t size = get_slot_count(set->used + count);
+    impl_resize(set, CT_MAX(size, set->size));
+}
+
+CT_HOTFN
+static const void *impl_add(set_t *set, const void *key, ctu_hash_t hash)
+{
+    size_t index = impl_find(set, key, hash);
+    if (index != SIZE_MAX)
+        return set->items[index].key;
+
+    impl_reserve(set, 1);
+    impl_place(set, key, hash);
+
+    return key;
 }
 
 STA_DECL
-void set_delete(set_t *set, const void *key)
+set_t *set_new(size_t size, hash_info_t info, arena_t *arena)
 {
-    item_t *item = impl_get_bucket(set, key);
+    CTASSERT(size > 0);
+    CTASSERT(arena != NULL);
 
-    while (true)
-    {
-        if (item->key == NULL)
-        {
-            return;
-        }
+    CTASSERT(info.hash != NULL);
+    CTASSERT(info.equals != NULL);
 
-        if (impl_keys_equal(set, item->key, key))
-        {
-            item->key = NULL;
-            return;
-        }
+    set_t *set = ARENA_MALLOC(sizeof(set_t), "set", NULL, arena);
+    set->arena = arena;
+    set->info = info;
 
-        if (item->next != NULL)
-        {
-            item = item->next;
-        }
-        else
-        {
-            return;
-        }
-    }
+    set_alloc_slots(set, get_slot_count(size));
 
-    CT_NEVER("unreachable");
+    return set;
 }
 
 STA_DECL
-bool set_empty(set_t *set)
+const void *set_add(set_t *set, const void *key)
 {
-    set_iter_t iter = set_iter(set);
-    while (set_has_next(&iter))
-    {
-        const void *key = set_next(&iter);
-        if (key != NULL)
-        {
-            return false;
-        }
-    }
+    CTASSERT(set != NULL);
+    CTASSERT(key != NULL);
 
-    return true;
+    return impl_add(set, key, impl_key_hash(set, key));
 }
 
 STA_DECL
-void set_reset(set_t *set)
+void set_add_many(set_t *set, const void *const *keys, size_t count)
 {
     CTASSERT(set != NULL);
+    CTASSERT(keys != NULL || count == 0);
 
-    for (size_t i = 0; i < set->size; i++)
+    // grow once up front rather than as the keys are added
+    impl_reserve(set, count);
+
+    for (size_t i = 0; i < count; i++)
     {
-        item_t *item = &set->items[i];
-        item->next = NULL;
-        item->key = NULL;
+        const void *key = keys[i];
+        CTASSERT(key != NULL);
+
+        (void)impl_add(set, key, impl_key_hash(set, key));
     }
 }
 
-static item_t *set_next_in_chain(item_t *entry)
+STA_DECL
+void set_union(set_t *set, const set_t *other)
 {
-    if (entry == NULL || entry->key == NULL)
-    {
-        return NULL;
-    }
+    CTASSERT(set != NULL);
+    CTASSERT(other != NULL);
 
-    // TODO: something better than this
+    impl_reserve(set, other->used);
 
-    while (entry->next != NULL)
+    // walk the control bytes directly, this skips empty groups entirely
+    for (size_t base = 0; base < other->size; base += SET_GROUP_WIDTH)
     {
-        entry = entry->next;
-
-        if (entry->key != NULL)
+        group_mask_t full = group_match_full(other->ctrl + base);
+        while (full != 0)
         {
-            return entry;
+            const void *key = other->items[base + mask_first(full)].key;
+            (void)impl_add(set, key, impl_key_hash(set, key));
+
+            full &= full - 1;
         }
     }
+}
 
-    return NULL;
+STA_DECL
+bool set_contains(const set_t *set, const void *key)
+{
+    CTASSERT(set != NULL);
+    CTASSERT(key != NULL);
+
+    return impl_find(set, key, impl_key_hash(set, key)) != SIZE_MAX;
 }
 
-/**
- * @brief get the next bucket for an iterator
- *
- * @param map the map being iterated
- * @param index the current toplevel bucket index
- * @param previous the previous bucket that was returned
- * @return bucket_t* the next bucket or NULL if there are no more buckets
- */
-static item_t *set_find_next_item(set_t *set, size_t *index, item_t *previous)
+STA_DECL
+void set_delete(set_t *set, const void *key)
 {
-    item_t *entry = set_next_in_chain(previous);
-    if (entry != NULL)
+    CTASSERT(set != NULL);
+    CTASSERT(key != NULL);
+
+    size_t index = impl_find(set, key, impl_key_hash(set, key));
+    if (index == SIZE_MAX)
+        return;
+
+    // if the group still has an empty slot no probe ever continued past it
+    // so the slot can be emptied, otherwise leave a tombstone
+    size_t base = index - (index % SET_GROUP_WIDTH);
+    if (group_match(set->ctrl + base, CTRL_EMPTY) != 0)
     {
-        return entry;
+        set->ctrl[index] = CTRL_EMPTY;
+        set->growth += 1;
+    }
+    else
+    {
+        set->ctrl[index] = CTRL_DELETED;
     }
 
+    set->items[index].key = NULL;
+    set->used -= 1;
+}
+
+STA_DECL
+bool set_empty(set_t *set)
+{
+    CTASSERT(set != NULL);
+
+    return set->used == 0;
+}
+
+STA_DECL
+size_t set_count(const set_t *set)
+{
+    CTASSERT(set != NULL);
+
+    return set->used;
+}
+
+STA_DECL
+void set_reset(set_t *set)
+{
+    CTASSERT(set != NULL);
+
+    ctu_memset(set->ctrl, CTRL_EMPTY, sizeof(ctrl_t) * set->size);
+    set->used = 0;
+    set->growth = get_growth(set->size);
+}
+
+// iteration
+
+static item_t *set_find_next_item(set_t *set, size_t *index)
+{
     size_t i = *index;
 
     while (i < set->size)
     {
-        entry = &set->items[i++];
-        if (entry->key != NULL)
-        {
-            *index = i;
-            return entry;
-        }
+        size_t base = i - (i % SET_GROUP_WIDTH);
 
-        entry = set_next_in_chain(entry);
-        if (entry != NULL)
+        // ignore the slots in this group that have already been visited
+        group_mask_t full = group_match_full(set->ctrl + base) >> (i - base);
+        if (full != 0)
         {
-            *index = i;
-            return entry;
+            size_t found = i + mask_first(full);
+            *index = found + 1;
+            return &set->items[found];
         }
+
+        i = base + SET_GROUP_WIDTH;
     }
 
+    *index = i;
     return NULL;
 }
 
@@ -271,8 +484,8 @@ set_iter_t set_iter(set_t *set)
 
     size_t index = 0;
 
-    item_t *current = set_find_next_item(set, &index, NULL);
-    item_t *next = set_find_next_item(set, &index, current);
+    item_t *current = set_find_next_item(set, &index);
+    item_t *next = set_find_next_item(set, &index);
 
     set_iter_t iter = {
         .set = set,
@@ -292,7 +505,7 @@ const void *set_next(set_iter_t *iter)
     const void *entry = iter->current->key;
 
     iter->current = iter->next;
-    iter->next = set_find_next_item(iter->set, &iter->index, iter->current);
+    iter->next = set_find_next_item(iter->set, &iter->index);
 
     return entry;
 }
@@ -13,6 +13,8 @@
 
 #include "core/macros.h"
 
+#include "common.h"
+
 #include <limits.h>
 
 #if CTU_STB_SPRINTF
@@ -28,7 +30,12 @@
 #   define CT_VSNPRINTF vsnprintf
 #endif
 
-// TODO: is it worth using stbsp_vsprintfcb when its available?
+// the size of the stack buffer str_vstream formats into
+#if CTU_STB_SPRINTF
+#   define STR_STREAM_SIZE STB_SPRINTF_MIN
+#else
+#   define STR_STREAM_SIZE 512
+#endif
 
 STA_DECL
 size_t str_sprintf(char *str, size_t len, const char *fmt, ...)
@@ -52,6 +59,78 @@ size_t str_vsprintf(char *str, size_t len, const char *fmt, va_list args)
     return CT_VSNPRINTF(str, (int)len, fmt, args);
 }
 
+#if CTU_STB_SPRINTF
+typedef struct stream_t
+{
+    str_stream_t fn;
+    void *user;
+    char buffer[STR_STREAM_SIZE];
+} stream_t;
+
+// stb calls this each time the buffer fills up, and once more at the end
+static char *stream_flush(const char *buf, void *user, int len)
+{
+    stream_t *stream = user;
+    if (len > 0)
+        stream->fn(stream->user, buf, (size_t)len);
+
+    // the chunk has been consumed, reuse the same buffer
+    return stream->buffer;
+}
+
+STA_DECL
+size_t str_vstream(str_stream_t fn, void *user, arena_t *arena, const char *fmt, va_list args)
+{
+    CTASSERT(fn != NULL);
+    CTASSERT(arena != NULL);
+    CTASSERT(fmt != NULL);
+
+    stream_t stream = {
+        .fn = fn,
+        .user = user
+    };
+
+    int len = stbsp_vsprintfcb(stream_flush, &stream, stream.buffer, fmt, args);
+    CTASSERTF(len >= 0, "str_vstream failed to format string: %s", fmt);
+
+    return (size_t)len;
+}
+#else
+STA_DECL
+size_t str_vstream(str_stream_t fn, void *user, arena_t *arena, const char *fmt, va_list args)
+{
+    CTASSERT(fn != NULL);
+    CTASSERT(arena != NULL);
+    CTASSERT(fmt != NULL);
+
+    // keep a copy in case the output doesnt fit on the stack
+    va_list again;
+    va_copy(again, args);
+
+    char buffer[STR_STREAM_SIZE];
+    size_t len = str_vsprintf(buffer, sizeof(buffer), fmt, args);
+
+    if (len < sizeof(buffer))
+    {
+        if (len > 0)
+            fn(user, buffer, len);
+    }
+    else
+    {
+        char *out = ARENA_MALLOC(len + 1, "str_vstream", NULL, arena);
+        size_t result = str_vsprintf(out, len + 1, fmt, again);
+        CTASSERTF(result == len, "str_vstream failed to format string: %s expected (%zu == %zu)", fmt, result, len);
+
+        fn(user, out, len);
+        arena_free(out, len + 1, arena);
+    }
+
+    va_end(again);
+
+    return len;
+}
+#endif
+
 STA_DECL
 text_t text_vformat(arena_t *arena, const char *fmt, va_list args)
 {
@@ -122,15 +201,12 @@ bool char_is_any_of(char c, const char *chars)
 {
     CTASSERT(chars != NULL);
 
-    for (; *chars; chars++)
+    if (c == '\0')
     {
-        if (*chars == c)
-        {
-            return true;
-        }
+        return false;
     }
 
-    return false;
+    return str_simd()->find_any(chars, ctu_strlen(chars), &c, 1) != SIZE_MAX;
 }
 
 STA_DECL
@@ -440,6 +516,33 @@ static size_t normstr(char *out, char c)
     }
 }
 
+// normalize len bytes of str into out, or only measure the result if out is NULL.
+// clean runs are copied in bulk, only the bytes between them are escaped one at a time
+static size_t normalize_runs(char *out, const char *str, size_t len)
+{
+    const str_simd_t *simd = str_simd();
+    size_t result = 0;
+    size_t i = 0;
+
+    while (i < len)
+    {
+        size_t run = simd->clean_prefix(str + i, len - i);
+        if (out != NULL)
+            ctu_memcpy(out + result, str + i, run);
+
+        result += run;
+        i += run;
+
+        if (i >= len)
+            break;
+
+        result += (out != NULL) ? normstr(out + result, str[i]) : normlen(str[i]);
+        i += 1;
+    }
+
+    return result;
+}
+
 STA_DECL
 size_t str_normalize_into(char *dst, size_t dstlen, const char *src, size_t srclen)
 {
@@ -450,9 +553,10 @@ size_t str_normalize_into(char *dst, size_t dstlen, const char *src, size_t srcl
     if (dst == NULL) CTASSERT(dstlen == 0);
 
 
-    // calculate required length
-    size_t outlength = 0;
-    for (size_t i = 0; i < srclen; i++)
+    // calculate required length, the clean prefix is copied as is
+    size_t prefix = str_simd()->clean_prefix(src, srclen);
+    size_t outlength = prefix;
+    for (size_t i = prefix; i < srclen; i++)
         outlength += normlen(src[i]);
 
     // if requested, return that length
@@ -487,35 +591,24 @@ char *str_normalize(const char *str, arena_t *arena)
     CTASSERT(str != NULL);
     CTASSERT(arena != NULL);
 
-    size_t input_length = 0;
-    size_t result_length = 0;
+    size_t input_length = ctu_strlen(str);
 
-    // compute the length of both the input string
-    // and the required length to allocate for the normalized string
-    {
-        const char *iter = str;
-        while (*iter != '\0')
-        {
-            size_t inc = normlen(*iter++);
-            result_length += inc;
-            input_length += 1;
-        }
-    }
+    // most strings need no escaping at all, skip over the clean prefix
+    size_t prefix = str_simd()->clean_prefix(str, input_length);
 
     // if the string is already normalized, just return a copy
-    if (input_length == result_length)
+    if (prefix == input_length)
     {
         return arena_strndup(str, input_length, arena);
     }
 
-    const char *iter = str;
+    // compute the required length to allocate for the normalized string
+    size_t result_length = prefix + normalize_runs(NULL, str + prefix, input_length - prefix);
+
     char *buf = ARENA_MALLOC(result_length + 1, "str_normalize", str, arena);
-    char *result = buf;
-    while (*iter != '\0')
-    {
-        result += normstr(result, *iter++);
-    }
-    *result = '\0';
+    ctu_memcpy(buf, str, prefix);
+    size_t offset = prefix + normalize_runs(buf + prefix, str + prefix, input_length - prefix);
+    buf[offset] = '\0';
 
     return buf;
 }
@@ -529,25 +622,19 @@ char *str_normalizen(text_view_t text, arena_t *arena)
     const char *str = text.text;
     size_t len = text.length;
 
-    size_t length = 1;
-    for (size_t i = 0; i < len; i++)
-    {
-        length += normlen(str[i]);
-    }
+    size_t prefix = str_simd()->clean_prefix(str, len);
 
     // if the string is already normalized, just return a copy
-    if (length == len)
+    if (prefix == len)
     {
         return arena_strndup(str, len, arena);
     }
 
+    size_t length = 1 + prefix + normalize_runs(NULL, str + prefix, len - prefix);
+
     char *buf = ARENA_MALLOC(length + 1, "str_normalizen", str, arena);
-    size_t offset = 0;
-    for (size_t i = 0; i < len; i++)
-    {
-        size_t inc = normstr(buf + offset, str[i]);
-        offset += inc;
-    }
+    ctu_memcpy(buf, str, prefix);
+    size_t offset = prefix + normalize_runs(buf + prefix, str + prefix, len - prefix);
 
     buf[offset] = '\0';
     return buf;
@@ -577,28 +664,22 @@ vector_t *str_split(IN_STRING const char *str, IN_STRING const char *sep, arena_
     size_t seplen = ctu_strlen(sep);
     vector_t *result = vector_new(4, arena);
 
-    // store the start of the current token
-    // continue until a seperator is found
-    // then push that token to the vector
-    // and start the next token
+    // jump from seperator to seperator, everything between
+    // two seperators is a token
 
+    const str_simd_t *simd = str_simd();
     const char *token = str;
-    const char *cursor = str;
+    size_t remaining = ctu_strlen(str);
+    size_t offset;
 
-    while (*cursor)
+    while ((offset = simd->find(token, remaining, sep, seplen)) != SIZE_MAX)
     {
-        if (!str_startswith(cursor, sep))
-        {
-            cursor += 1;
-            continue;
-        }
-
-        vector_push(&result, arena_strndup(token, cursor - token, arena));
-        token = cursor + seplen;
-        cursor += seplen;
+        vector_push(&result, arena_strndup(token, offset, arena));
+        token += offset + seplen;
+        remaining -= offset + seplen;
     }
 
-    vector_push(&result, arena_strndup(token, cursor - token, arena));
+    vector_push(&result, arena_strndup(token, remaining, arena));
 
     return result;
 }
@@ -609,7 +690,7 @@ bool str_contains(const char *str, const char *search)
     CTASSERT(str != NULL);
     CTASSERT(search != NULL);
 
-    return ctu_strstr(str, search) != NULL;
+    return str_find(str, search) != SIZE_MAX;
 }
 
 STA_DECL
@@ -732,50 +813,90 @@ void str_sort_inplace(char *str, size_t len)
     }
 }
 
-STA_DECL
-char *str_replace_many(const char *str, const map_t *repl, arena_t *arena)
+typedef struct replace_keys_t
 {
-    CTASSERT(str != NULL);
-    CTASSERT(repl != NULL);
-    CTASSERT(arena != NULL);
+    typevec_t *pairs;
 
-    size_t len = 0;
-    typevec_t *pairs = map_entries((map_t*)repl); // TODO: map_entries should have a const version
+    // the distinct first bytes of the keys
+    size_t count;
+    char firsts[UCHAR_MAX + 1];
+    bool seen[UCHAR_MAX + 1];
+} replace_keys_t;
+
+// apply the replacements to str, writing into out if it isnt NULL.
+// returns the length of the result
+static size_t replace_many_into(char *out, const char *str, size_t len, const replace_keys_t *keys)
+{
+    const str_simd_t *simd = str_simd();
+    size_t result = 0;
+    size_t offset = 0;
 
-    const char *iter = str;
-    while (*iter)
+    while (offset < len)
     {
-        const map_entry_t *entry = find_matching_key(pairs, iter);
+        size_t skip = simd->find_any(str + offset, len - offset, keys->firsts, keys->count);
+        if (skip == SIZE_MAX)
+            skip = len - offset;
+
+        if (out != NULL)
+            ctu_memcpy(out + result, str + offset, skip);
+
+        result += skip;
+        offset += skip;
+
+        if (offset >= len)
+            break;
+
+        const map_entry_t *entry = find_matching_key(keys->pairs, str + offset);
         if (entry != NULL)
         {
-            len += ctu_strlen(entry->value);
-            iter += ctu_strlen(entry->key);
+            size_t value_len = ctu_strlen(entry->value);
+            if (out != NULL)
+                ctu_memcpy(out + result, entry->value, value_len);
+
+            result += value_len;
+            offset += ctu_strlen(entry->key);
         }
         else
         {
-            len += 1;
-            iter += 1;
+            if (out != NULL)
+                out[result] = str[offset];
+
+            result += 1;
+            offset += 1;
         }
     }
 
-    char *out = ARENA_MALLOC(len + 1, "str_replace_many", repl, arena);
+    return result;
+}
+
+STA_DECL
+char *str_replace_many(const char *str, const map_t *repl, arena_t *arena)
+{
+    CTASSERT(str != NULL);
+    CTASSERT(repl != NULL);
+    CTASSERT(arena != NULL);
+
+    typevec_t *pairs = map_entries((map_t*)repl); // TODO: map_entries should have a const version
 
-    size_t offset = 0; // offset into input string
-    for (size_t i = 0; i < len;)
+    // only positions starting with the first byte of a key can match,
+    // everything between them is copied through in bulk
+    replace_keys_t keys = { .pairs = pairs };
+    for (size_t i = 0; i < typevec_len(pairs); i++)
     {
-        const map_entry_t *entry = find_matching_key(pairs, str + offset);
-        if (entry != NULL)
-        {
-            ctu_memcpy(out + i, entry->value, ctu_strlen(entry->value));
-            i += ctu_strlen(entry->value);
-            offset += ctu_strlen(entry->key);
-        }
-        else
+        const map_entry_t *entry = typevec_offset(pairs, i);
+        unsigned char first = *(const char*)entry->key;
+        if (!keys.seen[first])
         {
-            out[i++] = str[offset++];
+            keys.seen[first] = true;
+            keys.firsts[keys.count++] = (char)first;
         }
     }
 
+    size_t srclen = ctu_strlen(str);
+    size_t len = replace_many_into(NULL, str, srclen, &keys);
+
+    char *out = ARENA_MALLOC(len + 1, "str_replace_many", repl, arena);
+    replace_many_into(out, str, srclen, &keys);
     out[len] = '\0';
 
     return out;
@@ -860,26 +981,6 @@ finish:
     return result;
 }
 
-static size_t str_rfind_inner(const char *str, size_t len, const char *sub, size_t sublen)
-{
-    CTASSERT(str != NULL);
-    CTASSERT(sub != NULL);
-
-    if (len == 0) { return SIZE_MAX; }
-
-    CTASSERTM(sublen > 0, "sub must be non-empty");
-
-    while (len--)
-    {
-        if (ctu_strncmp(str + len, sub, sublen) == 0)
-        {
-            return len;
-        }
-    }
-
-    return SIZE_MAX;
-}
-
 STA_DECL
 size_t str_rfind(const char *str, const char *sub)
 {
@@ -889,7 +990,11 @@ size_t str_rfind(const char *str, const char *sub)
     size_t len = ctu_strlen(str);
     size_t sublen = ctu_strlen(sub);
 
-    return str_rfind_inner(str, len, sub, sublen);
+    if (len == 0) { return SIZE_MAX; }
+
+    CTASSERTM(sublen > 0, "sub must be non-empty");
+
+    return str_simd()->rfind(str, len, sub, sublen);
 }
 
 STA_DECL
@@ -898,8 +1003,7 @@ size_t str_find(const char *str, const char *sub)
     CTASSERT(str != NULL);
     CTASSERT(sub != NULL);
 
-    const char *ptr = ctu_strstr(str, sub);
-    return ptr == NULL ? SIZE_MAX : (size_t)(ptr - str);
+    return str_simd()->find(str, ctu_strlen(str), sub, ctu_strlen(sub));
 }
 
 STA_DECL CT_NOALIAS
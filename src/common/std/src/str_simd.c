@@ -0,0 +1,338 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "common.h"
+
+#include "std/str.h"
+
+#include "base/panic.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define STR_USE_SSE2 1
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define STR_USE_NEON 1
+#   include <arm_neon.h>
+#endif
+
+// avx2 is only used when the cpu supports it, checked once at startup
+#if (CT_CC_GNU || CT_CC_CLANG) && (defined(__x86_64__) || defined(__i386__))
+#   define STR_USE_AVX2 1
+#   include <immintrin.h>
+#endif
+
+#if CT_CC_MSVC
+#   include <intrin.h>
+#endif
+
+// the most bytes find_any will compare against in vector registers
+#define STR_SIMD_MAX_SET 8
+
+typedef uint32_t simd_mask_t;
+
+CT_CONSTFN
+static size_t mask_first(simd_mask_t mask)
+{
+#if CT_CC_MSVC
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return (size_t)__builtin_ctz(mask);
+#endif
+}
+
+CT_CONSTFN
+static size_t mask_last(simd_mask_t mask)
+{
+#if CT_CC_MSVC
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#else
+    return 31 - (size_t)__builtin_clz(mask);
+#endif
+}
+
+///
+/// scalar implementations, also used for the tails of the vector versions
+///
+
+static size_t scalar_find_from(const char *str, size_t len, const char *sub, size_t sublen, size_t start)
+{
+    if (sublen > len) return SIZE_MAX;
+
+    for (size_t i = start; i <= len - sublen; i++)
+    {
+        if (str[i] == sub[0] && memcmp(str + i, sub, sublen) == 0)
+            return i;
+    }
+
+    return SIZE_MAX;
+}
+
+// check every position below limit, from the highest down
+static size_t scalar_rfind_below(const char *str, const char *sub, size_t sublen, size_t limit)
+{
+    while (limit-- > 0)
+    {
+        if (str[limit] == sub[0] && memcmp(str + limit, sub, sublen) == 0)
+            return limit;
+    }
+
+    return SIZE_MAX;
+}
+
+static size_t scalar_find_any(const char *str, size_t len, const char *set, size_t setlen)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (memchr(set, str[i], setlen) != NULL)
+            return i;
+    }
+
+    return SIZE_MAX;
+}
+
+static bool is_clean(char c)
+{
+    return c > 0x1F && c != 0x7F && c != '\\' && c != '\'' && c != '\"';
+}
+
+static size_t scalar_clean_prefix(const char *str, size_t len)
+{
+    size_t i = 0;
+    while (i < len && is_clean(str[i]))
+        i += 1;
+
+    return i;
+}
+
+static size_t scalar_find(const char *str, size_t len, const char *sub, size_t sublen)
+{
+    if (sublen == 0) return 0;
+
+    return scalar_find_from(str, len, sub, sublen, 0);
+}
+
+static size_t scalar_rfind(const char *str, size_t len, const char *sub, size_t sublen)
+{
+    if (sublen > len) return SIZE_MAX;
+    if (sublen == 0) return len;
+
+    return scalar_rfind_below(str, sub, sublen, len - sublen + 1);
+}
+
+static const str_simd_t kScalarImpl = {
+    .find = scalar_find,
+    .rfind = scalar_rfind,
+    .find_any = scalar_find_any,
+    .clean_prefix = scalar_clean_prefix
+};
+
+///
+/// vector implementations
+///
+
+#if STR_USE_SSE2
+#   define SIMD_FN(name) sse2_##name
+#   define SIMD_TARGET
+#   define SIMD_WIDTH 16
+#   define SIMD_FULL_MASK 0xFFFFu
+#   define simd_vec_t __m128i
+#   define SIMD_LOAD(ptr) _mm_loadu_si128((const __m128i*)(ptr))
+#   define SIMD_SPLAT(c) _mm_set1_epi8((char)(c))
+#   define SIMD_EQ(a, b) _mm_cmpeq_epi8(a, b)
+#   define SIMD_GT(a, b) _mm_cmpgt_epi8(a, b)
+#   define SIMD_OR(a, b) _mm_or_si128(a, b)
+#   define SIMD_AND(a, b) _mm_and_si128(a, b)
+#   define SIMD_MASK(v) ((simd_mask_t)_mm_movemask_epi8(v))
+#   include "str_simd.inc"
+
+static const str_simd_t kSse2Impl = {
+    .find = sse2_find,
+    .rfind = sse2_rfind,
+    .find_any = sse2_find_any,
+    .clean_prefix = sse2_clean_prefix
+};
+#endif
+
+#if STR_USE_AVX2
+#   define SIMD_FN(name) avx2_##name
+#   define SIMD_TARGET __attribute__((target("avx2")))
+#   define SIMD_WIDTH 32
+#   define SIMD_FULL_MASK 0xFFFFFFFFu
+#   define simd_vec_t __m256i
+#   define SIMD_LOAD(ptr) _mm256_loadu_si256((const __m256i*)(ptr))
+#   define SIMD_SPLAT(c) _mm256_set1_epi8((char)(c))
+#   define SIMD_EQ(a, b) _mm256_cmpeq_epi8(a, b)
+#   define SIMD_GT(a, b) _mm256_cmpgt_epi8(a, b)
+#   define SIMD_OR(a, b) _mm256_or_si256(a, b)
+#   define SIMD_AND(a, b) _mm256_and_si256(a, b)
+#   define SIMD_MASK(v) ((simd_mask_t)_mm256_movemask_epi8(v))
+#   include "str_simd.inc"
+
+static const str_simd_t kAvx2Impl = {
+    .find = avx2_find,
+    .rfind = avx2_rfind,
+    .find_any = avx2_find_any,
+    .clean_prefix = avx2_clean_prefix
+};
+#endif
+
+#if STR_USE_NEON
+// neon has no movemask, narrow each lane to a single bit and sum them
+static simd_mask_t neon_movemask(uint8x16_t value)
+{
+    static const uint8_t kBits[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128,
+        1, 2, 4, 8, 16, 32, 64, 128
+    };
+
+    uint8x16_t bits = vandq_u8(value, vld1q_u8(kBits));
+    uint8x8_t lo = vget_low_u8(bits);
+    uint8x8_t hi = vget_high_u8(bits);
+
+    lo = vpadd_u8(lo, lo);
+    lo = vpadd_u8(lo, lo);
+    lo = vpadd_u8(lo, lo);
+
+    hi = vpadd_u8(hi, hi);
+    hi = vpadd_u8(hi, hi);
+    hi = vpadd_u8(hi, hi);
+
+    return (simd_mask_t)vget_lane_u8(lo, 0) | ((simd_mask_t)vget_lane_u8(hi, 0) << 8);
+}
+
+#   define SIMD_FN(name) neon_##name
+#   define SIMD_TARGET
+#   define SIMD_WIDTH 16
+#   define SIMD_FULL_MASK 0xFFFFu
+#   define simd_vec_t uint8x16_t
+#   define SIMD_LOAD(ptr) vld1q_u8((const uint8_t*)(ptr))
+#   define SIMD_SPLAT(c) vdupq_n_u8((uint8_t)(c))
+#   define SIMD_EQ(a, b) vceqq_u8(a, b)
+#   define SIMD_GT(a, b) vcgtq_s8(vreinterpretq_s8_u8(a), vreinterpretq_s8_u8(b))
+#   define SIMD_OR(a, b) vorrq_u8(a, b)
+#   define SIMD_AND(a, b) vandq_u8(a, b)
+#   define SIMD_MASK(v) neon_movemask(v)
+#   include "str_simd.inc"
+
+static const str_simd_t kNeonImpl = {
+    .find = neon_find,
+    .rfind = neon_rfind,
+    .find_any = neon_find_any,
+    .clean_prefix = neon_clean_prefix
+};
+#endif
+
+///
+/// dispatch
+///
+
+static const str_simd_t *get_impl(str_isa_t isa)
+{
+    switch (isa)
+    {
+    case eStrIsaScalar:
+        return &kScalarImpl;
+
+#if STR_USE_SSE2
+    case eStrIsaSse2:
+        return &kSse2Impl;
+#endif
+
+#if STR_USE_AVX2
+    case eStrIsaAvx2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? &kAvx2Impl : NULL;
+#endif
+
+#if STR_USE_NEON
+    case eStrIsaNeon:
+        return &kNeonImpl;
+#endif
+
+    default:
+        return NULL;
+    }
+}
+
+static str_isa_t select_best(void)
+{
+    static const str_isa_t kPreferred[] = { eStrIsaAvx2, eStrIsaSse2, eStrIsaNeon };
+
+    for (size_t i = 0; i < sizeof(kPreferred) / sizeof(str_isa_t); i++)
+    {
+        if (get_impl(kPreferred[i]) != NULL)
+            return kPreferred[i];
+    }
+
+    return eStrIsaScalar;
+}
+
+static const str_simd_t *gStrSimd = NULL;
+static str_isa_t gStrIsa = eStrIsaScalar;
+
+static void str_simd_init(void)
+{
+    str_isa_t isa = select_best();
+
+    gStrSimd = get_impl(isa);
+    gStrIsa = isa;
+}
+
+#if CT_CC_GNU || CT_CC_CLANG
+// pick the implementation before main so the string functions never race on it
+__attribute__((constructor))
+static void str_simd_startup(void)
+{
+    str_simd_init();
+}
+#endif
+
+const str_simd_t *str_simd(void)
+{
+    if (gStrSimd == NULL)
+        str_simd_init();
+
+    return gStrSimd;
+}
+
+STA_DECL
+str_isa_t str_get_isa(void)
+{
+    (void)str_simd();
+    return gStrIsa;
+}
+
+STA_DECL
+bool str_set_isa(str_isa_t isa)
+{
+    CT_ASSERT_RANGE(isa, 0, eStrIsaCount - 1);
+
+    const str_simd_t *impl = get_impl(isa);
+    if (impl == NULL)
+        return false;
+
+    gStrSimd = impl;
+    gStrIsa = isa;
+    return true;
+}
+
+STA_DECL
+const char *str_isa_name(str_isa_t isa)
+{
+    CT_ASSERT_RANGE(isa, 0, eStrIsaCount - 1);
+
+    static const char *const kNames[eStrIsaCount] = {
+        [eStrIsaScalar] = "scalar",
+        [eStrIsaSse2] = "sse2",
+        [eStrIsaAvx2] = "avx2",
+        [eStrIsaNeon] = "neon",
+    };
+
+    return kNames[isa];
+}
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "std/strbuf.h"
+#include "std/str.h"
+
+#include "base/util.h"
+#include "core/macros.h"
+
+#include "arena/arena.h"
+#include "base/panic.h"
+
+// make room for extra bytes and the nul terminator
+static void strbuf_ensure(strbuf_t *buf, size_t extra)
+{
+    size_t required = buf->used + extra + 1;
+    if (required <= buf->size)
+        return;
+
+    size_t size = CT_MAX(buf->size * 2, required);
+    buf->data = arena_realloc(buf->data, size, buf->size, buf->arena);
+    buf->size = size;
+}
+
+STA_DECL
+void strbuf_init(strbuf_t *buf, size_t size, arena_t *arena)
+{
+    CTASSERT(buf != NULL);
+    CTASSERT(arena != NULL);
+
+    size_t capacity = CT_MAX(size, 16);
+
+    buf->arena = arena;
+    buf->size = capacity;
+    buf->used = 0;
+    buf->data = ARENA_MALLOC(capacity, "strbuf", buf, arena);
+    buf->data[0] = '\0';
+}
+
+STA_DECL
+strbuf_t *strbuf_new(size_t size, arena_t *arena)
+{
+    strbuf_t *buf = ARENA_MALLOC(sizeof(strbuf_t), "strbuf", NULL, arena);
+    strbuf_init(buf, size, arena);
+    return buf;
+}
+
+STA_DECL
+size_t strbuf_len(const strbuf_t *buf)
+{
+    CTASSERT(buf != NULL);
+
+    return buf->used;
+}
+
+STA_DECL
+const char *strbuf_data(const strbuf_t *buf)
+{
+    CTASSERT(buf != NULL);
+
+    return buf->data;
+}
+
+STA_DECL
+text_view_t strbuf_view(const strbuf_t *buf)
+{
+    CTASSERT(buf != NULL);
+
+    return text_view_make(buf->data, buf->used);
+}
+
+STA_DECL
+char *strbuf_dup(const strbuf_t *buf, arena_t *arena)
+{
+    CTASSERT(buf != NULL);
+
+    return arena_strndup(buf->data, buf->used, arena);
+}
+
+STA_DECL
+void strbuf_reset(strbuf_t *buf)
+{
+    strbuf_truncate(buf, 0);
+}
+
+STA_DECL
+void strbuf_truncate(strbuf_t *buf, size_t len)
+{
+    CTASSERT(buf != NULL);
+    CTASSERTF(len <= buf->used, "truncate %zu > %zu", len, buf->used);
+
+    buf->used = len;
+    buf->data[len] = '\0';
+}
+
+STA_DECL
+void strbuf_append_char(strbuf_t *buf, char c)
+{
+    CTASSERT(buf != NULL);
+
+    strbuf_ensure(buf, 1);
+    buf->data[buf->used++] = c;
+    buf->data[buf->used] = '\0';
+}
+
+STA_DECL
+void strbuf_append(strbuf_t *buf, const char *str)
+{
+    strbuf_appendn(buf, str, ctu_strlen(str));
+}
+
+STA_DECL
+void strbuf_appendn(strbuf_t *buf, const char *str, size_t len)
+{
+    CTASSERT(buf != NULL);
+    CTASSERT(str != NULL);
+
+    strbuf_ensure(buf, len);
+    ctu_memcpy(buf->data + buf->used, str, len);
+    buf->used += len;
+    buf->data[buf->used] = '\0';
+}
+
+STA_DECL
+size_t strbuf_printf(strbuf_t *buf, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+
+    size_t len = strbuf_vprintf(buf, fmt, args);
+
+    va_end(args);
+
+    return len;
+}
+
+STA_DECL
+size_t strbuf_vprintf(strbuf_t *buf, const char *fmt, va_list args)
+{
+    CTASSERT(buf != NULL);
+    CTASSERT(fmt != NULL);
+
+    // keep a copy in case the first attempt doesnt fit
+    va_list again;
+    va_copy(again, args);
+
+    // format straight into the spare capacity, this almost always fits
+    size_t remaining = buf->size - buf->used;
+    size_t len = str_vsprintf(buf->data + buf->used, remaining, fmt, args);
+
+    if (len >= remaining)
+    {
+        strbuf_ensure(buf, len);
+        size_t result = str_vsprintf(buf->data + buf->used, len + 1, fmt, again);
+        CTASSERTF(result == len, "strbuf_vprintf failed to format string: %s expected (%zu == %zu)", fmt, result, len);
+    }
+
+    va_end(again);
+
+    buf->used += len;
+    buf->data[buf->used] = '\0';
+
+    return len;
+}
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "std/typed/segvec.h"
+
+#include "base/util.h"
+#include "core/macros.h"
+
+#include "arena/arena.h"
+#include "base/panic.h"
+
+#if CT_CC_MSVC
+#   include <intrin.h>
+#endif
+
+// the segment table starts with enough room for (base << 8) - base elements
+#define SEGVEC_INITIAL_SEGMENTS 8
+
+CT_CONSTFN
+static size_t log2_floor(size_t value)
+{
+#if CT_CC_MSVC && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return index;
+#elif CT_CC_MSVC
+    // size_t is 32 bits on 32 bit windows
+    unsigned long index;
+    _BitScanReverse(&index, (unsigned long)value);
+    return index;
+#else
+    return (sizeof(unsigned long long) * 8 - 1) - (size_t)__builtin_clzll(value);
+#endif
+}
+
+// the number of elements in segment n
+static size_t segment_size(const segvec_t *vec, size_t segment)
+{
+    return ((size_t)1 << vec->shift) << segment;
+}
+
+// the index of the first element in segment n
+static size_t segment_start(const segvec_t *vec, size_t segment)
+{
+    return (((size_t)1 << segment) - 1) << vec->shift;
+}
+
+// segment n starts at base * (2^n - 1), so the segment of an index
+// is the highest set bit of (index / base + 1)
+static size_t segment_of(const segvec_t *vec, size_t index)
+{
+    return log2_floor((index >> vec->shift) + 1);
+}
+
+static void *get_element(const segvec_t *vec, size_t index)
+{
+    size_t segment = segment_of(vec, index);
+    size_t offset = index - segment_start(vec, segment);
+
+    return ((char*)vec->segments[segment]) + (offset * vec->width);
+}
+
+static void segvec_add_segment(segvec_t *vec)
+{
+    if (vec->count >= vec->capacity)
+    {
+        // only the table of segment pointers moves, never the elements
+        size_t capacity = CT_MAX(vec->capacity * 2, SEGVEC_INITIAL_SEGMENTS);
+        vec->segments = arena_realloc(vec->segments, capacity * sizeof(void*), vec->capacity * sizeof(void*), vec->arena);
+        vec->capacity = capacity;
+    }
+
+    size_t size = segment_size(vec, vec->count);
+    vec->segments[vec->count] = ARENA_MALLOC(size * vec->width, "segment", vec, vec->arena);
+    vec->count += 1;
+}
+
+STA_DECL
+void segvec_init(segvec_t *vec, size_t width, size_t len, arena_t *arena)
+{
+    CTASSERT(vec != NULL);
+    CTASSERT(arena != NULL);
+    CTASSERT(width > 0);
+
+    size_t size = CT_MAX(len, 1);
+    size_t shift = log2_floor(size);
+    if (((size_t)1 << shift) < size) shift += 1;
+
+    vec->arena = arena;
+    vec->shift = shift;
+    vec->used = 0;
+    vec->width = width;
+    vec->count = 0;
+    vec->capacity = SEGVEC_INITIAL_SEGMENTS;
+    vec->segments = ARENA_MALLOC(SEGVEC_INITIAL_SEGMENTS * sizeof(void*), "segments", vec, arena);
+}
+
+STA_DECL
+segvec_t *segvec_new(size_t width, size_t len, arena_t *arena)
+{
+    segvec_t *vec = ARENA_MALLOC(sizeof(segvec_t), "segvec", NULL, arena);
+    segvec_init(vec, width, len, arena);
+    return vec;
+}
+
+STA_DECL
+size_t segvec_len(const segvec_t *vec)
+{
+    CTASSERT(vec != NULL);
+
+    return vec->used;
+}
+
+STA_DECL
+void *segvec_push(segvec_t *vec, const void *src)
+{
+    CTASSERT(vec != NULL);
+    CTASSERT(src != NULL);
+
+    size_t index = vec->used;
+    if (index == segment_start(vec, vec->count))
+    {
+        segvec_add_segment(vec);
+    }
+
+    void *dst = get_element(vec, index);
+    ctu_memcpy(dst, src, vec->width);
+    vec->used += 1;
+
+    return dst;
+}
+
+STA_DECL
+void *segvec_offset(const segvec_t *vec, size_t index)
+{
+    CTASSERT(vec != NULL);
+    CTASSERTF(index < segvec_len(vec), "index out of bounds %zu >= %zu", index, segvec_len(vec));
+
+    return get_element(vec, index);
+}
+
+STA_DECL
+void segvec_get(const segvec_t *vec, size_t index, void *dst)
+{
+    CTASSERT(dst != NULL);
+
+    void *src = segvec_offset(vec, index);
+    ctu_memcpy(dst, src, vec->width);
+}
+
+STA_DECL
+void segvec_set(segvec_t *vec, size_t index, const void *src)
+{
+    CTASSERT(src != NULL);
+
+    void *dst = segvec_offset(vec, index);
+    ctu_memcpy(dst, src, vec->width);
+}
+
+STA_DECL
+void segvec_reset(segvec_t *vec)
+{
+    CTASSERT(vec != NULL);
+
+    vec->used = 0;
+}
+
+// point the cursor at the used part of a segment
+static void iter_enter(segvec_iter_t *iter, size_t segment)
+{
+    const segvec_t *vec = iter->vec;
+    size_t start = segment_start(vec, segment);
+
+    iter->segment = segment;
+
+    if (start >= vec->used)
+    {
+        iter->cursor = NULL;
+        iter->end = NULL;
+        return;
+    }
+
+    size_t len = CT_MIN(vec->used - start, segment_size(vec, segment));
+    iter->cursor = vec->segments[segment];
+    iter->end = iter->cursor + (len * vec->width);
+}
+
+STA_DECL
+segvec_iter_t segvec_iter(const segvec_t *vec)
+{
+    CTASSERT(vec != NULL);
+
+    segvec_iter_t iter = { .vec = vec };
+    iter_enter(&iter, 0);
+    return iter;
+}
+
+STA_DECL
+bool segvec_has_next(const segvec_iter_t *iter)
+{
+    CTASSERT(iter != NULL);
+
+    return iter->cursor != iter->end;
+}
+
+STA_DECL
+void *segvec_next(segvec_iter_t *iter)
+{
+    CTASSERT(segvec_has_next(iter));
+
+    void *item = iter->cursor;
+    iter->cursor += iter->vec->width;
+
+    if (iter->cursor == iter->end)
+    {
+        iter_enter(iter, iter->segment + 1);
+    }
+
+    return item;
+}
@@ -6,6 +6,20 @@
 
 #include "common.h"
 
+#include <stdint.h>
+
+ctu_hash_t info_mix_hash(ctu_hash_t hash)
+{
+    // the murmur3 64 bit finalizer
+    uint64_t h = hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return (ctu_hash_t)h;
+}
+
 size_t info_ptr_hash(const void *key) { return ctu_ptrhash(key); }
 bool info_ptr_equal(const void *lhs, const void *rhs) { return lhs == rhs; }
 
@@ -5,6 +5,8 @@
 #include "base/panic.h"
 #include "base/util.h"
 
+#include "core/macros.h"
+
 /**
  * a vector of non-owning pointers
  *
@@ -18,11 +20,14 @@ typedef struct vector_t
 
     size_t size;                   ///< the total number of allocated elements
     size_t used;                   ///< the number of elements in use
+    bool placed;                   ///< the vector lives in storage it does not own
     STA_FIELD_SIZE(size) void *data[]; ///< the data
 } vector_t;
 
-vector_t gEmptyVector = { NULL, 0, 0 };
-const vector_t kEmptyVector = { NULL, 0, 0 };
+vector_t gEmptyVector = { NULL, 0, 0, false };
+const vector_t kEmptyVector = { NULL, 0, 0, false };
+
+CT_STATIC_ASSERT(sizeof(vector_t) <= sizeof(((smallvec_t*)NULL)->header), "smallvec_t header is too small");
 
 // get the size of the vector struct given a number of elements
 static size_t vector_typesize(size_t size)
@@ -38,7 +43,20 @@ static size_t vector_typesize(size_t size)
 
 static void vector_ensure(vector_t **vector, size_t size)
 {
-    if (size >= VEC->size)
+    if (VEC->placed)
+    {
+        if (size <= VEC->size)
+            return;
+
+        // placed vectors cant be resized in place, move them into the arena
+        size_t resize = (size + 1) * 2;
+        vector_t *heap = ARENA_MALLOC(vector_typesize(resize), "vector", NULL, VEC->arena);
+        ctu_memcpy(heap, VEC, vector_typesize(VEC->used));
+        heap->size = resize;
+        heap->placed = false;
+        VEC = heap;
+    }
+    else if (size >= VEC->size)
     {
         size_t resize = (size + 1) * 2;
         VEC = arena_realloc(VEC, vector_typesize(resize), vector_typesize(size), VEC->arena);
@@ -53,6 +71,7 @@ static vector_t *vector_init_inner(size_t size, size_t used, arena_t *arena)
     vector->arena = arena;
     vector->size = size;
     vector->used = used;
+    vector->placed = false;
 
     return vector;
 }
@@ -75,6 +94,50 @@ vector_t *vector_of(size_t len, arena_t *arena)
     return vector_init_inner(len, len, arena);
 }
 
+STA_DECL
+size_t vector_place_size(size_t capacity)
+{
+    return vector_typesize(capacity);
+}
+
+STA_DECL
+vector_t *vector_place(void *buffer, size_t capacity, size_t len, arena_t *arena)
+{
+    CTASSERT(buffer != NULL);
+    CTASSERT(arena != NULL);
+    CTASSERTF(len <= capacity, "vector_place(len=%zu, capacity=%zu)", len, capacity);
+
+    vector_t *vector = buffer;
+    vector->arena = arena;
+    vector->size = capacity;
+    vector->used = len;
+    vector->placed = true;
+
+    return vector;
+}
+
+STA_DECL
+vector_t *vector_place_copy(void *buffer, const vector_t *vector, arena_t *arena)
+{
+    CTASSERT(vector != NULL);
+
+    size_t len = vector_len(vector);
+    vector_t *copy = vector_place(buffer, len, len, arena);
+    ctu_memcpy(copy->data, vector->data, len * sizeof(void *));
+    return copy;
+}
+
+STA_DECL
+vector_t *smallvec_of(smallvec_t *storage, size_t len, arena_t *arena)
+{
+    CTASSERT(storage != NULL);
+
+    if (len > CT_SMALLVEC_SIZE)
+        return vector_of(len, arena);
+
+    return vector_place(storage, CT_SMALLVEC_SIZE, len, arena);
+}
+
 STA_DECL
 vector_t *vector_init(void *value, arena_t *arena)
 {
@@ -101,6 +164,10 @@ void vector_delete(vector_t *vector)
 {
     CTASSERT(vector != NULL);
 
+    // placed vectors are freed along with the storage they live in
+    if (vector->placed)
+        return;
+
     arena_free(vector, vector_typesize(vector->size), vector->arena);
 }
 
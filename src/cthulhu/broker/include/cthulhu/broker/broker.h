@@ -23,6 +23,7 @@ typedef struct tree_cookie_t tree_cookie_t;
 typedef struct io_t io_t;
 typedef struct node_t node_t;
 typedef struct logger_t logger_t;
+typedef struct typevec_t typevec_t;
 typedef struct tree_attrib_t tree_attrib_t;
 typedef struct ssa_result_t ssa_result_t;
 
@@ -78,6 +79,7 @@ typedef enum broker_event_t
     eEventCount
 } broker_event_t;
 
+/// @brief the arenas owned by the broker
 typedef enum broker_arena_t
 {
 #define BROKER_ARENA(ID, STR) ID,
@@ -262,12 +264,21 @@ typedef struct language_runtime_t
     const language_t *info;
     broker_t *broker;
 
-    /// @brief default memory arena
+    /// @brief default memory arena, used for the tree IR
     arena_t *arena;
 
-    /// @brief arena for the language ast
+    /// @brief arena for the language ast and parser scratch memory
+    /// @warning released by @ref broker_release_ast once sema is complete
     arena_t *ast_arena;
 
+    /// @brief arena for strings such as identifiers and literals
+    arena_t *string_arena;
+
+    /// @brief arena for scratch memory
+    /// @warning this arena is reset after every pass, nothing allocated
+    ///          from it may outlive the pass it was allocated in
+    arena_t *transient_arena;
+
     /// @brief logger
     logger_t *logger;
 
@@ -282,6 +293,7 @@ typedef struct compile_unit_t
 
     /// @brief the ast for this unit
     /// is NULL if this is a builtin/precompiled unit
+    /// or if the ast has been released with @ref broker_release_ast
     void *ast;
 
     /// @brief the tree for this unit
@@ -328,14 +340,55 @@ CT_BROKER_API compile_unit_t *broker_get_unit(IN_NOTNULL broker_t *broker, unit_
 
 CT_BROKER_API void broker_parse(IN_NOTNULL language_runtime_t *runtime, IN_NOTNULL io_t *io);
 
+/// @brief a source file to parse with @ref broker_parse_sources
+typedef struct broker_source_t
+{
+    /// @brief the language to parse the source with
+    language_runtime_t *lang;
+
+    /// @brief the source file
+    io_t *io;
+} broker_source_t;
+
+/// @brief parse many source files
+/// when @p jobs is more than 1 every file is parsed on a worker thread with
+/// its own arenas and logger. once all files are parsed the events and units
+/// are merged in the order of @p sources, so the result is the same as calling
+/// @ref broker_parse on each source in turn.
+/// @pre when @p jobs is more than 1 the broker arena, the global arena and the
+///      gmp arena must be thread safe. arenas that are not can be wrapped with
+///      @ref shared_new
+///
+/// @param broker the broker
+/// @param sources the files to parse
+/// @param jobs the maximum number of files to parse at once
+CT_BROKER_API void broker_parse_sources(IN_NOTNULL broker_t *broker, IN_NOTNULL const typevec_t *sources, size_t jobs);
+
 CT_BROKER_API void broker_run_pass(IN_NOTNULL broker_t *broker, broker_pass_t pass);
 
 CT_BROKER_API void broker_resolve(IN_NOTNULL broker_t *broker);
 
+/// @brief release the ast of every unit
+/// frees all memory in the ast arena at once, including scanner
+/// and parser scratch memory. only the tree IR is kept.
+/// @warning no passes may be run and no files may be parsed after this
+/// @pre all units must have been resolved with @ref broker_resolve
+///
+/// @param broker the broker
+CT_BROKER_API void broker_release_ast(IN_NOTNULL broker_t *broker);
+
 CT_BROKER_API logger_t *broker_get_logger(IN_NOTNULL broker_t *broker);
 CT_BROKER_API const node_t *broker_get_node(IN_NOTNULL broker_t *broker);
 CT_BROKER_API arena_t *broker_get_arena(IN_NOTNULL broker_t *broker);
 
+/// @brief get one of the purpose specific arenas owned by the broker
+///
+/// @param broker the broker
+/// @param arena the arena to get
+///
+/// @return the arena
+CT_BROKER_API arena_t *broker_get_purpose_arena(IN_NOTNULL broker_t *broker, IN_DOMAIN(<, eArenaCount) broker_arena_t arena);
+
 /// @brief get all the modules in the broker
 /// this does not include the root module
 CT_BROKER_API vector_t *broker_get_modules(IN_NOTNULL broker_t *broker);
@@ -7,19 +7,27 @@
 #include "cthulhu/events/events.h"
 
 #include "arena/arena.h"
+#include "arena/region.h"
 #include "base/panic.h"
 #include "base/util.h"
+#include "core/macros.h"
 #include "cthulhu/tree/tree.h"
 #include "interop/compile.h"
+#include "memory/memory.h"
 #include "notify/notify.h"
+#include "os/sched.h"
 #include "scan/node.h"
 #include "std/map.h"
+#include "std/typed/vector.h"
 #include "std/vector.h"
 
 typedef struct broker_t
 {
     const frontend_t *frontend;
     arena_t *arena;
+
+    // purpose specific arenas, all allocated from arena
+    arena_t *arenas[eArenaCount];
     node_t *builtin;
     logger_t *logger;
     tree_cookie_t cookie;
@@ -45,6 +53,13 @@ typedef struct broker_t
 
     // all builtin modules
     map_t *builtins;
+
+    // ast regions of files parsed in parallel, released with the ast arena
+    // vector_t<arena_t*>
+    vector_t *shards;
+
+    // has the ast arena been released
+    bool ast_released;
 } broker_t;
 
 static const size_t kDeclSizes[eSemaCount] = {
@@ -54,6 +69,11 @@ static const size_t kDeclSizes[eSemaCount] = {
     [eSemaModules] = 64,
 };
 
+static const char *const kArenaNames[eArenaCount] = {
+#define BROKER_ARENA(ID, STR) [ID] = (STR),
+#include "cthulhu/broker/broker.inc"
+};
+
 #define OPT_EXEC(fn, ...) do { if (fn != NULL) fn(__VA_ARGS__); } while (0)
 
 /// @brief was the parse successful
@@ -137,6 +157,11 @@ broker_t *broker_new(const frontend_t *frontend, arena_t *arena)
     broker_t *broker = ARENA_MALLOC(sizeof(broker_t), "broker", NULL, arena);
     broker->frontend = frontend;
     broker->arena = arena;
+
+    for (size_t i = 0; i < eArenaCount; i++)
+    {
+        broker->arenas[i] = region_new(kArenaNames[i], CT_REGION_CHUNK_SIZE, arena);
+    }
     broker->builtin = node_builtin(info.name, arena);
     broker->logger = logger_new(arena);
 
@@ -160,6 +185,8 @@ broker_t *broker_new(const frontend_t *frontend, arena_t *arena)
 
     broker->units = map_new(64, kTypeInfoText, arena);
     broker->builtins = map_new(64, kTypeInfoText, arena);
+    broker->shards = vector_new(0, arena);
+    broker->ast_released = false;
 
     ARENA_REPARENT(broker->root, broker, arena);
     ARENA_REPARENT(broker->langs, broker, arena);
@@ -167,6 +194,7 @@ broker_t *broker_new(const frontend_t *frontend, arena_t *arena)
     ARENA_REPARENT(broker->plugins, broker, arena);
     ARENA_REPARENT(broker->units, broker, arena);
     ARENA_REPARENT(broker->builtins, broker, arena);
+    ARENA_REPARENT(broker->shards, broker, arena);
 
     return broker;
 }
@@ -192,10 +220,11 @@ language_runtime_t *broker_add_language(broker_t *broker, const language_t *lang
     runtime->info = lang;
     runtime->broker = broker;
 
-    // TODO: seperate arena per language
-    runtime->arena = arena;
+    runtime->arena = broker->arenas[eArenaTree];
     runtime->logger = broker->logger;
-    runtime->ast_arena = arena;
+    runtime->ast_arena = broker->arenas[eArenaAst];
+    runtime->string_arena = broker->arenas[eArenaString];
+    runtime->transient_arena = broker->arenas[eArenaTransient];
 
     node_t *node = node_builtin(info.id, arena);
     ARENA_REPARENT(node, runtime, arena);
@@ -345,6 +374,15 @@ arena_t *broker_get_arena(broker_t *broker)
     return broker->arena;
 }
 
+STA_DECL
+arena_t *broker_get_purpose_arena(broker_t *broker, broker_arena_t arena)
+{
+    CTASSERT(broker != NULL);
+    CT_ASSERT_RANGE(arena, 0, eArenaCount - 1);
+
+    return broker->arenas[arena];
+}
+
 static void collect_units(vector_t **vec, map_t *map)
 {
     map_iter_t iter = map_iter(map);
@@ -372,28 +410,27 @@ vector_t *broker_get_modules(broker_t *broker)
     return modules;
 }
 
-STA_DECL
-void broker_parse(language_runtime_t *runtime, io_t *io)
+// the context is only needed while parsing, so it lives with the ast.
+// nodes are referenced by the tree and must outlive the ast,
+// but scanner and parser buffers are released along with it
+static scan_t *parse_begin(language_runtime_t *runtime, io_t *io, logger_t *logger, arena_t *ast, arena_t *strings, arena_t *nodes)
 {
-    CTASSERT(runtime != NULL);
-    CTASSERT(io != NULL);
-
-    broker_t *broker = runtime->broker;
-
     const language_t *lang = runtime->info;
     const module_info_t *info = &lang->info;
 
-    scan_context_t *ctx = ARENA_MALLOC(sizeof(scan_context_t) + lang->context_size, "scan context", runtime, broker->arena);
-    ctx->logger = broker->logger;
-    ctx->arena = broker->arena;
-    ctx->string_arena = broker->arena;
-    ctx->ast_arena = broker->arena;
+    scan_context_t *ctx = ARENA_MALLOC(sizeof(scan_context_t) + lang->context_size, "scan context", runtime, ast);
+    ctx->logger = logger;
+    ctx->arena = ast;
+    ctx->string_arena = strings;
+    ctx->ast_arena = ast;
 
     // TODO: allow languages that dont use scanner callbacks
     CTASSERTF(lang->scanner != NULL, "language '%s' did not specify a scanner", info->name);
 
-    scan_t *scan = scan_io(info->name, io, broker->arena);
-    ARENA_REPARENT(scan, runtime, broker->arena);
+    scan_t *scan = scan_io(info->name, io, nodes);
+    ARENA_REPARENT(scan, runtime, nodes);
+
+    scan->arena = ast;
 
     if (lang->fn_preparse != NULL)
     {
@@ -405,20 +442,145 @@ void broker_parse(language_runtime_t *runtime, io_t *io)
         scan_set_context(scan, ctx);
     }
 
-    parse_result_t result = scan_buffer(scan, lang->scanner);
+    return scan;
+}
+
+static void parse_end(language_runtime_t *runtime, scan_t *scan, parse_result_t result)
+{
+    broker_t *broker = runtime->broker;
+    const language_t *lang = runtime->info;
+
     if (!parse_ok(result, scan, broker->logger))
     {
         return;
     }
 
-    CTASSERTF(lang->fn_postparse != NULL, "language '%s' did not specify a postparse function", info->name);
+    CTASSERTF(lang->fn_postparse != NULL, "language '%s' did not specify a postparse function", lang->info.name);
     lang->fn_postparse(runtime, scan, result.tree);
 }
 
+STA_DECL
+void broker_parse(language_runtime_t *runtime, io_t *io)
+{
+    CTASSERT(runtime != NULL);
+    CTASSERT(io != NULL);
+
+    broker_t *broker = runtime->broker;
+    CTASSERTF(!broker->ast_released, "cannot parse after the ast arena has been released");
+
+    const language_t *lang = runtime->info;
+
+    scan_t *scan = parse_begin(runtime, io, broker->logger, runtime->ast_arena, runtime->string_arena, broker->arena);
+    parse_result_t result = scan_buffer(scan, lang->scanner);
+    parse_end(runtime, scan, result);
+}
+
+///
+/// parallel parsing
+///
+
+// most files are small, so shards grow in smaller steps than the broker arenas
+#define SHARD_CHUNK_SIZE (64U * 1024U)
+
+// a file parsed on a worker thread, with everything the parser writes to
+typedef struct parse_shard_t
+{
+    language_runtime_t *runtime;
+    scan_t *scan;
+
+    // events reported while parsing, merged into the broker logger afterwards
+    logger_t *logger;
+
+    parse_result_t result;
+} parse_shard_t;
+
+static void parse_range(size_t first, size_t last, void *arg)
+{
+    typevec_t *shards = arg;
+
+    for (size_t i = first; i < last; i++)
+    {
+        parse_shard_t *shard = typevec_offset(shards, i);
+        shard->result = scan_buffer(shard->scan, shard->runtime->info->scanner);
+    }
+}
+
+static parse_shard_t parse_shard(broker_t *broker, const broker_source_t *source)
+{
+    CTASSERT(source->lang != NULL);
+    CTASSERT(source->io != NULL);
+
+    // the ast is released with the rest of the ast arena, everything
+    // else the parser creates is kept for the rest of the compile
+    arena_t *ast = region_new("shard ast", SHARD_CHUNK_SIZE, broker->arena);
+    arena_t *data = region_new("shard data", SHARD_CHUNK_SIZE, broker->arena);
+    vector_push(&broker->shards, ast);
+
+    logger_t *logger = logger_new(data);
+
+    parse_shard_t shard = {
+        .runtime = source->lang,
+        .scan = parse_begin(source->lang, source->io, logger, ast, data, data),
+        .logger = logger,
+    };
+
+    return shard;
+}
+
+static void parse_shards(typevec_t *shards, size_t jobs, arena_t *arena)
+{
+    // the calling thread runs tasks while it waits, so it is one of the jobs
+    os_sched_t *sched = os_sched_new(jobs - 1, arena);
+    os_parallel_for(sched, 0, typevec_len(shards), 1, parse_range, shards);
+    os_sched_delete(sched);
+}
+
+STA_DECL
+void broker_parse_sources(broker_t *broker, const typevec_t *sources, size_t jobs)
+{
+    CTASSERT(broker != NULL);
+    CTASSERT(sources != NULL);
+    CTASSERTF(!broker->ast_released, "cannot parse after the ast arena has been released");
+
+    size_t len = typevec_len(sources);
+    if (jobs <= 1 || len <= 1)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            const broker_source_t *source = typevec_offset(sources, i);
+            broker_parse(source->lang, source->io);
+        }
+
+        return;
+    }
+
+    // the atom table is created on first use, which must not race
+    CT_UNUSED(get_atom_table());
+
+    typevec_t *shards = typevec_new(sizeof(parse_shard_t), len, broker->arena);
+    for (size_t i = 0; i < len; i++)
+    {
+        parse_shard_t shard = parse_shard(broker, typevec_offset(sources, i));
+        typevec_push(shards, &shard);
+    }
+
+    parse_shards(shards, jobs, broker->arena);
+
+    // merge in the order the sources were given so the units
+    // and reported events do not depend on thread timing
+    for (size_t i = 0; i < len; i++)
+    {
+        parse_shard_t *shard = typevec_offset(shards, i);
+        logger_append(broker->logger, shard->logger);
+        parse_end(shard->runtime, shard->scan, shard->result);
+    }
+}
+
 STA_DECL
 void broker_run_pass(broker_t *broker, broker_pass_t pass)
 {
     CTASSERT(broker != NULL);
+    CTASSERTF(!broker->ast_released, "cannot run pass '%s' after the ast arena has been released", broker_pass_name(pass));
 
     map_iter_t iter = map_iter(broker->units);
     while (map_has_next(&iter))
@@ -444,6 +606,9 @@ void broker_run_pass(broker_t *broker, broker_pass_t pass)
 
         OPT_EXEC(fn, lang, unit);
     }
+
+    // nothing in the transient arena may outlive a pass
+    region_reset(broker->arenas[eArenaTransient]);
 }
 
 STA_DECL
@@ -454,6 +619,33 @@ void broker_resolve(broker_t *broker)
     resolve_module(broker->root);
 }
 
+STA_DECL
+void broker_release_ast(broker_t *broker)
+{
+    CTASSERT(broker != NULL);
+    CTASSERT(!broker->ast_released);
+
+    map_iter_t iter = map_iter(broker->units);
+    while (map_has_next(&iter))
+    {
+        map_entry_t entry = map_next(&iter);
+        compile_unit_t *unit = entry.value;
+        unit->ast = NULL;
+    }
+
+    // every ast, scan context and parser buffer is released in one go
+    region_reset(broker->arenas[eArenaAst]);
+
+    size_t shards = vector_len(broker->shards);
+    for (size_t i = 0; i < shards; i++)
+    {
+        region_delete(vector_get(broker->shards, i));
+    }
+
+    vector_reset(broker->shards);
+    broker->ast_released = true;
+}
+
 ///
 /// translation unit api
 ///
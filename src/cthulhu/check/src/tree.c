@@ -13,6 +13,7 @@
 #include "cthulhu/tree/query.h"
 
 #include "arena/arena.h"
+#include "arena/region.h"
 #include "std/vector.h"
 #include "std/set.h"
 #include "std/map.h"
@@ -24,6 +25,9 @@
 #include <stdint.h>
 #include <stdio.h>
 
+// size of each chunk of scratch memory
+#define CHECK_SCRATCH_SIZE (64U * 1024U)
+
 typedef struct check_t
 {
     logger_t *reports;
@@ -36,8 +40,18 @@ typedef struct check_t
 
     set_t *checked_exprs;
     set_t *checked_types;
+
+    // scratch memory for diagnostic text
+    // released after each declaration is checked
+    arena_t *scratch;
 } check_t;
 
+// diagnostic text is copied by the logger, so it can live in scratch memory
+static const char *check_string(check_t *check, const tree_t *tree)
+{
+    return tree_to_string_arena(tree, check->scratch);
+}
+
 // check for a valid name and a type being set
 static bool check_simple(check_t *check, const tree_t *decl)
 {
@@ -189,8 +203,8 @@ static void check_func_return_equal(check_t *check, const tree_t *return_type, c
 
     msg_notify(check->reports, &kEvent_ReturnTypeMismatch, tree_get_node(real_type),
         "return type `%s` does not match function return type `%s`",
-        tree_to_string(real_type),
-        tree_to_string(return_type)
+        check_string(check, real_type),
+        check_string(check, return_type)
     );
 }
 
@@ -211,14 +225,14 @@ static void check_deprecated_call(check_t *check, const tree_t *expr)
     msg_note(id, "deprecated: %s", attribs->deprecated);
 }
 
-static const char *get_fn_name(const tree_t *fn)
+static const char *get_fn_name(check_t *check, const tree_t *fn)
 {
     if (tree_is(fn, eTreeDeclFunction)) { return tree_get_name(fn); }
 
     // its an indirect call, so give the type name
 
     // TODO: need a pretty typename function
-    return tree_to_string(tree_get_type(fn));
+    return check_string(check, tree_get_type(fn));
 }
 
 static void check_single_expr(check_t *check, const tree_t *expr);
@@ -245,7 +259,7 @@ static void check_params(check_t *check, const vector_t *args, const vector_t *p
                 i + 1,
                 name
             );
-            msg_note(id, "expected `%s`, got `%s`", tree_to_string(param_type), tree_to_string(arg_type));
+            msg_note(id, "expected `%s`, got `%s`", check_string(check, param_type), check_string(check, arg_type));
         }
     }
 }
@@ -255,7 +269,7 @@ static void check_call_args_fixed(check_t *check, const tree_t *expr, const vect
     size_t arg_count = vector_len(args);
     size_t param_count = vector_len(params);
 
-    const char *name = get_fn_name(expr->callee);
+    const char *name = get_fn_name(check, expr->callee);
 
     if (arg_count != param_count)
     {
@@ -276,7 +290,7 @@ static void check_call_args_variadic(check_t *check, const tree_t *expr, const v
     size_t arg_count = vector_len(args);
     size_t param_count = vector_len(params);
 
-    const char *name = get_fn_name(expr->callee);
+    const char *name = get_fn_name(check, expr->callee);
 
     if (arg_count < param_count)
     {
@@ -341,7 +355,7 @@ static void check_bitcast_expr(check_t *check, const tree_t *expr)
     {
         event_builder_t msg = msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "bitcast to invalid type `%s`",
-            tree_to_string(dst)
+            check_string(check, dst)
         );
         msg_note(msg, "expected digit, pointer or opaque pointer");
     }
@@ -351,7 +365,7 @@ static void check_bitcast_expr(check_t *check, const tree_t *expr)
     {
         event_builder_t msg = msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "bitcast from invalid type `%s`",
-            tree_to_string(src)
+            check_string(check, src)
         );
         msg_note(msg, "expected digit, pointer or opaque pointer");
     }
@@ -364,7 +378,7 @@ static void check_signextend_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "sign extension of non-integer type `%s`",
-            tree_to_string(dst)
+            check_string(check, dst)
         );
     }
 
@@ -373,7 +387,7 @@ static void check_signextend_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "sign extension from non-integer type `%s`",
-            tree_to_string(src)
+            check_string(check, src)
         );
     }
 }
@@ -385,7 +399,7 @@ static void check_zeroextend_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "zero extension into non-integer type `%s`",
-            tree_to_string(dst)
+            check_string(check, dst)
         );
     }
 
@@ -394,7 +408,7 @@ static void check_zeroextend_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "zero extension of non-integer type `%s`",
-            tree_to_string(src)
+            check_string(check, src)
         );
     }
 }
@@ -413,7 +427,7 @@ static void check_cast_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "invalid cast from type `%s`",
-            tree_to_string(src)
+            check_string(check, src)
         );
 
         return;
@@ -423,7 +437,7 @@ static void check_cast_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "invalid cast to type `%s`",
-            tree_to_string(dst)
+            check_string(check, dst)
         );
 
         return;
@@ -462,8 +476,8 @@ static void check_binary_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "binary operation with non-digit types `%s` and `%s`",
-            tree_to_string(lhs),
-            tree_to_string(rhs)
+            check_string(check, lhs),
+            check_string(check, rhs)
         );
     }
 
@@ -478,8 +492,8 @@ static void check_binary_expr(check_t *check, const tree_t *expr)
     {
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(expr),
             "binary operation with different types `%s` and `%s`",
-            tree_to_string(lhs),
-            tree_to_string(rhs)
+            check_string(check, lhs),
+            check_string(check, rhs)
         );
     }
 }
@@ -587,8 +601,8 @@ static void check_assign(check_t *check, const tree_t *stmt)
     {
         msg_notify(check->reports, &kEvent_InvalidAssignment, tree_get_node(stmt),
             "assignment of type `%s` to `%s`",
-            tree_to_string(src_type),
-            tree_to_string(dst_type)
+            check_string(check, src_type),
+            check_string(check, dst_type)
         );
     }
 #endif
@@ -823,7 +837,7 @@ static void check_global_type(check_t *check, const tree_t *global)
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(global),
             "global `%s` is of unit type `%s`",
             tree_get_name(global),
-            tree_to_string(ty)
+            check_string(check, ty)
         );
     }
     else if (tree_is(ty, eTreeTypeEmpty))
@@ -831,7 +845,7 @@ static void check_global_type(check_t *check, const tree_t *global)
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(global),
             "global `%s` is of empty type `%s`",
             tree_get_name(global),
-            tree_to_string(ty)
+            check_string(check, ty)
         );
     }
 
@@ -842,7 +856,7 @@ static void check_global_type(check_t *check, const tree_t *global)
         msg_notify(check->reports, &kEvent_InvalidType, tree_get_node(global),
             "global value `%s` has invalid storage `%s`",
             tree_get_name(global),
-            tree_to_string(ty)
+            check_string(check, ty)
         );
     }
 }
@@ -1035,12 +1049,15 @@ static void check_module_valid(check_t *check, const tree_t *mod)
     {
         const tree_t *global = vector_get(globals, i);
         CTASSERTF(tree_is(global, eTreeDeclGlobal), "invalid global `%s`", tree_to_string(global));
+
+        arena_mark_t mark = arena_mark(check->scratch);
         check_simple(check, global);
 
         check_global_attribs(check, global);
         check_global_recursion(check, global);
         check_global_type(check, global);
         check_global_init(check, global);
+        arena_release_to(check->scratch, mark);
     }
 
     vector_t *functions = map_values(tree_module_tag(mod, eSemaProcs));
@@ -1049,10 +1066,13 @@ static void check_module_valid(check_t *check, const tree_t *mod)
     {
         const tree_t *function = vector_get(functions, i);
         CTASSERTF(tree_is(function, eTreeDeclFunction), "invalid function `%s`", tree_to_string(function));
+
+        arena_mark_t mark = arena_mark(check->scratch);
         check_simple(check, function);
 
         check_func_attribs(check, function);
         check_function_definition(check, function);
+        arena_release_to(check->scratch, mark);
     }
 
     vector_t *types = map_values(tree_module_tag(mod, eSemaTypes));
@@ -1082,6 +1102,8 @@ void check_tree(logger_t *reports, vector_t *mods, arena_t *arena)
 
         .checked_exprs = set_new(64, kTypeInfoPtr, arena),
         .checked_types = set_new(64, kTypeInfoPtr, arena),
+
+        .scratch = region_new("check", CHECK_SCRATCH_SIZE, arena),
     };
 
     size_t len = vector_len(mods);
@@ -1090,4 +1112,6 @@ void check_tree(logger_t *reports, vector_t *mods, arena_t *arena)
         const tree_t *tree = vector_get(mods, i);
         check_module_valid(&check, tree);
     }
+
+    region_delete(check.scratch);
 }
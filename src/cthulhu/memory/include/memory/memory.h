@@ -9,6 +9,7 @@
 CT_BEGIN_API
 
 typedef struct arena_t arena_t;
+typedef struct atom_table_t atom_table_t;
 
 /// @defgroup global_memory Global memory allocation
 /// @ingroup runtime
@@ -22,7 +23,23 @@ typedef struct arena_t arena_t;
 /// @return the global memory arena
 CT_MEMORY_API arena_t *get_global_arena(void);
 
+/// @brief get the pool for small fixed size nodes
+/// the pool is layered on top of the global arena and packs nodes
+/// of the same size together in memory.
+///
+/// @return the node pool
+CT_MEMORY_API arena_t *get_node_arena(void);
+
+/// @brief get the global identifier table
+/// identifiers interned in this table are shared by all languages
+/// and compare equal by pointer, the table is layered on top of the global arena.
+/// @warning the first call must happen before any other threads intern atoms
+///
+/// @return the atom table
+CT_MEMORY_API atom_table_t *get_atom_table(void);
+
 /// @brief initialize the global memory arena
+/// the node pool and atom table are recreated on top of @p arena when they are next used
 /// @warning this should be called with care, as it will overwrite the current arena
 ///
 /// @param arena the arena to initialize
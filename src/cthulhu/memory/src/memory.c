@@ -3,8 +3,11 @@
 #include "memory/memory.h"
 
 #include "arena/arena.h"
+#include "arena/pool.h"
 #include "base/panic.h"
 
+#include "std/atom.h"
+
 #include <gmp.h>
 
 ///
@@ -12,17 +15,50 @@
 ///
 
 static arena_t *gGlobalArena = NULL;
+static arena_t *gNodeArena = NULL;
+static atom_table_t *gAtomTable = NULL;
+
+// the number of identifiers the atom table starts with room for
+#define ATOM_TABLE_SIZE (1024)
 
 arena_t *get_global_arena(void)
 {
     return gGlobalArena;
 }
 
+arena_t *get_node_arena(void)
+{
+    // created on first use so that installing a global
+    // arena never allocates from it
+    if (gNodeArena == NULL)
+    {
+        CTASSERTF(gGlobalArena != NULL, "global arena has not been initialized");
+        gNodeArena = pool_new("nodes", CT_POOL_SLAB_SIZE, gGlobalArena);
+    }
+
+    return gNodeArena;
+}
+
+atom_table_t *get_atom_table(void)
+{
+    if (gAtomTable == NULL)
+    {
+        CTASSERTF(gGlobalArena != NULL, "global arena has not been initialized");
+        gAtomTable = atom_table_new(ATOM_TABLE_SIZE, gGlobalArena);
+    }
+
+    return gAtomTable;
+}
+
 void init_global_arena(arena_t *arena)
 {
     CTASSERT(arena != NULL);
 
+    // the previous pool and atoms are left alone, anything allocated
+    // from them is still owned by the previous arena
     gGlobalArena = arena;
+    gNodeArena = NULL;
+    gAtomTable = NULL;
 }
 
 /// gmp arena managment
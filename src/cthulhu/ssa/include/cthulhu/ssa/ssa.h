@@ -21,6 +21,7 @@ CT_BEGIN_API
 typedef struct logger_t logger_t;
 typedef struct vector_t vector_t;
 typedef struct typevec_t typevec_t;
+typedef struct segvec_t segvec_t;
 typedef struct map_t map_t;
 typedef struct set_t set_t;
 typedef struct arena_t arena_t;
@@ -327,7 +328,9 @@ typedef struct ssa_step_t {
 typedef struct ssa_block_t
 {
     const char *name;
-    typevec_t *steps;
+
+    /// @note segvec_t<ssa_step_t>, steps never move once added
+    segvec_t *steps;
 } ssa_block_t;
 
 typedef struct ssa_symbol_t
@@ -9,6 +9,7 @@
 #include "std/map.h"
 #include "std/vector.h"
 
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 
 #include "scan/node.h"
@@ -60,7 +61,7 @@ static void ssa_opt_global(ssa_vm_t *vm, ssa_symbol_t *global);
 static const ssa_step_t *get_step_indexed(const ssa_block_t *block, size_t index)
 {
     CTASSERT(block != NULL);
-    return typevec_offset(block->steps, index);
+    return segvec_offset(block->steps, index);
 }
 
 static const ssa_value_t *ssa_opt_operand(ssa_scope_t *vm, ssa_operand_t operand)
@@ -322,10 +323,10 @@ static const ssa_value_t *ssa_opt_step(ssa_scope_t *vm, const ssa_step_t *step)
 
 static void ssa_opt_block(ssa_scope_t *vm, const ssa_block_t *block)
 {
-    size_t len = typevec_len(block->steps);
-    for (size_t i = 0; i < len; i++)
+    segvec_iter_t iter = segvec_iter(block->steps);
+    while (segvec_has_next(&iter))
     {
-        const ssa_step_t *step = typevec_offset(block->steps, i);
+        const ssa_step_t *step = segvec_next(&iter);
         const ssa_value_t *value = ssa_opt_step(vm, step);
         map_set(vm->step_values, step, (void*)value);
 
@@ -377,10 +378,16 @@ void ssa_opt(logger_t *reports, ssa_result_t result, arena_t *arena)
         add_globals(&vm, mod);
     }
 
-    set_iter_t iter = set_iter(vm.globals);
-    while (set_has_next(&iter))
+    // walk the modules rather than the pointer keyed set so that
+    // globals are evaluated, and errors reported, in a stable order
+    for (size_t i = 0; i < len; i++)
     {
-        ssa_symbol_t *global = (ssa_symbol_t*)set_next(&iter);
-        ssa_opt_global(&vm, global);
+        const ssa_module_t *mod = vector_get(result.modules, i);
+        size_t count = vector_len(mod->globals);
+        for (size_t j = 0; j < count; j++)
+        {
+            ssa_symbol_t *global = vector_get(mod->globals, j);
+            ssa_opt_global(&vm, global);
+        }
     }
 }
@@ -5,14 +5,19 @@
 #include "cthulhu/tree/query.h"
 
 #include "arena/arena.h"
+#include "arena/pool.h"
+#include "arena/region.h"
 #include "std/str.h"
 #include "std/map.h"
 #include "std/set.h"
 #include "std/vector.h"
 
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 
 #include "base/panic.h"
+#include "core/macros.h"
+
 #include <stdio.h>
 
 /// @brief the ssa compilation context
@@ -33,6 +38,10 @@ typedef struct ssa_compile_t
 
     arena_t *arena;
 
+    /// @brief pool for basic blocks
+    /// keeps blocks packed together for the optimizer and emitter walks
+    arena_t *block_arena;
+
     /// @brief all strings in the program
     /// map_t<text_view_t*, ssa_symbol>
     size_t string_count;
@@ -50,6 +59,10 @@ typedef struct ssa_compile_t
     /// map<tree, ssa_type>
     map_t *types;
 
+    /// @brief scratch memory for the symbol being compiled
+    /// released after each symbol is compiled
+    arena_t *scratch;
+
     /// @brief all locals in the current symbol
     /// map<tree, size_t>
     map_t *symbol_locals;
@@ -168,7 +181,6 @@ static ssa_symbol_t *function_create(ssa_compile_t *ssa, const tree_t *tree)
         };
 
         typevec_set(self->locals, i, &it);
-        map_set(ssa->symbol_locals, local, (void*)(uintptr_t)i);
     }
 
     size_t params = vector_len(tree->params);
@@ -185,7 +197,6 @@ static ssa_symbol_t *function_create(ssa_compile_t *ssa, const tree_t *tree)
         };
 
         typevec_set(self->params, i, &it);
-        map_set(ssa->symbol_locals, param, (void*)(uintptr_t)i);
     }
 
     return self;
@@ -239,9 +250,9 @@ static ssa_module_t *module_create(ssa_compile_t *ssa, const char *name)
 
 static ssa_operand_t bb_add_step(ssa_block_t *bb, ssa_step_t step)
 {
-    size_t index = typevec_len(bb->steps);
+    size_t index = segvec_len(bb->steps);
 
-    typevec_push(bb->steps, &step);
+    segvec_push(bb->steps, &step);
 
     ssa_operand_t operand = {
         .kind = eOperandReg,
@@ -274,11 +285,12 @@ static ssa_operand_t add_step(ssa_compile_t *ssa, ssa_step_t step)
     return bb_add_step(ssa->current_block, step);
 }
 
-static ssa_block_t *ssa_block_create(ssa_symbol_t *symbol, const char *name, size_t size, arena_t *arena)
+static ssa_block_t *ssa_block_create(ssa_compile_t *ssa, ssa_symbol_t *symbol, const char *name, size_t size)
 {
-    ssa_block_t *bb = ARENA_MALLOC(sizeof(ssa_block_t), name, symbol, arena);
+    arena_t *arena = ssa->arena;
+    ssa_block_t *bb = ARENA_MALLOC(sizeof(ssa_block_t), name, symbol, ssa->block_arena);
     bb->name = name;
-    bb->steps = typevec_new(sizeof(ssa_step_t), size, arena);
+    bb->steps = segvec_new(sizeof(ssa_step_t), size, arena);
     vector_push(&symbol->blocks, bb);
 
     ARENA_IDENTIFY(bb->steps, "steps", bb, arena);
@@ -293,9 +305,9 @@ static ssa_operand_t compile_branch(ssa_compile_t *ssa, const tree_t *branch)
     ssa_operand_t cond = compile_tree(ssa, branch->cond);
     ssa_block_t *current = ssa->current_block;
 
-    ssa_block_t *tail_block = ssa_block_create(ssa->current_symbol, "tail", 0, ssa->arena);
-    ssa_block_t *then_block = ssa_block_create(ssa->current_symbol, "then", 0, ssa->arena);
-    ssa_block_t *else_block = branch->other != NULL ? ssa_block_create(ssa->current_symbol, "other", 0, ssa->arena) : NULL;
+    ssa_block_t *tail_block = ssa_block_create(ssa, ssa->current_symbol, "tail", 0);
+    ssa_block_t *then_block = ssa_block_create(ssa, ssa->current_symbol, "then", 0);
+    ssa_block_t *else_block = branch->other != NULL ? ssa_block_create(ssa, ssa->current_symbol, "other", 0) : NULL;
 
     ssa_step_t step = {
         .opcode = eOpBranch,
@@ -350,9 +362,9 @@ static ssa_operand_t compile_loop(ssa_compile_t *ssa, const tree_t *tree)
     * .tail:
     *
     */
-    ssa_block_t *loop_block = ssa_block_create(ssa->current_symbol, NULL, 0, ssa->arena);
-    ssa_block_t *body_block = ssa_block_create(ssa->current_symbol, NULL, 0, ssa->arena);
-    ssa_block_t *tail_block = ssa_block_create(ssa->current_symbol, NULL, 0, ssa->arena);
+    ssa_block_t *loop_block = ssa_block_create(ssa, ssa->current_symbol, NULL, 0);
+    ssa_block_t *body_block = ssa_block_create(ssa, ssa->current_symbol, NULL, 0);
+    ssa_block_t *tail_block = ssa_block_create(ssa, ssa->current_symbol, NULL, 0);
 
     ssa_loop_t save = {
         .enter_loop = body_block,
@@ -830,18 +842,35 @@ static void forward_module(ssa_compile_t *ssa, const tree_t *tree)
 
 static void begin_compile(ssa_compile_t *ssa, ssa_symbol_t *symbol)
 {
-    ssa_block_t *bb = ssa_block_create(symbol, "entry", 4, ssa->arena);
+    ssa_block_t *bb = ssa_block_create(ssa, symbol, "entry", 4);
 
     symbol->entry = bb;
     ssa->current_block = bb;
     ssa->current_symbol = symbol;
+
+    // globals have no locals or params
+    size_t locals = (symbol->locals != NULL) ? typevec_len(symbol->locals) : 0;
+    size_t params = (symbol->params != NULL) ? typevec_len(symbol->params) : 0;
+    ssa->symbol_locals = map_optimal(CT_MAX(locals + params, 1), kTypeInfoPtr, ssa->scratch);
+    ssa->symbol_loops = map_optimal(32, kTypeInfoPtr, ssa->scratch);
 }
 
-// static void reset_local_maps(ssa_compile_t *ssa)
-// {
-//     map_reset(ssa->locals);
-//     map_reset(ssa->loops);
-// }
+static void add_symbol_locals(ssa_compile_t *ssa, const tree_t *tree)
+{
+    size_t locals = vector_len(tree->locals);
+    for (size_t i = 0; i < locals; i++)
+    {
+        const tree_t *local = vector_get(tree->locals, i);
+        map_set(ssa->symbol_locals, local, (void*)(uintptr_t)i);
+    }
+
+    size_t params = vector_len(tree->params);
+    for (size_t i = 0; i < params; i++)
+    {
+        const tree_t *param = vector_get(tree->params, i);
+        map_set(ssa->symbol_locals, param, (void*)(uintptr_t)i);
+    }
+}
 
 /// @brief a prediction of how many items will be in each map
 /// this is not a hard limit, but a hint to the allocator
@@ -917,6 +946,7 @@ ssa_result_t ssa_compile(vector_t *mods, arena_t *arena)
 
     ssa_compile_t ssa = {
         .arena = arena,
+        .block_arena = pool_new("blocks", CT_POOL_SLAB_SIZE, arena),
 
         .modules = vector_new(sizes.modules, arena),
         .symbol_deps = map_optimal(sizes.deps, kTypeInfoPtr, arena),
@@ -927,9 +957,7 @@ ssa_result_t ssa_compile(vector_t *mods, arena_t *arena)
         .functions = map_optimal(sizes.functions, kTypeInfoPtr, arena),
         .types = map_optimal(sizes.types, kTypeInfoPtr, arena),
 
-        // TODO: these should be per symbol rather than persistent global
-        .symbol_locals = map_optimal(sizes.deps * 4, kTypeInfoPtr, arena),
-        .symbol_loops = map_optimal(32, kTypeInfoPtr, arena),
+        .scratch = region_new("ssa scratch", CT_REGION_CHUNK_SIZE, arena),
 
         .module_lookup = map_optimal(sizes.deps, kTypeInfoPtr, arena),
     };
@@ -941,6 +969,9 @@ ssa_result_t ssa_compile(vector_t *mods, arena_t *arena)
         forward_module(&ssa, mod);
     }
 
+    // everything allocated while compiling a symbol is released in one go
+    arena_mark_t mark = arena_mark(ssa.scratch);
+
     map_iter_t globals = map_iter(ssa.globals);
     while (map_has_next(&globals))
     {
@@ -978,7 +1009,7 @@ ssa_result_t ssa_compile(vector_t *mods, arena_t *arena)
             add_step(&ssa, ret);
         }
 
-        map_reset(ssa.symbol_loops);
+        arena_release_to(ssa.scratch, mark);
     }
 
     map_iter_t functions = map_iter(ssa.functions);
@@ -993,6 +1024,7 @@ ssa_result_t ssa_compile(vector_t *mods, arena_t *arena)
         CTASSERTF(ssa.current_module != NULL, "symbol `%s` has no module", symbol->name);
 
         begin_compile(&ssa, symbol);
+        add_symbol_locals(&ssa, tree);
 
         const tree_t *body = tree->body;
         if (body != NULL)
@@ -1008,9 +1040,11 @@ ssa_result_t ssa_compile(vector_t *mods, arena_t *arena)
             );
         }
 
-        map_reset(ssa.symbol_loops);
+        arena_release_to(ssa.scratch, mark);
     }
 
+    region_delete(ssa.scratch);
+
     ssa_result_t result = {
         .modules = ssa.modules,
         .deps = ssa.symbol_deps
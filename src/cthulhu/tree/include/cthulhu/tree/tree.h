@@ -578,6 +578,14 @@ CT_TREE_API void *tree_module_find(tree_t *sema, size_t tag, const char *name, t
  */
 CT_TREE_API void *tree_module_set(tree_t *self, size_t tag, const char *name, void *value);
 
+/// @brief get all declarations of a category in a module
+/// @note the keys of the map are atoms from @ref get_atom_table,
+///       use @ref atom_intern before looking up names directly
+///
+/// @param self the module
+/// @param tag the declaration category
+///
+/// @return the declarations or NULL if the module does not have @p tag
 CT_TREE_API map_t *tree_module_tag(const tree_t *self, size_t tag);
 
 /**
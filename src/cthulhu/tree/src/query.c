@@ -56,13 +56,13 @@ char *tree_to_string_arena(const tree_t *self, arena_t *arena)
         return str_format(arena, "{ error: %s }", self->message);
 
     case eTreeTypeArray:
-        return str_format(arena, "{ array %s { element: %s, length: %zu } }", tree_get_name(self), tree_to_string(self->ptr), self->length);
+        return str_format(arena, "{ array %s { element: %s, length: %zu } }", tree_get_name(self), tree_to_string_arena(self->ptr, arena), self->length);
 
     case eTreeTypePointer:
-        return str_format(arena, "{ pointer %s { to: %s, length: %s } }", tree_get_name(self), tree_to_string(self->ptr), length_name(self->length, arena));
+        return str_format(arena, "{ pointer %s { to: %s, length: %s } }", tree_get_name(self), tree_to_string_arena(self->ptr, arena), length_name(self->length, arena));
 
     case eTreeTypeReference:
-        return str_format(arena, "{ reference %s { to: %s } }", tree_get_name(self), tree_to_string(self->ptr));
+        return str_format(arena, "{ reference %s { to: %s } }", tree_get_name(self), tree_to_string_arena(self->ptr, arena));
 
     case eTreeTypeAlias:
         return str_format(arena, "{ alias %s { to: %s } }", tree_get_name(self), tree_to_string_arena(tree_get_type(self), arena));
@@ -5,6 +5,7 @@
 
 #include "cthulhu/tree/query.h"
 
+#include "std/atom.h"
 #include "std/vector.h"
 #include "std/map.h"
 
@@ -31,7 +32,7 @@ static tree_t *tree_module_new(const node_t *node, const char *name,
 
     for (size_t i = 0; i < decls; i++)
     {
-        map_t *map = map_optimal(sizes[i], kTypeInfoString, arena);
+        map_t *map = map_optimal(sizes[i], kTypeInfoAtom, arena);
         ARENA_IDENTIFY(map, "module_tag", self, arena);
         vector_set(self->tags, i, map);
     }
@@ -56,16 +57,23 @@ tree_t *tree_module(tree_t *parent, const node_t *node, const char *name, size_t
     return tree_module_new(node, name, parent, parent->cookie, parent->reports, decls, sizes, parent->arena);
 }
 
-void *tree_module_get(tree_t *self, size_t tag, const char *name)
+// all module maps are keyed by atoms, so the name is interned once
+// and every module in the chain compares by pointer
+static const char *get_module_key(const char *name)
 {
     CTASSERT(name != NULL);
 
+    return atom_intern(get_atom_table(), name);
+}
+
+static void *module_get_atom(tree_t *self, size_t tag, const char *id)
+{
     // its ok to do an early return here and skip checking the parent module
     // because parent modules will always have <= the tags of the child module
     map_t *map = tree_module_tag(self, tag);
     if (map == NULL) return NULL;
 
-    tree_t *old = map_get(map, name);
+    tree_t *old = map_get(map, id);
     if (old != NULL)
     {
         return old;
@@ -73,18 +81,14 @@ void *tree_module_get(tree_t *self, size_t tag, const char *name)
 
     if (self->parent != NULL)
     {
-        return tree_module_get(self->parent, tag, name);
+        return module_get_atom(self->parent, tag, id);
     }
 
     return NULL;
 }
 
-void *tree_module_find(tree_t *sema, size_t tag, const char *name, tree_t **module)
+static void *module_find_atom(tree_t *sema, size_t tag, const char *id, tree_t **module)
 {
-    CTASSERT(sema != NULL);
-    CTASSERT(name != NULL);
-    CTASSERT(module != NULL);
-
     map_t *map = tree_module_tag(sema, tag);
     if (map == NULL)
     {
@@ -92,7 +96,7 @@ void *tree_module_find(tree_t *sema, size_t tag, const char *name, tree_t **modu
         return NULL;
     }
 
-    tree_t *decl = map_get(map, name);
+    tree_t *decl = map_get(map, id);
     if (decl != NULL)
     {
         *module = sema;
@@ -101,23 +105,37 @@ void *tree_module_find(tree_t *sema, size_t tag, const char *name, tree_t **modu
 
     if (sema->parent != NULL)
     {
-        return tree_module_find(sema->parent, tag, name, module);
+        return module_find_atom(sema->parent, tag, id, module);
     }
 
     *module = NULL;
     return NULL;
 }
 
+void *tree_module_get(tree_t *self, size_t tag, const char *name)
+{
+    return module_get_atom(self, tag, get_module_key(name));
+}
+
+void *tree_module_find(tree_t *sema, size_t tag, const char *name, tree_t **module)
+{
+    CTASSERT(sema != NULL);
+    CTASSERT(module != NULL);
+
+    return module_find_atom(sema, tag, get_module_key(name), module);
+}
+
 void *tree_module_set(tree_t *self, size_t tag, const char *name, void *value)
 {
-    void *old = tree_module_get(self, tag, name);
+    const char *id = get_module_key(name);
+    void *old = module_get_atom(self, tag, id);
     if (old != NULL)
     {
         return old;
     }
 
     map_t *map = tree_module_tag(self, tag);
-    map_set(map, name, value);
+    map_set(map, id, value);
 
     return NULL;
 }
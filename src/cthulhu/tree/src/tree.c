@@ -19,10 +19,11 @@ static const tree_attribs_t kDefaultAttrib = {
     .visibility = eVisiblePrivate
 };
 
-tree_t *tree_new(tree_kind_t kind, const node_t *node, const tree_t *type)
+// allocate a tree with @p extra bytes of trailing storage
+static tree_t *tree_alloc(tree_kind_t kind, const node_t *node, const tree_t *type, size_t extra)
 {
-    arena_t *arena = get_global_arena();
-    tree_t *self = ARENA_MALLOC(sizeof(tree_t), tree_kind_to_string(kind), NULL, arena);
+    arena_t *arena = get_node_arena();
+    tree_t *self = ARENA_MALLOC(sizeof(tree_t) + extra, tree_kind_to_string(kind), NULL, arena);
 
     self->kind = kind;
     self->node = node;
@@ -32,10 +33,31 @@ tree_t *tree_new(tree_kind_t kind, const node_t *node, const tree_t *type)
     return self;
 }
 
-tree_t *tree_decl(tree_kind_t kind, const node_t *node, const tree_t *type, const char *name, tree_quals_t quals)
+// copy a short list into the trailing storage of the tree that owns it.
+// callers can then build the list in a smallvec_t on the stack.
+static const vector_t *tree_embed_list(tree_t *self, const vector_t *list)
+{
+    if (vector_len(list) == 0)
+        return &kEmptyVector;
+
+    return vector_place_copy(self + 1, list, get_node_arena());
+}
+
+static size_t tree_list_size(const vector_t *list)
+{
+    size_t len = vector_len(list);
+    return (len == 0) ? 0 : vector_place_size(len);
+}
+
+tree_t *tree_new(tree_kind_t kind, const node_t *node, const tree_t *type)
+{
+    return tree_alloc(kind, node, type, 0);
+}
+
+static tree_t *tree_decl_alloc(tree_kind_t kind, const node_t *node, const tree_t *type, const char *name, tree_quals_t quals, size_t extra)
 {
-    tree_t *self = tree_new(kind, node, type);
-    ARENA_RENAME(self, (name == NULL) ? "<anonymous>" : name, get_global_arena());
+    tree_t *self = tree_alloc(kind, node, type, extra);
+    ARENA_RENAME(self, (name == NULL) ? "<anonymous>" : name, get_node_arena());
 
     self->name = name;
     self->attrib = &kDefaultAttrib;
@@ -46,6 +68,11 @@ tree_t *tree_decl(tree_kind_t kind, const node_t *node, const tree_t *type, cons
     return self;
 }
 
+tree_t *tree_decl(tree_kind_t kind, const node_t *node, const tree_t *type, const char *name, tree_quals_t quals)
+{
+    return tree_decl_alloc(kind, node, type, name, quals, 0);
+}
+
 void tree_report(logger_t *reports, const tree_t *error)
 {
     msg_notify(reports, error->diagnostic, tree_get_node(error), "%s", error->message);
@@ -155,9 +182,9 @@ tree_t *tree_type_closure(const node_t *node, const char *name, const tree_t *re
         TREE_EXPECT(param, eTreeDeclParam);
     }
 
-    tree_t *self = tree_decl(eTreeTypeClosure, node, NULL, name, eQualNone);
+    tree_t *self = tree_decl_alloc(eTreeTypeClosure, node, NULL, name, eQualNone, tree_list_size(params));
     self->return_type = result;
-    self->params = params;
+    self->params = tree_embed_list(self, params);
     self->arity = arity;
     return self;
 }
@@ -346,9 +373,10 @@ tree_t *tree_expr_call(const node_t *node, const tree_t *callee, const vector_t
     CTASSERT(callee != NULL);
     CTASSERT(args != NULL);
 
-    tree_t *self = tree_new(eTreeExprCall, node, tree_fn_get_return(tree_get_type(callee)));
+    const tree_t *type = tree_fn_get_return(tree_get_type(callee));
+    tree_t *self = tree_alloc(eTreeExprCall, node, type, tree_list_size(args));
     self->callee = callee;
-    self->args = args;
+    self->args = tree_embed_list(self, args);
     return self;
 }
 
@@ -10,6 +10,18 @@ typedef struct map_t map_t;
 typedef struct ap_t ap_t;
 typedef struct vector_t vector_t;
 
+/// @brief the allocator used for compilation
+typedef enum tool_arena_t
+{
+    /// @brief use the global heap allocator
+    eToolArenaDefault,
+
+    /// @brief use a region allocator that is released in bulk
+    eToolArenaRegion,
+
+    eToolArenaCount
+} tool_arena_t;
+
 typedef struct tool_t
 {
     cfg_group_t *config;
@@ -28,6 +40,11 @@ typedef struct tool_t
     cfg_field_t *report_limit;
     cfg_field_t *report_style;
 
+    cfg_field_t *arena;
+    cfg_field_t *memory_stats;
+
+    cfg_field_t *jobs;
+
     setup_options_t options;
 } tool_t;
 
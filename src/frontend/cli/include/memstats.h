@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <stddef.h>
+
+typedef struct arena_t arena_t;
+typedef struct io_t io_t;
+
+/// @brief allocation statistics collected while compiling
+typedef struct mem_stats_t mem_stats_t;
+
+/// @brief create a new statistics collector
+/// all allocations made through the arena returned by @ref mem_stats_arena
+/// are forwarded to @p inner and counted
+///
+/// @param inner the arena to forward allocations to
+/// @param arena the arena to allocate bookkeeping data from, this is not counted
+///
+/// @return the statistics collector
+mem_stats_t *mem_stats_new(arena_t *inner, arena_t *arena);
+
+/// @brief get the counting arena
+///
+/// @param stats the statistics collector
+///
+/// @return the arena that counts allocations
+arena_t *mem_stats_arena(mem_stats_t *stats);
+
+/// @brief begin a new phase
+/// all allocations from now on are attributed to this phase
+///
+/// @param stats the statistics collector
+/// @param name the name of the phase
+void mem_stats_phase(mem_stats_t *stats, const char *name);
+
+/// @brief write a report of all phases and the largest allocation sites
+///
+/// @param stats the statistics collector
+/// @param io the io to write the report to
+/// @param top the number of allocation sites to report
+void mem_stats_report(mem_stats_t *stats, io_t *io, size_t top);
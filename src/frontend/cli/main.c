@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "cmd.h"
+#include "memstats.h"
 
 #include "base/util.h"
 #include "config/config.h"
@@ -28,6 +29,11 @@
 
 #include "cthulhu/ssa/ssa.h"
 
+#include "arena/region.h"
+#include "arena/shared.h"
+#include "memory/memory.h"
+#include "std/typed/vector.h"
+
 #include "core/macros.h"
 #include "support/loader.h"
 #include "support/support.h"
@@ -49,7 +55,7 @@ static const frontend_t kFrontendInfo = {
     }
 };
 
-static void parse_source(broker_t *broker, support_t *support, const char *path)
+static void add_source(typevec_t *sources, broker_t *broker, support_t *support, const char *path)
 {
     const node_t *node = broker_get_node(broker);
     logger_t *reports = broker_get_logger(broker);
@@ -83,7 +89,12 @@ static void parse_source(broker_t *broker, support_t *support, const char *path)
         return;
     }
 
-    broker_parse(lang, io);
+    broker_source_t source = {
+        .lang = lang,
+        .io = io,
+    };
+
+    typevec_push(sources, &source);
 }
 
 static int check_reports(logger_t *logger, report_config_t config, const char *title)
@@ -99,12 +110,23 @@ static int check_reports(logger_t *logger, report_config_t config, const char *t
     return 0;
 }
 
+typedef struct cli_module_t
+{
+    const char *path;
+    module_type_t type;
+} cli_module_t;
+
 typedef struct cli_t
 {
     broker_t *broker;
     support_t *support;
     logger_t *logger;
     io_t *con;
+
+    // modules requested on the command line
+    // these are loaded once the broker has been created
+    // typevec_t<cli_module_t>
+    typevec_t *modules;
 } cli_t;
 
 static bool add_shared_module(cli_t *cli, const char *path, module_type_t type)
@@ -131,12 +153,33 @@ static bool add_shared_module(cli_t *cli, const char *path, module_type_t type)
 #endif
 }
 
+static bool queue_shared_module(cli_t *cli, const char *path, module_type_t type)
+{
+    cli_module_t mod = {
+        .path = path,
+        .type = type,
+    };
+
+    typevec_push(cli->modules, &mod);
+    return true;
+}
+
+static void load_shared_modules(cli_t *cli)
+{
+    size_t len = typevec_len(cli->modules);
+    for (size_t i = 0; i < len; i++)
+    {
+        const cli_module_t *mod = typevec_offset(cli->modules, i);
+        add_shared_module(cli, mod->path, mod->type);
+    }
+}
+
 static bool on_add_plugin(ap_t *ap, const cfg_field_t *param, const void *value, void *data)
 {
     CT_UNUSED(ap);
     CT_UNUSED(param);
 
-    return add_shared_module(data, value, eModPlugin);
+    return queue_shared_module(data, value, eModPlugin);
 }
 
 static bool on_add_target(ap_t *ap, const cfg_field_t *param, const void *value, void *data)
@@ -144,7 +187,7 @@ static bool on_add_target(ap_t *ap, const cfg_field_t *param, const void *value,
     CT_UNUSED(ap);
     CT_UNUSED(param);
 
-    return add_shared_module(data, value, eModTarget);
+    return queue_shared_module(data, value, eModTarget);
 }
 
 static bool on_add_language(ap_t *ap, const cfg_field_t *param, const void *value, void *data)
@@ -152,7 +195,65 @@ static bool on_add_language(ap_t *ap, const cfg_field_t *param, const void *valu
     CT_UNUSED(ap);
     CT_UNUSED(param);
 
-    return add_shared_module(data, value, eModLanguage);
+    return queue_shared_module(data, value, eModLanguage);
+}
+
+static arena_t *select_arena(tool_arena_t kind)
+{
+    arena_t *heap = ctu_default_alloc();
+    if (kind != eToolArenaRegion)
+        return heap;
+
+    // nothing allocated during compilation is freed before exit
+    // so a single region can serve everything
+    arena_t *region = region_new("compile", CT_REGION_CHUNK_SIZE, heap);
+    init_global_arena(region);
+    init_gmp_arena(region);
+
+    return region;
+}
+
+static arena_t *select_stats(mem_stats_t **stats, bool enabled, arena_t *arena)
+{
+    if (!enabled)
+        return arena;
+
+    // bookkeeping comes from the heap so it is not counted
+    *stats = mem_stats_new(arena, ctu_default_alloc());
+
+    arena_t *counter = mem_stats_arena(*stats);
+    init_global_arena(counter);
+    init_gmp_arena(counter);
+
+    return counter;
+}
+
+static arena_t *select_shared(size_t jobs, bool thread_safe, arena_t *arena)
+{
+    if (jobs <= 1 || thread_safe)
+        return arena;
+
+    // files are parsed on multiple threads that all allocate from the
+    // compile arena, regions and memory stats have to be serialized
+    arena_t *shared = shared_new("compile", arena);
+    init_global_arena(shared);
+    init_gmp_arena(shared);
+
+    return shared;
+}
+
+static void begin_phase(mem_stats_t *stats, const char *name)
+{
+    if (stats == NULL) return;
+
+    mem_stats_phase(stats, name);
+}
+
+static void report_stats(mem_stats_t *stats, io_t *io)
+{
+    if (stats == NULL) return;
+
+    mem_stats_report(stats, io, 10);
 }
 
 #define CHECK_LOG(logger, fmt)                               \
@@ -161,6 +262,7 @@ static bool on_add_language(ap_t *ap, const cfg_field_t *param, const void *valu
         int err = check_reports(logger, report_config, fmt); \
         if (err != CT_EXIT_OK)                                  \
         {                                                    \
+            report_stats(stats, con);                        \
             return err;                                      \
         }                                                    \
     } while (0)
@@ -169,25 +271,15 @@ int main(int argc, const char **argv)
 {
     setup_default(NULL);
 
-    arena_t *arena = ctu_default_alloc();
-    broker_t *broker = broker_new(&kFrontendInfo, arena);
-    loader_t *loader = loader_new(arena);
-    support_t *support = support_new(broker, loader, arena);
-
-    support_load_default_modules(support);
-
-    logger_t *reports = broker_get_logger(broker);
-    const node_t *node = broker_get_node(broker);
+    arena_t *heap = ctu_default_alloc();
     io_t *con = io_stdout();
 
     cli_t cli = {
-        .broker = broker,
-        .support = support,
-        .logger = reports,
-        .con = con
+        .con = con,
+        .modules = typevec_new(sizeof(cli_module_t), 4, heap),
     };
 
-    tool_t tool = make_tool(kFrontendInfo.info.version, arena);
+    tool_t tool = make_tool(kFrontendInfo.info.version, heap);
 
     ap_t *ap = tool.options.ap;
 
@@ -199,6 +291,33 @@ int main(int argc, const char **argv)
     if (setup_should_exit(&init))
         return setup_exit_code(&init);
 
+    // the allocator is chosen on the command line, so nothing
+    // that lives for the whole compile can be created before this
+    mem_stats_t *stats = NULL;
+    tool_arena_t kind = cfg_enum_value(tool.arena);
+    bool memory_stats = cfg_bool_value(tool.memory_stats);
+    arena_t *arena = select_arena(kind);
+    arena = select_stats(&stats, memory_stats, arena);
+
+    // the default heap is already thread safe
+    size_t jobs = (size_t)cfg_int_value(tool.jobs);
+    arena = select_shared(jobs, kind != eToolArenaRegion && !memory_stats, arena);
+
+    broker_t *broker = broker_new(&kFrontendInfo, arena);
+    loader_t *loader = loader_new(arena);
+    support_t *support = support_new(broker, loader, arena);
+
+    support_load_default_modules(support);
+
+    logger_t *reports = broker_get_logger(broker);
+    const node_t *node = broker_get_node(broker);
+
+    cli.broker = broker;
+    cli.support = support;
+    cli.logger = reports;
+
+    load_shared_modules(&cli);
+
     broker_init(broker);
 
     vector_t *paths = ap_get_posargs(ap);
@@ -228,35 +347,49 @@ int main(int argc, const char **argv)
 
     CHECK_LOG(reports, "opening sources");
 
+    begin_phase(stats, "parse");
+    typevec_t *sources = typevec_new(sizeof(broker_source_t), total_sources, arena);
     for (size_t i = 0; i < total_sources; i++)
     {
         const char *path = vector_get(paths, i);
-        parse_source(broker, support, path);
+        add_source(sources, broker, support, path);
     }
 
+    broker_parse_sources(broker, sources, jobs);
+
     CHECK_LOG(reports, "parsing sources");
 
     for (size_t pass = 0; pass < ePassCount; pass++)
     {
+        begin_phase(stats, broker_pass_name(pass));
         broker_run_pass(broker, pass);
 
         char *msg = str_format(arena, "running pass %s", broker_pass_name(pass));
         CHECK_LOG(reports, msg);
     }
 
+    begin_phase(stats, "resolve");
     broker_resolve(broker);
     CHECK_LOG(reports, "compiling sources");
 
+    // the tree is complete, the ast is no longer needed
+    broker_release_ast(broker);
+
+    begin_phase(stats, "check");
     vector_t *mods = broker_get_modules(broker);
     check_tree(reports, mods, arena);
     CHECK_LOG(reports, "checking tree");
 
+    begin_phase(stats, "ssa");
     ssa_result_t ssa = ssa_compile(mods, arena);
     CHECK_LOG(reports, "compiling ssa");
 
+    begin_phase(stats, "opt");
     ssa_opt(reports, ssa, arena);
     CHECK_LOG(reports, "optimizing ssa");
 
+    begin_phase(stats, "emit");
+
     // fs_t *fs = fs_virtual("out", arena);
 
     const char *target_output = cfg_string_value(tool.output_target);
@@ -273,7 +406,8 @@ int main(int argc, const char **argv)
     }
     CHECK_LOG(reports, "querying target");
 
-    fs_t *out = fs_physical(output_dir, arena);
+    // the emitters write in small pieces, collect them before they reach the disk
+    fs_t *out = fs_physical_buffered(output_dir, 0x10000, arena);
     if (out == NULL)
     {
         msg_notify(reports, &kEvent_FailedToCreateOutputDirectory, node,
@@ -290,6 +424,8 @@ int main(int argc, const char **argv)
     target_emit_ssa(target, &ssa, &emit);
     CHECK_LOG(reports, "emitting target ssa");
 
+    report_stats(stats, con);
+
 #if 0
     emit_options_t base_emit_options = {
         .arena = arena,
@@ -118,6 +118,35 @@ static const cfg_choice_t kReportStyleChoices[] = {
     { "complex", eTextComplex },
 };
 
+static const cfg_arg_t kArenaArgs[] = { CT_ARG_LONG("arena") };
+
+static const cfg_info_t kArena = {
+    .name = "arena",
+    .brief = "Allocator to use for compilation",
+    .args = CT_ARGS(kArenaArgs),
+};
+
+static const cfg_choice_t kArenaChoices[] = {
+    { "default", eToolArenaDefault },
+    { "region", eToolArenaRegion },
+};
+
+static const cfg_arg_t kMemoryStatsArgs[] = { CT_ARG_LONG("memory-stats") };
+
+static const cfg_info_t kMemoryStats = {
+    .name = "memory-stats",
+    .brief = "Report allocation statistics for each compilation phase",
+    .args = CT_ARGS(kMemoryStatsArgs),
+};
+
+static const cfg_arg_t kJobsArgs[] = { CT_ARG_SHORT("j"), CT_ARG_LONG("jobs") };
+
+static const cfg_info_t kJobs = {
+    .name = "jobs",
+    .brief = "Number of source files to parse at once",
+    .args = CT_ARGS(kJobsArgs),
+};
+
 tool_t make_tool(version_info_t version, arena_t *arena)
 {
     cfg_group_t *config = config_root(&kConfigInfo, arena);
@@ -155,6 +184,17 @@ tool_t make_tool(version_info_t version, arena_t *arena)
     };
     cfg_field_t *report_style_field = config_enum(options.report.group, &kReportStyle, report_style_options);
 
+    cfg_enum_t arena_options = {
+        .options = kArenaChoices,
+        .count = (sizeof(kArenaChoices) / sizeof(cfg_choice_t)),
+        .initial = eToolArenaDefault,
+    };
+    cfg_field_t *arena_field = config_enum(config, &kArena, arena_options);
+    cfg_field_t *memory_stats_field = config_bool(config, &kMemoryStats, false);
+
+    cfg_int_t jobs_options = {.initial = 1, .min = 1, .max = 64};
+    cfg_field_t *jobs_field = config_int(config, &kJobs, jobs_options);
+
     tool_t tool = {
         .config = config,
         .options = options,
@@ -172,6 +212,11 @@ tool_t make_tool(version_info_t version, arena_t *arena)
         .warn_as_error = warn_as_error_field,
         .report_limit = report_limit_field,
         .report_style = report_style_field,
+
+        .arena = arena_field,
+        .memory_stats = memory_stats_field,
+
+        .jobs = jobs_field,
     };
 
     return tool;
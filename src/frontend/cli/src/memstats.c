@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "memstats.h"
+
+#include "arena/arena.h"
+#include "base/panic.h"
+#include "io/io.h"
+#include "std/map.h"
+#include "std/typed/vector.h"
+
+#include "core/macros.h"
+
+#include <stdint.h>
+
+// every allocation is prefixed with a header so sizes
+// and sites are known even when the caller does not know them
+typedef struct mem_site_t
+{
+    const char *name;
+
+    // number of live allocations currently named after this site
+    size_t count;
+
+    // total bytes allocated under this name
+    size_t bytes;
+} mem_site_t;
+
+typedef struct mem_header_t
+{
+    size_t size;
+    mem_site_t *site;
+} mem_header_t;
+
+#define MEM_HEADER CT_ALIGN_POW2(sizeof(mem_header_t), sizeof(void*) * 2)
+
+typedef struct mem_phase_t
+{
+    const char *name;
+
+    size_t mallocs;
+    size_t reallocs;
+    size_t frees;
+
+    // bytes requested during this phase
+    size_t bytes;
+
+    // the most bytes live at once during this phase
+    size_t peak;
+
+    // bytes live when this phase ended
+    size_t live;
+} mem_phase_t;
+
+typedef struct mem_stats_t
+{
+    arena_t arena;
+    arena_t *inner;
+    arena_t *data;
+
+    // map_t<const char*, mem_site_t*>
+    map_t *sites;
+    mem_site_t *unnamed;
+
+    // typevec_t<mem_phase_t>
+    typevec_t *phases;
+
+    size_t live;
+} mem_stats_t;
+
+static mem_site_t *site_new(mem_stats_t *stats, const char *name)
+{
+    mem_site_t *site = ARENA_MALLOC(sizeof(mem_site_t), "site", stats, stats->data);
+    site->name = arena_strdup(name, stats->data);
+    site->count = 0;
+    site->bytes = 0;
+    return site;
+}
+
+static mem_site_t *get_site(mem_stats_t *stats, const char *name)
+{
+    mem_site_t *site = map_get(stats->sites, name);
+    if (site != NULL) return site;
+
+    site = site_new(stats, name);
+    map_set(stats->sites, site->name, site);
+    return site;
+}
+
+static mem_phase_t *current_phase(mem_stats_t *stats)
+{
+    size_t len = typevec_len(stats->phases);
+    return typevec_offset(stats->phases, len - 1);
+}
+
+static mem_header_t *get_header(void *ptr)
+{
+    return (mem_header_t*)((char*)ptr - MEM_HEADER);
+}
+
+static void *get_data(mem_header_t *header)
+{
+    return (char*)header + MEM_HEADER;
+}
+
+static void stats_grow(mem_stats_t *stats, size_t size)
+{
+    mem_phase_t *phase = current_phase(stats);
+    phase->bytes += size;
+
+    stats->live += size;
+    phase->peak = CT_MAX(phase->peak, stats->live);
+}
+
+static void *stats_malloc(size_t size, void *user)
+{
+    mem_stats_t *stats = user;
+
+    mem_header_t *header = arena_opt_malloc(size + MEM_HEADER, stats->inner);
+    if (header == NULL) return NULL;
+
+    header->size = size;
+    header->site = stats->unnamed;
+    header->site->count += 1;
+    header->site->bytes += size;
+
+    current_phase(stats)->mallocs += 1;
+    stats_grow(stats, size);
+
+    return get_data(header);
+}
+
+static void *stats_realloc(void *ptr, size_t new_size, size_t old_size, void *user)
+{
+    CT_UNUSED(old_size);
+
+    mem_stats_t *stats = user;
+    mem_header_t *header = get_header(ptr);
+    size_t size = header->size;
+
+    header = arena_opt_realloc(header, new_size + MEM_HEADER, size + MEM_HEADER, stats->inner);
+    if (header == NULL) return NULL;
+
+    header->size = new_size;
+    current_phase(stats)->reallocs += 1;
+
+    if (new_size > size)
+    {
+        header->site->bytes += new_size - size;
+        stats_grow(stats, new_size - size);
+    }
+    else
+    {
+        stats->live -= size - new_size;
+    }
+
+    return get_data(header);
+}
+
+static void stats_free(void *ptr, size_t size, void *user)
+{
+    CT_UNUSED(size);
+
+    mem_stats_t *stats = user;
+    mem_header_t *header = get_header(ptr);
+
+    header->site->count -= 1;
+    stats->live -= header->size;
+    current_phase(stats)->frees += 1;
+
+    arena_opt_free(header, header->size + MEM_HEADER, stats->inner);
+}
+
+static void stats_rename(const void *ptr, const char *name, void *user)
+{
+    mem_stats_t *stats = user;
+    mem_header_t *header = get_header((void*)ptr);
+
+    // move the allocation over to its new site
+    mem_site_t *site = get_site(stats, name);
+    if (site == header->site) return;
+
+    header->site->count -= 1;
+    header->site->bytes -= header->size;
+
+    site->count += 1;
+    site->bytes += header->size;
+    header->site = site;
+}
+
+static void begin_phase(mem_stats_t *stats, const char *name)
+{
+    mem_phase_t phase = {
+        .name = name,
+        .peak = stats->live,
+    };
+
+    typevec_push(stats->phases, &phase);
+}
+
+mem_stats_t *mem_stats_new(arena_t *inner, arena_t *arena)
+{
+    CTASSERT(inner != NULL);
+    CTASSERT(arena != NULL);
+
+    mem_stats_t *stats = ARENA_MALLOC(sizeof(mem_stats_t), "memory stats", NULL, arena);
+
+    arena_t counter = {
+        .name = inner->name,
+        .fn_malloc = stats_malloc,
+        .fn_realloc = stats_realloc,
+        .fn_free = stats_free,
+        .fn_rename = stats_rename,
+        .user = stats,
+    };
+
+    stats->arena = counter;
+    stats->inner = inner;
+    stats->data = arena;
+    stats->sites = map_new(1024, kTypeInfoString, arena);
+    stats->unnamed = get_site(stats, "<unnamed>");
+    stats->phases = typevec_new(sizeof(mem_phase_t), 16, arena);
+    stats->live = 0;
+
+    begin_phase(stats, "init");
+
+    return stats;
+}
+
+arena_t *mem_stats_arena(mem_stats_t *stats)
+{
+    CTASSERT(stats != NULL);
+
+    return &stats->arena;
+}
+
+void mem_stats_phase(mem_stats_t *stats, const char *name)
+{
+    CTASSERT(stats != NULL);
+    CTASSERT(name != NULL);
+
+    current_phase(stats)->live = stats->live;
+    begin_phase(stats, name);
+}
+
+static int site_compare(const void *lhs, const void *rhs)
+{
+    const mem_site_t *a = lhs;
+    const mem_site_t *b = rhs;
+
+    if (a->bytes > b->bytes) return -1;
+    if (a->bytes < b->bytes) return 1;
+    return 0;
+}
+
+void mem_stats_report(mem_stats_t *stats, io_t *io, size_t top)
+{
+    CTASSERT(stats != NULL);
+    CTASSERT(io != NULL);
+
+    current_phase(stats)->live = stats->live;
+
+    io_printf(io, "memory stats for arena `%s`\n", stats->inner->name);
+    io_printf(io, "%-24s %10s %10s %10s %14s %14s %14s\n", "phase", "mallocs", "reallocs", "frees", "bytes", "peak", "live");
+
+    size_t phases = typevec_len(stats->phases);
+    for (size_t i = 0; i < phases; i++)
+    {
+        const mem_phase_t *phase = typevec_offset(stats->phases, i);
+        io_printf(io, "%-24s %10zu %10zu %10zu %14zu %14zu %14zu\n",
+            phase->name, phase->mallocs, phase->reallocs, phase->frees,
+            phase->bytes, phase->peak, phase->live
+        );
+    }
+
+    typevec_t *sites = typevec_new(sizeof(mem_site_t), map_count(stats->sites), stats->data);
+    map_iter_t iter = map_iter(stats->sites);
+    while (map_has_next(&iter))
+    {
+        map_entry_t entry = map_next(&iter);
+        const mem_site_t *site = entry.value;
+        typevec_push(sites, site);
+    }
+
+    typevec_sort(sites, site_compare);
+
+    size_t len = CT_MIN(typevec_len(sites), top);
+    io_printf(io, "top %zu allocation sites by bytes\n", len);
+
+#if !CTU_TRACE_MEMORY
+    io_printf(io, "allocation names are only recorded when memory tracing is enabled\n");
+#endif
+
+    io_printf(io, "%-40s %10s %14s\n", "site", "live", "bytes");
+
+    for (size_t i = 0; i < len; i++)
+    {
+        const mem_site_t *site = typevec_offset(sites, i);
+        io_printf(io, "%-40s %10zu %14zu\n", site->name, site->count, site->bytes);
+    }
+}
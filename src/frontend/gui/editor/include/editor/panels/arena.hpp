@@ -4,6 +4,7 @@
 #include "editor/arena.hpp"
 #include "editor/memory.hpp"
 
+#include <random>
 #include <unordered_set>
 #include <vector>
 #include <stacktrace>
@@ -13,12 +14,20 @@ struct AllocInfo
     size_t id; ///< the id of the allocation
     Memory size; ///< the size of the allocation
     std::chrono::steady_clock::time_point timestamp; ///< the time of the allocation
-    size_t trace; ///< hash of the stack trace
+    size_t trace; ///< hash of the stack trace, 0 if no trace was captured
 
     std::string name; ///< the name of the allocation
     const void *parent; ///< the parent of the allocation
 };
 
+/// @brief allocation totals attributed to a single stack trace
+struct SiteInfo
+{
+    size_t samples = 0; ///< the number of allocations captured at this site
+    double bytes = 0; ///< the estimated number of bytes allocated at this site
+    double count = 0; ///< the estimated number of allocations made at this site
+};
+
 class TraceArena final : public IArena
 {
 public:
@@ -52,6 +61,20 @@ public:
 
     size_t add_stacktrace(const std::stacktrace& trace);
 
+    // estimated totals per stack trace hash
+    std::unordered_map<size_t, SiteInfo> sites;
+
+    // poisson sampling state, a stack is only captured when
+    // the countdown crosses zero
+    std::minstd_rand rng;
+    size_t sample_interval = kDefaultSampleInterval;
+    size_t bytes_until_sample = 0;
+    size_t samples_taken = 0;
+
+    size_t next_sample_distance();
+    bool should_sample(size_t size);
+    void record_site(size_t trace, size_t size, bool sampled);
+
     int collect;
 
     // all allocations
@@ -80,12 +103,22 @@ public:
 
         eCollectStackTrace = 1 << 0,
         eCollectTimeStamps = 1 << 1,
+
+        /// @brief only capture a stack trace on average every @a sample_interval bytes
+        /// site totals are scaled up to estimate the true number of bytes
+        eCollectSampled = 1 << 2,
     };
 
+    static constexpr size_t kDefaultSampleInterval = 512 * 1024;
+
     TraceArena(const char *id, Collect collect);
 
     // TraceArena
     void reset();
+
+    /// @brief change the mean number of bytes between samples
+    /// @param interval the new interval, clamped to at least 1 byte
+    void set_sample_interval(size_t interval);
 };
 
 class TraceArenaWidget
@@ -106,6 +139,9 @@ class TraceArenaWidget
     // flat output
     void draw_flat() const;
 
+    // per stack trace output
+    void draw_sites() const;
+
 public:
     /// @brief the draw mode for the gui view of this allocator
     enum draw_mode_t : int
@@ -115,6 +151,9 @@ public:
 
         /// @brief draw the allocations as a flat list
         eDrawFlat,
+
+        /// @brief draw the estimated bytes allocated at each stack trace
+        eDrawSites,
     };
 
     TraceArenaWidget(TraceArena& arena, int mode)
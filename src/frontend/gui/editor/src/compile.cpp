@@ -10,6 +10,7 @@
 
 #include "std/str.h"
 
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 
 #include "support/support.h"
@@ -87,6 +88,6 @@ void Broker::init()
 bool Broker::check_reports() const
 {
     logger_t *logger = broker_get_logger(broker);
-    typevec_t *events = logger_get_events(logger);
-    return typevec_len(events) == 0;
+    segvec_t *events = logger_get_events(logger);
+    return segvec_len(events) == 0;
 }
@@ -31,6 +31,7 @@
 #include "memory/memory.h"
 #include "config/config.h"
 
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 
 #include "core/macros.h"
@@ -492,6 +493,30 @@ private:
     }
 };
 
+// events only carry a byte span, count the lines before it for display
+static location_t get_event_location(const node_t *node)
+{
+    where_t where = node_get_location(node);
+    text_view_t source = scan_source(node_get_scan(node));
+
+    location_t location = { 0, 0, 0, 0 };
+    size_t end = CT_MIN((size_t)where.offset, source.length);
+    for (size_t i = 0; i < end; i++)
+    {
+        if (source.text[i] == '\n')
+        {
+            location.first_line += 1;
+            location.first_column = 0;
+        }
+        else
+        {
+            location.first_column += 1;
+        }
+    }
+
+    return location;
+}
+
 static void draw_log_event(const event_t *event)
 {
     ImGui::TableNextRow();
@@ -500,7 +525,7 @@ static void draw_log_event(const event_t *event)
     ImGui::TextUnformatted(event->diagnostic->id);
 
     ImGui::TableNextColumn();
-    where_t where = node_get_location(&event->node);
+    location_t where = get_event_location(&event->node);
     const scan_t *scan = node_get_scan(&event->node);
     ImGui::Text("%s:%" PRI_LINE ":%" PRI_COLUMN, scan_path(scan), where.first_line, where.first_column);
 
@@ -525,8 +550,8 @@ static const ImGuiTableFlags kLogTableFlags
 
 static void draw_log_content(logger_t *logger)
 {
-    typevec_t *events = logger_get_events(logger);
-    size_t len = typevec_len(events);
+    segvec_t *events = logger_get_events(logger);
+    size_t len = segvec_len(events);
     ImGui::Text("Events: %zu", len);
 
     if (ImGui::BeginTable("Events", 4, kLogTableFlags))
@@ -538,8 +563,9 @@ static void draw_log_content(logger_t *logger)
         ImGui::TableSetupScrollFreeze(0, 1);
         ImGui::TableHeadersRow();
 
-        for (size_t i = 0; i < len; i++)
-            draw_log_event((event_t*)typevec_offset(events, i));
+        segvec_iter_t iter = segvec_iter(events);
+        while (segvec_has_next(&iter))
+            draw_log_event((event_t*)segvec_next(&iter));
 
         ImGui::EndTable();
     }
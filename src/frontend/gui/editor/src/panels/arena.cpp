@@ -4,6 +4,9 @@
 #include "editor/panels/arena.hpp"
 #include "editor/panels/panel.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 struct FrameInfo
 {
     std::string name;
@@ -50,8 +53,11 @@ const FrameInfo& get_frame_info(std::stacktrace_entry entry)
 
 TraceArena::TraceArena(const char *id, Collect collect)
     : IArena(id)
+    , rng(std::random_device{}())
     , collect(collect)
-{ }
+{
+    bytes_until_sample = next_sample_distance();
+}
 
 void *TraceArena::malloc(size_t size)
 {
@@ -110,6 +116,57 @@ void TraceArena::reset()
     live_allocs.clear();
     tree.clear();
     allocs.clear();
+
+    sites.clear();
+    samples_taken = 0;
+    bytes_until_sample = next_sample_distance();
+}
+
+void TraceArena::set_sample_interval(size_t interval)
+{
+    sample_interval = std::max<size_t>(interval, 1);
+    bytes_until_sample = next_sample_distance();
+}
+
+// the distance between samples is exponentially distributed, this makes
+// every byte equally likely to be sampled regardless of allocation patterns
+size_t TraceArena::next_sample_distance()
+{
+    std::exponential_distribution<double> dist(1.0 / double(sample_interval));
+    return std::max<size_t>(size_t(dist(rng)), 1);
+}
+
+bool TraceArena::should_sample(size_t size)
+{
+    if (size < bytes_until_sample)
+    {
+        bytes_until_sample -= size;
+        return false;
+    }
+
+    bytes_until_sample = next_sample_distance();
+    samples_taken += 1;
+    return true;
+}
+
+void TraceArena::record_site(size_t trace, size_t size, bool sampled)
+{
+    SiteInfo& site = sites[trace];
+    site.samples += 1;
+
+    if (!sampled)
+    {
+        site.bytes += double(size);
+        site.count += 1;
+        return;
+    }
+
+    // an allocation of size bytes is sampled with probability 1 - e^(-size/interval)
+    // so weight each sample by the inverse of that to get an unbiased estimate
+    double probability = -std::expm1(-double(size) / double(sample_interval));
+    double scale = (probability > 0) ? 1.0 / probability : 1.0;
+    site.bytes += double(size) * scale;
+    site.count += scale;
 }
 
 size_t TraceArena::add_stacktrace(const std::stacktrace& trace)
@@ -124,14 +181,30 @@ void TraceArena::create_alloc(void *ptr, size_t size)
 {
     peak_memory_usage += size;
     live_memory_usage += size;
-    allocs[ptr].id = gCounter++;
-    allocs[ptr].size = size;
+
+    AllocInfo& info = allocs[ptr];
+    info.id = gCounter++;
+    info.size = size;
+    info.trace = 0;
 
     if (collect & eCollectTimeStamps)
-        allocs[ptr].timestamp = std::chrono::high_resolution_clock::now();
+        info.timestamp = std::chrono::high_resolution_clock::now();
 
-    if (collect & eCollectStackTrace)
-        allocs[ptr].trace = add_stacktrace(std::stacktrace::current());
+    // capturing a stack is by far the most expensive part of tracking
+    // so when sampling only pay for it every sample_interval bytes on average
+    if (collect & eCollectSampled)
+    {
+        if (should_sample(size))
+        {
+            info.trace = add_stacktrace(std::stacktrace::current());
+            record_site(info.trace, size, true);
+        }
+    }
+    else if (collect & eCollectStackTrace)
+    {
+        info.trace = add_stacktrace(std::stacktrace::current());
+        record_site(info.trace, size, false);
+    }
 
     live_allocs.insert(ptr);
 }
@@ -294,10 +367,10 @@ void TraceArenaWidget::draw_name(const AllocInfo& alloc) const
 
     if (ImGui::BeginPopupContextItem("TracePopup"))
     {
-        const auto& trace = arena.stacktraces[alloc.trace];
-        if (!trace.empty())
+        auto it = arena.stacktraces.find(alloc.trace);
+        if (it != arena.stacktraces.end() && !it->second.empty())
         {
-            draw_backtrace(trace);
+            draw_backtrace(it->second);
         }
         else
         {
@@ -506,6 +579,76 @@ void TraceArenaWidget::draw_flat() const
     }
 }
 
+static const ImGuiTableFlags kMemorySiteTableFlags
+    = ImGuiTableFlags_BordersV
+    | ImGuiTableFlags_BordersOuterH
+    | ImGuiTableFlags_Resizable
+    | ImGuiTableFlags_RowBg
+    | ImGuiTableFlags_NoHostExtendX
+    | ImGuiTableFlags_NoBordersInBody
+    | ImGuiTableFlags_ScrollY;
+
+void TraceArenaWidget::draw_sites() const
+{
+    bool sampled = arena.collect & TraceArena::eCollectSampled;
+    ImGui::SeparatorText(sampled ? "Estimated allocation sites" : "Allocation sites");
+
+    std::vector<std::pair<size_t, const SiteInfo*>> order;
+    order.reserve(arena.sites.size());
+    for (const auto& [hash, site] : arena.sites)
+        order.emplace_back(hash, &site);
+
+    std::sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second->bytes > rhs.second->bytes;
+    });
+
+    if (ImGui::BeginTable("Sites", 4, kMemorySiteTableFlags))
+    {
+        ImGui::TableSetupColumn("Site");
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableSetupColumn("Samples");
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableHeadersRow();
+
+        for (const auto& [hash, site] : order)
+        {
+            ed::ScopeID scope((int)hash);
+            ImGui::TableNextRow();
+
+            ImGui::TableNextColumn();
+            bool is_open = ImGui::TreeNodeEx("Site", kGroupNodeFlags, "%016zx", hash);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", Memory::bytes(size_t(site->bytes)).to_string().c_str());
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.0f", site->count);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", site->samples);
+
+            if (is_open)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                if (auto it = arena.stacktraces.find(hash); it != arena.stacktraces.end())
+                {
+                    draw_backtrace(it->second);
+                }
+                else
+                {
+                    ImGui::TextDisabled("Stacktrace not available");
+                }
+
+                ImGui::TreePop();
+            }
+        }
+
+        ImGui::EndTable();
+    }
+}
+
 void TraceArenaWidget::draw()
 {
     if (ImGui::BeginMenuBar())
@@ -522,6 +665,17 @@ void TraceArenaWidget::draw()
                 arena.collect ^= TraceArena::eCollectTimeStamps;
             }
 
+            if (ImGui::MenuItem("Sample Stack Traces", nullptr, arena.collect & TraceArena::eCollectSampled))
+            {
+                arena.collect ^= TraceArena::eCollectSampled;
+            }
+
+            int interval = int(arena.sample_interval / Memory::kKilobyte);
+            if (ImGui::SliderInt("Sample Interval (kb)", &interval, 1, 16 * 1024, "%d", ImGuiSliderFlags_Logarithmic))
+            {
+                arena.set_sample_interval(size_t(interval) * Memory::kKilobyte);
+            }
+
             ImGui::EndMenu();
         }
         ImGui::EndMenuBar();
@@ -529,6 +683,12 @@ void TraceArenaWidget::draw()
 
     ImGui::TextWrapped("Memory usage: (%zu mallocs, %zu reallocs, %zu frees, %s peak, %s live)", arena.malloc_calls, arena.realloc_calls, arena.free_calls, arena.peak_memory_usage.to_string().c_str(), arena.live_memory_usage.to_string().c_str());
 
+    if (arena.collect & TraceArena::eCollectSampled)
+    {
+        Memory interval = Memory::bytes(arena.sample_interval);
+        ImGui::TextWrapped("Sampling: %zu samples, one every %s on average. Site sizes are estimates.", arena.samples_taken, interval.to_string().c_str());
+    }
+
     if (ImGui::Button("Reset Stats"))
     {
         arena.reset();
@@ -541,11 +701,17 @@ void TraceArenaWidget::draw()
     ImGui::RadioButton("Tree", &mode, eDrawTree);
     ImGui::SameLine();
     ImGui::RadioButton("Flat", &mode, eDrawFlat);
+    ImGui::SameLine();
+    ImGui::RadioButton("Sites", &mode, eDrawSites);
 
     if (mode == eDrawTree)
     {
         draw_tree();
     }
+    else if (mode == eDrawSites)
+    {
+        draw_sites();
+    }
     else
     {
         draw_flat();
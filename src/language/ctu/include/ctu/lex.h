@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core/where.h"
+
+#include <stddef.h>
+
+typedef struct scan_t scan_t;
+typedef struct scan_callbacks_t scan_callbacks_t;
+
+union CTUSTYPE;
+
+// hand written scanner, produces the same tokens and locations as ctu.l
+typedef struct ctu_lexer_t
+{
+    scan_t *scan;
+
+    // the source is lexed in place and does not need to be nul terminated
+    const char *text;
+    size_t length;
+
+    // the offset of the first byte that has not been lexed yet
+    size_t offset;
+
+    // the location of the last lexed text, the same as yylloc in ctu.l
+    where_t where;
+} ctu_lexer_t;
+
+void ctu_lexer_init(ctu_lexer_t *lexer, scan_t *scan, const char *text, size_t length);
+
+// lex the next token, returns 0 at the end of the source
+int ctu_lexer_next(ctu_lexer_t *lexer, union CTUSTYPE *value, where_t *where);
+
+#if CTU_HAND_LEXER
+extern const scan_callbacks_t kCtuLexer;
+#endif
@@ -11,9 +11,11 @@
 #include "cthulhu/tree/tree.h"
 #include "cthulhu/tree/query.h"
 
+#include "std/atom.h"
 #include "std/vector.h"
 #include "std/map.h"
 #include "std/str.h"
+#include "memory/memory.h"
 
 #include "base/panic.h"
 
@@ -51,19 +53,20 @@ void ctu_forward_decls(language_runtime_t *runtime, compile_unit_t *unit)
 
 static tree_t *get_import(tree_t *sema, const char *name)
 {
+    const char *id = atom_intern(get_atom_table(), name);
     map_t *imports = tree_module_tag(sema, eCtuTagImports);
-    tree_t *it = map_get(imports, name);
+    tree_t *it = map_get(imports, id);
     if (it != NULL)
         return it;
 
     map_t *mods = tree_module_tag(sema, eCtuTagModules);
-    return map_get(mods, name);
+    return map_get(mods, id);
 }
 
 static void import_module(language_runtime_t *runtime, tree_t *sema, ctu_t *include)
 {
     CTASSERT(include->kind == eCtuImport);
-    arena_t *arena = runtime->arena;
+    arena_t *arena = runtime->transient_arena;
     unit_id_t id = build_unit_id(include->import_path, arena);
     compile_unit_t *ctx = lang_get_unit(runtime, id);
 
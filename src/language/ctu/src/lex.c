@@ -0,0 +1,646 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+// hand written scanner for ctu, an alternative to the flex scanner in ctu.l.
+// runs of identifier, whitespace and comment bytes are classified a vector
+// at a time and keywords are found with a perfect hash of the identifier.
+// tokens and locations match ctu.l exactly so ctu.y can use either.
+
+#include "ctu/lex.h"
+
+#include "ctu_bison.h" // IWYU pragma: keep
+
+#include "cthulhu/broker/scan.h"
+#include "cthulhu/util/text.h"
+#include "interop/compile.h"
+#include "memory/memory.h"
+#include "scan/node.h"
+
+#include "arena/arena.h"
+#include "base/panic.h"
+#include "base/util.h"
+#include "core/compiler.h"
+#include "core/macros.h"
+#include "std/atom.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define LEX_USE_SSE2 1
+#   include <emmintrin.h>
+#endif
+
+#if CT_CC_MSVC
+#   include <intrin.h>
+#endif
+
+// returned by the token matchers for text that does not produce a token
+#define LEX_SKIP (-1)
+
+///
+/// character classes
+///
+
+enum {
+    eCharSpace = (1 << 0),
+    eCharIdent = (1 << 1),
+    eCharStart = (1 << 2),
+    eCharDigit = (1 << 3),
+};
+
+#define S (eCharSpace)
+#define A (eCharIdent | eCharStart)
+#define D (eCharIdent | eCharDigit)
+
+// bytes above 0x7F are never part of an identifier or whitespace
+static const uint8_t kCharClass[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, S, S, S, S, S, 0, 0, // 0x00
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
+    S, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x20
+    D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, 0, 0, // 0x30
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A, // 0x40
+    A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, A, // 0x50
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A, // 0x60
+    A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, 0, // 0x70
+};
+
+#undef S
+#undef A
+#undef D
+
+static bool char_is(char c, uint8_t cls)
+{
+    return (kCharClass[(uint8_t)c] & cls) != 0;
+}
+
+static bool char_is_base(char c, size_t base)
+{
+    switch (base)
+    {
+    case 2: return c == '0' || c == '1';
+    case 8: return c >= '0' && c <= '7';
+    case 10: return c >= '0' && c <= '9';
+    case 16: return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    default: CT_NEVER("invalid base %zu", base);
+    }
+}
+
+///
+/// vector classification, each of these has a scalar tail for the last partial vector
+///
+
+#if LEX_USE_SSE2
+typedef uint32_t lex_mask_t;
+
+CT_CONSTFN
+static size_t mask_first(lex_mask_t mask)
+{
+#if CT_CC_MSVC
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return (size_t)__builtin_ctz(mask);
+#endif
+}
+
+static __m128i vec_load(const char *text)
+{
+    return _mm_loadu_si128((const __m128i*)text);
+}
+
+// lanes where lo <= c <= hi, both bounds must be below 0x80
+static __m128i vec_range(__m128i c, char lo, char hi)
+{
+    __m128i above = _mm_cmpgt_epi8(c, _mm_set1_epi8((char)(lo - 1)));
+    __m128i below = _mm_cmplt_epi8(c, _mm_set1_epi8((char)(hi + 1)));
+    return _mm_and_si128(above, below);
+}
+
+static lex_mask_t vec_mask(__m128i v)
+{
+    return (lex_mask_t)_mm_movemask_epi8(v);
+}
+#endif
+
+// find the end of a run of identifier characters starting at i
+static size_t span_ident(const char *text, size_t i, size_t end)
+{
+#if LEX_USE_SSE2
+    for (; i + 16 <= end; i += 16)
+    {
+        __m128i c = vec_load(text + i);
+
+        // folding to lower case maps only letters into a-z
+        __m128i alpha = vec_range(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 'z');
+        __m128i digit = vec_range(c, '0', '9');
+        __m128i under = _mm_cmpeq_epi8(c, _mm_set1_epi8('_'));
+
+        lex_mask_t other = ~vec_mask(_mm_or_si128(_mm_or_si128(alpha, digit), under)) & 0xFFFF;
+        if (other != 0)
+            return i + mask_first(other);
+    }
+#endif
+
+    while (i < end && char_is(text[i], eCharIdent))
+        i += 1;
+
+    return i;
+}
+
+// find the end of a run of whitespace starting at i
+static size_t span_space(const char *text, size_t i, size_t end)
+{
+#if LEX_USE_SSE2
+    for (; i + 16 <= end; i += 16)
+    {
+        __m128i c = vec_load(text + i);
+
+        // tab, newline, vertical tab, form feed and carriage return are contiguous
+        __m128i control = vec_range(c, '\t', '\r');
+        __m128i space = _mm_cmpeq_epi8(c, _mm_set1_epi8(' '));
+
+        lex_mask_t other = ~vec_mask(_mm_or_si128(control, space)) & 0xFFFF;
+        if (other != 0)
+            return i + mask_first(other);
+    }
+#endif
+
+    while (i < end && char_is(text[i], eCharSpace))
+        i += 1;
+
+    return i;
+}
+
+// find the start of the next */ at or after i
+static size_t find_comment_end(const char *text, size_t i, size_t end)
+{
+#if LEX_USE_SSE2
+    for (; i + 17 <= end; i += 16)
+    {
+        __m128i star = _mm_cmpeq_epi8(vec_load(text + i), _mm_set1_epi8('*'));
+        __m128i slash = _mm_cmpeq_epi8(vec_load(text + i + 1), _mm_set1_epi8('/'));
+
+        lex_mask_t mask = vec_mask(_mm_and_si128(star, slash));
+        if (mask != 0)
+            return i + mask_first(mask);
+    }
+#endif
+
+    for (; i + 1 < end; i++)
+    {
+        if (text[i] == '*' && text[i + 1] == '/')
+            return i;
+    }
+
+    return SIZE_MAX;
+}
+
+///
+/// keywords
+///
+
+typedef struct keyword_t
+{
+    const char *text;
+    size_t length;
+    int token;
+} keyword_t;
+
+#define KEYWORD_MIN 2
+#define KEYWORD_MAX 10
+#define KEYWORD_SLOTS 64
+
+// perfect over the keywords below, every keyword has a different hash
+static size_t keyword_hash(const char *text, size_t length)
+{
+    size_t hash = (uint8_t)text[0] * 3
+                + (uint8_t)text[1] * 13
+                + (uint8_t)text[length - 1] * 29
+                + length;
+
+    return hash & (KEYWORD_SLOTS - 1);
+}
+
+// each keyword is stored in the slot keyword_hash assigns it
+static const keyword_t kKeywords[KEYWORD_SLOTS] = {
+    [2] = { "for", 3, FOR },
+    [3] = { "as", 2, AS },
+    [5] = { "continue", 8, CONTINUE },
+    [6] = { "__sizeof", 8, SIZEOF },
+    [7] = { "__alignof", 9, ALIGNOF },
+    [8] = { "__offsetof", 10, OFFSETOF },
+    [9] = { "in", 2, IN },
+    [11] = { "case", 4, CASE },
+    [20] = { "break", 5, BREAK },
+    [21] = { "false", 5, BOOLEAN },
+    [23] = { "noinit", 6, NOINIT },
+    [27] = { "true", 4, BOOLEAN },
+    [30] = { "def", 3, DEF },
+    [32] = { "else", 4, ELSE },
+    [33] = { "module", 6, MODULE },
+    [35] = { "while", 5, WHILE },
+    [37] = { "out", 3, OUT },
+    [39] = { "struct", 6, STRUCT },
+    [46] = { "import", 6, IMPORT },
+    [48] = { "union", 5, UNION },
+    [49] = { "export", 6, EXPORT },
+    [51] = { "return", 6, RETURN },
+    [53] = { "const", 5, CONST },
+    [54] = { "type", 4, TYPE },
+    [56] = { "default", 7, DEFAULT },
+    [57] = { "if", 2, IF },
+    [58] = { "variant", 7, VARIANT },
+    [60] = { "var", 3, VAR },
+    [62] = { "cast", 4, CAST },
+};
+
+static const keyword_t *find_keyword(const char *text, size_t length)
+{
+    if (length < KEYWORD_MIN || length > KEYWORD_MAX)
+        return NULL;
+
+    const keyword_t *keyword = &kKeywords[keyword_hash(text, length)];
+    if (keyword->length != length || memcmp(keyword->text, text, length) != 0)
+        return NULL;
+
+    return keyword;
+}
+
+///
+/// locations
+///
+
+static char peek(const ctu_lexer_t *lexer, size_t offset)
+{
+    size_t i = lexer->offset + offset;
+    return (i < lexer->length) ? lexer->text[i] : '\0';
+}
+
+// consume length bytes as a single token, the same span flex_action gives it
+static void action(ctu_lexer_t *lexer, size_t length)
+{
+    lexer->where.offset = (ctu_offset_t)lexer->offset;
+    lexer->where.length = (ctu_offset_t)length;
+    lexer->offset += length;
+}
+
+// consume text up to end. ctu.l matches whitespace and comment bodies a
+// byte at a time, so only the last byte is left as the location
+static void action_tail(ctu_lexer_t *lexer, size_t end)
+{
+    lexer->offset = end - 1;
+    action(lexer, 1);
+}
+
+static int emit(ctu_lexer_t *lexer, size_t length, int token)
+{
+    action(lexer, length);
+    return token;
+}
+
+///
+/// tokens
+///
+
+static int skip_space(ctu_lexer_t *lexer)
+{
+    size_t end = span_space(lexer->text, lexer->offset, lexer->length);
+    action_tail(lexer, end);
+    return LEX_SKIP;
+}
+
+static int skip_line_comment(ctu_lexer_t *lexer)
+{
+    const char *text = lexer->text + lexer->offset;
+    const char *newline = memchr(text, '\n', lexer->length - lexer->offset);
+    size_t length = (newline != NULL) ? (size_t)(newline - text) : lexer->length - lexer->offset;
+    action(lexer, length);
+    return LEX_SKIP;
+}
+
+static int skip_block_comment(ctu_lexer_t *lexer)
+{
+    action(lexer, 2);
+
+    size_t end = find_comment_end(lexer->text, lexer->offset, lexer->length);
+    if (end != SIZE_MAX)
+    {
+        lexer->offset = end;
+        action(lexer, 2);
+    }
+    else if (lexer->offset < lexer->length)
+    {
+        // unterminated comments run to the end of the source
+        action_tail(lexer, lexer->length);
+    }
+
+    return LEX_SKIP;
+}
+
+static int unknown_symbol(ctu_lexer_t *lexer)
+{
+    char symbol[2] = { peek(lexer, 0), '\0' };
+    action(lexer, 1);
+    ctx_unknown_symbol(lexer->scan, &lexer->where, symbol);
+    return LEX_SKIP;
+}
+
+static int lex_ident(ctu_lexer_t *lexer, CTUSTYPE *value)
+{
+    const char *text = lexer->text + lexer->offset;
+    size_t length = span_ident(lexer->text, lexer->offset + 1, lexer->length) - lexer->offset;
+    action(lexer, length);
+
+    const keyword_t *keyword = find_keyword(text, length);
+    if (keyword != NULL)
+    {
+        if (keyword->token == BOOLEAN)
+            value->boolean = (text[0] == 't');
+
+        return keyword->token;
+    }
+
+    // identifiers are interned so sema can compare them by pointer
+    // the ast treats them as mutable but atoms are never written to
+    value->ident = (char*)atom_intern_text(get_atom_table(), text_view_make(text, length));
+    return IDENT;
+}
+
+static size_t match_digits(const ctu_lexer_t *lexer, size_t i, size_t base)
+{
+    size_t start = i;
+    while (char_is_base(peek(lexer, i), base))
+        i += 1;
+
+    return i - start;
+}
+
+static size_t match_suffix(const ctu_lexer_t *lexer, size_t i)
+{
+    char c = peek(lexer, i);
+    if (c == 'l')
+        return 1;
+
+    if (c != 'u')
+        return 0;
+
+    char next = peek(lexer, i + 1);
+    return (next == 'l' || next == 'z') ? 2 : 1;
+}
+
+static int lex_number(ctu_lexer_t *lexer, CTUSTYPE *value)
+{
+    size_t base = 10;
+    size_t prefix = 0;
+
+    // 0b and 0x only start a literal when a digit follows them
+    char radix = peek(lexer, 1);
+    if (peek(lexer, 0) == '0' && (radix == 'b' || radix == 'x'))
+    {
+        size_t other = (radix == 'b') ? 2 : 16;
+        if (match_digits(lexer, 2, other) > 0)
+        {
+            base = other;
+            prefix = 2;
+        }
+    }
+
+    size_t length = prefix + match_digits(lexer, prefix, base);
+    length += match_suffix(lexer, length);
+
+    const char *text = lexer->text + lexer->offset;
+    action(lexer, length);
+
+    ctu_parse_digit(lexer->scan, lexer->where, &value->digit, text + prefix, (int)(length - prefix), base);
+    return INTEGER;
+}
+
+// the length of the escape sequence starting at i, 0 if it is not valid
+static size_t match_escape(const ctu_lexer_t *lexer, size_t i)
+{
+    char c = peek(lexer, i + 1);
+    switch (c)
+    {
+    case '\'': case '"': case '?': case '\\':
+    case 'a': case 'b': case 'f': case 'n':
+    case 'r': case 't': case 'v':
+        return 2;
+
+    case 'x': {
+        size_t digits = match_digits(lexer, i + 2, 16);
+        return (digits > 0) ? digits + 2 : 0;
+    }
+
+    default: {
+        size_t digits = match_digits(lexer, i + 1, 8);
+        return (digits > 0) ? CT_MIN(digits, 3) + 1 : 0;
+    }
+    }
+}
+
+static size_t match_string(const ctu_lexer_t *lexer)
+{
+    size_t i = 1;
+    while (lexer->offset + i < lexer->length)
+    {
+        char c = peek(lexer, i);
+        if (c == '"')
+            return i + 1;
+
+        if (c == '\n')
+            return 0;
+
+        if (c != '\\')
+        {
+            i += 1;
+            continue;
+        }
+
+        size_t escape = match_escape(lexer, i);
+        if (escape == 0)
+            return 0;
+
+        i += escape;
+    }
+
+    return 0;
+}
+
+static size_t match_char(const ctu_lexer_t *lexer)
+{
+    if (lexer->offset + 1 >= lexer->length)
+        return 0;
+
+    char c = peek(lexer, 1);
+    if (c == '\'' || c == '\n')
+        return 0;
+
+    size_t length = (c == '\\') ? match_escape(lexer, 1) : 1;
+    if (length == 0 || peek(lexer, length + 1) != '\'')
+        return 0;
+
+    return length + 2;
+}
+
+static int lex_text(ctu_lexer_t *lexer, CTUSTYPE *value, size_t length, int token)
+{
+    if (length == 0)
+        return unknown_symbol(lexer);
+
+    const char *text = lexer->text + lexer->offset;
+    action(lexer, length);
+
+    arena_t *arena = ctx_get_string_arena(lexer->scan);
+    logger_t *logger = ctx_get_logger(lexer->scan);
+    value->string = util_text_escape(logger, node_new(lexer->scan, lexer->where), text + 1, length - 2, arena);
+    return token;
+}
+
+static int lex_token(ctu_lexer_t *lexer, CTUSTYPE *value)
+{
+    char c = peek(lexer, 0);
+    char next = peek(lexer, 1);
+
+    if (char_is(c, eCharSpace)) return skip_space(lexer);
+    if (char_is(c, eCharStart)) return lex_ident(lexer, value);
+    if (char_is(c, eCharDigit)) return lex_number(lexer, value);
+
+    switch (c)
+    {
+    case '/':
+        if (next == '/') return skip_line_comment(lexer);
+        if (next == '*') return skip_block_comment(lexer);
+        return emit(lexer, 1, DIVIDE);
+
+    case '"': return lex_text(lexer, value, match_string(lexer), STRING);
+    case '\'': return lex_text(lexer, value, match_char(lexer), CHARACTER);
+
+    case '-': return (next == '>') ? emit(lexer, 2, ARROW) : emit(lexer, 1, MINUS);
+    case '.': return (next == '.' && peek(lexer, 2) == '.') ? emit(lexer, 3, DOT3) : emit(lexer, 1, DOT);
+    case ':': return (next == ':') ? emit(lexer, 2, COLON2) : emit(lexer, 1, COLON);
+    case '=': return (next == '=') ? emit(lexer, 2, EQ) : emit(lexer, 1, ASSIGN);
+    case '!': return (next == '=') ? emit(lexer, 2, NEQ) : emit(lexer, 1, NOT);
+    case '&': return (next == '&') ? emit(lexer, 2, AND) : emit(lexer, 1, BITAND);
+    case '|': return (next == '|') ? emit(lexer, 2, OR) : emit(lexer, 1, BITOR);
+
+    case '<':
+        if (next == '<') return emit(lexer, 2, SHL);
+        if (next == '=') return emit(lexer, 2, LTE);
+        return emit(lexer, 1, LT);
+
+    case '>':
+        if (next == '>') return emit(lexer, 2, SHR);
+        if (next == '=') return emit(lexer, 2, GTE);
+        return emit(lexer, 1, GT);
+
+    case '+': return emit(lexer, 1, PLUS);
+    case '*': return emit(lexer, 1, STAR);
+    case '%': return emit(lexer, 1, MODULO);
+    case '^': return emit(lexer, 1, BITXOR);
+    case ',': return emit(lexer, 1, COMMA);
+    case ';': return emit(lexer, 1, SEMI);
+    case '[': return emit(lexer, 1, LSQUARE);
+    case ']': return emit(lexer, 1, RSQUARE);
+    case '(': return emit(lexer, 1, LPAREN);
+    case ')': return emit(lexer, 1, RPAREN);
+    case '{': return emit(lexer, 1, LBRACE);
+    case '}': return emit(lexer, 1, RBRACE);
+    case '$': return emit(lexer, 1, DISCARD);
+    case '@': return emit(lexer, 1, AT);
+
+    default: return unknown_symbol(lexer);
+    }
+}
+
+void ctu_lexer_init(ctu_lexer_t *lexer, scan_t *scan, const char *text, size_t length)
+{
+    CTASSERT(lexer != NULL);
+    CTASSERT(scan != NULL);
+    CTASSERT(text != NULL);
+
+    where_t zero = { 0 };
+
+    lexer->scan = scan;
+    lexer->text = text;
+    lexer->length = length;
+    lexer->offset = 0;
+    lexer->where = zero;
+}
+
+int ctu_lexer_next(ctu_lexer_t *lexer, CTUSTYPE *value, where_t *where)
+{
+    CTASSERT(lexer != NULL);
+    CTASSERT(value != NULL);
+    CTASSERT(where != NULL);
+
+    int token = CTUEOF;
+    while (lexer->offset < lexer->length)
+    {
+        token = lex_token(lexer, value);
+        if (token != LEX_SKIP)
+            break;
+
+        token = CTUEOF;
+    }
+
+    *where = lexer->where;
+    return token;
+}
+
+///
+/// bison and scan_buffer glue
+///
+
+#if CTU_HAND_LEXER
+
+// matches the declaration in ctu.y, scan is the lexer created by lexer_init
+int ctulex(void *lval, void *loc, scan_t *scan)
+{
+    return ctu_lexer_next((ctu_lexer_t*)scan, lval, loc);
+}
+
+static int lexer_init(scan_t *extra, void *scanner)
+{
+    arena_t *arena = scan_get_arena(extra);
+    ctu_lexer_t *lexer = ARENA_MALLOC(sizeof(ctu_lexer_t), "ctu lexer", extra, arena);
+    ctu_lexer_init(lexer, extra, "", 0);
+
+    *(ctu_lexer_t**)scanner = lexer;
+    return 0;
+}
+
+static int lexer_parse(void *scanner, scan_t *extra)
+{
+    return ctuparse(scanner, extra);
+}
+
+// the source is lexed where it is, nothing is copied
+static void *lexer_scan(const char *text, size_t size, void *scanner)
+{
+    ctu_lexer_t *lexer = scanner;
+    ctu_lexer_init(lexer, lexer->scan, text, size);
+    return lexer;
+}
+
+static void lexer_destroy_buffer(void *buffer, void *scanner)
+{
+    CT_UNUSED(buffer);
+    CT_UNUSED(scanner);
+}
+
+static void lexer_destroy(void *scanner)
+{
+    ctu_lexer_t *lexer = scanner;
+    arena_free(lexer, sizeof(ctu_lexer_t), scan_get_arena(lexer->scan));
+}
+
+const scan_callbacks_t kCtuLexer = {
+    .init = lexer_init,
+    .parse = lexer_parse,
+    .scan = lexer_scan,
+    .destroy_buffer = lexer_destroy_buffer,
+    .destroy = lexer_destroy,
+};
+
+#endif
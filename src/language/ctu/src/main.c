@@ -15,9 +15,15 @@
 #include "driver/driver.h"
 
 #include "ctu_bison.h" // IWYU pragma: keep
-#include "ctu_flex.h" // IWYU pragma: keep
 
+#if CTU_HAND_LEXER
+#   include "ctu/lex.h"
+#   define CTU_SCANNER (&kCtuLexer)
+#else
+#   include "ctu_flex.h" // IWYU pragma: keep
 CT_CALLBACKS(kCallbacks, ctu);
+#   define CTU_SCANNER (&kCallbacks)
+#endif
 
 static vector_t *mod_basename(const char *fp, arena_t *arena)
 {
@@ -111,7 +117,7 @@ CT_DRIVER_API const language_t kCtuModule = {
     .fn_create = ctu_init,
 
     .fn_postparse = ctu_postparse,
-    .scanner = &kCallbacks,
+    .scanner = CTU_SCANNER,
 
     .fn_passes = {
         [ePassForwardDecls] = ctu_forward_decls,
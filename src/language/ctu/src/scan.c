@@ -14,6 +14,9 @@
 
 void ctu_parse_digit(scan_t *scan, where_t where, ctu_integer_t *integer, const char *str, int len, size_t base)
 {
+    // str is not always nul terminated, keep the whole literal for diagnostics
+    int total = len;
+
     // TODO: this chain could be better
     if (str_endswithn(str, len, "ul"))
     {
@@ -55,7 +58,7 @@ void ctu_parse_digit(scan_t *scan, where_t where, ctu_integer_t *integer, const
     {
         const node_t *node = node_new(scan, where);
         logger_t *logger = ctx_get_logger(scan);
-        msg_notify(logger, &kEvent_InvalidIntegerLiteral, node, "failed to parse base %zu digit '%s'", base, str);
+        msg_notify(logger, &kEvent_InvalidIntegerLiteral, node, "failed to parse base %zu digit '%.*s'", base, total, str);
     }
 }
 
@@ -97,7 +97,8 @@ void ctu_resolve_function_type(tree_t *sema, tree_t *self, void *user)
     ctu_sema_t inner = ctu_sema_init(sema, NULL, vector_new(0, arena));
 
     size_t len = vector_len(decl->params);
-    vector_t *params = vector_of(len, arena);
+    smallvec_t storage;
+    vector_t *params = smallvec_of(&storage, len, arena);
     for (size_t i = 0; i < len; i++)
     {
         ctu_t *param = vector_get(decl->params, i);
@@ -114,5 +115,5 @@ void ctu_resolve_function_type(tree_t *sema, tree_t *self, void *user)
     tree_t *signature = tree_type_closure(decl->node, decl->name, return_type, params, arity);
 
     tree_set_type(self, signature);
-    self->params = params;
+    self->params = tree_fn_get_params(signature);
 }
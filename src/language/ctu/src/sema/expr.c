@@ -340,7 +340,8 @@ static tree_t *sema_call(ctu_sema_t *sema, const ctu_t *expr)
 
     arena_t *arena = get_global_arena();
     size_t len = vector_len(expr->args);
-    vector_t *result = vector_of(len, arena);
+    smallvec_t storage;
+    vector_t *result = smallvec_of(&storage, len, arena);
     for (size_t i = 0; i < len; i++)
     {
         const tree_t *ty = get_param_checked(params, i);
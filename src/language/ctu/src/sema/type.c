@@ -51,7 +51,8 @@ static tree_t *sema_type_function(ctu_sema_t *sema, const ctu_t *type)
 
     arena_t *arena = get_global_arena();
     size_t len = vector_len(type->params);
-    vector_t *params = vector_of(len, arena);
+    smallvec_t storage;
+    vector_t *params = smallvec_of(&storage, len, arena);
     for (size_t i = 0; i < len; i++)
     {
         const ctu_t *param = vector_get(type->params, i);
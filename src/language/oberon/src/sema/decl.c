@@ -211,7 +211,8 @@ static tree_t *forward_proc(tree_t *sema, obr_t *decl)
     tree_t *result = decl->result == NULL ? obr_get_void_type() : obr_sema_type(sema, decl->result, decl->name);
     arena_t *arena = get_global_arena();
     size_t len = vector_len(decl->params);
-    vector_t *params = vector_of(len, arena);
+    smallvec_t storage;
+    vector_t *params = smallvec_of(&storage, len, arena);
     for (size_t i = 0; i < len; i++)
     {
         obr_t *param = vector_get(decl->params, i);
@@ -226,7 +227,7 @@ static tree_t *forward_proc(tree_t *sema, obr_t *decl)
     // if this is an extern declaration it doesnt need a body
     if (decl->body == NULL)
     {
-        return tree_decl_function(decl->node, decl->name, signature, params, &gEmptyVector, NULL);
+        return tree_decl_function(decl->node, decl->name, signature, tree_fn_get_params(signature), &gEmptyVector, NULL);
     }
 
     tree_resolve_info_t resolve = {
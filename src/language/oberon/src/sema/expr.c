@@ -119,7 +119,8 @@ static tree_t *sema_call(tree_t *sema, obr_t *expr)
 
     arena_t *arena = get_global_arena();
     size_t len = vector_len(expr->args);
-    vector_t *args = vector_of(len, arena);
+    smallvec_t storage;
+    vector_t *args = smallvec_of(&storage, len, arena);
     for (size_t i = 0; i < len; i++)
     {
         obr_t *it = vector_get(expr->args, i);
@@ -10,7 +10,9 @@
 #include "cthulhu/util/util.h"
 
 #include "base/panic.h"
+#include "base/util.h"
 
+#include "std/atom.h"
 #include "std/str.h"
 #include "std/map.h"
 #include "std/vector.h"
@@ -44,10 +46,24 @@ static const tree_attribs_t kEntryAttrib = {
     .visibility = eVisiblePrivate
 };
 
-static char *pl0_normalize(const char *name)
+// most identifiers are lowered on the stack, longer ones go through the global arena
+#define PL0_NAME_BUFFER (128)
+
+static const char *pl0_normalize(const char *name)
 {
-    arena_t *arena = get_global_arena();
-    return str_lower(name, arena);
+    atom_table_t *atoms = get_atom_table();
+    size_t len = ctu_strlen(name);
+    if (len >= PL0_NAME_BUFFER)
+    {
+        arena_t *arena = get_global_arena();
+        return atom_intern(atoms, str_lower(name, arena));
+    }
+
+    char buffer[PL0_NAME_BUFFER];
+    for (size_t i = 0; i < len; i++)
+        buffer[i] = str_tolower(name[i]);
+
+    return atom_intern_text(atoms, text_view_make(buffer, len));
 }
 
 static void report_pl0_shadowing(logger_t *reports, const char *name, const node_t *prev, const node_t *next)
@@ -58,7 +74,7 @@ static void report_pl0_shadowing(logger_t *reports, const char *name, const node
 
 static tree_t *get_decl(tree_t *sema, const char *name, const pl0_tag_t *tags, size_t len)
 {
-    char *id = pl0_normalize(name);
+    const char *id = pl0_normalize(name);
     for (size_t i = 0; i < len; i++)
     {
         pl0_tag_t tag = tags[i];
@@ -85,7 +101,7 @@ static tree_t *get_proc(tree_t *sema, const char *name)
 
 static void set_decl(tree_t *sema, pl0_tag_t tag, const char *name, tree_t *decl)
 {
-    char *id = pl0_normalize(name);
+    const char *id = pl0_normalize(name);
     tree_module_set(sema, tag, id, decl);
 }
 
@@ -534,7 +550,7 @@ void pl0_forward_decls(language_runtime_t *runtime, compile_unit_t *context)
 void pl0_process_imports(language_runtime_t *runtime, compile_unit_t *context)
 {
     pl0_t *ast = unit_get_ast(context);
-    arena_t *arena = runtime->arena;
+    arena_t *arena = runtime->transient_arena;
     tree_t *root = context->tree;
 
     size_t import_count = vector_len(ast->imports);
@@ -34,7 +34,7 @@
 
 typedef struct io_t io_t;
 typedef struct event_t event_t;
-typedef struct typevec_t typevec_t;
+typedef struct segvec_t segvec_t;
 typedef struct arena_t arena_t;
 
 typedef struct colour_pallete_t colour_pallete_t;
@@ -94,7 +94,7 @@ typedef struct report_config_t
 } report_config_t;
 
 CT_FORMAT_API int text_report(
-    IN_NOTNULL typevec_t *events,
+    IN_NOTNULL const segvec_t *events,
     report_config_t config,
     IN_STRING const char *title);
 
@@ -12,7 +12,7 @@
 CT_BEGIN_API
 
 typedef struct event_t event_t;
-typedef struct typevec_t typevec_t;
+typedef struct segvec_t segvec_t;
 
 /// @defgroup format_notify Format compiler messages for printing
 /// @ingroup format
@@ -59,7 +59,7 @@ CT_FORMAT_API void print_notify(print_notify_t config, IN_NOTNULL const event_t
 ///
 /// @param config the config to use when printing
 /// @param events the events to print
-CT_FORMAT_API void print_notify_many(print_notify_t config, IN_NOTNULL const typevec_t *events);
+CT_FORMAT_API void print_notify_many(print_notify_t config, IN_NOTNULL const segvec_t *events);
 
 /// @}
 
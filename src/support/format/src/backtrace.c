@@ -328,7 +328,7 @@ static const char *fmt_entry_location(backtrace_t *pass, const entry_t *entry)
 
         if (resolved & eResolveLine)
         {
-            where_t where = {
+            location_t where = {
                 .first_line = entry->line,
             };
 
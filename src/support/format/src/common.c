@@ -121,7 +121,7 @@ format_context_t format_context_make(print_options_t options)
     return context;
 }
 
-char *fmt_source_location(source_config_t config, const char *path, where_t where)
+char *fmt_source_location(source_config_t config, const char *path, location_t where)
 {
     ctu_line_t first_line = calc_line_number(config.zero_indexed_lines, where.first_line);
 
@@ -35,4 +35,4 @@ typedef struct source_config_t
 } source_config_t;
 
 format_context_t format_context_make(print_options_t options);
-char *fmt_source_location(source_config_t config, const char *path, where_t where);
+char *fmt_source_location(source_config_t config, const char *path, location_t where);
@@ -14,6 +14,7 @@
 #include "std/str.h"
 #include "arena/arena.h"
 
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 #include "std/vector.h"
 
@@ -75,14 +76,12 @@ static int segment_cmp(const void *lhs, const void *rhs)
     CTASSERTF(scan_lhs == scan_rhs, "segments must be in the same scan (%s and %s)",
               scan_path(scan_lhs), scan_path(scan_rhs));
 
+    // offsets in the same file sort the same as their lines and columns
     where_t where_lhs = node_get_location(&seg_lhs->node);
     where_t where_rhs = node_get_location(&seg_rhs->node);
 
-    if (where_lhs.first_line < where_rhs.first_line) return -1;
-    if (where_lhs.first_line > where_rhs.first_line) return 1;
-
-    if (where_lhs.first_column < where_rhs.first_column) return -1;
-    if (where_lhs.first_column > where_rhs.first_column) return 1;
+    if (where_lhs.offset < where_rhs.offset) return -1;
+    if (where_lhs.offset > where_rhs.offset) return 1;
 
     return 0;
 }
@@ -118,9 +117,9 @@ typevec_t *all_segments_in_scan(const typevec_t *segments, const node_t *node, a
     return result;
 }
 
-size_t get_line_number(file_config_t config, const node_t *node)
+size_t get_line_number(file_config_t config, cache_map_t *cache, const node_t *node)
 {
-    where_t where = node_get_location(node);
+    location_t where = cache_get_node_location(cache, node);
     if (config.zeroth_line) return where.first_line;
 
     return where.first_line + 1;
@@ -134,7 +133,12 @@ bool node_has_line(const node_t *node)
 typedef struct cache_map_t
 {
     arena_t *arena;
+
+    // map of path to text cache
     map_t *map;
+
+    // map of scan to text cache
+    map_t *scans;
 } cache_map_t;
 
 typedef struct lineinfo_t
@@ -187,7 +191,7 @@ static text_cache_t *text_cache_new(io_t *io, text_view_t source, size_t len, ar
     cache->io = io;
     cache->source = source;
     cache->line_info = typevec_new(sizeof(lineinfo_t), len, arena);
-    cache->cached_lines = map_optimal(len, kTypeInfoString, arena);
+    cache->cached_lines = map_optimal(len, kTypeInfoPtr, arena);
 
     return cache;
 }
@@ -255,6 +259,7 @@ cache_map_t *cache_map_new(size_t size, arena_t *arena)
     cache_map_t *data = ARENA_MALLOC(sizeof(cache_map_t), "cache_map", NULL, arena);
     data->arena = arena;
     data->map = map_optimal(size, kTypeInfoString, arena);
+    data->scans = map_optimal(size, kTypeInfoPtr, arena);
 
     return data;
 }
@@ -270,6 +275,13 @@ void cache_map_delete(cache_map_t *map)
     {
         text_cache_delete(cache);
     }
+
+    map_iter_t scans = map_iter(map->scans);
+    const scan_t *scan = NULL;
+    while (CTU_MAP_NEXT(&scans, &scan, &cache))
+    {
+        text_cache_delete(cache);
+    }
 }
 
 text_cache_t *cache_emplace_file(cache_map_t *map, const char *path)
@@ -297,16 +309,88 @@ text_cache_t *cache_emplace_scan(cache_map_t *map, const scan_t *scan)
     CTASSERT(map != NULL);
     CTASSERT(scan != NULL);
 
-    text_cache_t *cache = map_get(map->map, scan);
+    text_cache_t *cache = map_get(map->scans, scan);
     if (cache != NULL && cache_is_valid(cache)) return cache;
 
     // scan caches will never be invalid, so we can just insert them
     text_cache_t *text = text_cache_scan(scan, map->arena);
-    map_set(map->map, scan, text);
+    map_set(map->scans, scan, text);
 
     return text;
 }
 
+// find the last line that starts at or before offset
+static size_t cache_find_line(const text_cache_t *cache, size_t offset)
+{
+    size_t lo = 0;
+    size_t hi = typevec_len(cache->line_info);
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        const lineinfo_t *info = typevec_offset(cache->line_info, mid);
+
+        if (info->offset <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return (lo == 0) ? 0 : lo - 1;
+}
+
+static void cache_resolve_offset(const text_cache_t *cache, size_t offset, ctu_line_t *line, ctu_column_t *column)
+{
+    if (typevec_len(cache->line_info) == 0)
+    {
+        *line = 0;
+        *column = offset;
+        return;
+    }
+
+    size_t index = cache_find_line(cache, offset);
+    const lineinfo_t *info = typevec_offset(cache->line_info, index);
+    size_t end = info->offset + info->length;
+
+    // the line table has no entry for the empty line after a trailing newline
+    if (offset > end)
+    {
+        *line = index + 1;
+        *column = offset - end - 1;
+        return;
+    }
+
+    *line = index;
+    *column = offset - info->offset;
+}
+
+location_t cache_get_location(text_cache_t *cache, where_t where)
+{
+    CTASSERT(cache != NULL);
+
+    location_t location;
+    cache_resolve_offset(cache, where.offset, &location.first_line, &location.first_column);
+    cache_resolve_offset(cache, (size_t)where.offset + where.length, &location.last_line, &location.last_column);
+
+    return location;
+}
+
+location_t cache_get_node_location(cache_map_t *map, const node_t *node)
+{
+    CTASSERT(map != NULL);
+    CTASSERT(node != NULL);
+
+    if (!node_has_line(node))
+    {
+        location_t nowhere = { 0, 0, 0, 0 };
+        return nowhere;
+    }
+
+    text_cache_t *cache = cache_emplace_scan(map, node_get_scan(node));
+
+    return cache_get_location(cache, node_get_location(node));
+}
+
 text_view_t cache_get_line(text_cache_t *cache, size_t line)
 {
     CTASSERT(cache != NULL);
@@ -413,7 +497,7 @@ static bool set_has_option(set_t *set, const diagnostic_t *diag)
 }
 
 STA_DECL
-int text_report(typevec_t *events, report_config_t config, const char *title)
+int text_report(const segvec_t *events, report_config_t config, const char *title)
 {
     CTASSERT(events != NULL);
     CTASSERT(title != NULL);
@@ -429,7 +513,6 @@ int text_report(typevec_t *events, report_config_t config, const char *title)
 
     text.cache = cache;
 
-    size_t len = typevec_len(events);
     void (*fn)(text_config_t, const event_t *) = fmt == eTextComplex ? text_report_rich
                                                                      : text_report_simple;
 
@@ -439,9 +522,10 @@ int text_report(typevec_t *events, report_config_t config, const char *title)
     size_t bug_count = 0;
 
 
-    for (size_t i = 0; i < len; i++)
+    segvec_iter_t iter = segvec_iter(events);
+    while (segvec_has_next(&iter))
     {
-        event_t *event = typevec_offset(events, i);
+        const event_t *event = segvec_next(&iter);
         const diagnostic_t *diag = event->diagnostic;
         if (set_has_option(config.ignore_warnings, diag))
         {
@@ -527,11 +611,11 @@ int text_report(typevec_t *events, report_config_t config, const char *title)
     return result;
 }
 
-char *fmt_node_location(source_config_t config, const node_t *node)
+char *fmt_node_location(source_config_t config, cache_map_t *cache, const node_t *node)
 {
     const scan_t *scan = node_get_scan(node);
     const char *path = scan_is_builtin(scan) ? NULL : scan_path(scan);
-    where_t where = node_get_location(node);
+    location_t where = cache_get_node_location(cache, node);
 
     return fmt_source_location(config, path, where);
 }
@@ -23,7 +23,7 @@ colour_t get_severity_colour(severity_t severity);
 typevec_t *all_segments_in_scan(const typevec_t *segments, const node_t *node, arena_t *arena);
 void segments_sort(typevec_t *segments);
 
-size_t get_line_number(file_config_t config, const node_t *node);
+size_t get_line_number(file_config_t config, cache_map_t *cache, const node_t *node);
 
 bool node_has_line(const node_t *node);
 
@@ -33,6 +33,12 @@ void cache_map_delete(cache_map_t *map);
 text_cache_t *cache_emplace_file(cache_map_t *map, const char *path);
 text_cache_t *cache_emplace_scan(cache_map_t *map, const scan_t *scan);
 
+// resolve a span to its lines and columns using the line table of the file
+location_t cache_get_location(text_cache_t *cache, where_t where);
+
+// resolve the span of a node, nodes without a line resolve to the start of the file
+location_t cache_get_node_location(cache_map_t *map, const node_t *node);
+
 text_view_t cache_get_line(text_cache_t *cache, size_t line);
 size_t cache_count_lines(text_cache_t *cache);
 
@@ -44,4 +50,4 @@ text_t cache_escape_line(text_cache_t *cache, size_t line, const colour_pallete_
 /// version 2 of the common stuff
 ///
 
-char *fmt_node_location(source_config_t config, const node_t *node);
+char *fmt_node_location(source_config_t config, cache_map_t *cache, const node_t *node);
@@ -6,6 +6,7 @@
 
 #include "io/io.h"
 
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 #include "std/vector.h"
 
@@ -14,6 +15,9 @@
 typedef struct notify_config_t
 {
     print_notify_t config;
+
+    // line tables of the files in the event
+    cache_map_t *cache;
 } notify_config_t;
 
 // TODO: all this
@@ -34,7 +38,7 @@ static void print_notify_segment_simple(notify_config_t *config, const segment_t
         .zero_indexed_lines = options.zero_indexed_lines,
     };
 
-    char *path = fmt_node_location(source_config, &segment->node);
+    char *path = fmt_node_location(source_config, config->cache, &segment->node);
 
     io_printf(base.io, "%s: %s\n", path, segment->message);
 }
@@ -68,7 +72,7 @@ static void print_notify_simple(notify_config_t *config, const event_t *event)
     const char *severity_name = get_severity_name(severity);
     colour_t severity_colour = get_severity_colour(severity);
 
-    char *path = fmt_node_location(source_config, &event->node);
+    char *path = fmt_node_location(source_config, config->cache, &event->node);
 
     char *level = colour_format(format_context, severity_colour, "%s %s:", severity_name, id);
 
@@ -102,20 +106,23 @@ void print_notify(print_notify_t config, const event_t *event)
 
     notify_config_t notify_config = {
         .config = config,
+        .cache = cache_map_new(4, config.options.arena),
     };
 
     print_notify_simple(&notify_config, event);
+
+    cache_map_delete(notify_config.cache);
 }
 
 STA_DECL
-void print_notify_many(print_notify_t config, const typevec_t *events)
+void print_notify_many(print_notify_t config, const segvec_t *events)
 {
     CTASSERT(events != NULL);
 
-    size_t len = typevec_len(events);
-    for (size_t i = 0; i < len; i++)
+    segvec_iter_t iter = segvec_iter(events);
+    while (segvec_has_next(&iter))
     {
-        const event_t *event = typevec_offset(events, i);
+        const event_t *event = segvec_next(&iter);
         print_notify(config, event);
     }
 }
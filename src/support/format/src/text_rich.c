@@ -65,8 +65,9 @@ static void print_report_header(rich_t *rich, const char *message)
     io_printf(config.io, "%s %s\n", coloured, message);
 }
 
-static where_t get_first_line(const typevec_t *segments)
+static size_t get_first_line(rich_t *rich, const typevec_t *segments)
 {
+    CTASSERT(rich != NULL);
     CTASSERT(segments != NULL);
 
     size_t len = typevec_len(segments);
@@ -80,19 +81,12 @@ static where_t get_first_line(const typevec_t *segments)
         if (!node_has_line(&segment->node))
             continue;
 
-        where_t where = node_get_location(&segment->node);
+        location_t where = cache_get_node_location(rich->file_cache, &segment->node);
         first_line = CT_MIN(first_line, where.first_line);
         break;
     }
 
-    where_t where = {
-        .first_line = first_line,
-        .first_column = 0,
-        .last_line = first_line,
-        .last_column = 0,
-    };
-
-    return where;
+    return first_line;
 }
 
 static void print_scan_header(rich_t *rich, size_t largest, size_t line, const scan_t *scan)
@@ -128,7 +122,7 @@ static void print_file_header(rich_t *rich, const node_t *node)
     const scan_t *scan = node_get_scan(node);
     text_config_t config = rich->config;
     int width = get_num_width(rich->largest_line);
-    size_t line = get_line_number(config.config, node);
+    size_t line = get_line_number(config.config, rich->file_cache, node);
 
     if (node_has_line(node))
     {
@@ -149,7 +143,7 @@ static char *fmt_underline(text_cache_t *cache, const node_t *node, size_t limit
 {
     CTASSERT(cache != NULL);
 
-    where_t where = node_get_location(node);
+    location_t where = cache_get_location(cache, node_get_location(node));
 
     text_view_t view = cache_get_line(cache, where.first_line);
     size_t width = CT_MIN(view.length, limit);
@@ -185,15 +179,16 @@ static void print_file_segment(rich_t *rich, const node_t *node, const char *mes
     text_config_t config = rich->config;
 
     const scan_t *scan = node_get_scan(node);
-    where_t where = node_get_location(node);
+    text_cache_t *file = cache_emplace_scan(rich->file_cache, scan);
+
+    location_t where = cache_get_location(file, node_get_location(node));
     size_t data_line = where.first_line;
 
-    size_t display_line = get_line_number(config.config, node);
+    size_t display_line = get_line_number(config.config, rich->file_cache, node);
     int width = get_num_width(CT_MAX(display_line, rich->largest_line));
     char *padding = str_repeat(" ", width, rich->arena);
     char *line = fmt_left_align(rich->arena, width, "%zu", display_line);
 
-    text_cache_t *file = cache_emplace_scan(rich->file_cache, scan);
     text_t source = cache_escape_line(file, data_line, config.colours, rich->max_columns);
 
     // get the first line of the message
@@ -271,13 +266,14 @@ static void print_file_segments(rich_t *rich, const typevec_t *segments)
     }
 }
 
-static bool nodes_overlap(const node_t *lhs, const node_t *rhs)
+static bool nodes_overlap(rich_t *rich, const node_t *lhs, const node_t *rhs)
 {
+    CTASSERT(rich != NULL);
     CTASSERT(lhs != NULL);
     CTASSERT(rhs != NULL);
 
-    where_t lhs_where = node_get_location(lhs);
-    where_t rhs_where = node_get_location(rhs);
+    location_t lhs_where = cache_get_node_location(rich->file_cache, lhs);
+    location_t rhs_where = cache_get_node_location(rich->file_cache, rhs);
 
     // if the elements overlap at all then they are considered to be the same
 
@@ -317,7 +313,7 @@ static typevec_t *collect_segments(rich_t *rich, const typevec_t *all, const sca
 
         if (node_has_line(other))
         {
-            where_t where = node_get_location(other);
+            location_t where = cache_get_node_location(rich->file_cache, other);
             rich->largest_line = CT_MAX(rich->largest_line, where.first_line);
         }
 
@@ -339,7 +335,7 @@ static join_result_t join_node_messages(rich_t *rich, const segment_t *segment,
     CTASSERT(segment != NULL);
     CTASSERT(other != NULL);
 
-    if (!nodes_overlap(&segment->node, &other->node))
+    if (!nodes_overlap(rich, &segment->node, &other->node))
     {
         join_result_t result = {
             .joined_nodes = false,
@@ -439,8 +435,9 @@ static typevec_t *collect_primary_segments(rich_t *rich, const typevec_t *all, c
     return result;
 }
 
-static size_t longest_segment_line(const typevec_t *segments)
+static size_t longest_segment_line(rich_t *rich, const typevec_t *segments)
 {
+    CTASSERT(rich != NULL);
     CTASSERT(segments != NULL);
 
     size_t len = typevec_len(segments);
@@ -454,7 +451,7 @@ static size_t longest_segment_line(const typevec_t *segments)
         if (!node_has_line(&segment->node))
             continue;
 
-        where_t where = node_get_location(&segment->node);
+        location_t where = cache_get_node_location(rich->file_cache, &segment->node);
         longest = CT_MAX(longest, where.first_line);
     }
 
@@ -495,10 +492,10 @@ static void print_extra_files(rich_t *rich)
         typevec_t *all = collect_segments(rich, event->segments, scan);
         typevec_t *merged = merge_segments(rich, all, NULL);
 
-        size_t largest_line = longest_segment_line(merged);
-        where_t where = get_first_line(merged);
+        size_t largest_line = longest_segment_line(rich, merged);
+        size_t first_line = get_first_line(rich, merged);
 
-        print_scan_header(rich, largest_line, where.first_line, scan);
+        print_scan_header(rich, largest_line, first_line, scan);
         print_file_segments(rich, merged);
     }
 }
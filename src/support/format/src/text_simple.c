@@ -75,7 +75,7 @@ static void print_segment(simple_t *simple, const segment_t *segment, size_t sca
         .zero_indexed_lines = simple->file.zeroth_line,
     };
 
-    const char *path = fmt_node_location(source_config, &segment->node);
+    const char *path = fmt_node_location(source_config, simple->text.cache, &segment->node);
 
     const char *msg = segment->message;
 
@@ -181,6 +181,10 @@ void text_report_simple(text_config_t config, const event_t *event)
         .fmt = fmt
     };
 
+    // line numbers are resolved from the line table of each file
+    if (config.cache == NULL)
+        simple.text.cache = cache_map_new(4, arena);
+
     file_config_t cfg = config.config;
     severity_t severity = get_severity(diagnostic, cfg.override_fatal);
 
@@ -194,7 +198,7 @@ void text_report_simple(text_config_t config, const event_t *event)
         .zero_indexed_lines = cfg.zeroth_line,
     };
 
-    const char *path = fmt_node_location(source_config, &event->node);
+    const char *path = fmt_node_location(source_config, simple.text.cache, &event->node);
     const char *lvl = colour_format(fmt, col, "%s: %s:", sev, diagnostic->id);
 
     io_printf(io, "%s %s %s:\n", path, lvl, event->message);
@@ -202,4 +206,7 @@ void text_report_simple(text_config_t config, const event_t *event)
     print_segments(&simple, event);
 
     print_simple_notes(&simple, event->notes);
+
+    if (config.cache == NULL)
+        cache_map_delete(simple.text.cache);
 }
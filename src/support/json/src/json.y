@@ -7,7 +7,7 @@
 %define api.prefix {json}
 
 %code top {
-    #include "json_actions.h"
+    #include "interop/flex.h"
     #include "interop/bison.h"
 
     #include "arena/arena.h"
@@ -24,7 +24,7 @@
 
 %{
 int jsonlex(void *lval, void *loc, scan_t *scan);
-void jsonerror(json_where_t *where, void *state, scan_t *scan, const char *msg);
+void jsonerror(where_t *where, void *state, scan_t *scan, const char *msg);
 %}
 
 %union {
@@ -85,16 +85,16 @@ element: value { $$ = $1; }
     ;
 
 value: object { $$ = $1; }
-    | array { $$ = json_ast_array(@$.where, $1); }
-    | STRING { $$ = json_ast_string(@$.where, $1); }
-    | INTEGER { $$ = json_ast_integer(@$.where, $1); }
-    | REAL { $$ = json_ast_float(@$.where, $1); }
-    | BOOLEAN { $$ = json_ast_boolean(@$.where, $1); }
-    | NULLVAL { $$ = json_ast_null(@$.where); }
+    | array { $$ = json_ast_array(@$, $1); }
+    | STRING { $$ = json_ast_string(@$, $1); }
+    | INTEGER { $$ = json_ast_integer(@$, $1); }
+    | REAL { $$ = json_ast_float(@$, $1); }
+    | BOOLEAN { $$ = json_ast_boolean(@$, $1); }
+    | NULLVAL { $$ = json_ast_null(@$); }
     ;
 
-object: LBRACE RBRACE { $$ = json_ast_empty_object(@$.where); }
-    | LBRACE members RBRACE { $$ = json_ast_object(x, @$.where, $2); }
+object: LBRACE RBRACE { $$ = json_ast_empty_object(@$); }
+    | LBRACE members RBRACE { $$ = json_ast_object(x, @$, $2); }
     ;
 
 array: LBRACKET RBRACKET { $$ = kEmptyTypevec; }
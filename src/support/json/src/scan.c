@@ -39,13 +39,13 @@ void json_parse_float(float *real, scan_t *scan, where_t where, const char *text
     *real = result;
 }
 
-void json_parse_string(text_view_t *string, scan_t *scan, json_where_t where, const char *text, size_t length)
+void json_parse_string(text_view_t *string, scan_t *scan, where_t where, const char *text, size_t length)
 {
     // if we dont have any escapes then we return a view of the source text
     if (!util_text_has_escapes(text, length))
     {
         text_view_t source = scan_source(scan);
-        text_view_t span = text_view_make(source.text + where.offset - length - 1, length);
+        text_view_t span = text_view_make(source.text + where.offset + 1, length);
         *string = span;
     }
     else
@@ -53,7 +53,7 @@ void json_parse_string(text_view_t *string, scan_t *scan, json_where_t where, co
         // otherwise escape the text
         json_scan_t *ctx = json_scan_context(scan);
         arena_t *arena = scan_get_arena(scan);
-        node_t node = node_make(scan, where.where);
+        node_t node = node_make(scan, where);
         text_t escaped = util_text_escape(ctx->reports, &node, text, length, arena);
         *string = text_view_make(escaped.text, escaped.length);
     }
@@ -5,6 +5,8 @@
 #include "common.h"
 #include "cthulhu/broker/broker.h"
 
+#include "std/strbuf.h"
+
 typedef struct io_t io_t;
 
 typedef struct c89_source_t
@@ -34,6 +36,9 @@ typedef struct c89_emit_t
 
     set_t *defined; // set<ssa_type>
 
+    // scratch space for building output before it is written
+    strbuf_t buffer;
+
     fs_t *fs;
     map_t *deps;
     vector_t *sources;
@@ -49,16 +54,16 @@ typedef enum type_format_t {
     eFormatEmitConst = 1 << 0,
 
     // TODO: this is a bit of a hack to always emit const types
-    // when an object has const storage, ideally c89_format_type should accept
-    // storage or c89_format_storage should be more generic.
+    // when an object has const storage, ideally c89_append_type should accept
+    // storage or c89_append_storage should be more generic.
     eFormatIsConst = 1 << 1,
 } type_format_t;
 
-const char *c89_format_type(c89_emit_t *emit, const ssa_type_t *type, const char *name, type_format_t flags);
-const char *c89_format_params(c89_emit_t *emit, typevec_t *params, bool variadic);
-const char *c89_printf_specifier(digit_t digit, sign_t sign);
+void c89_append_type(c89_emit_t *emit, strbuf_t *buf, const ssa_type_t *type, const char *name, type_format_t flags);
+void c89_append_params(c89_emit_t *emit, strbuf_t *buf, typevec_t *params, bool variadic);
+void c89_append_storage(c89_emit_t *emit, strbuf_t *buf, ssa_storage_t storage, const char *name, type_format_t flags);
 
-const char *c89_format_storage(c89_emit_t *emit, ssa_storage_t storage, const char *name, type_format_t flags);
+const char *c89_printf_specifier(digit_t digit, sign_t sign);
 
 c89_source_t *c89_get_source(c89_emit_t *emit, const ssa_module_t *mod);
 c89_source_t *c89_get_header(c89_emit_t *emit, const ssa_module_t *mod);
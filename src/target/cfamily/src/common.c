@@ -5,6 +5,7 @@
 #include "std/str.h"
 #include "std/map.h"
 #include "std/vector.h"
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 
 #include "fs/fs.h"
@@ -102,7 +103,7 @@ char *get_anon_local_name(emit_t *emit, const ssa_local_t *local, const char *pr
 
 char *get_step_from_block(emit_t *emit, const ssa_block_t *block, size_t index)
 {
-    ssa_step_t *step = typevec_offset(block->steps, index);
+    ssa_step_t *step = segvec_offset(block->steps, index);
     return get_step_name(emit, step);
 }
 
@@ -12,7 +12,9 @@
 #include "std/str.h"
 #include "std/map.h"
 #include "std/set.h"
+#include "std/strbuf.h"
 #include "std/vector.h"
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 
 #include "os/os.h"
@@ -215,6 +217,15 @@ static void c89_begin_module(c89_emit_t *emit, const ssa_module_t *mod)
     io_printf(src->io, "#include \"%s.h\"\n", hdr_file);
 }
 
+static void c89_end_module(c89_emit_t *emit, const ssa_module_t *mod)
+{
+    c89_source_t *src = map_get(emit->srcmap, mod);
+    c89_source_t *hdr = map_get(emit->hdrmap, mod);
+
+    io_close(src->io);
+    io_close(hdr->io);
+}
+
 // emit api
 
 static const char *format_c89_link(tree_linkage_t linkage)
@@ -233,46 +244,75 @@ static const char *format_c89_link(tree_linkage_t linkage)
     }
 }
 
-static void get_required_headers(c89_emit_t *emit, set_t *requires, const ssa_module_t *root, vector_t *symbols)
+static void get_required_symbols(c89_emit_t *emit, set_t *symbols, vector_t *globals)
 {
-    size_t len = vector_len(symbols);
+    size_t len = vector_len(globals);
     for (size_t i = 0; i < len; i++)
     {
-        const ssa_symbol_t *global = vector_get(symbols, i);
+        const ssa_symbol_t *global = vector_get(globals, i);
         set_t *deps = map_get(emit->deps, global);
         if (deps == NULL) { continue; }
 
-        set_iter_t iter = set_iter(deps);
-        while (set_has_next(&iter))
+        set_union(symbols, deps);
+    }
+}
+
+static void get_required_headers(c89_emit_t *emit, set_t *requires, const ssa_module_t *root, set_t *symbols)
+{
+    set_iter_t iter = set_iter(symbols);
+    while (set_has_next(&iter))
+    {
+        const ssa_symbol_t *dep = set_next(&iter);
+        const ssa_module_t *dep_mod = map_get(emit->modmap, dep);
+        if (dep_mod != root)
         {
-            const ssa_symbol_t *dep = set_next(&iter);
-            const ssa_module_t *dep_mod = map_get(emit->modmap, dep);
-            if (dep_mod != root)
-            {
-                set_add(requires, dep_mod);
-            }
+            set_add(requires, dep_mod);
         }
     }
 }
 
+static int header_path_cmp(const void *lhs, const void *rhs)
+{
+    const char *const *path_lhs = lhs;
+    const char *const *path_rhs = rhs;
+
+    return ctu_strcmp(*path_lhs, *path_rhs);
+}
+
 static void emit_required_headers(c89_emit_t *emit, const ssa_module_t *mod)
 {
     // TODO: this is very coarse, we should only add deps to the headers
     // for symbols that are externally visible
 
-    size_t len = vector_len(mod->globals);
-    set_t *requires = set_new(CT_MAX(len, 1), kTypeInfoPtr, emit->arena); // set of modules required by this module
+    size_t len = vector_len(mod->globals) + vector_len(mod->functions);
 
-    get_required_headers(emit, requires, mod, mod->globals);
-    get_required_headers(emit, requires, mod, mod->functions);
+    // many symbols share dependencies, merge them first so each
+    // dependency is only looked up in the module map once
+    set_t *symbols = set_new(CT_MAX(len, 1), kTypeInfoPtr, emit->arena);
+    get_required_symbols(emit, symbols, mod->globals);
+    get_required_symbols(emit, symbols, mod->functions);
 
-    io_t *hdr = c89_get_header_io(emit, mod);
+    set_t *requires = set_new(CT_MAX(len, 1), kTypeInfoPtr, emit->arena); // set of modules required by this module
+    get_required_headers(emit, requires, mod, symbols);
+
+    // the set is keyed by pointer, sort the paths so the output is stable
+    typevec_t *paths = typevec_new(sizeof(const char*), CT_MAX(set_count(requires), 1), emit->arena);
     set_iter_t iter = set_iter(requires);
     while (set_has_next(&iter))
     {
         const ssa_module_t *item = set_next(&iter);
         c89_source_t *dep = c89_get_header(emit, item);
-        io_printf(hdr, "#include \"%s\"\n", dep->path);
+        typevec_push(paths, &dep->path);
+    }
+
+    typevec_sort(paths, header_path_cmp);
+
+    io_t *hdr = c89_get_header_io(emit, mod);
+    size_t count = typevec_len(paths);
+    for (size_t i = 0; i < count; i++)
+    {
+        const char *const *path = typevec_offset(paths, i);
+        io_printf(hdr, "#include \"%s\"\n", *path);
     }
 }
 
@@ -301,56 +341,92 @@ static bool is_entry_point(tree_linkage_t link)
     return link == eLinkEntryCli || link == eLinkEntryGui;
 }
 
-static const char *format_symbol(c89_emit_t *emit, const ssa_type_t *type, const char *name)
+static void append_symbol(c89_emit_t *emit, strbuf_t *buf, const ssa_type_t *type, const char *name)
 {
-    return c89_format_type(emit, type, name, eFormatEmitConst);
+    c89_append_type(emit, buf, type, name, eFormatEmitConst);
 }
 
-char *c89_format_integer_literal(arena_t *arena, const mpz_t value)
+static void append_integer_literal(strbuf_t *buf, const mpz_t value)
 {
+    // most literals are small enough to format without going through gmp
     if (mpz_fits_sint_p(value))
-        return mpz_get_str(NULL, 10, value);
+    {
+        strbuf_printf(buf, "%ld", mpz_get_si(value));
+        return;
+    }
 
-    if (integer_fits_longlong(value))
-        return str_format(arena, "%sll", mpz_get_str(NULL, 10, value));
+    if (mpz_fits_slong_p(value) && integer_fits_longlong(value))
+    {
+        strbuf_printf(buf, "%ldll", mpz_get_si(value));
+        return;
+    }
 
-    // integer must be unsigned if we get this far
-    if (integer_is_unsigned(value))
-        return str_format(arena, "%sull", mpz_get_str(NULL, 10, value));
+    // integer must be unsigned if it does not fit in a long long
+    const char *suffix = integer_fits_longlong(value) ? "ll" : "ull";
+    CTASSERTF(integer_fits_longlong(value) || integer_is_unsigned(value), "integer literal is too large, this should be caught earlier");
 
-    CT_NEVER("integer literal %s is too large, this should be caught earlier", mpz_get_str(NULL, 10, value));
+    char *digits = mpz_get_str(NULL, 10, value);
+    strbuf_printf(buf, "%s%s", digits, suffix);
+
+    // the string was allocated by gmp and has to be released the same way
+    void (*gmp_free)(void *, size_t);
+    mp_get_memory_functions(NULL, NULL, &gmp_free);
+    gmp_free(digits, ctu_strlen(digits) + 1);
+}
+
+char *c89_format_integer_literal(arena_t *arena, const mpz_t value)
+{
+    strbuf_t buf;
+    strbuf_init(&buf, 32, arena);
+    append_integer_literal(&buf, value);
+
+    // the buffer lives in the arena, so its contents can be returned directly
+    return (char*)strbuf_data(&buf);
 }
 
-static char *format_integer_value(arena_t *arena, const ssa_value_t *value)
+static void append_integer_value(strbuf_t *buf, const ssa_value_t *value)
 {
     mpz_t digit;
     ssa_value_get_digit(value, digit);
-    return c89_format_integer_literal(arena, digit);
+    append_integer_literal(buf, digit);
+}
+
+// write everything appended to the scratch buffer and empty it
+static void flush_buffer(c89_emit_t *emit, io_t *io)
+{
+    io_write_strbuf(io, &emit->buffer);
+    strbuf_reset(&emit->buffer);
 }
 
 static void define_enum(io_t *io, const ssa_type_t *type, c89_emit_t *emit)
 {
-    // update c89_format_type eTypeEnum when this is changed
+    // update c89_append_type eTypeEnum when this is changed
     const ssa_type_enum_t it = type->sum;
     size_t len = typevec_len(it.cases);
     const ssa_type_t *underlying = it.underlying;
+    strbuf_t *buf = &emit->buffer;
     char *under = str_format(emit->arena, "%s_underlying_t", type->name);
-    const char *tydef = c89_format_type(emit, underlying, under, false);
-    io_printf(io, "typedef %s;\n", tydef);
+    strbuf_append(buf, "typedef ");
+    c89_append_type(emit, buf, underlying, under, eFormatEmitNone);
+    strbuf_append(buf, ";\n");
 
-    io_printf(io, "enum %s_cases_t { /* %zu cases */\n", type->name, len);
+    strbuf_printf(buf, "enum %s_cases_t { /* %zu cases */\n", type->name, len);
     if (len == 0)
     {
-        io_printf(io, "\te%s_empty = 0,\n", type->name);
+        strbuf_printf(buf, "\te%s_empty = 0,\n", type->name);
     }
     else for (size_t i = 0; i < len; i++)
     {
         const ssa_case_t *field = typevec_offset(it.cases, i);
 
         // TODO: formalize the name mangling for enum fields
-        io_printf(io, "\te%s%s = %s,\n", type->name, field->name, c89_format_integer_literal(emit->arena, field->value));
+        strbuf_printf(buf, "\te%s%s = ", type->name, field->name);
+        append_integer_literal(buf, field->value);
+        strbuf_append(buf, ",\n");
     }
-    io_printf(io, "};\n");
+    strbuf_append(buf, "};\n");
+
+    flush_buffer(emit, io);
 }
 
 static void c89_proto_aggregate(io_t *io, const char *ty, const char *name)
@@ -378,13 +454,13 @@ void c89_proto_type(c89_emit_t *emit, io_t *io, const ssa_type_t *type)
     }
 }
 
-static void write_global(c89_emit_t *emit, io_t *io, const ssa_symbol_t *global)
+static void write_global(c89_emit_t *emit, strbuf_t *buf, const ssa_symbol_t *global)
 {
     ssa_storage_t storage = global->storage;
-    const char *it = c89_format_storage(emit, global->storage, mangle_symbol_name(emit, global), (storage.quals & eQualConst) ? eFormatIsConst : eFormatEmitNone);
-    const char *link = format_c89_link(global->linkage);
+    type_format_t flags = (storage.quals & eQualConst) ? eFormatIsConst : eFormatEmitNone;
 
-    io_printf(io, "%s%s", link, it);
+    strbuf_append(buf, format_c89_link(global->linkage));
+    c89_append_storage(emit, buf, storage, mangle_symbol_name(emit, global), flags);
 }
 
 void c89_proto_global(c89_emit_t *emit, const ssa_module_t *mod, const ssa_symbol_t *global)
@@ -392,17 +468,31 @@ void c89_proto_global(c89_emit_t *emit, const ssa_module_t *mod, const ssa_symbo
     if (global->visibility == eVisiblePublic)
     {
         CTASSERT(global->linkage != eLinkModule); // TODO: move this check into the checker
-
-        io_t *io = c89_get_header_io(emit, mod);
-        write_global(emit, io, global);
-        io_printf(io, ";\n");
-    }
-    else
-    {
-        io_t *io = c89_get_source_io(emit, mod);
-        write_global(emit, io, global);
-        io_printf(io, ";\n");
     }
+
+    io_t *io = (global->visibility == eVisiblePublic)
+        ? c89_get_header_io(emit, mod)
+        : c89_get_source_io(emit, mod);
+
+    write_global(emit, &emit->buffer, global);
+    strbuf_append(&emit->buffer, ";\n");
+    flush_buffer(emit, io);
+}
+
+// append `link result name(params)`
+static void write_signature(c89_emit_t *emit, strbuf_t *buf, const ssa_symbol_t *symbol)
+{
+    const ssa_type_t *type = symbol->type;
+    CTASSERTF(type->kind == eTypeClosure, "expected closure type on %s, got %d", symbol->name, type->kind);
+
+    ssa_type_closure_t closure = type->closure;
+
+    // TODO: handle -Werror=main when the entry point doesnt return int
+    strbuf_append(buf, format_c89_link(symbol->linkage));
+    append_symbol(emit, buf, closure.result, mangle_symbol_name(emit, symbol));
+    strbuf_append_char(buf, '(');
+    c89_append_params(emit, buf, closure.params, closure.variadic);
+    strbuf_append_char(buf, ')');
 }
 
 void c89_proto_function(c89_emit_t *emit, const ssa_module_t *mod, const ssa_symbol_t *symbol)
@@ -413,17 +503,11 @@ void c89_proto_function(c89_emit_t *emit, const ssa_module_t *mod, const ssa_sym
     io_t *src = c89_get_source_io(emit, mod);
     io_t *hdr = c89_get_header_io(emit, mod);
 
-    const ssa_type_t *type = symbol->type;
-    CTASSERTF(type->kind == eTypeClosure, "expected closure type on %s, got %d", symbol->name, type->kind);
-
-    ssa_type_closure_t closure = type->closure;
-    const char *params = c89_format_params(emit, closure.params, closure.variadic);
-    const char *result = format_symbol(emit, closure.result, mangle_symbol_name(emit, symbol));
-
-    const char *link = format_c89_link(symbol->linkage);
-
     io_t *dst = symbol->visibility == eVisiblePublic ? hdr : src;
-    io_printf(dst, "%s%s(%s);\n", link, result, params);
+
+    write_signature(emit, &emit->buffer, symbol);
+    strbuf_append(&emit->buffer, ";\n");
+    flush_buffer(emit, dst);
 }
 
 static void proto_symbols(c89_emit_t *emit, const ssa_module_t *mod, vector_t *vec, void (*fn)(c89_emit_t*, const ssa_module_t*, const ssa_symbol_t*))
@@ -516,7 +600,7 @@ static const ssa_type_t *get_operand_type(c89_emit_t *emit, ssa_operand_t operan
     }
     case eOperandReg: {
         const ssa_block_t *bb = operand.vreg_context;
-        const ssa_step_t *step = typevec_offset(bb->steps, operand.vreg_index);
+        const ssa_step_t *step = segvec_offset(bb->steps, operand.vreg_index);
         const ssa_type_t *type = map_get(emit->stepmap, step);
         return type;
     }
@@ -530,18 +614,21 @@ static void set_step_type(c89_emit_t *emit, const ssa_step_t *step, const ssa_ty
     map_set(emit->stepmap, step, (ssa_type_t*)type);
 }
 
-static const char *c89_name_vreg(c89_emit_t *emit, const ssa_step_t *step, const ssa_type_t *type)
+static void append_vreg(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step, const ssa_type_t *type)
 {
     set_step_type(emit, step, (ssa_type_t*)type);
 
-    const char *id = str_format(emit->arena, "vreg%s", get_step_name(&emit->emit, step));
-    return format_symbol(emit, type, id);
+    char id[32];
+    size_t len = str_sprintf(id, sizeof(id), "vreg%s", get_step_name(&emit->emit, step));
+    CTASSERTF(len < sizeof(id), "vreg name too long (%zu)", len);
+
+    append_symbol(emit, buf, type, id);
 }
 
-static const char *c89_name_vreg_by_operand(c89_emit_t *emit, const ssa_step_t *step, ssa_operand_t operand)
+static void append_vreg_by_operand(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step, ssa_operand_t operand)
 {
     const ssa_type_t *type = get_operand_type(emit, operand);
-    return c89_name_vreg(emit, step, type);
+    append_vreg(emit, buf, step, type);
 }
 
 static const ssa_type_t *get_reg_type(const ssa_type_t *type)
@@ -557,10 +644,10 @@ static const ssa_type_t *get_reg_type(const ssa_type_t *type)
     }
 }
 
-static const char *c89_name_load_vreg_by_operand(c89_emit_t *emit, const ssa_step_t *step, ssa_operand_t operand)
+static void append_load_vreg_by_operand(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step, ssa_operand_t operand)
 {
     const ssa_type_t *type = get_operand_type(emit, operand);
-    return c89_name_vreg(emit, step, get_reg_type(type));
+    append_vreg(emit, buf, step, get_reg_type(type));
 }
 
 static const char *operand_type_string(c89_emit_t *emit, ssa_operand_t operand)
@@ -569,59 +656,69 @@ static const char *operand_type_string(c89_emit_t *emit, ssa_operand_t operand)
     return type_to_string(type, emit->arena);
 }
 
-static const char *c89_format_value(c89_emit_t *emit, const ssa_value_t* value);
+static void append_value(c89_emit_t *emit, strbuf_t *buf, const ssa_value_t* value);
 
-static const char *c89_format_pointer(c89_emit_t *emit, const ssa_value_t *value)
+static void append_pointer(c89_emit_t *emit, strbuf_t *buf, const ssa_value_t *value)
 {
     if (value->value == eValueRelative)
     {
         ssa_relative_value_t relative = value->relative;
-        return str_format(emit->arena, "(%s)", relative.symbol->name);
+        strbuf_printf(buf, "(%s)", relative.symbol->name);
+        return;
     }
 
     ssa_literal_value_t literal = ssa_value_get_literal(value);
-    arena_t *arena = emit->arena;
     size_t len = vector_len(literal.data);
-    vector_t *result = vector_of(len, arena);
+
+    strbuf_append(buf, "{ ");
     for (size_t i = 0; i < len; i++)
     {
+        if (i > 0) strbuf_append(buf, ", ");
+
         const ssa_value_t *element = vector_get(literal.data, i);
-        const char *it = c89_format_value(emit, element);
-        vector_set(result, i, (char*)it);
+        append_value(emit, buf, element);
     }
-
-    char *joined = str_join(", ", result, arena);
-    return str_format(arena, "{ %s }", joined);
+    strbuf_append(buf, " }");
 }
 
-static const char *c89_format_opaque(c89_emit_t *emit, const ssa_value_t *value)
+static void append_opaque(strbuf_t *buf, const ssa_value_t *value)
 {
     if (value->value == eValueLiteral)
     {
         ssa_literal_value_t literal = value->literal;
-        return str_format(emit->arena, "((void*)%s)", c89_format_integer_literal(emit->arena, literal.pointer));
+        strbuf_append(buf, "((void*)");
+        append_integer_literal(buf, literal.pointer);
+        strbuf_append_char(buf, ')');
+        return;
     }
 
     if (value->value == eValueRelative)
     {
         const ssa_relative_value_t *relative = &value->relative;
-        return str_format(emit->arena, "((void*)%s)", relative->symbol->name);
+        strbuf_printf(buf, "((void*)%s)", relative->symbol->name);
+        return;
     }
 
     CT_NEVER("unknown opaque value kind %d", value->value);
 }
 
-static const char *c89_format_value(c89_emit_t *emit, const ssa_value_t* value)
+static void append_value(c89_emit_t *emit, strbuf_t *buf, const ssa_value_t* value)
 {
     const ssa_type_t *type = value->type;
     switch (type->kind)
     {
     case eTypeBool:
-        return ssa_value_get_bool(value) ? "true" : "false";
+        strbuf_append(buf, ssa_value_get_bool(value) ? "true" : "false");
+        break;
     case eTypeDigit:
-        return format_integer_value(emit->arena, value);
-    case eTypePointer: return c89_format_pointer(emit, value);
-    case eTypeOpaque: return c89_format_opaque(emit, value);
+        append_integer_value(buf, value);
+        break;
+    case eTypePointer:
+        append_pointer(emit, buf, value);
+        break;
+    case eTypeOpaque:
+        append_opaque(buf, value);
+        break;
     default: CT_NEVER("unknown type kind %d", type->kind);
     }
 }
@@ -634,49 +731,61 @@ static const char *get_local_name(c89_emit_t *emit, const ssa_local_t *local)
     return get_anon_local_name(&emit->emit, local, "local_");
 }
 
-static const char *c89_format_local(c89_emit_t *emit, size_t local)
+static void append_local(c89_emit_t *emit, strbuf_t *buf, size_t local)
 {
     typevec_t *locals = emit->current->locals;
     CTASSERTF(local < typevec_len(locals), "local(%zu) > locals(%zu)", local, typevec_len(locals));
 
     const ssa_local_t *it = typevec_offset(locals, local);
-    return get_local_name(emit, it);
+    if (it->name != NULL)
+        strbuf_printf(buf, "local_%s", it->name);
+    else
+        strbuf_append(buf, get_anon_local_name(&emit->emit, it, "local_"));
 }
 
-static const char *c89_format_param(c89_emit_t *emit, size_t param)
+static void append_param(c89_emit_t *emit, strbuf_t *buf, size_t param)
 {
     typevec_t *params = emit->current->params;
     CTASSERTF(param < typevec_len(params), "param(%zu) > params(%zu)", param, typevec_len(params));
 
     const ssa_param_t *it = typevec_offset(params, param);
-    return it->name;
+    strbuf_append(buf, it->name);
 }
 
-static const char *c89_format_operand(c89_emit_t *emit, ssa_operand_t operand)
+static void append_operand(c89_emit_t *emit, strbuf_t *buf, ssa_operand_t operand)
 {
     switch (operand.kind)
     {
-    case eOperandEmpty: return "/* empty */";
+    case eOperandEmpty:
+        strbuf_append(buf, "/* empty */");
+        break;
     case eOperandImm:
-        return c89_format_value(emit, operand.value);
+        append_value(emit, buf, operand.value);
+        break;
 
     case eOperandBlock:
-        return str_format(emit->arena, "bb%s", get_block_name(&emit->emit, operand.bb));
+        strbuf_printf(buf, "bb%s", get_block_name(&emit->emit, operand.bb));
+        break;
 
     case eOperandReg:
-        return str_format(emit->arena, "vreg%s", get_step_from_block(&emit->emit, operand.vreg_context, operand.vreg_index));
+        strbuf_printf(buf, "vreg%s", get_step_from_block(&emit->emit, operand.vreg_context, operand.vreg_index));
+        break;
 
     case eOperandGlobal:
-        return mangle_symbol_name(emit, operand.global);
+        strbuf_append(buf, mangle_symbol_name(emit, operand.global));
+        break;
 
     case eOperandFunction:
-        return mangle_symbol_name(emit, operand.function);
+        strbuf_append(buf, mangle_symbol_name(emit, operand.function));
+        break;
 
     case eOperandLocal:
-        return c89_format_local(emit, operand.local);
+        append_local(emit, buf, operand.local);
+        break;
 
     case eOperandParam:
-        return c89_format_param(emit, operand.param);
+        append_param(emit, buf, operand.param);
+        break;
 
     default: CT_NEVER("unknown operand kind %d", operand.kind);
     }
@@ -699,29 +808,32 @@ static bool operand_cant_return(ssa_operand_t operand)
     return operand.kind == eOperandEmpty;
 }
 
-static void c89_write_address(c89_emit_t *emit, io_t *io, const ssa_step_t *step)
+static void c89_write_address(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step)
 {
     ssa_addr_t addr = step->addr;
     ssa_operand_t symbol = addr.symbol;
     const ssa_type_t *type = get_operand_type(emit, symbol);
 
     const ssa_type_t *ptr = ssa_type_pointer(type->name, eQualNone, (ssa_type_t*)type, 0);
-    const char *step_name = c89_name_vreg(emit, step, ptr);
 
-    io_printf(io, "\t%s = &(%s); /* %s */\n",
-        step_name,
-        c89_format_operand(emit, addr.symbol),
-        type_to_string(ptr, emit->arena)
-    );
+    strbuf_append_char(buf, '\t');
+    append_vreg(emit, buf, step, ptr);
+    strbuf_append(buf, " = &(");
+    append_operand(emit, buf, addr.symbol);
+    strbuf_printf(buf, "); /* %s */\n", type_to_string(ptr, emit->arena));
 }
 
-static void c89_write_offset(c89_emit_t *emit, io_t *io, const ssa_step_t *step)
+static void c89_write_offset(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step)
 {
     ssa_offset_t offset = step->offset;
-    io_printf(io, "\t%s = &%s[%s]; /* (array = %s, offset = %s) */\n",
-        c89_name_vreg_by_operand(emit, step, offset.array),
-        c89_format_operand(emit, offset.array),
-        c89_format_operand(emit, offset.offset),
+
+    strbuf_append_char(buf, '\t');
+    append_vreg_by_operand(emit, buf, step, offset.array);
+    strbuf_append(buf, " = &");
+    append_operand(emit, buf, offset.array);
+    strbuf_append_char(buf, '[');
+    append_operand(emit, buf, offset.offset);
+    strbuf_printf(buf, "]; /* (array = %s, offset = %s) */\n",
         operand_type_string(emit, offset.array),
         operand_type_string(emit, offset.offset)
     );
@@ -735,7 +847,7 @@ static const ssa_field_t *get_aggregate_field(c89_emit_t *emit, const ssa_type_t
     return typevec_offset(record.fields, index);
 }
 
-static void c89_write_member(c89_emit_t *emit, io_t *io, const ssa_step_t *step)
+static void c89_write_member(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step)
 {
     CTASSERTF(step->opcode == eOpMember, "expected member, got %s", ssa_opcode_name(step->opcode));
 
@@ -749,198 +861,242 @@ static void c89_write_member(c89_emit_t *emit, io_t *io, const ssa_step_t *step)
 
     const ssa_field_t *field = get_aggregate_field(emit, record, member.index);
 
-    io_printf(io, "\t%s = &%s->%s;\n",
-        c89_name_vreg(emit, step, ssa_type_pointer(field->name, eQualNone, (ssa_type_t*)field->type, 1)),
-        c89_format_operand(emit, member.object),
-        field->name
-    );
+    strbuf_append_char(buf, '\t');
+    append_vreg(emit, buf, step, ssa_type_pointer(field->name, eQualNone, (ssa_type_t*)field->type, 1));
+    strbuf_append(buf, " = &");
+    append_operand(emit, buf, member.object);
+    strbuf_printf(buf, "->%s;\n", field->name);
 }
 
-static void c89_write_block(c89_emit_t *emit, io_t *io, const ssa_block_t *bb)
+// append `\tvreg = (lhs op rhs);\n`
+static void c89_write_infix(c89_emit_t *emit, strbuf_t *buf, ssa_operand_t lhs, const char *op, ssa_operand_t rhs)
 {
-    size_t len = typevec_len(bb->steps);
-    io_printf(io, "bb%s: { /* len = %zu */\n", get_block_name(&emit->emit, bb), len);
-    for (size_t i = 0; i < len; i++)
+    strbuf_append(buf, " = (");
+    append_operand(emit, buf, lhs);
+    strbuf_printf(buf, " %s ", op);
+    append_operand(emit, buf, rhs);
+    strbuf_append(buf, ");\n");
+}
+
+static void c89_write_call(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step)
+{
+    ssa_call_t call = step->call;
+    size_t args_len = typevec_len(call.args);
+
+    const ssa_type_t *ty = get_operand_type(emit, call.function);
+    ssa_type_closure_t closure = ty->closure;
+    const ssa_type_t *result = closure.result;
+
+    strbuf_append_char(buf, '\t');
+
+    if (result->kind != eTypeEmpty && result->kind != eTypeUnit)
+    {
+        append_vreg(emit, buf, step, result);
+        strbuf_append(buf, " = ");
+    }
+
+    append_operand(emit, buf, call.function);
+    strbuf_append_char(buf, '(');
+    for (size_t arg_idx = 0; arg_idx < args_len; arg_idx++)
     {
-        const ssa_step_t *step = typevec_offset(bb->steps, i);
-        switch (step->opcode)
+        if (arg_idx > 0) strbuf_append(buf, ", ");
+
+        const ssa_operand_t *operand = typevec_offset(call.args, arg_idx);
+        append_operand(emit, buf, *operand);
+    }
+    strbuf_append(buf, ");\n");
+}
+
+static void c89_write_step(c89_emit_t *emit, strbuf_t *buf, const ssa_step_t *step)
+{
+    switch (step->opcode)
+    {
+    case eOpNop:
+        strbuf_append(buf, "\t/* nop */\n");
+        break;
+    case eOpValue: {
+        const ssa_value_t *value = step->value;
+        strbuf_append_char(buf, '\t');
+        append_vreg(emit, buf, step, value->type);
+        strbuf_append(buf, " = ");
+        append_value(emit, buf, value);
+        strbuf_append(buf, ";\n");
+        break;
+    }
+    case eOpStore: {
+        ssa_store_t store = step->store;
+        strbuf_append(buf, "\t*(");
+        append_operand(emit, buf, store.dst);
+        strbuf_append(buf, ") = ");
+        append_operand(emit, buf, store.src);
+        strbuf_append(buf, ";\n");
+        break;
+    }
+    case eOpCast: {
+        ssa_cast_t cast = step->cast;
+        strbuf_append_char(buf, '\t');
+        append_vreg(emit, buf, step, cast.type);
+        strbuf_append(buf, " = (");
+        append_symbol(emit, buf, cast.type, NULL);
+        strbuf_append(buf, ")(");
+        append_operand(emit, buf, cast.operand);
+        strbuf_append(buf, ");\n");
+        break;
+    }
+    case eOpLoad: {
+        ssa_load_t load = step->load;
+        strbuf_append_char(buf, '\t');
+        append_load_vreg_by_operand(emit, buf, step, load.src);
+        strbuf_append(buf, " = *(");
+        append_operand(emit, buf, load.src);
+        strbuf_append(buf, ");\n");
+        break;
+    }
+
+    case eOpAddress:
+        c89_write_address(emit, buf, step);
+        break;
+    case eOpOffset:
+        c89_write_offset(emit, buf, step);
+        break;
+    case eOpMember:
+        c89_write_member(emit, buf, step);
+        break;
+
+    case eOpUnary: {
+        ssa_unary_t unary = step->unary;
+        strbuf_append_char(buf, '\t');
+        append_vreg_by_operand(emit, buf, step, unary.operand);
+        strbuf_printf(buf, " = (%s ", unary_symbol(unary.unary));
+        append_operand(emit, buf, unary.operand);
+        strbuf_append(buf, ");\n");
+        break;
+    }
+    case eOpBinary: {
+        ssa_binary_t bin = step->binary;
+        strbuf_append_char(buf, '\t');
+        append_vreg_by_operand(emit, buf, step, bin.lhs);
+        c89_write_infix(emit, buf, bin.lhs, binary_symbol(bin.binary), bin.rhs);
+        break;
+    }
+    case eOpCompare: {
+        ssa_compare_t cmp = step->compare;
+        strbuf_append_char(buf, '\t');
+        append_vreg(emit, buf, step, ssa_type_bool("bool", eQualConst));
+        c89_write_infix(emit, buf, cmp.lhs, compare_symbol(cmp.compare), cmp.rhs);
+        break;
+    }
+
+    case eOpCall:
+        c89_write_call(emit, buf, step);
+        break;
+
+    case eOpJump: {
+        ssa_jump_t jmp = step->jump;
+        strbuf_append(buf, "\tgoto ");
+        append_operand(emit, buf, jmp.target);
+        strbuf_append(buf, ";\n");
+        break;
+    }
+    case eOpBranch: {
+        ssa_branch_t br = step->branch;
+        strbuf_append(buf, "\tif (");
+        append_operand(emit, buf, br.cond);
+        strbuf_append(buf, ") { goto ");
+        append_operand(emit, buf, br.then);
+        strbuf_append(buf, "; }");
+        if (!operand_is_empty(br.other))
         {
-        case eOpNop:
-            io_printf(io, "\t/* nop */\n");
-            break;
-        case eOpValue: {
-            const ssa_value_t *value = step->value;
-            const char *name = c89_name_vreg(emit, step, value->type);
-            io_printf(io, "\t%s = %s;\n", name, c89_format_value(emit, value));
-            break;
-        }
-        case eOpStore: {
-            ssa_store_t store = step->store;
-            io_printf(io, "\t*(%s) = %s;\n",
-                c89_format_operand(emit, store.dst),
-                c89_format_operand(emit, store.src)
-            );
-            break;
+            strbuf_append(buf, " else { goto ");
+            append_operand(emit, buf, br.other);
+            strbuf_append(buf, "; }");
         }
-        case eOpCast: {
-            ssa_cast_t cast = step->cast;
-            io_printf(io, "\t%s = (%s)(%s);\n",
-                c89_name_vreg(emit, step, cast.type),
-                format_symbol(emit, cast.type, NULL),
-                c89_format_operand(emit, cast.operand)
-            );
-            break;
+        strbuf_append_char(buf, '\n');
+        break;
+    }
+    case eOpReturn: {
+        ssa_return_t ret = step->ret;
+        if (!operand_cant_return(ret.value))
+        {
+            strbuf_append(buf, "\treturn ");
+            append_operand(emit, buf, ret.value);
+            strbuf_append(buf, ";\n");
         }
-        case eOpLoad: {
-            ssa_load_t load = step->load;
-            io_printf(io, "\t%s = *(%s);\n",
-                c89_name_load_vreg_by_operand(emit, step, load.src),
-                c89_format_operand(emit, load.src)
-            );
-            break;
+        else
+        {
+            strbuf_append(buf, "\treturn;\n");
         }
+        break;
+    }
 
-        case eOpAddress:
-            c89_write_address(emit, io, step);
-            break;
-        case eOpOffset:
-            c89_write_offset(emit, io, step);
-            break;
-        case eOpMember:
-            c89_write_member(emit, io, step);
-            break;
-
-        case eOpUnary: {
-            ssa_unary_t unary = step->unary;
-            io_printf(io, "\t%s = (%s %s);\n",
-                c89_name_vreg_by_operand(emit, step, unary.operand),
-                unary_symbol(unary.unary),
-                c89_format_operand(emit, unary.operand)
-            );
-            break;
-        }
-        case eOpBinary: {
-            ssa_binary_t bin = step->binary;
-            io_printf(io, "\t%s = (%s %s %s);\n",
-                c89_name_vreg_by_operand(emit, step, bin.lhs),
-                c89_format_operand(emit, bin.lhs),
-                binary_symbol(bin.binary),
-                c89_format_operand(emit, bin.rhs)
-            );
-            break;
-        }
-        case eOpCompare: {
-            ssa_compare_t cmp = step->compare;
-            io_printf(io, "\t%s = (%s %s %s);\n",
-                c89_name_vreg(emit, step, ssa_type_bool("bool", eQualConst)),
-                c89_format_operand(emit, cmp.lhs),
-                compare_symbol(cmp.compare),
-                c89_format_operand(emit, cmp.rhs)
-            );
-            break;
-        }
+    case eOpSizeOf:
+        strbuf_append_char(buf, '\t');
+        append_vreg(emit, buf, step, ssa_type_digit("size_t", eQualConst, eSignUnsigned, eDigitSize));
+        strbuf_append(buf, " = sizeof(");
+        c89_append_type(emit, buf, step->size_of.type, NULL, eFormatEmitNone);
+        strbuf_append(buf, ");\n");
+        break;
 
-        case eOpCall: {
-            ssa_call_t call = step->call;
-            size_t args_len = typevec_len(call.args);
-
-            const ssa_type_t *ty = get_operand_type(emit, call.function);
-            ssa_type_closure_t closure = ty->closure;
-            const ssa_type_t *result = closure.result;
-
-            vector_t *args = vector_of(args_len, emit->arena);
-            for (size_t arg_idx = 0; arg_idx < args_len; arg_idx++)
-            {
-                const ssa_operand_t *operand = typevec_offset(call.args, arg_idx);
-                vector_set(args, arg_idx, (char*)c89_format_operand(emit, *operand));
-            }
-
-            io_printf(io, "\t");
-
-            if (result->kind != eTypeEmpty && result->kind != eTypeUnit)
-            {
-                io_printf(io, "%s = ", c89_name_vreg(emit, step, result));
-            }
-
-            io_printf(io, "%s(%s);\n",
-                c89_format_operand(emit, call.function),
-                str_join(", ", args, emit->arena)
-            );
-            break;
-        }
+    case eOpAlignOf:
+        strbuf_append_char(buf, '\t');
+        append_vreg(emit, buf, step, ssa_type_digit("size_t", eQualConst, eSignUnsigned, eDigitSize));
+        strbuf_append(buf, " = alignof(");
+        c89_append_type(emit, buf, step->align_of.type, NULL, eFormatEmitNone);
+        strbuf_append(buf, ");\n");
+        break;
 
-        case eOpJump: {
-            ssa_jump_t jmp = step->jump;
-            io_printf(io, "\tgoto %s;\n", c89_format_operand(emit, jmp.target));
-            break;
-        }
-        case eOpBranch: {
-            ssa_branch_t br = step->branch;
-            io_printf(io, "\tif (%s) { goto %s; }", c89_format_operand(emit, br.cond), c89_format_operand(emit, br.then));
-            if (!operand_is_empty(br.other))
-            {
-                io_printf(io, " else { goto %s; }", c89_format_operand(emit, br.other));
-            }
-            io_printf(io, "\n");
-            break;
-        }
-        case eOpReturn: {
-            ssa_return_t ret = step->ret;
-            if (!operand_cant_return(ret.value))
-            {
-                io_printf(io, "\treturn %s;\n", c89_format_operand(emit, ret.value));
-            }
-            else
-            {
-                io_printf(io, "\treturn;\n");
-            }
-            break;
-        }
+    case eOpOffsetOf: {
+        ssa_offsetof_t offset = step->offset_of;
+        const ssa_field_t *field = get_aggregate_field(emit, offset.type, offset.index);
+        strbuf_append_char(buf, '\t');
+        append_vreg(emit, buf, step, ssa_type_digit("size_t", eQualConst, eSignUnsigned, eDigitSize));
+        strbuf_append(buf, " = offsetof(");
+        c89_append_type(emit, buf, step->offset_of.type, NULL, eFormatEmitNone);
+        strbuf_printf(buf, ", %s);\n", field->name);
+        break;
+    }
 
-        case eOpSizeOf:
-            io_printf(io, "\t%s = sizeof(%s);\n",
-                c89_name_vreg(emit, step, ssa_type_digit("size_t", eQualConst, eSignUnsigned, eDigitSize)),
-                c89_format_type(emit, step->size_of.type, NULL, eFormatEmitNone)
-            );
-            break;
-
-        case eOpAlignOf:
-            io_printf(io, "\t%s = alignof(%s);\n",
-                c89_name_vreg(emit, step, ssa_type_digit("size_t", eQualConst, eSignUnsigned, eDigitSize)),
-                c89_format_type(emit, step->align_of.type, NULL, eFormatEmitNone)
-            );
-            break;
-
-        case eOpOffsetOf: {
-            ssa_offsetof_t offset = step->offset_of;
-            const ssa_field_t *field = get_aggregate_field(emit, offset.type, offset.index);
-            io_printf(io, "\t%s = offsetof(%s, %s);\n",
-                c89_name_vreg(emit, step, ssa_type_digit("size_t", eQualConst, eSignUnsigned, eDigitSize)),
-                c89_format_type(emit, step->offset_of.type, NULL, eFormatEmitNone),
-                field->name
-            );
-            break;
-        }
+    default: CT_NEVER("unknown opcode %d", step->opcode);
+    }
+}
 
-        default: CT_NEVER("unknown opcode %d", step->opcode);
-        }
+static void c89_write_block(c89_emit_t *emit, io_t *io, const ssa_block_t *bb)
+{
+    strbuf_t *buf = &emit->buffer;
+    size_t len = segvec_len(bb->steps);
+    strbuf_printf(buf, "bb%s: { /* len = %zu */\n", get_block_name(&emit->emit, bb), len);
+
+    segvec_iter_t iter = segvec_iter(bb->steps);
+    while (segvec_has_next(&iter))
+    {
+        const ssa_step_t *step = segvec_next(&iter);
+        c89_write_step(emit, buf, step);
     }
-    io_printf(io, "} /* end %s */\n", get_block_name(&emit->emit, bb));
+
+    strbuf_printf(buf, "} /* end %s */\n", get_block_name(&emit->emit, bb));
+
+    // each block is written out in one go
+    flush_buffer(emit, io);
 }
 
 /// defines
 
 static void define_record(c89_emit_t *emit, const char *aggregate, io_t *io, const ssa_type_t *type)
 {
+    strbuf_t *buf = &emit->buffer;
     const ssa_type_record_t record = type->record;
-    io_printf(io, "%s %s {\n", aggregate, type->name);
+    strbuf_printf(buf, "%s %s {\n", aggregate, type->name);
     size_t len = typevec_len(record.fields);
     for (size_t i = 0; i < len; i++)
     {
         const ssa_field_t *field = typevec_offset(record.fields, i);
-        io_printf(io, "\t%s;\n", format_symbol(emit, field->type, field->name));
+        strbuf_append_char(buf, '\t');
+        append_symbol(emit, buf, field->type, field->name);
+        strbuf_append(buf, ";\n");
     }
-    io_printf(io, "};\n");
+    strbuf_append(buf, "};\n");
+
+    flush_buffer(emit, io);
 }
 
 void c89_define_type(c89_emit_t *emit, io_t *io, const ssa_type_t *type)
@@ -959,18 +1115,20 @@ void c89_define_type(c89_emit_t *emit, io_t *io, const ssa_type_t *type)
     }
 }
 
-static void write_init(c89_emit_t *emit, io_t *io, const ssa_value_t *value)
+static void write_init(c89_emit_t *emit, strbuf_t *buf, const ssa_value_t *value)
 {
     const ssa_type_t *type = value->type;
-    const char *init = c89_format_value(emit, value);
 
     if (type->kind == eTypePointer)
     {
-        io_printf(io, " = %s", init);
+        strbuf_append(buf, " = ");
+        append_value(emit, buf, value);
     }
     else
     {
-       io_printf(io, " = { %s }", init);
+        strbuf_append(buf, " = { ");
+        append_value(emit, buf, value);
+        strbuf_append(buf, " }");
     }
 }
 
@@ -981,13 +1139,14 @@ void c89_define_global(c89_emit_t *emit, const ssa_module_t *mod, const ssa_symb
     if (symbol->linkage != eLinkImport)
     {
         const ssa_value_t *value = symbol->value;
-        write_global(emit, src, symbol);
+        write_global(emit, &emit->buffer, symbol);
         if (value->init)
         {
-            write_init(emit, src, value);
+            write_init(emit, &emit->buffer, value);
         }
 
-        io_printf(src, ";\n");
+        strbuf_append(&emit->buffer, ";\n");
+        flush_buffer(emit, src);
     }
 }
 
@@ -996,7 +1155,7 @@ static bool is_type_pointer(const ssa_type_t *type)
     return type->kind == eTypePointer || type->kind == eTypeOpaque || type->kind == eTypeClosure;
 }
 
-static void write_locals(c89_emit_t *emit, io_t *io, typevec_t *locals)
+static void write_locals(c89_emit_t *emit, strbuf_t *buf, typevec_t *locals)
 {
     size_t len = typevec_len(locals);
     for (size_t i = 0; i < len; i++)
@@ -1011,39 +1170,31 @@ static void write_locals(c89_emit_t *emit, io_t *io, typevec_t *locals)
         if (!is_type_pointer(storage.type))
             flags = eFormatEmitNone;
 
-        io_printf(io, "\t%s;\n",
-            c89_format_storage(emit, local->storage, name, flags)
-        );
+        strbuf_append_char(buf, '\t');
+        c89_append_storage(emit, buf, local->storage, name, flags);
+        strbuf_append(buf, ";\n");
     }
 }
 
 void c89_define_function(c89_emit_t *emit, const ssa_module_t *mod, const ssa_symbol_t *symbol)
 {
     io_t *src = c89_get_source_io(emit, mod);
-
-    const ssa_type_t *type = symbol->type;
-    CTASSERTF(type->kind == eTypeClosure, "expected closure type on %s, got %d", symbol->name, type->kind);
-
-    ssa_type_closure_t closure = type->closure;
-    const char *params = c89_format_params(emit, closure.params, closure.variadic);
-
-    // TODO: handle -Werror=main when the entry point doesnt return int
-    const char *result = format_symbol(emit, closure.result, mangle_symbol_name(emit, symbol));
-
-    const char *link = format_c89_link(symbol->linkage);
+    strbuf_t *buf = &emit->buffer;
 
     if (symbol->linkage != eLinkImport)
     {
-        io_printf(src, "%s%s(%s) {\n", link, result, params);
-        write_locals(emit, src, symbol->locals);
-        io_printf(src, "\tgoto bb%s;\n", get_block_name(&emit->emit, symbol->entry));
+        write_signature(emit, buf, symbol);
+        strbuf_append(buf, " {\n");
+        write_locals(emit, buf, symbol->locals);
+        strbuf_printf(buf, "\tgoto bb%s;\n", get_block_name(&emit->emit, symbol->entry));
         size_t len = vector_len(symbol->blocks);
         for (size_t i = 0; i < len; i++)
         {
             const ssa_block_t *bb = vector_get(symbol->blocks, i);
             c89_write_block(emit, src, bb);
         }
-        io_printf(src, "}\n");
+        strbuf_append(buf, "}\n");
+        flush_buffer(emit, src);
 
         map_reset(emit->stepmap);
         counter_reset(&emit->emit);
@@ -1166,6 +1317,8 @@ emit_result_t cfamily_ssa(target_runtime_t *runtime, const ssa_result_t *ssa, ta
         .layout = emit->layout,
     };
 
+    strbuf_init(&ctx.buffer, 0x1000, arena);
+
     if (emit->layout == eFileLayoutPair)
     {
         c89_begin_all(&ctx);
@@ -1199,6 +1352,12 @@ emit_result_t cfamily_ssa(target_runtime_t *runtime, const ssa_result_t *ssa, ta
             const ssa_module_t *mod = vector_get(modules, i);
             c89_define_module(&ctx, mod);
         }
+
+        for (size_t i = 0; i < len; i++)
+        {
+            const ssa_module_t *mod = vector_get(modules, i);
+            c89_end_module(&ctx, mod);
+        }
     }
 
     emit_result_t result = {
@@ -7,6 +7,7 @@
 #include "std/map.h"
 #include "std/vector.h"
 #include "std/str.h"
+#include "std/strbuf.h"
 
 #include "std/typed/vector.h"
 
@@ -48,98 +49,177 @@ static const char *get_c89_digit(ssa_type_digit_t ty)
 // TODO: we should emit east const types rather than west const
 // its more consistent and should make codegen easier
 
-static const char *get_quals(tree_quals_t quals, type_format_t fmt, arena_t *arena)
+static const char *get_quals(tree_quals_t quals, type_format_t fmt)
 {
     if (fmt & eFormatIsConst) { return "const "; }
     if (quals & eQualConst) { return (fmt & eFormatEmitConst) ? "const " : ""; }
 
-    vector_t *vec = vector_new(3, arena);
-    if (quals & eQualAtomic) { vector_push(&vec, "_Atomic"); }
-    if (quals & eQualVolatile) { vector_push(&vec, "volatile"); }
+    bool is_atomic = quals & eQualAtomic;
+    bool is_volatile = quals & eQualVolatile;
 
-    return str_join(" ", vec, arena);
+    if (is_atomic && is_volatile) { return "_Atomic volatile"; }
+    if (is_atomic) { return "_Atomic"; }
+    if (is_volatile) { return "volatile"; }
+
+    return "";
 }
 
-static const char *format_c89_closure(c89_emit_t *emit, const char *quals, ssa_type_closure_t type, const char *name)
+// the part of a declaration that wraps the name
+// pointers are applied from the outside in, so `int *x[4]` is
+// { .pointers = 1, .name = "x", .array = true, .size = 4 }
+typedef struct c89_declarator_t
 {
-    const char *result = c89_format_type(emit, type.result, NULL, eFormatEmitConst);
-    const char *params = c89_format_params(emit, type.params, type.variadic);
+    size_t pointers;
+    const char *name;
+
+    bool array;
+    size_t size;
+} c89_declarator_t;
+
+static bool has_declarator(const c89_declarator_t *decl)
+{
+    return decl->pointers > 0 || decl->name != NULL;
+}
+
+static void append_declarator(strbuf_t *buf, const c89_declarator_t *decl)
+{
+    for (size_t i = 0; i < decl->pointers; i++)
+        strbuf_append_char(buf, '*');
+
+    if (decl->name != NULL)
+        strbuf_append(buf, decl->name);
+
+    if (decl->array)
+        strbuf_printf(buf, "[%zu]", decl->size);
+}
+
+// append `type` followed by a space and the declarator if there is one
+static void append_named(strbuf_t *buf, const char *quals, const char *type, const c89_declarator_t *decl)
+{
+    strbuf_append(buf, quals);
+    strbuf_append(buf, type);
+
+    if (has_declarator(decl))
+    {
+        strbuf_append_char(buf, ' ');
+        append_declarator(buf, decl);
+    }
+}
+
+static void append_type(c89_emit_t *emit, strbuf_t *buf, const ssa_type_t *type, const c89_declarator_t *decl, type_format_t flags);
 
-    return (name == NULL)
-        ? str_format(emit->arena, "%s (*%s)(%s)", result, quals, params)
-        : str_format(emit->arena, "%s (*%s%s)(%s)", result, quals, name, params);
+static void append_c89_closure(c89_emit_t *emit, strbuf_t *buf, const char *quals, ssa_type_closure_t type, const c89_declarator_t *decl)
+{
+    c89_declarator_t none = { 0 };
+    append_type(emit, buf, type.result, &none, eFormatEmitConst);
+
+    strbuf_append(buf, " (*");
+    strbuf_append(buf, quals);
+    append_declarator(buf, decl);
+    strbuf_append(buf, ")(");
+    c89_append_params(emit, buf, type.params, type.variadic);
+    strbuf_append_char(buf, ')');
 }
 
-static const char *format_c89_pointer(c89_emit_t *emit, ssa_type_pointer_t pointer, const char *name)
+static void append_c89_pointer(c89_emit_t *emit, strbuf_t *buf, ssa_type_pointer_t pointer, const c89_declarator_t *decl)
 {
-    const char *tmp = (name == NULL) ? "*" : str_format(emit->arena, "*%s", name);
+    c89_declarator_t inner = *decl;
+    inner.pointers += 1;
 
-    return c89_format_type(emit, pointer.pointer, tmp, eFormatEmitConst);
+    append_type(emit, buf, pointer.pointer, &inner, eFormatEmitConst);
 }
 
-static const char *format_c89_enum(c89_emit_t *emit, const ssa_type_t *type, const char *name, const char *quals)
+static void append_c89_enum(strbuf_t *buf, const ssa_type_t *type, const c89_declarator_t *decl, const char *quals)
 {
-    const char *padding = ctu_strlen(quals) > 0 ? " " : "";
-    return (name != NULL)
-        // TODO: this is a hack for abi stability
-        // update define_enum when this is updated
-        ? str_format(emit->arena, "%s%s%s_underlying_t %s", quals, padding, type->name, name)
-        : str_format(emit->arena, "%s%s%s_underlying_t",    quals, padding, type->name);
+    // TODO: this is a hack for abi stability
+    // update define_enum when this is updated
+    strbuf_append(buf, quals);
+    if (ctu_strlen(quals) > 0)
+        strbuf_append_char(buf, ' ');
+
+    strbuf_printf(buf, "%s_underlying_t", type->name);
+
+    if (has_declarator(decl))
+    {
+        strbuf_append_char(buf, ' ');
+        append_declarator(buf, decl);
+    }
 }
 
-static const char *format_c89_struct(c89_emit_t *emit, const ssa_type_t *type, const char *name, const char *quals)
+static void append_c89_struct(strbuf_t *buf, const ssa_type_t *type, const c89_declarator_t *decl, const char *quals)
 {
-    return (name != NULL)
-        ? str_format(emit->arena, "%sstruct %s %s", quals, type->name, name)
-        : str_format(emit->arena, "%sstruct %s", quals, type->name);
+    strbuf_append(buf, quals);
+    strbuf_printf(buf, "struct %s", type->name);
+
+    if (has_declarator(decl))
+    {
+        strbuf_append_char(buf, ' ');
+        append_declarator(buf, decl);
+    }
 }
 
-const char *c89_format_type(c89_emit_t *emit, const ssa_type_t *type, const char *name, type_format_t flags)
+static void append_type(c89_emit_t *emit, strbuf_t *buf, const ssa_type_t *type, const c89_declarator_t *decl, type_format_t flags)
 {
     CTASSERT(type != NULL);
 
-    const char *quals = get_quals(type->quals, flags, emit->arena);
+    const char *quals = get_quals(type->quals, flags);
 
     switch (type->kind)
     {
-    case eTypeUnit: return (name != NULL)
-        ? str_format(emit->arena, "void %s", name)
-        : "void";
-
-    case eTypeBool: return (name != NULL)
-        ? str_format(emit->arena, "%sbool %s", quals, name)
-        : str_format(emit->arena, "%sbool", quals);
-
-    case eTypeDigit: {
-        const char *digit_name = get_c89_digit(type->digit);
-        return (name != NULL)
-            ? str_format(emit->arena, "%s%s %s", quals, digit_name, name)
-            : str_format(emit->arena, "%s%s", quals, digit_name);
-    }
+    case eTypeUnit:
+        append_named(buf, "", "void", decl);
+        break;
 
-    case eTypeOpaque: return (name != NULL)
-        ? str_format(emit->arena, "%svoid *%s", quals, name)
-        : str_format(emit->arena, "%svoid *", quals);
+    case eTypeBool:
+        append_named(buf, quals, "bool", decl);
+        break;
 
-    case eTypeClosure: return format_c89_closure(emit, quals, type->closure, name);
-    case eTypePointer: return format_c89_pointer(emit, type->pointer, name);
+    case eTypeDigit:
+        append_named(buf, quals, get_c89_digit(type->digit), decl);
+        break;
 
-    case eTypeEnum: return format_c89_enum(emit, type, name, quals);
+    case eTypeOpaque:
+        strbuf_append(buf, quals);
+        strbuf_append(buf, "void *");
+        append_declarator(buf, decl);
+        break;
 
-    case eTypeStruct: return format_c89_struct(emit, type, name, quals);
+    case eTypeClosure:
+        append_c89_closure(emit, buf, quals, type->closure, decl);
+        break;
+
+    case eTypePointer:
+        append_c89_pointer(emit, buf, type->pointer, decl);
+        break;
+
+    case eTypeEnum:
+        append_c89_enum(buf, type, decl, quals);
+        break;
+
+    case eTypeStruct:
+        append_c89_struct(buf, type, decl, quals);
+        break;
 
     case eTypeEmpty: CT_NEVER("cannot emit empty type `%s`", type->name);
     default: CT_NEVER("unknown type %s", type_to_string(type, emit->arena));
     }
 }
 
-const char *c89_format_storage(c89_emit_t *emit, ssa_storage_t storage, const char *name, type_format_t flags)
+void c89_append_type(c89_emit_t *emit, strbuf_t *buf, const ssa_type_t *type, const char *name, type_format_t flags)
+{
+    c89_declarator_t decl = { .name = name };
+    append_type(emit, buf, type, &decl, flags);
+}
+
+void c89_append_storage(c89_emit_t *emit, strbuf_t *buf, ssa_storage_t storage, const char *name, type_format_t flags)
 {
-    char *it = str_format(emit->arena, "%s[%zu]", name, storage.size);
-    return c89_format_type(emit, storage.type, it, flags);
+    CTASSERT(name != NULL);
+
+    c89_declarator_t decl = { .name = name, .array = true, .size = storage.size };
+    append_type(emit, buf, storage.type, &decl, flags);
 }
 
-const char *c89_format_params(c89_emit_t *emit, typevec_t *params, bool variadic)
+void c89_append_params(c89_emit_t *emit, strbuf_t *buf, typevec_t *params, bool variadic)
 {
     CTASSERT(emit != NULL);
     CTASSERT(params != NULL);
@@ -147,17 +227,17 @@ const char *c89_format_params(c89_emit_t *emit, typevec_t *params, bool variadic
     size_t len = typevec_len(params);
     if (len == 0)
     {
-        return variadic ? "" : "void";
+        if (!variadic) strbuf_append(buf, "void");
+        return;
     }
 
-    vector_t *args = vector_of(len, emit->arena);
     for (size_t i = 0; i < len; i++)
     {
         const ssa_param_t *param = typevec_offset(params, i);
-        const char *it = c89_format_type(emit, param->type, param->name, eFormatEmitConst);
-        vector_set(args, i, (char*)it);
+        if (i > 0) strbuf_append(buf, ", ");
+
+        c89_append_type(emit, buf, param->type, param->name, eFormatEmitConst);
     }
 
-    char *all = str_join(", ", args, emit->arena);
-    return variadic ? str_format(emit->arena, "%s, ...", all) : all;
+    if (variadic) strbuf_append(buf, ", ...");
 }
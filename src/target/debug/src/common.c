@@ -3,8 +3,10 @@
 #include "common.h"
 
 #include "std/str.h"
+#include "std/strbuf.h"
 #include "std/map.h"
 #include "std/vector.h"
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 
 #include "fs/fs.h"
@@ -80,90 +82,87 @@ char *get_block_name(emit_t *emit, const ssa_block_t *block)
 
 char *get_step_from_block(emit_t *emit, const ssa_block_t *block, size_t index)
 {
-    ssa_step_t *step = typevec_offset(block->steps, index);
+    ssa_step_t *step = segvec_offset(block->steps, index);
     return get_step_name(emit, step);
 }
 
-static char *digit_to_string(ssa_type_digit_t digit, arena_t *arena)
+static void append_digit(strbuf_t *buf, ssa_type_digit_t digit)
 {
-    return str_format(arena, "digit(%s.%s)", sign_name(digit.sign), digit_name(digit.digit));
+    strbuf_printf(buf, "digit(%s.%s)", sign_name(digit.sign), digit_name(digit.digit));
 }
 
-static char *params_to_string(typevec_t *params, arena_t *arena)
+static void append_closure(strbuf_t *buf, ssa_type_closure_t closure)
 {
-    size_t len = typevec_len(params);
-    vector_t *vec = vector_of(len, arena);
-    for (size_t i = 0; i < len; i++)
-    {
-        const ssa_param_t *param = typevec_offset(params, i);
-        const char *ty = type_to_string(param->type, arena);
-        vector_set(vec, i, str_format(arena, "%s: %s", param->name, ty));
-    }
-
-    return str_join(", ", vec, arena);
+    strbuf_append(buf, "closure(result: ");
+    append_type(buf, closure.result);
+    strbuf_append(buf, ", params: [");
+    append_params(buf, closure.params);
+    strbuf_printf(buf, "], variadic: %s)", closure.variadic ? "true" : "false");
 }
 
-static char *closure_to_string(ssa_type_closure_t closure, arena_t *arena)
+static void append_pointer(strbuf_t *buf, ssa_type_pointer_t pointer)
 {
-    const char *result = type_to_string(closure.result, arena);
-    char *params = params_to_string(closure.params, arena);
+    strbuf_append(buf, (pointer.length == SIZE_MAX) ? "unbounded-ptr(" : "ptr(");
 
-    return str_format(arena, "closure(result: %s, params: [%s], variadic: %s)", result, params, closure.variadic ? "true" : "false");
-}
+    append_type(buf, pointer.pointer);
 
-static char *pointer_to_string(ssa_type_pointer_t pointer, arena_t *arena)
-{
-    const char *pointee = type_to_string(pointer.pointer, arena);
-    switch (pointer.length)
-    {
-    case 0: return str_format(arena, "ptr(%s)", pointee);
-    case SIZE_MAX: return str_format(arena, "unbounded-ptr(%s)", pointee);
-    default: return str_format(arena, "ptr(%s of %zu)", pointee, pointer.length);
-    }
+    if (pointer.length != 0 && pointer.length != SIZE_MAX)
+        strbuf_printf(buf, " of %zu", pointer.length);
+
+    strbuf_append_char(buf, ')');
 }
 
-static char *record_to_string(ssa_type_record_t record, arena_t *arena)
+static void append_record(strbuf_t *buf, ssa_type_record_t record)
 {
+    strbuf_append(buf, "record(fields: [");
     size_t len = typevec_len(record.fields);
-    vector_t *fields = vector_of(len, arena);
     for (size_t i = 0; i < len; i++)
     {
         const ssa_field_t *field = typevec_offset(record.fields, i);
-        vector_set(fields, i, (char*)field->name);
+        if (i > 0) strbuf_append(buf, ", ");
+        strbuf_append(buf, field->name);
     }
-
-    char *joined = str_join(", ", fields, arena);
-    return str_format(arena, "record(fields: [%s])", joined);
+    strbuf_append(buf, "])");
 }
 
-static char *enum_to_string(ssa_type_enum_t sum, arena_t *arena)
+static void append_enum(strbuf_t *buf, ssa_type_enum_t sum)
 {
+    strbuf_append(buf, "enum(variants: [");
     size_t len = typevec_len(sum.cases);
-    vector_t *variants = vector_of(len, arena);
     for (size_t i = 0; i < len; i++)
     {
         const ssa_case_t *field = typevec_offset(sum.cases, i);
-        char *segment = str_format(arena, "%s: %s", field->name, mpz_get_str(NULL, 10, field->value));
-        vector_set(variants, i, segment);
+        if (i > 0) strbuf_append(buf, ", ");
+        strbuf_printf(buf, "%s: %s", field->name, mpz_get_str(NULL, 10, field->value));
     }
+    strbuf_append(buf, "])");
+}
 
-    char *joined = str_join(", ", variants, arena);
-    return str_format(arena, "enum(variants: [%s])", joined);
+void append_params(strbuf_t *buf, typevec_t *params)
+{
+    size_t len = typevec_len(params);
+    for (size_t i = 0; i < len; i++)
+    {
+        const ssa_param_t *param = typevec_offset(params, i);
+        if (i > 0) strbuf_append(buf, ", ");
+        strbuf_printf(buf, "%s: ", param->name);
+        append_type(buf, param->type);
+    }
 }
 
-const char *type_to_string(const ssa_type_t *type, arena_t *arena)
+void append_type(strbuf_t *buf, const ssa_type_t *type)
 {
     switch (type->kind)
     {
-    case eTypeEmpty: return "empty";
-    case eTypeUnit: return "unit";
-    case eTypeBool: return "bool";
-    case eTypeOpaque: return "opaque";
-    case eTypeEnum: return enum_to_string(type->sum, arena);
-    case eTypeDigit: return digit_to_string(type->digit, arena);
-    case eTypeClosure: return closure_to_string(type->closure, arena);
-    case eTypePointer: return pointer_to_string(type->pointer, arena);
-    case eTypeStruct: return record_to_string(type->record, arena);
+    case eTypeEmpty: strbuf_append(buf, "empty"); break;
+    case eTypeUnit: strbuf_append(buf, "unit"); break;
+    case eTypeBool: strbuf_append(buf, "bool"); break;
+    case eTypeOpaque: strbuf_append(buf, "opaque"); break;
+    case eTypeEnum: append_enum(buf, type->sum); break;
+    case eTypeDigit: append_digit(buf, type->digit); break;
+    case eTypeClosure: append_closure(buf, type->closure); break;
+    case eTypePointer: append_pointer(buf, type->pointer); break;
+    case eTypeStruct: append_record(buf, type->record); break;
     default: CT_NEVER("unknown type kind %d", type->kind);
     }
 }
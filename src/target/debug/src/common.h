@@ -5,6 +5,7 @@
 #include "cthulhu/ssa/ssa.h"
 
 typedef struct fs_t fs_t;
+typedef struct strbuf_t strbuf_t;
 
 typedef struct names_t
 {
@@ -33,4 +34,5 @@ char *get_step_name(emit_t *emit, const ssa_step_t *step);
 char *get_block_name(emit_t *emit, const ssa_block_t *block);
 char *get_step_from_block(emit_t *emit, const ssa_block_t *block, size_t index);
 
-const char *type_to_string(const ssa_type_t *type, arena_t *arena);
+void append_type(strbuf_t *buf, const ssa_type_t *type);
+void append_params(strbuf_t *buf, typevec_t *params);
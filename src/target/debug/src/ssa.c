@@ -16,6 +16,8 @@
 #include "std/map.h"
 #include "std/set.h"
 #include "std/str.h"
+#include "std/strbuf.h"
+#include "std/typed/segvec.h"
 #include "std/typed/vector.h"
 #include "std/vector.h"
 
@@ -25,322 +27,350 @@ typedef struct ssa_emit_t
 
     fs_t *fs;
     map_t *deps;
-} ssa_emit_t;
-
-static char *fn_params_to_string(typevec_t *params, arena_t *arena)
-{
-    size_t len = typevec_len(params);
-    vector_t *vec = vector_of(len, arena);
-    for (size_t i = 0; i < len; i++)
-    {
-        const ssa_param_t *param = typevec_offset(params, i);
-        const char *ty = type_to_string(param->type, arena);
-        vector_set(vec, i, str_format(arena, "%s: %s", param->name, ty));
-    }
 
-    return str_join(", ", vec, arena);
-}
+    // the output is built here before being written
+    strbuf_t buffer;
+} ssa_emit_t;
 
-static vector_t *join_attribs(const ssa_symbol_t *symbol, arena_t *arena)
+static void emit_ssa_attribs(strbuf_t *buf, const ssa_symbol_t *symbol)
 {
-    vector_t *attribs = vector_new(2, arena);
+    strbuf_append(buf, "\t[");
 
     if (symbol->linkage_string != NULL)
     {
-        vector_push(&attribs, str_format(arena, "extern = `%s`", symbol->linkage_string));
+        strbuf_printf(buf, "extern = `%s`, ", symbol->linkage_string);
     }
 
-    vector_push(&attribs, str_format(arena, "linkage = %s", linkage_string(symbol->linkage)));
-    vector_push(&attribs, str_format(arena, "visibility = %s", visibility_string(symbol->visibility)));
-
-    return attribs;
+    strbuf_printf(buf, "linkage = %s, visibility = %s]\n",
+        linkage_string(symbol->linkage),
+        visibility_string(symbol->visibility)
+    );
 }
 
-static void emit_ssa_attribs(io_t *io, const ssa_symbol_t *symbol, arena_t *arena)
-{
-    io_printf(io, "\t[%s]\n", str_join(", ", join_attribs(symbol, arena), arena));
-}
+static void append_value(strbuf_t *buf, const ssa_value_t *value);
 
-static const char *value_to_string(const ssa_value_t *value, arena_t *arena);
-
-static const char *pointer_value_to_string(const ssa_value_t *value, arena_t *arena)
+static void append_pointer_value(strbuf_t *buf, const ssa_value_t *value)
 {
     ssa_literal_value_t literal = ssa_value_get_literal(value);
     size_t len = vector_len(literal.data);
-    vector_t *parts = vector_new(16, arena);
+
+    strbuf_append_char(buf, '[');
     for (size_t i = 0; i < CT_MIN(len, 16); i++)
     {
+        if (i > 0) strbuf_append(buf, ", ");
+
         const ssa_value_t *elem = vector_get(literal.data, i);
-        const char *it = value_to_string(elem, arena);
-        vector_push(&parts, (char*)it);
+        append_value(buf, elem);
     }
 
-    if (len > 16) { vector_push(&parts, "..."); }
+    if (len > 16) { strbuf_append(buf, ", ..."); }
 
-    char *joined = str_join(", ", parts, arena);
-    return str_format(arena, "[%s]", joined);
+    strbuf_append_char(buf, ']');
 }
 
-static const char *value_to_string(const ssa_value_t *value, arena_t *arena)
+static void append_value(strbuf_t *buf, const ssa_value_t *value)
 {
-    if (!value->init) { return "noinit"; }
+    if (!value->init)
+    {
+        strbuf_append(buf, "noinit");
+        return;
+    }
 
     const ssa_type_t *type = value->type;
     switch (type->kind)
     {
-    case eTypeDigit: return mpz_get_str(NULL, 10, ssa_value_get_literal(value).digit);
-    case eTypeBool: return ssa_value_get_bool(value) ? "true" : "false";
-    case eTypeUnit: return "unit";
-    case eTypeEmpty: return "empty";
-    case eTypePointer: return pointer_value_to_string(value, arena);
+    case eTypeDigit: strbuf_append(buf, mpz_get_str(NULL, 10, ssa_value_get_literal(value).digit)); break;
+    case eTypeBool: strbuf_append(buf, ssa_value_get_bool(value) ? "true" : "false"); break;
+    case eTypeUnit: strbuf_append(buf, "unit"); break;
+    case eTypeEmpty: strbuf_append(buf, "empty"); break;
+    case eTypePointer: append_pointer_value(buf, value); break;
 
     default: CT_NEVER("unknown type kind %d", type->kind);
     }
 }
 
-static const char *operand_to_string(ssa_emit_t *emit, ssa_operand_t operand)
+static void append_operand(ssa_emit_t *emit, strbuf_t *buf, ssa_operand_t operand)
 {
-    emit_t *base = &emit->emit;
-    arena_t *arena = base->arena;
     switch (operand.kind)
     {
-    case eOperandEmpty: return "empty";
+    case eOperandEmpty:
+        strbuf_append(buf, "empty");
+        break;
     case eOperandBlock:
-        return str_format(arena, ".%s", get_block_name(&emit->emit, operand.bb));
+        strbuf_printf(buf, ".%s", get_block_name(&emit->emit, operand.bb));
+        break;
     case eOperandImm:
-        return str_format(arena, "$%s", value_to_string(operand.value, arena));
+        strbuf_append_char(buf, '$');
+        append_value(buf, operand.value);
+        break;
     case eOperandReg:
-        return str_format(arena, "%%%s", get_step_from_block(&emit->emit, operand.vreg_context, operand.vreg_index));
+        strbuf_printf(buf, "%%%s", get_step_from_block(&emit->emit, operand.vreg_context, operand.vreg_index));
+        break;
     case eOperandGlobal: {
         const ssa_symbol_t *symbol = operand.global;
-        return str_format(arena, "@%s", symbol->name);
+        strbuf_printf(buf, "@%s", symbol->name);
+        break;
     }
     case eOperandFunction: {
         const ssa_symbol_t *symbol = operand.function;
-        return str_format(arena, "::%s", symbol->name);
-    }
-    case eOperandLocal: {
-        size_t index = operand.local;
-        return str_format(arena, "local(%zu)", index);
-    }
-    case eOperandParam: {
-        size_t index = operand.param;
-        return str_format(arena, "param(%zu)", index);
+        strbuf_printf(buf, "::%s", symbol->name);
+        break;
     }
+    case eOperandLocal:
+        strbuf_printf(buf, "local(%zu)", operand.local);
+        break;
+    case eOperandParam:
+        strbuf_printf(buf, "param(%zu)", operand.param);
+        break;
     default: CT_NEVER("unknown operand kind %d", operand.kind);
     }
 }
 
-static void emit_ssa_block(ssa_emit_t *emit, io_t *io, const ssa_block_t *bb)
+// append a space followed by each operand
+static void append_operands(ssa_emit_t *emit, strbuf_t *buf, const ssa_operand_t *operands, size_t len)
 {
-    emit_t *base = &emit->emit;
-    size_t len = typevec_len(bb->steps);
-    io_printf(io, ".%s: [len=%zu]\n", get_block_name(&emit->emit, bb), len);
     for (size_t i = 0; i < len; i++)
     {
-        const ssa_step_t *step = typevec_offset(bb->steps, i);
-        switch (step->opcode)
+        strbuf_append_char(buf, ' ');
+        append_operand(emit, buf, operands[i]);
+    }
+}
+
+// append `\t%name = ` for steps that produce a value
+static void append_result(ssa_emit_t *emit, strbuf_t *buf, const ssa_step_t *step)
+{
+    strbuf_printf(buf, "\t%%%s = ", get_step_name(&emit->emit, step));
+}
+
+static void emit_ssa_step(ssa_emit_t *emit, strbuf_t *buf, const ssa_step_t *step)
+{
+    switch (step->opcode)
+    {
+    case eOpValue:
+        append_result(emit, buf, step);
+        strbuf_append(buf, "const ");
+        append_value(buf, step->value);
+        break;
+    case eOpNop:
+        strbuf_append(buf, "\tnop");
+        break;
+    case eOpUnary: {
+        ssa_unary_t unary = step->unary;
+        append_result(emit, buf, step);
+        strbuf_printf(buf, "unary %s", unary_name(unary.unary));
+        append_operands(emit, buf, &unary.operand, 1);
+        break;
+    }
+    case eOpBinary: {
+        ssa_binary_t binary = step->binary;
+        ssa_operand_t operands[2] = { binary.lhs, binary.rhs };
+        append_result(emit, buf, step);
+        strbuf_printf(buf, "binary %s", binary_name(binary.binary));
+        append_operands(emit, buf, operands, 2);
+        break;
+    }
+    case eOpCast: {
+        ssa_cast_t cast = step->cast;
+        append_result(emit, buf, step);
+        strbuf_append(buf, "cast ");
+        append_type(buf, cast.type);
+        append_operands(emit, buf, &cast.operand, 1);
+        break;
+    }
+    case eOpLoad: {
+        ssa_load_t load = step->load;
+        append_result(emit, buf, step);
+        strbuf_append(buf, "load");
+        append_operands(emit, buf, &load.src, 1);
+        break;
+    }
+    case eOpOffset: {
+        ssa_offset_t offset = step->offset;
+        ssa_operand_t operands[2] = { offset.array, offset.offset };
+        append_result(emit, buf, step);
+        strbuf_append(buf, "offset");
+        append_operands(emit, buf, operands, 2);
+        break;
+    }
+    case eOpMember: {
+        ssa_member_t member = step->member;
+        append_result(emit, buf, step);
+        strbuf_append(buf, "member");
+        append_operands(emit, buf, &member.object, 1);
+        strbuf_printf(buf, ".%zu", member.index);
+        break;
+    }
+    case eOpAddress: {
+        ssa_addr_t addr = step->addr;
+        append_result(emit, buf, step);
+        strbuf_append(buf, "addr");
+        append_operands(emit, buf, &addr.symbol, 1);
+        break;
+    }
+    case eOpReturn: {
+        ssa_return_t ret = step->ret;
+        strbuf_append(buf, "\tret");
+        append_operands(emit, buf, &ret.value, 1);
+        break;
+    }
+    case eOpJump: {
+        ssa_jump_t jmp = step->jump;
+        strbuf_append(buf, "\tjump");
+        append_operands(emit, buf, &jmp.target, 1);
+        break;
+    }
+    case eOpStore: {
+        ssa_store_t store = step->store;
+        ssa_operand_t operands[2] = { store.dst, store.src };
+        strbuf_append(buf, "\tstore");
+        append_operands(emit, buf, operands, 2);
+        break;
+    }
+    case eOpCall: {
+        ssa_call_t call = step->call;
+        size_t args_len = typevec_len(call.args);
+        append_result(emit, buf, step);
+        strbuf_append(buf, "call");
+        append_operands(emit, buf, &call.function, 1);
+        strbuf_append(buf, " (");
+        for (size_t arg_idx = 0; arg_idx < args_len; arg_idx++)
         {
-        case eOpValue:
-            io_printf(io, "\t%%%s = const %s\n",
-                get_step_name(&emit->emit, step),
-                value_to_string(step->value, base->arena)
-            );
-            break;
-        case eOpNop:
-            io_printf(io, "\tnop\n");
-            break;
-        case eOpUnary: {
-            ssa_unary_t unary = step->unary;
-            io_printf(io, "\t%%%s = unary %s %s\n",
-                get_step_name(&emit->emit, step),
-                unary_name(unary.unary),
-                operand_to_string(emit, unary.operand)
-            );
-            break;
-        }
-        case eOpBinary: {
-            ssa_binary_t binary = step->binary;
-            io_printf(io, "\t%%%s = binary %s %s %s\n",
-                get_step_name(&emit->emit, step),
-                binary_name(binary.binary),
-                operand_to_string(emit, binary.lhs),
-                operand_to_string(emit, binary.rhs)
-            );
-            break;
-        }
-        case eOpCast: {
-            ssa_cast_t cast = step->cast;
-            io_printf(io, "\t%%%s = cast %s %s\n",
-                get_step_name(&emit->emit, step),
-                type_to_string(cast.type, base->arena),
-                operand_to_string(emit, cast.operand)
-            );
-            break;
-        }
-        case eOpLoad: {
-            ssa_load_t load = step->load;
-            io_printf(io, "\t%%%s = load %s\n",
-                get_step_name(&emit->emit, step),
-                operand_to_string(emit, load.src)
-            );
-            break;
-        }
-        case eOpOffset: {
-            ssa_offset_t offset = step->offset;
-            io_printf(io, "\t%%%s = offset %s %s\n",
-                get_step_name(&emit->emit, step),
-                operand_to_string(emit, offset.array),
-                operand_to_string(emit, offset.offset)
-            );
-            break;
-        }
-        case eOpMember: {
-            ssa_member_t member = step->member;
-            io_printf(io, "\t%%%s = member %s.%zu\n",
-                get_step_name(&emit->emit, step),
-                operand_to_string(emit, member.object),
-                member.index
-            );
-            break;
-        }
-        case eOpAddress: {
-            ssa_addr_t addr = step->addr;
-            io_printf(io, "\t%%%s = addr %s\n",
-                get_step_name(&emit->emit, step),
-                operand_to_string(emit, addr.symbol)
-            );
-            break;
-        }
-        case eOpReturn: {
-            ssa_return_t ret = step->ret;
-            io_printf(io, "\tret %s\n", operand_to_string(emit, ret.value));
-            break;
-        }
-        case eOpJump: {
-            ssa_jump_t jmp = step->jump;
-            io_printf(io, "\tjump %s\n", operand_to_string(emit, jmp.target));
-            break;
-        }
-        case eOpStore: {
-            ssa_store_t store = step->store;
-            io_printf(io, "\tstore %s %s\n",
-                operand_to_string(emit, store.dst),
-                operand_to_string(emit, store.src)
-            );
-            break;
-        }
-        case eOpCall: {
-            ssa_call_t call = step->call;
-            size_t args_len = typevec_len(call.args);
-            vector_t *args = vector_of(args_len, base->arena);
-            for (size_t arg_idx = 0; arg_idx < args_len; arg_idx++)
-            {
-                const ssa_operand_t *arg = typevec_offset(call.args, arg_idx);
-                vector_set(args, arg_idx, (char*)operand_to_string(emit, *arg));
-            }
-            io_printf(io, "\t%%%s = call %s (%s)\n",
-                get_step_name(&emit->emit, step),
-                operand_to_string(emit, call.function),
-                str_join(", ", args, base->arena)
-            );
-            break;
-        }
-        case eOpBranch: {
-            ssa_branch_t branch = step->branch;
-            io_printf(io, "\tbranch %s %s %s\n",
-                operand_to_string(emit, branch.cond),
-                operand_to_string(emit, branch.then),
-                operand_to_string(emit, branch.other)
-            );
-            break;
-        }
-        case eOpCompare: {
-            ssa_compare_t compare = step->compare;
-            io_printf(io, "\t%%%s = compare %s %s %s\n",
-                get_step_name(&emit->emit, step),
-                compare_name(compare.compare),
-                operand_to_string(emit, compare.lhs),
-                operand_to_string(emit, compare.rhs)
-            );
-            break;
-        }
-        case eOpSizeOf: {
-            ssa_sizeof_t size_of = step->size_of;
-            io_printf(io, "\t%%%s = sizeof %s\n",
-                get_step_name(&emit->emit, step),
-                type_to_string(size_of.type, base->arena)
-            );
-            break;
-        }
-        case eOpAlignOf: {
-            ssa_alignof_t align_of = step->align_of;
-            io_printf(io, "\t%%%s = alignof %s\n",
-                get_step_name(&emit->emit, step),
-                type_to_string(align_of.type, base->arena)
-            );
-            break;
-        }
-        case eOpOffsetOf: {
-            ssa_offsetof_t offset_of = step->offset_of;
-            io_printf(io, "\t%%%s = offsetof %s %zu\n",
-                get_step_name(&emit->emit, step),
-                type_to_string(offset_of.type, base->arena),
-                offset_of.index
-            );
-            break;
-        }
+            if (arg_idx > 0) strbuf_append(buf, ", ");
 
-        default:
-            CT_NEVER("unknown opcode %d", step->opcode);
+            const ssa_operand_t *arg = typevec_offset(call.args, arg_idx);
+            append_operand(emit, buf, *arg);
         }
+        strbuf_append_char(buf, ')');
+        break;
+    }
+    case eOpBranch: {
+        ssa_branch_t branch = step->branch;
+        ssa_operand_t operands[3] = { branch.cond, branch.then, branch.other };
+        strbuf_append(buf, "\tbranch");
+        append_operands(emit, buf, operands, 3);
+        break;
+    }
+    case eOpCompare: {
+        ssa_compare_t compare = step->compare;
+        ssa_operand_t operands[2] = { compare.lhs, compare.rhs };
+        append_result(emit, buf, step);
+        strbuf_printf(buf, "compare %s", compare_name(compare.compare));
+        append_operands(emit, buf, operands, 2);
+        break;
+    }
+    case eOpSizeOf: {
+        ssa_sizeof_t size_of = step->size_of;
+        append_result(emit, buf, step);
+        strbuf_append(buf, "sizeof ");
+        append_type(buf, size_of.type);
+        break;
+    }
+    case eOpAlignOf: {
+        ssa_alignof_t align_of = step->align_of;
+        append_result(emit, buf, step);
+        strbuf_append(buf, "alignof ");
+        append_type(buf, align_of.type);
+        break;
     }
+    case eOpOffsetOf: {
+        ssa_offsetof_t offset_of = step->offset_of;
+        append_result(emit, buf, step);
+        strbuf_append(buf, "offsetof ");
+        append_type(buf, offset_of.type);
+        strbuf_printf(buf, " %zu", offset_of.index);
+        break;
+    }
+
+    default:
+        CT_NEVER("unknown opcode %d", step->opcode);
+    }
+
+    strbuf_append_char(buf, '\n');
 }
 
-static void emit_ssa_blocks(ssa_emit_t *emit, io_t *io, vector_t *bbs)
+static void emit_ssa_block(ssa_emit_t *emit, strbuf_t *buf, const ssa_block_t *bb)
+{
+    size_t len = segvec_len(bb->steps);
+    strbuf_printf(buf, ".%s: [len=%zu]\n", get_block_name(&emit->emit, bb), len);
+    segvec_iter_t iter = segvec_iter(bb->steps);
+    while (segvec_has_next(&iter))
+    {
+        const ssa_step_t *step = segvec_next(&iter);
+        emit_ssa_step(emit, buf, step);
+    }
+}
+
+static void emit_ssa_blocks(ssa_emit_t *emit, strbuf_t *buf, vector_t *bbs)
 {
     size_t len = vector_len(bbs);
     for (size_t i = 0; i < len; i++)
     {
         const ssa_block_t *bb = vector_get(bbs, i);
-        emit_ssa_block(emit, io, bb);
+        emit_ssa_block(emit, buf, bb);
     }
 }
 
-static const char *storage_to_string(ssa_storage_t storage, arena_t *arena)
+static void append_storage(strbuf_t *buf, ssa_storage_t storage)
 {
-    const char *ty = type_to_string(storage.type, arena);
-    const char *quals = quals_string(storage.quals);
-
-    return str_format(arena, "{type = %s, quals = %s, size = %zu}", ty, quals, storage.size);
+    strbuf_append(buf, "{type = ");
+    append_type(buf, storage.type);
+    strbuf_printf(buf, ", quals = %s, size = %zu}", quals_string(storage.quals), storage.size);
 }
 
-static void emit_ssa_locals(ssa_emit_t *emit, io_t *io, typevec_t *locals)
+static void emit_ssa_locals(strbuf_t *buf, typevec_t *locals)
 {
-    emit_t *base = &emit->emit;
     size_t len = typevec_len(locals);
     for (size_t i = 0; i < len; i++)
     {
         const ssa_local_t *local = typevec_offset(locals, i);
-        io_printf(io, "\tlocal[%zu] %s %s\n", i, type_to_string(local->type, base->arena), storage_to_string(local->storage, base->arena));
+        strbuf_printf(buf, "\tlocal[%zu] ", i);
+        append_type(buf, local->type);
+        strbuf_append_char(buf, ' ');
+        append_storage(buf, local->storage);
+        strbuf_append_char(buf, '\n');
     }
 }
 
-static void emit_symbol_deps(io_t *io, const ssa_symbol_t *symbol, map_t *deps)
+static int symbol_name_cmp(const void *lhs, const void *rhs)
+{
+    const ssa_symbol_t *const *symbol_lhs = lhs;
+    const ssa_symbol_t *const *symbol_rhs = rhs;
+
+    const char *name_lhs = (*symbol_lhs)->name;
+    const char *name_rhs = (*symbol_rhs)->name;
+
+    if (name_lhs == NULL || name_rhs == NULL)
+        return (name_lhs != NULL) - (name_rhs != NULL);
+
+    return ctu_strcmp(name_lhs, name_rhs);
+}
+
+static void emit_symbol_deps(strbuf_t *buf, const ssa_symbol_t *symbol, map_t *deps, arena_t *arena)
 {
     set_t *all = map_get(deps, symbol);
     if (all != NULL)
     {
-        io_printf(io, "deps: (");
+        // the set is keyed by pointer, sort by name so the output is stable
+        typevec_t *sorted = typevec_new(sizeof(const ssa_symbol_t*), CT_MAX(set_count(all), 1), arena);
         set_iter_t iter = set_iter(all);
         while (set_has_next(&iter))
         {
             const ssa_symbol_t *dep = set_next(&iter);
-            io_printf(io, "%s", dep->name);
+            typevec_push(sorted, &dep);
+        }
+
+        typevec_sort(sorted, symbol_name_cmp);
+
+        strbuf_append(buf, "deps: (");
+        size_t len = typevec_len(sorted);
+        for (size_t i = 0; i < len; i++)
+        {
+            const ssa_symbol_t *const *dep = typevec_offset(sorted, i);
+            strbuf_printf(buf, "%s", (*dep)->name);
 
-            if (set_has_next(&iter)) { io_printf(io, ", "); }
+            if (i + 1 < len) { strbuf_append(buf, ", "); }
         }
-        io_printf(io, ")\n");
+        strbuf_append(buf, ")\n");
     }
 }
 
@@ -348,6 +378,7 @@ static void debug_emit_module(ssa_emit_t *emit, const ssa_module_t *mod)
 {
     fs_t *fs = emit->fs;
     emit_t *base = &emit->emit;
+    strbuf_t *buf = &emit->buffer;
     char *path = begin_module(&emit->emit, fs, mod);
 
     char *file = str_format(base->arena, "%s/%s.ssa", path, mod->name);
@@ -355,51 +386,62 @@ static void debug_emit_module(ssa_emit_t *emit, const ssa_module_t *mod)
     vector_push(&base->files, file);
 
     io_t *io = fs_open(fs, file, eOsAccessWrite | eOsAccessTruncate);
-    io_printf(io, "module {name=%s", mod->name);
-    if (ctu_strlen(path) > 0) { io_printf(io, ", path=%s", path); }
-    io_printf(io, "}\n");
+    strbuf_printf(buf, "module {name=%s", mod->name);
+    if (ctu_strlen(path) > 0) { strbuf_printf(buf, ", path=%s", path); }
+    strbuf_append(buf, "}\n");
 
-    io_printf(io, "\n");
+    strbuf_append(buf, "\n");
 
     size_t len = vector_len(mod->globals);
     for (size_t i = 0; i < len; i++)
     {
         const ssa_symbol_t *global = vector_get(mod->globals, i);
-        emit_symbol_deps(io, global, emit->deps);
+        emit_symbol_deps(buf, global, emit->deps, base->arena);
 
-        io_printf(io, "global %s: %s\n", global->name, type_to_string(global->type, base->arena));
-        emit_ssa_attribs(io, global, base->arena);
+        strbuf_printf(buf, "global %s: ", global->name);
+        append_type(buf, global->type);
+        strbuf_append_char(buf, '\n');
+        emit_ssa_attribs(buf, global);
 
-        emit_ssa_blocks(emit, io, global->blocks);
+        emit_ssa_blocks(emit, buf, global->blocks);
 
-        if (len >= i) { io_printf(io, "\n"); }
+        if (len >= i) { strbuf_append(buf, "\n"); }
     }
 
     size_t fns = vector_len(mod->functions);
     for (size_t i = 0; i < fns; i++)
     {
         const ssa_symbol_t *fn = vector_get(mod->functions, i);
-        emit_symbol_deps(io, fn, emit->deps);
+        emit_symbol_deps(buf, fn, emit->deps, base->arena);
 
         const ssa_type_t *type = fn->type;
         CTASSERTF(type->kind == eTypeClosure, "fn %s is not a closure", fn->name);
         ssa_type_closure_t closure = type->closure;
 
-        io_printf(io, "fn %s(%s) -> %s [variadic: %s]\n",
-            fn->name,
-            fn_params_to_string(closure.params, base->arena), type_to_string(closure.result, base->arena),
-            closure.variadic ? "true" : "false"
-        );
-        emit_ssa_attribs(io, fn, base->arena);
+        strbuf_printf(buf, "fn %s(", fn->name);
+        append_params(buf, closure.params);
+        strbuf_append(buf, ") -> ");
+        append_type(buf, closure.result);
+        strbuf_printf(buf, " [variadic: %s]\n", closure.variadic ? "true" : "false");
+        emit_ssa_attribs(buf, fn);
 
         if (fn->linkage != eLinkImport)
         {
-            emit_ssa_locals(emit, io, fn->locals);
-            emit_ssa_blocks(emit, io, fn->blocks);
+            emit_ssa_locals(buf, fn->locals);
+            emit_ssa_blocks(emit, buf, fn->blocks);
         }
 
-        if (len >= i) { io_printf(io, "\n"); }
+        if (len >= i) { strbuf_append(buf, "\n"); }
+
+        // write each function as it is finished so the buffer stays small
+        io_write_strbuf(io, buf);
+        strbuf_reset(buf);
     }
+
+    io_write_strbuf(io, buf);
+    strbuf_reset(buf);
+
+    io_close(io);
 }
 
 emit_result_t debug_ssa(target_runtime_t *runtime, const ssa_result_t *ssa, target_emit_t *target)
@@ -417,6 +459,8 @@ emit_result_t debug_ssa(target_runtime_t *runtime, const ssa_result_t *ssa, targ
         .deps = ssa->deps,
     };
 
+    strbuf_init(&emit.buffer, 0x1000, arena);
+
     size_t len = vector_len(ssa->modules);
     for (size_t i = 0; i < len; i++)
     {
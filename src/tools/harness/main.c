@@ -8,9 +8,12 @@
 #include "cthulhu/broker/broker.h"
 
 #include "arena/arena.h"
+#include "arena/region.h"
+#include "arena/shared.h"
 #include "io/console.h"
 #include "memory/memory.h"
 #include "notify/notify.h"
+#include "setup/memory.h"
 #include "format/notify.h"
 #include "scan/node.h"
 #include "support/loader.h"
@@ -24,6 +27,7 @@
 
 #include "std/map.h"
 #include "std/str.h"
+#include "std/typed/vector.h"
 #include "std/vector.h"
 
 #include "fs/fs.h"
@@ -34,7 +38,10 @@
 #include "support/support.h"
 
 #include <stddef.h>
-#include <stdlib.h> // for malloc, free, system
+#include <stdlib.h> // for system
+
+// the number of source files parsed at once
+#define HARNESS_JOBS 4
 
 #define CHECK_REPORTS(reports, msg)                         \
     do                                                      \
@@ -67,128 +74,6 @@ static io_t *make_file(const char *path, os_access_t flags, arena_t *arena)
     return io;
 }
 
-typedef struct user_ptr_t
-{
-    uint32_t size;
-    uint32_t pad0;
-    uint32_t pad1;
-    uint32_t pad2;
-
-    STA_FIELD_SIZE(size) char data[];
-} user_ptr_t;
-
-CT_STATIC_ASSERT(sizeof(user_ptr_t) == 16, "user_ptr_t must be 16 byte aligned");
-
-typedef struct user_arena_t
-{
-    char *memory_start;
-    char *memory_cursor;
-    char *memory_end;
-
-    size_t alloc_count;
-    size_t realloc_count;
-    size_t free_count;
-} user_arena_t;
-
-static user_ptr_t *get_memory(user_arena_t *arena, size_t size)
-{
-    size_t aligned = CT_ALIGN_POW2(size, 16);
-    size_t space = aligned + sizeof(user_ptr_t); // required space
-
-    CTASSERTF(arena->memory_cursor + space < arena->memory_end,
-              "out of memory (size: %zu)", size);
-
-    user_ptr_t *ptr = (user_ptr_t *)arena->memory_cursor;
-
-    // align the pointer itself
-    ptr = (user_ptr_t *)CT_ALIGN_POW2((uintptr_t)ptr, 16);
-    ptr->size = (uint32_t)size;
-    arena->memory_cursor = (char *)ptr + aligned + sizeof(user_ptr_t);
-
-    arena->alloc_count++;
-
-    return ptr;
-}
-
-static user_ptr_t *get_ptr(void *ptr)
-{
-    char *data = (char *)ptr;
-    return (user_ptr_t *)(data - sizeof(user_ptr_t));
-}
-
-static void *user_malloc(size_t size, void *user)
-{
-    user_arena_t *data = (user_arena_t *)user;
-
-    user_ptr_t *ptr = get_memory(data, size);
-    return ptr->data;
-}
-
-static void *user_realloc(void *ptr, size_t new_size, size_t old_size, void *user)
-{
-    CT_UNUSED(old_size);
-
-    user_arena_t *data = (user_arena_t *)user;
-
-    user_ptr_t *old = get_ptr(ptr);
-
-    if (old->size >= new_size) return old->data;
-
-    user_ptr_t *new = get_memory(data, new_size);
-    ctu_memcpy(new->data, old->data, old->size);
-
-    data->realloc_count++;
-
-    return new->data;
-}
-
-static void user_free(void *ptr, size_t size, void *user)
-{
-    CT_UNUSED(ptr);
-    CT_UNUSED(size);
-
-    user_arena_t *data = (user_arena_t *)user;
-
-    data->free_count++;
-}
-
-static user_arena_t new_user_arena(size_t size)
-{
-    char *memory = malloc(size);
-    CTASSERT(memory != NULL);
-
-    user_arena_t arena = {
-        .memory_start = memory,
-        .memory_cursor = memory,
-        .memory_end = memory + size,
-
-        .alloc_count = 0,
-        .realloc_count = 0,
-        .free_count = 0,
-    };
-
-    return arena;
-}
-
-typedef struct arena_user_wrap_t
-{
-    arena_t arena;
-    user_arena_t user;
-} arena_user_wrap_t;
-
-static arena_t new_alloc(user_arena_t *user)
-{
-    arena_t arena = {
-        .name = "user",
-        .fn_malloc = user_malloc,
-        .fn_realloc = user_realloc,
-        .fn_free = user_free,
-        .user = user,
-    };
-
-    return arena;
-}
-
 static int check_reports(logger_t *logger, report_config_t config, const char *title)
 {
     int err = text_report(logger_get_events(logger), config, title);
@@ -255,6 +140,7 @@ int run_test_harness(int argc, const char **argv, arena_t *arena)
 
     CTASSERTF(start < argc, "no files to parse");
 
+    typevec_t *inputs = typevec_new(sizeof(broker_source_t), argc - start, arena);
     for (int i = start; i < argc; i++)
     {
         const char *path = argv[i];
@@ -263,13 +149,17 @@ int run_test_harness(int argc, const char **argv, arena_t *arena)
         language_runtime_t *lang = support_get_lang(support, ext);
         CTASSERTF(lang != NULL, "no language for extension `%s`", ext);
 
-        io_t *io = make_file(path, eOsAccessRead, arena);
+        broker_source_t source = {
+            .lang = lang,
+            .io = make_file(path, eOsAccessRead, arena),
+        };
 
-        broker_parse(lang, io);
-
-        CHECK_LOG(logger, "parsing source");
+        typevec_push(inputs, &source);
     }
 
+    broker_parse_sources(broker, inputs, HARNESS_JOBS);
+    CHECK_LOG(logger, "parsing sources");
+
     for (size_t stage = 0; stage < ePassCount; stage++)
     {
         broker_run_pass(broker, stage);
@@ -281,6 +171,9 @@ int run_test_harness(int argc, const char **argv, arena_t *arena)
     broker_resolve(broker);
     CHECK_LOG(logger, "resolving symbols");
 
+    // the tree is complete, the ast is no longer needed
+    broker_release_ast(broker);
+
     vector_t *mods = broker_get_modules(broker);
 
     check_tree(logger, mods, arena);
@@ -396,17 +289,17 @@ int main(int argc, const char **argv)
 {
     setup_default(NULL);
 
-    size_t size = (size_t)(1024U * 1024U * 64U);
-    user_arena_t arena = new_user_arena(size);
-    arena_t user = new_alloc(&arena);
-    init_global_arena(&user);
-    init_gmp_arena(&user);
+    // sources are parsed on multiple threads, so the region is shared between them
+    arena_t *region = region_new("harness", CT_REGION_CHUNK_SIZE, ctu_default_alloc());
+    arena_t *arena = shared_new("harness", region);
+    init_global_arena(arena);
+    init_gmp_arena(arena);
 
     ctu_log_update(true);
 
-    int result = run_test_harness(argc, argv, &user);
+    int result = run_test_harness(argc, argv, arena);
 
-    free(arena.memory_start);
+    region_delete(region);
 
     return result;
 }
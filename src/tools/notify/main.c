@@ -190,6 +190,34 @@ static const diagnostic_t kReservedName = {
         "Reserved names are keywords and builtin names.\n"
 };
 
+// the offset of a line and column inside a source
+static ctu_offset_t offset_at(text_view_t source, size_t line, size_t column)
+{
+    size_t offset = 0;
+    while (line > 0 && offset < source.length)
+    {
+        if (source.text[offset++] == '\n')
+            line -= 1;
+    }
+
+    return (ctu_offset_t)(offset + column);
+}
+
+// the events below are easier to read as lines and columns than offsets
+static where_t where_at(const scan_t *scan, size_t first_line, size_t first_column, size_t last_line, size_t last_column)
+{
+    text_view_t source = scan_source(scan);
+    ctu_offset_t first = offset_at(source, first_line, first_column);
+    ctu_offset_t last = offset_at(source, last_line, last_column);
+
+    where_t where = {
+        .offset = first,
+        .length = last - first,
+    };
+
+    return where;
+}
+
 void event_simple(logger_t *logs, const node_t *builtin)
 {
     event_builder_t event = msg_notify(logs, &kInfoDiagnostic, builtin, "test");
@@ -198,30 +226,15 @@ void event_simple(logger_t *logs, const node_t *builtin)
 
 void event_missing_call(logger_t *logs, scan_t *scan_main, scan_t *scan_lhs, const node_t *builtin)
 {
-    where_t where = {
-        .first_line = 11,
-        .last_line = 11,
-        .first_column = 4,
-        .last_column = 4 + 8
-    };
+    where_t where = where_at(scan_main, 11, 4, 11, 4 + 8);
 
     node_t *node = node_new(scan_main, where);
 
-    where_t where2 = {
-        .first_line = 8,
-        .last_line = 8,
-        .first_column = 4,
-        .last_column = 4 + 8
-    };
+    where_t where2 = where_at(scan_lhs, 8, 4, 8, 4 + 8);
 
     node_t *node2 = node_new(scan_lhs, where2);
 
-    where_t where3 = {
-        .first_line = 12,
-        .last_line = 12,
-        .first_column = 8,
-        .last_column = 8 + 3
-    };
+    where_t where3 = where_at(scan_lhs, 12, 8, 12, 8 + 3);
 
     node_t *node3 = node_new(scan_lhs, where3);
 
@@ -237,21 +250,11 @@ void event_missing_call(logger_t *logs, scan_t *scan_main, scan_t *scan_lhs, con
 
 void event_invalid_import(logger_t *logs, scan_t *scan, scan_t *scan_rhs)
 {
-    where_t where = {
-        .first_line = 2,
-        .last_line = 2,
-        .first_column = 7,
-        .last_column = 7 + 9
-    };
+    where_t where = where_at(scan, 2, 7, 2, 7 + 9);
 
     node_t *node = node_new(scan, where);
 
-    where_t where2 = {
-        .first_line = 3,
-        .last_line = 3,
-        .first_column = 7,
-        .last_column = 7 + 9
-    };
+    where_t where2 = where_at(scan_rhs, 3, 7, 3, 7 + 9);
 
     node_t *node2 = node_new(scan_rhs, where2);
 
@@ -264,12 +267,7 @@ void event_invalid_import(logger_t *logs, scan_t *scan, scan_t *scan_rhs)
 
 void event_invalid_function(logger_t *logs, scan_t *scan)
 {
-    where_t where = {
-        .first_line = 8,
-        .last_line = 13,
-        .first_column = 0,
-        .last_column = 4
-    };
+    where_t where = where_at(scan, 8, 0, 13, 4);
 
     node_t *node = node_new(scan, where);
 
@@ -449,7 +447,7 @@ int main(int argc, const char **argv)
             .zero_indexed_lines = zero_indexed,
         };
 
-        const typevec_t *events = logger_get_events(logs);
+        const segvec_t *events = logger_get_events(logs);
         print_notify_many(notify_options, events);
     }
 
@@ -0,0 +1,171 @@
+// compares the flex and hand written ctu scanners.
+// the files passed on the command line are joined into one corpus that
+// each scanner lexes to the end once per round. flex is the baseline.
+
+#include "setup/memory.h"
+
+#include "arena/arena.h"
+#include "core/macros.h"
+#include "io/console.h"
+#include "io/io.h"
+#include "memory/memory.h"
+#include "notify/notify.h"
+#include "os/os.h"
+#include "scan/scan.h"
+#include "std/typed/vector.h"
+
+#include "cthulhu/broker/scan.h"
+
+#include "ctu/lex.h"
+
+#include "ctu_bison.h" // IWYU pragma: keep
+#include "ctu_flex.h" // IWYU pragma: keep
+
+#include <time.h>
+
+#define BENCH_ROUNDS 200
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static size_t bench_flex(scan_t *scan, const char *text, size_t size)
+{
+    yyscan_t scanner;
+    ctulex_init_extra(scan, &scanner);
+    YY_BUFFER_STATE buffer = ctu_scan_bytes(text, (int)size, scanner);
+
+    size_t tokens = 0;
+    CTUSTYPE value;
+    where_t where;
+    while (ctulex(&value, &where, scanner) != CTUEOF)
+        tokens += 1;
+
+    ctu_delete_buffer(buffer, scanner);
+    ctulex_destroy(scanner);
+
+    return tokens;
+}
+
+static size_t bench_hand(scan_t *scan, const char *text, size_t size)
+{
+    ctu_lexer_t lexer;
+    ctu_lexer_init(&lexer, scan, text, size);
+
+    size_t tokens = 0;
+    CTUSTYPE value;
+    where_t where;
+    while (ctu_lexer_next(&lexer, &value, &where) != CTUEOF)
+        tokens += 1;
+
+    return tokens;
+}
+
+typedef size_t (*bench_fn_t)(scan_t *scan, const char *text, size_t size);
+
+typedef struct bench_t
+{
+    const char *name;
+    bench_fn_t fn;
+} bench_t;
+
+static const bench_t kBenches[] = {
+    { "flex", bench_flex },
+    { "hand", bench_hand },
+};
+
+#define BENCHES_LEN (sizeof(kBenches) / sizeof(bench_t))
+
+static double run_bench(const bench_t *bench, scan_t *scan, const char *text, size_t size, size_t *tokens)
+{
+    double start = now_ms();
+    for (size_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        *tokens = bench->fn(scan, text, size);
+    }
+    return now_ms() - start;
+}
+
+int main(int argc, const char **argv)
+{
+    arena_t *arena = ctu_default_alloc();
+    io_t *con = io_stdout();
+
+    init_global_arena(arena);
+    init_gmp_arena(arena);
+
+    typevec_t *corpus = typevec_new(sizeof(char), 0x10000, arena);
+
+    for (int i = 1; i < argc; i++)
+    {
+        io_t *io = io_file(argv[i], eOsAccessRead, arena);
+        if (io_error(io) != eOsSuccess)
+        {
+            io_printf(con, "failed to open %s\n", argv[i]);
+            return 1;
+        }
+
+        size_t size = io_size(io);
+        if (size > 0)
+        {
+            const char *text = io_map(io, eOsProtectRead);
+            typevec_append(corpus, text, size);
+
+            // keep a token from running into the next file
+            char newline = '\n';
+            typevec_push(corpus, &newline);
+        }
+    }
+
+    size_t total = typevec_len(corpus);
+    if (total == 0)
+    {
+        io_printf(con, "usage: %s <source files...>\n", argv[0]);
+        return 1;
+    }
+
+    const char *text = typevec_data(corpus);
+
+    scan_context_t *ctx = ARENA_MALLOC(sizeof(scan_context_t), "bench context", NULL, arena);
+    ctx->logger = logger_new(arena);
+    ctx->arena = arena;
+    ctx->string_arena = arena;
+    ctx->ast_arena = arena;
+
+    io_t *source = io_memory("corpus", text, total, eOsAccessRead, arena);
+    scan_t *scan = scan_io("ctu", source, arena);
+    scan_set_context(scan, ctx);
+
+    io_printf(con, "%zu bytes, %d rounds\n", total, BENCH_ROUNDS);
+
+    double baseline = 0.0;
+    size_t expected = 0;
+
+    for (size_t i = 0; i < BENCHES_LEN; i++)
+    {
+        const bench_t *bench = &kBenches[i];
+
+        size_t tokens = 0;
+        double elapsed = run_bench(bench, scan, text, total, &tokens);
+        if (i == 0)
+        {
+            baseline = elapsed;
+            expected = tokens;
+        }
+
+        double mbps = ((double)total * BENCH_ROUNDS) / (elapsed * 1000.0);
+        io_printf(con, "%-6s %8.2f ms %8.1f MB/s %5.2fx %zu tokens\n",
+            bench->name, elapsed, mbps, baseline / elapsed, tokens);
+
+        if (tokens != expected)
+        {
+            io_printf(con, "%s produced %zu tokens, expected %zu\n", bench->name, tokens, expected);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+// compares text_hash against the multiply by 31 hash it replaced.
+// identifiers are collected from every file passed on the command line,
+// each hash is timed over the whole corpus and then checked for how
+// evenly it spreads the unique identifiers over a power of 2 table.
+
+#include "setup/memory.h"
+
+#include "arena/arena.h"
+#include "base/util.h"
+#include "core/macros.h"
+#include "io/console.h"
+#include "io/io.h"
+#include "os/os.h"
+#include "std/set.h"
+#include "std/typed/vector.h"
+
+#include <time.h>
+
+#define BENCH_ROUNDS 200
+
+typedef ctu_hash_t (*text_hash_fn_t)(text_view_t text);
+
+static ctu_hash_t legacy_hash(text_view_t text)
+{
+    ctu_hash_t hash = 0;
+    for (size_t i = 0; i < text.length; i++)
+    {
+        hash = (hash << 5) - hash + text.text[i];
+    }
+
+    return hash;
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static bool is_ident_start(char c)
+{
+    return ctu_isalpha(c) || c == '_';
+}
+
+static bool is_ident(char c)
+{
+    return is_ident_start(c) || ctu_isdigit(c);
+}
+
+static void collect_idents(typevec_t *idents, const char *text, size_t size)
+{
+    size_t i = 0;
+    while (i < size)
+    {
+        if (!is_ident_start(text[i]))
+        {
+            i += 1;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < size && is_ident(text[i]))
+            i += 1;
+
+        text_view_t view = text_view_make(text + start, i - start);
+        typevec_push(idents, &view);
+    }
+}
+
+static size_t get_table_size(size_t count)
+{
+    size_t size = 16;
+    while (size < count)
+        size *= 2;
+
+    return size;
+}
+
+static void bench_hash(io_t *io, const char *name, text_hash_fn_t fn, typevec_t *idents, set_t *unique, arena_t *arena)
+{
+    size_t len = typevec_len(idents);
+    text_view_t *data = typevec_offset(idents, 0);
+
+    // keep the results alive so the loop is not optimized away
+    ctu_hash_t sink = 0;
+
+    double start = now_ms();
+    for (size_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            sink += fn(data[i]);
+        }
+    }
+    double elapsed = now_ms() - start;
+
+    // count how many unique identifiers share a slot in the low bits
+    size_t count = set_count(unique);
+    size_t size = get_table_size(count);
+    size_t *slots = ARENA_MALLOC(sizeof(size_t) * size, "slots", NULL, arena);
+    ctu_memset(slots, 0, sizeof(size_t) * size);
+
+    size_t collisions = 0;
+    size_t worst = 0;
+    set_iter_t iter = set_iter(unique);
+    while (set_has_next(&iter))
+    {
+        const text_view_t *ident = set_next(&iter);
+        size_t *slot = &slots[fn(*ident) & (size - 1)];
+        if (*slot > 0) collisions += 1;
+
+        *slot += 1;
+        worst = CT_MAX(worst, *slot);
+    }
+
+    double ns = (elapsed * 1000000.0) / (double)(len * BENCH_ROUNDS);
+    io_printf(io, "%-12s %8.2f ms %6.2f ns/ident  %zu collisions in %zu slots, worst slot %zu (%zx)\n",
+        name, elapsed, ns, collisions, size, worst, sink);
+
+    arena_free(slots, sizeof(size_t) * size, arena);
+}
+
+int main(int argc, const char **argv)
+{
+    arena_t *arena = ctu_default_alloc();
+    io_t *con = io_stdout();
+
+    typevec_t *idents = typevec_new(sizeof(text_view_t), 4096, arena);
+    size_t total = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        io_t *io = io_file(argv[i], eOsAccessRead, arena);
+        if (io_error(io) != eOsSuccess)
+        {
+            io_printf(con, "failed to open %s\n", argv[i]);
+            return 1;
+        }
+
+        size_t size = io_size(io);
+        if (size > 0)
+        {
+            const char *text = io_map(io, eOsProtectRead);
+            collect_idents(idents, text, size);
+            total += size;
+        }
+    }
+
+    size_t len = typevec_len(idents);
+    if (len == 0)
+    {
+        io_printf(con, "usage: %s <source files...>\n", argv[0]);
+        return 1;
+    }
+
+    set_t *unique = set_new(len, kTypeInfoText, arena);
+    for (size_t i = 0; i < len; i++)
+    {
+        set_add(unique, typevec_offset(idents, i));
+    }
+
+    io_printf(con, "%zu identifiers (%zu unique) from %zu bytes\n", len, set_count(unique), total);
+
+    bench_hash(con, "legacy", legacy_hash, idents, unique, arena);
+    bench_hash(con, "text_hash", text_hash, idents, unique, arena);
+
+    return 0;
+}
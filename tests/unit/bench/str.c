@@ -0,0 +1,188 @@
+// compares every string search implementation available on this machine.
+// the files passed on the command line are joined into one corpus, each
+// operation is timed over it once per implementation. the scalar version
+// is the baseline the vector versions are measured against.
+
+#include "setup/memory.h"
+
+#include "arena/arena.h"
+#include "base/util.h"
+#include "core/macros.h"
+#include "io/console.h"
+#include "io/io.h"
+#include "os/os.h"
+#include "std/map.h"
+#include "std/str.h"
+#include "std/typed/vector.h"
+
+#include <time.h>
+
+#define BENCH_ROUNDS 50
+
+static const char *kNeedles[] = { "return", "static", "CTASSERT", "arena_t", "not in the corpus" };
+
+#define NEEDLES_LEN (sizeof(kNeedles) / sizeof(const char *))
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+// count every occurrence of each needle
+static size_t bench_find(const char *corpus, arena_t *arena)
+{
+    CT_UNUSED(arena);
+
+    size_t count = 0;
+    for (size_t i = 0; i < NEEDLES_LEN; i++)
+    {
+        const char *iter = corpus;
+        size_t offset;
+        while ((offset = str_find(iter, kNeedles[i])) != SIZE_MAX)
+        {
+            count += 1;
+            iter += offset + 1;
+        }
+    }
+
+    return count;
+}
+
+static size_t bench_rfind(const char *corpus, arena_t *arena)
+{
+    CT_UNUSED(arena);
+
+    size_t sink = 0;
+    for (size_t i = 0; i < NEEDLES_LEN; i++)
+    {
+        sink += str_rfind(corpus, kNeedles[i]);
+    }
+
+    return sink;
+}
+
+static size_t bench_replace(const char *corpus, arena_t *arena)
+{
+    char *result = str_replace(corpus, "static", "STATIC", arena);
+    size_t len = ctu_strlen(result);
+    arena_free(result, len + 1, arena);
+    return len;
+}
+
+static map_t *gReplacements = NULL;
+
+static size_t bench_replace_many(const char *corpus, arena_t *arena)
+{
+    char *result = str_replace_many(corpus, gReplacements, arena);
+    size_t len = ctu_strlen(result);
+    arena_free(result, len + 1, arena);
+    return len;
+}
+
+static size_t bench_normalize(const char *corpus, arena_t *arena)
+{
+    char *result = str_normalize(corpus, arena);
+    size_t len = ctu_strlen(result);
+    arena_free(result, len + 1, arena);
+    return len;
+}
+
+typedef size_t (*bench_fn_t)(const char *corpus, arena_t *arena);
+
+typedef struct bench_t
+{
+    const char *name;
+    bench_fn_t fn;
+} bench_t;
+
+static const bench_t kBenches[] = {
+    { "str_find", bench_find },
+    { "str_rfind", bench_rfind },
+    { "str_replace", bench_replace },
+    { "str_replace_many", bench_replace_many },
+    { "str_normalize", bench_normalize },
+};
+
+#define BENCHES_LEN (sizeof(kBenches) / sizeof(bench_t))
+
+static double run_bench(const bench_t *bench, const char *corpus, arena_t *arena, size_t *sink)
+{
+    double start = now_ms();
+    for (size_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        *sink += bench->fn(corpus, arena);
+    }
+    return now_ms() - start;
+}
+
+int main(int argc, const char **argv)
+{
+    arena_t *arena = ctu_default_alloc();
+    io_t *con = io_stdout();
+
+    typevec_t *corpus = typevec_new(sizeof(char), 0x10000, arena);
+
+    for (int i = 1; i < argc; i++)
+    {
+        io_t *io = io_file(argv[i], eOsAccessRead, arena);
+        if (io_error(io) != eOsSuccess)
+        {
+            io_printf(con, "failed to open %s\n", argv[i]);
+            return 1;
+        }
+
+        size_t size = io_size(io);
+        if (size > 0)
+        {
+            const char *text = io_map(io, eOsProtectRead);
+            typevec_append(corpus, text, size);
+        }
+    }
+
+    size_t total = typevec_len(corpus);
+    if (total == 0)
+    {
+        io_printf(con, "usage: %s <source files...>\n", argv[0]);
+        return 1;
+    }
+
+    char zero = '\0';
+    typevec_push(corpus, &zero);
+    const char *text = typevec_data(corpus);
+
+    gReplacements = map_new(4, kTypeInfoString, arena);
+    map_set(gReplacements, "\t", "    ");
+    map_set(gReplacements, "NULL", "nullptr");
+    map_set(gReplacements, "->", ".");
+
+    io_printf(con, "%zu bytes, %d rounds, default %s\n", total, BENCH_ROUNDS, str_isa_name(str_get_isa()));
+
+    str_isa_t best = str_get_isa();
+    size_t sink = 0;
+
+    for (size_t i = 0; i < BENCHES_LEN; i++)
+    {
+        const bench_t *bench = &kBenches[i];
+
+        (void)str_set_isa(eStrIsaScalar);
+        double baseline = run_bench(bench, text, arena, &sink);
+
+        for (str_isa_t isa = eStrIsaScalar; isa < eStrIsaCount; isa++)
+        {
+            if (!str_set_isa(isa))
+                continue;
+
+            double elapsed = (isa == eStrIsaScalar) ? baseline : run_bench(bench, text, arena, &sink);
+            double mbps = ((double)total * BENCH_ROUNDS) / (elapsed * 1000.0);
+            io_printf(con, "%-18s %-8s %8.2f ms %8.1f MB/s %5.2fx\n",
+                bench->name, str_isa_name(isa), elapsed, mbps, baseline / elapsed);
+        }
+    }
+
+    (void)str_set_isa(best);
+    io_printf(con, "(%zx)\n", sink);
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "base/util.h"
+#include "core/macros.h"
+#include "cthulhu/broker/broker.h"
+#include "cthulhu/broker/scan.h"
+#include "cthulhu/events/events.h"
+#include "cthulhu/tree/context.h"
+#include "cthulhu/tree/tree.h"
+#include "interop/compile.h"
+#include "io/io.h"
+#include "memory/memory.h"
+#include "notify/notify.h"
+#include "scan/node.h"
+#include "std/str.h"
+#include "std/typed/segvec.h"
+#include "std/typed/vector.h"
+#include "std/vector.h"
+
+// a language where each file is the name of its module,
+// files starting with ! fail to parse
+
+static int test_init(scan_t *extra, void *scanner)
+{
+    *(void**)scanner = extra;
+    return 0;
+}
+
+static int test_parse(void *scanner, scan_t *extra)
+{
+    CT_UNUSED(scanner);
+
+    text_view_t source = scan_source(extra);
+    if (source.text[0] == '!')
+    {
+        where_t where = { 0, (ctu_offset_t)source.length };
+        msg_notify(ctx_get_logger(extra), &kEvent_ParseFailed, node_new(extra, where), "rejected %s", scan_path(extra));
+        return 1;
+    }
+
+    scan_set(extra, (void*)source.text);
+    return 0;
+}
+
+static void *test_scan(const char *text, size_t size, void *scanner)
+{
+    CT_UNUSED(size);
+    CT_UNUSED(scanner);
+
+    return (void*)text;
+}
+
+static void test_destroy_buffer(void *buffer, void *scanner)
+{
+    CT_UNUSED(buffer);
+    CT_UNUSED(scanner);
+}
+
+static void test_destroy(void *scanner)
+{
+    CT_UNUSED(scanner);
+}
+
+static const scan_callbacks_t kTestCallbacks = {
+    .init = test_init,
+    .parse = test_parse,
+    .scan = test_scan,
+    .destroy_buffer = test_destroy_buffer,
+    .destroy = test_destroy,
+};
+
+static const size_t kTestSizes[eSemaCount] = {
+    [eSemaValues] = 1,
+    [eSemaTypes] = 1,
+    [eSemaProcs] = 1,
+    [eSemaModules] = 1,
+};
+
+static void test_postparse(language_runtime_t *runtime, scan_t *scan, void *tree)
+{
+    text_view_t source = scan_source(scan);
+    CTASSERT(tree == source.text);
+
+    char *name = arena_strndup(source.text, source.length, runtime->arena);
+    vector_t *path = vector_init(name, runtime->arena);
+    lang_add_unit(runtime, build_unit_id(path, runtime->arena), node_new(scan, kNowhere), tree, kTestSizes, eSemaCount);
+}
+
+static const language_t kTestLang = {
+    .info = {
+        .id = "lang/test",
+        .name = "test",
+        .version = {
+            .license = "LGPLv3",
+            .desc = "Parse order test language",
+            .version = CT_NEW_VERSION(0, 0, 1),
+        },
+    },
+
+    .builtin = {
+        .name = CT_TEXT_VIEW("test"),
+        .decls = kTestSizes,
+        .length = eSemaCount,
+    },
+
+    .fn_postparse = test_postparse,
+    .scanner = &kTestCallbacks,
+};
+
+static const frontend_t kTestFrontend = {
+    .info = {
+        .id = "frontend/test",
+        .name = "test",
+        .version = {
+            .license = "LGPLv3",
+            .desc = "Parse order test frontend",
+            .version = CT_NEW_VERSION(0, 0, 1),
+        },
+    },
+};
+
+static const char *const kSources[] = {
+    "alpha", "!beta", "gamma", "delta", "!epsilon", "zeta", "eta", "!theta",
+};
+
+#define SOURCES_LEN (sizeof(kSources) / sizeof(const char *))
+
+// the modules in order, failed sources have no module
+static const char *const kModules[] = {
+    "alpha", "gamma", "delta", "zeta", "eta",
+};
+
+#define MODULES_LEN (sizeof(kModules) / sizeof(const char *))
+
+static const char *const kEvents[] = {
+    "rejected !beta", "rejected !epsilon", "rejected !theta",
+};
+
+#define EVENTS_LEN (sizeof(kEvents) / sizeof(const char *))
+
+typedef struct parse_order_t
+{
+    // vector_t<const char*>
+    vector_t *modules;
+
+    // vector_t<const char*>
+    vector_t *events;
+} parse_order_t;
+
+static parse_order_t parse_with_jobs(size_t jobs, arena_t *arena)
+{
+    broker_t *broker = broker_new(&kTestFrontend, arena);
+    language_runtime_t *lang = broker_add_language(broker, &kTestLang);
+    broker_init(broker);
+
+    typevec_t *sources = typevec_new(sizeof(broker_source_t), SOURCES_LEN, arena);
+    for (size_t i = 0; i < SOURCES_LEN; i++)
+    {
+        const char *text = kSources[i];
+        broker_source_t source = {
+            .lang = lang,
+            .io = io_memory(text, text, ctu_strlen(text), eOsAccessRead, arena),
+        };
+
+        typevec_push(sources, &source);
+    }
+
+    broker_parse_sources(broker, sources, jobs);
+
+    parse_order_t order = {
+        .modules = vector_new(SOURCES_LEN, arena),
+        .events = vector_new(SOURCES_LEN, arena),
+    };
+
+    // the builtin module comes first
+    vector_t *modules = broker_get_modules(broker);
+    for (size_t i = 1; i < vector_len(modules); i++)
+        vector_push(&order.modules, (char*)tree_get_name(vector_get(modules, i)));
+
+    segvec_t *events = logger_get_events(broker_get_logger(broker));
+    for (size_t i = 0; i < segvec_len(events); i++)
+    {
+        const event_t *event = segvec_offset(events, i);
+        vector_push(&order.events, event->message);
+    }
+
+    broker_deinit(broker);
+
+    return order;
+}
+
+static bool same_strings(const vector_t *lhs, const char *const *rhs, size_t len)
+{
+    if (vector_len(lhs) != len)
+        return false;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!str_equal(vector_get(lhs, i), rhs[i]))
+            return false;
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("broker parse", arena);
+
+    init_global_arena(arena);
+    init_gmp_arena(arena);
+
+    parse_order_t sequential = parse_with_jobs(1, arena);
+    parse_order_t parallel = parse_with_jobs(4, arena);
+
+    {
+        test_group_t group = test_group(&suite, "sequential");
+        GROUP_EXPECT_PASS(group, "module order", same_strings(sequential.modules, kModules, MODULES_LEN));
+        GROUP_EXPECT_PASS(group, "event order", same_strings(sequential.events, kEvents, EVENTS_LEN));
+    }
+
+    {
+        test_group_t group = test_group(&suite, "parallel");
+        GROUP_EXPECT_PASS(group, "module order", same_strings(parallel.modules, kModules, MODULES_LEN));
+        GROUP_EXPECT_PASS(group, "event order", same_strings(parallel.events, kEvents, EVENTS_LEN));
+    }
+
+    return test_suite_finish(&suite);
+}
@@ -0,0 +1,82 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "base/util.h"
+#include "interop/actions.h"
+#include "io/io.h"
+#include "scan/scan.h"
+
+#include "common_extra.h"
+
+// lines are "ab cd", "ef", "", "gh" followed by a trailing newline
+static const char *const kText = "ab cd\nef\n\ngh\n";
+
+static bool location_is(location_t location, ctu_line_t first_line, ctu_column_t first_column,
+                        ctu_line_t last_line, ctu_column_t last_column)
+{
+    return location.first_line == first_line
+        && location.first_column == first_column
+        && location.last_line == last_line
+        && location.last_column == last_column;
+}
+
+static location_t resolve(text_cache_t *cache, ctu_offset_t offset, ctu_offset_t length)
+{
+    where_t where = { offset, length };
+    return cache_get_location(cache, where);
+}
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("locations", arena);
+
+    cache_map_t *map = cache_map_new(4, arena);
+
+    io_t *io = io_memory("text", kText, ctu_strlen(kText), eOsAccessRead, arena);
+    scan_t *scan = scan_io("test", io, arena);
+    text_cache_t *cache = cache_emplace_scan(map, scan);
+
+    {
+        test_group_t group = test_group(&suite, "offsets");
+
+        GROUP_EXPECT_PASS(group, "first byte", location_is(resolve(cache, 0, 2), 0, 0, 0, 2));
+        GROUP_EXPECT_PASS(group, "mid line", location_is(resolve(cache, 3, 2), 0, 3, 0, 5));
+        GROUP_EXPECT_PASS(group, "after newline", location_is(resolve(cache, 6, 2), 1, 0, 1, 2));
+        GROUP_EXPECT_PASS(group, "empty line", location_is(resolve(cache, 9, 0), 2, 0, 2, 0));
+        GROUP_EXPECT_PASS(group, "across lines", location_is(resolve(cache, 3, 5), 0, 3, 1, 2));
+        GROUP_EXPECT_PASS(group, "past trailing newline", location_is(resolve(cache, 13, 0), 4, 0, 4, 0));
+    }
+
+    {
+        test_group_t group = test_group(&suite, "empty file");
+
+        text_cache_t *empty = cache_emplace_scan(map, scan_builtin("test", arena));
+        GROUP_EXPECT_PASS(group, "no lines", cache_count_lines(empty) == 0);
+        GROUP_EXPECT_PASS(group, "start", location_is(resolve(empty, 0, 0), 0, 0, 0, 0));
+    }
+
+    {
+        test_group_t group = test_group(&suite, "rule spans");
+
+        // symbols "cd" and "ef" reduced by a rule
+        where_t rule[3] = { { 0, 2 }, { 3, 2 }, { 6, 2 } };
+        where_t where;
+        flex_update(&where, rule, 2);
+        GROUP_EXPECT_PASS(group, "covers symbols", where.offset == 3 && where.length == 5);
+        GROUP_EXPECT_PASS(group, "resolves across lines", location_is(cache_get_location(cache, where), 0, 3, 1, 2));
+
+        // an empty rule after "ab" sits at the end of "ab"
+        flex_update(&where, rule, 0);
+        GROUP_EXPECT_PASS(group, "empty rule", where.offset == 2 && where.length == 0);
+        GROUP_EXPECT_PASS(group, "empty rule resolves", location_is(cache_get_location(cache, where), 0, 2, 0, 2));
+    }
+
+    cache_map_delete(map);
+
+    return test_suite_finish(&suite);
+}
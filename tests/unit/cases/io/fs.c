@@ -10,6 +10,34 @@
 
 #include "std/str.h"
 
+#include "base/util.h"
+
+#include <sys/stat.h>
+
+#if CT_OS_WINDOWS
+#   include <sys/utime.h>
+#else
+#   include <utime.h>
+#endif
+
+#define SYNC_FILE(root) "test" CT_NATIVE_PATH_SEPARATOR root CT_NATIVE_PATH_SEPARATOR "nested" CT_NATIVE_PATH_SEPARATOR "second.txt"
+
+// move the modification time of a file into the past so a rewrite is visible
+static bool backdate_file(const char *path, struct stat *st)
+{
+    struct utimbuf times = { .actime = 1000000000, .modtime = 1000000000 };
+    return utime(path, &times) == 0 && stat(path, st) == 0;
+}
+
+static bool file_untouched(const char *path, const struct stat *before)
+{
+    struct stat after;
+    if (stat(path, &after) != 0)
+        return false;
+
+    return after.st_mtime == before->st_mtime && after.st_ino == before->st_ino;
+}
+
 int main(void)
 {
     test_install_panic_handler();
@@ -73,6 +101,72 @@ int main(void)
         GROUP_EXPECT_PASS(group, "io_error() should return no error", io_error(io) == eOsSuccess);
     }
 
+    {
+        test_group_t group = test_group(&suite, "sync");
+
+        fs_t *vfs = fs_virtual("sync", arena);
+        fs_dir_create(vfs, "nested");
+
+        io_t *io = fs_open(vfs, "first.txt", eOsAccessWrite | eOsAccessTruncate);
+        io_printf(io, "first file");
+        io_close(io);
+
+        io = fs_open(vfs, "nested/second.txt", eOsAccessWrite | eOsAccessTruncate);
+        io_printf(io, "second file");
+        io_close(io);
+
+        fs_t *out = fs_physical("test" CT_NATIVE_PATH_SEPARATOR "sync", arena);
+        sync_result_t result = fs_sync(out, vfs);
+        GROUP_EXPECT_PASS(group, "result should be empty", result.path == NULL);
+
+        io = fs_open(out, "nested/second.txt", eOsAccessRead);
+        GROUP_EXPECT_PASS(group, "fs_sync() should write files", io_size(io) == 11 && ctu_strncmp(io_map(io, eOsProtectRead), "second file", 11) == 0);
+        io_close(io);
+
+        io = fs_open(vfs, "first.txt", eOsAccessWrite | eOsAccessTruncate);
+        io_printf(io, "changed");
+        io_close(io);
+
+        result = fs_sync(out, vfs);
+        GROUP_EXPECT_PASS(group, "result should be empty", result.path == NULL);
+
+        io = fs_open(out, "first.txt", eOsAccessRead);
+        GROUP_EXPECT_PASS(group, "fs_sync() should update changed files", io_size(io) == 7 && ctu_strncmp(io_map(io, eOsProtectRead), "changed", 7) == 0);
+        io_close(io);
+
+        struct stat before;
+        GROUP_EXPECT_PASS(group, "file can be backdated", backdate_file(SYNC_FILE("sync"), &before));
+
+        result = fs_sync(out, vfs);
+        GROUP_EXPECT_PASS(group, "result should be empty", result.path == NULL);
+        GROUP_EXPECT_PASS(group, "fs_sync() should not rewrite unchanged files", file_untouched(SYNC_FILE("sync"), &before));
+
+        fs_t *copy = fs_physical("test" CT_NATIVE_PATH_SEPARATOR "copy", arena);
+        result = fs_sync(copy, out);
+        GROUP_EXPECT_PASS(group, "result should be empty", result.path == NULL);
+
+        io = fs_open(copy, "nested/second.txt", eOsAccessRead);
+        GROUP_EXPECT_PASS(group, "fs_sync() should copy between physical filesystems", io_size(io) == 11 && ctu_strncmp(io_map(io, eOsProtectRead), "second file", 11) == 0);
+        io_close(io);
+
+        GROUP_EXPECT_PASS(group, "file can be backdated", backdate_file(SYNC_FILE("copy"), &before));
+
+        result = fs_sync(copy, out);
+        GROUP_EXPECT_PASS(group, "result should be empty", result.path == NULL);
+        GROUP_EXPECT_PASS(group, "fs_sync() should not copy unchanged files", file_untouched(SYNC_FILE("copy"), &before));
+
+        fs_t *roots[] = { out, copy };
+        for (size_t i = 0; i < sizeof(roots) / sizeof(fs_t*); i++)
+        {
+            fs_file_delete(roots[i], "nested/second.txt");
+            fs_file_delete(roots[i], "first.txt");
+            fs_dir_delete(roots[i], "nested");
+        }
+
+        os_dir_delete("test" CT_NATIVE_PATH_SEPARATOR "sync");
+        os_dir_delete("test" CT_NATIVE_PATH_SEPARATOR "copy");
+    }
+
     // cleanup the physical test directory
     os_dir_delete("test");
 
@@ -1,12 +1,40 @@
 #include "unit/ct-test.h"
 
 #include "arena/arena.h"
+#include "base/util.h"
 #include "setup/memory.h"
 
 #include "io/io.h"
+#include "os/os.h"
 #include "io/impl/file.h"
 #include "io/impl/view.h"
 #include "io/impl/buffer.h"
+#include "io/impl.h"
+
+#include "core/macros.h"
+
+// accepts at most 4 bytes per write without reporting an error
+#define SHORT_WRITE_LIMIT 4
+
+typedef struct short_io_t
+{
+    size_t total;
+} short_io_t;
+
+static size_t short_write(io_t *self, const void *src, size_t size)
+{
+    CT_UNUSED(src);
+
+    short_io_t *impl = io_data(self);
+    size_t count = CT_MIN(size, SHORT_WRITE_LIMIT);
+    impl->total += count;
+    return count;
+}
+
+static const io_callbacks_t kShortCallbacks = {
+    .fn_write = short_write,
+    .size = sizeof(short_io_t),
+};
 
 int main(void)
 {
@@ -37,5 +65,122 @@ int main(void)
         GROUP_EXPECT_PASS(group, "io_close() should have no error", err == eOsSuccess);
     }
 
+    // printf
+    {
+        test_group_t group = test_group(&suite, "printf");
+        io_t *io = io_blob("test", 64, eOsAccessRead | eOsAccessWrite, arena);
+
+        size_t short_len = io_printf(io, "%s %d", "hello", 25);
+        GROUP_EXPECT_PASS(group, "io_printf() should write short output", short_len == 8);
+
+        // longer than any stack buffer used for formatting
+        char long_text[2000];
+        ctu_memset(long_text, 'x', sizeof(long_text) - 1);
+        long_text[sizeof(long_text) - 1] = '\0';
+
+        size_t long_len = io_printf(io, "[%s]", long_text);
+        GROUP_EXPECT_PASS(group, "io_printf() should write long output", long_len == sizeof(long_text) + 1);
+
+        size_t empty_len = io_printf(io, "%s", "");
+        GROUP_EXPECT_PASS(group, "io_printf() should write nothing for empty output", empty_len == 0);
+
+        size_t size = io_size(io);
+        GROUP_EXPECT_PASS(group, "io_size() should include every write", size == short_len + long_len);
+
+        const char *text = io_map(io, eOsProtectRead);
+        GROUP_EXPECT_PASS(group, "short output should be first", ctu_strncmp(text, "hello 25[x", 10) == 0);
+        GROUP_EXPECT_PASS(group, "long output should be complete", text[size - 2] == 'x' && text[size - 1] == ']');
+
+        os_error_t err = io_free(io);
+        GROUP_EXPECT_PASS(group, "io_free() should have no error", err == eOsSuccess);
+    }
+
+    // buffered
+    {
+        test_group_t group = test_group(&suite, "buffered");
+        io_t *inner = io_blob("inner", 64, eOsAccessRead | eOsAccessWrite, arena);
+        io_t *io = io_buffered(inner, 16, arena);
+        GROUP_EXPECT_PASS(group, "io_buffered() should have no error", io_error(io) == eOsSuccess);
+
+        io_write(io, "hello", 5);
+        io_printf(io, " %d", 42);
+        GROUP_EXPECT_PASS(group, "small writes should be held back", io_size(inner) == 0);
+
+        os_error_t err = io_flush(io);
+        GROUP_EXPECT_PASS(group, "io_flush() should have no error", err == eOsSuccess);
+        GROUP_EXPECT_PASS(group, "io_flush() should write pending data", io_size(inner) == 8);
+
+        io_write(io, "abc", 3);
+        io_write(io, "0123456789abcdefghij", 20);
+        GROUP_EXPECT_PASS(group, "large writes should skip the buffer", io_size(inner) == 31);
+
+        io_write(io, "tail", 4);
+        GROUP_EXPECT_PASS(group, "io_size() should flush first", io_size(io) == 35);
+
+        const char *text = io_map(io, eOsProtectRead);
+        GROUP_EXPECT_PASS(group, "writes should stay in order", ctu_strncmp(text, "hello 42abc0123456789abcdefghijtail", 35) == 0);
+
+        io_write(io, "!", 1);
+        err = io_close(io);
+        GROUP_EXPECT_PASS(group, "io_close() should have no error", err == eOsSuccess);
+        GROUP_EXPECT_PASS(group, "io_close() should flush", io_size(inner) == 36);
+    }
+
+    // buffered short writes
+    {
+        test_group_t group = test_group(&suite, "buffered short writes");
+        short_io_t data = { 0 };
+        io_t *inner = io_new(&kShortCallbacks, eOsAccessWrite, "short", &data, arena);
+        short_io_t *impl = io_data(inner);
+        io_t *io = io_buffered(inner, 16, arena);
+
+        io_write(io, "01234567", 8);
+        os_error_t err = io_flush(io);
+        GROUP_EXPECT_PASS(group, "io_flush() should report a short write", err == eOsTooSmall);
+        GROUP_EXPECT_PASS(group, "io_error() should be set", io_error(io) == eOsTooSmall);
+        GROUP_EXPECT_PASS(group, "accepted bytes should be written", impl->total == SHORT_WRITE_LIMIT);
+
+        err = io_flush(io);
+        GROUP_EXPECT_PASS(group, "unwritten bytes should be kept", err == eOsSuccess && impl->total == 8);
+
+        size_t written = io_write(io, "0123456789abcdefghij", 20);
+        GROUP_EXPECT_PASS(group, "large writes should report a short write", written == SHORT_WRITE_LIMIT && io_error(io) == eOsTooSmall);
+    }
+
+    // private mappings
+    {
+        test_group_t group = test_group(&suite, "private map");
+        const char *path = "test_private_map.txt";
+
+        io_t *out = io_file(path, eOsAccessWrite | eOsAccessTruncate, arena);
+        io_write(out, "hello world", 11);
+        os_error_t err = io_free(out);
+        GROUP_EXPECT_PASS(group, "io_free() should have no error", err == eOsSuccess);
+
+        io_t *io = io_file(path, eOsAccessRead, arena);
+        os_mapping_t mapping = { 0 };
+        bool mapped = io_map_private(io, 2, &mapping);
+        GROUP_EXPECT_PASS(group, "io_map_private() should map a file", mapped);
+
+        char *text = os_mapping_data(&mapping);
+        GROUP_EXPECT_PASS(group, "contents should be mapped", ctu_strncmp(text, "hello world", 11) == 0);
+        GROUP_EXPECT_PASS(group, "contents should be padded", text[11] == '\0' && text[12] == '\0');
+
+        text[0] = 'j';
+        const char *view = io_map(io, eOsProtectRead);
+        GROUP_EXPECT_PASS(group, "writes should stay private", view[0] == 'h');
+
+        err = os_unmap(&mapping);
+        GROUP_EXPECT_PASS(group, "os_unmap() should have no error", err == eOsSuccess);
+
+        io_t *blob = io_blob("blob", 16, eOsAccessRead | eOsAccessWrite, arena);
+        os_mapping_t unused = { 0 };
+        GROUP_EXPECT_PASS(group, "memory should not map privately", !io_map_private(blob, 2, &unused));
+
+        io_free(blob);
+        io_free(io);
+        os_file_delete(path);
+    }
+
     return test_suite_finish(&suite);
 }
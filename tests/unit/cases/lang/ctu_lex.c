@@ -0,0 +1,218 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "base/util.h"
+#include "core/macros.h"
+#include "io/io.h"
+#include "memory/memory.h"
+#include "notify/notify.h"
+#include "os/os.h"
+#include "scan/scan.h"
+#include "std/str.h"
+
+#include "cthulhu/broker/scan.h"
+
+#include "ctu/lex.h"
+
+#include "ctu_bison.h" // IWYU pragma: keep
+
+#if CTU_TEST_FLEX
+#   include "ctu_flex.h" // IWYU pragma: keep
+#endif
+
+typedef struct lex_token_t
+{
+    int kind;
+    ctu_offset_t offset;
+    ctu_offset_t length;
+} lex_token_t;
+
+typedef struct lex_case_t
+{
+    const char *name;
+    const char *text;
+    const lex_token_t *tokens;
+    size_t count;
+} lex_case_t;
+
+static const lex_token_t kModuleTokens[] = {
+    { MODULE, 0, 6 }, { IDENT, 7, 1 }, { DOT, 8, 1 }, { IDENT, 9, 1 }, { SEMI, 10, 1 },
+};
+
+static const lex_token_t kKeywordTokens[] = {
+    { VARIANT, 0, 7 }, { IDENT, 8, 8 }, { SIZEOF, 17, 8 }, { IDENT, 26, 4 }, { NOINIT, 31, 6 },
+};
+
+static const lex_token_t kOperatorTokens[] = {
+    { LTE, 0, 2 }, { SHR, 3, 2 }, { EQ, 6, 2 }, { NEQ, 9, 2 }, { AND, 12, 2 },
+    { OR, 15, 2 }, { ARROW, 18, 2 }, { DISCARD, 21, 1 }, { AT, 23, 1 }, { LT, 25, 1 },
+    { MINUS, 26, 1 },
+};
+
+static const lex_token_t kLiteralTokens[] = {
+    { INTEGER, 0, 4 }, { PLUS, 5, 1 }, { INTEGER, 7, 4 }, { STRING, 12, 7 },
+    { CHARACTER, 20, 3 }, { BOOLEAN, 24, 4 },
+};
+
+static const lex_token_t kCommentTokens[] = {
+    { VAR, 0, 3 }, { IDENT, 13, 1 }, { ASSIGN, 28, 1 }, { INTEGER, 30, 1 },
+};
+
+#define LEX_CASE(name, text, tokens) { name, text, tokens, sizeof(tokens) / sizeof(lex_token_t) }
+
+static const lex_case_t kCases[] = {
+    LEX_CASE("module", "module a.b;", kModuleTokens),
+    LEX_CASE("keywords", "variant variants __sizeof def_ noinit", kKeywordTokens),
+    LEX_CASE("operators", "<= >> == != && || -> $ @ <-", kOperatorTokens),
+    LEX_CASE("literals", "0x1F + 0b10 \"esc\\n\" 'a' true", kLiteralTokens),
+    LEX_CASE("comments", "var // line\n x /* block\n */ = 1", kCommentTokens),
+};
+
+#define CASES_LEN (sizeof(kCases) / sizeof(lex_case_t))
+
+static scan_t *lex_scan(const char *name, const char *text, size_t size, arena_t *arena)
+{
+    scan_context_t *ctx = ARENA_MALLOC(sizeof(scan_context_t), "lex context", NULL, arena);
+    ctx->logger = logger_new(arena);
+    ctx->arena = arena;
+    ctx->string_arena = arena;
+    ctx->ast_arena = arena;
+
+    io_t *io = io_memory(name, text, size, eOsAccessRead, arena);
+    scan_t *scan = scan_io("ctu", io, arena);
+    scan_set_context(scan, ctx);
+
+    return scan;
+}
+
+static typevec_t *lex_hand(scan_t *scan, const char *text, size_t size, arena_t *arena)
+{
+    typevec_t *tokens = typevec_new(sizeof(lex_token_t), 64, arena);
+
+    ctu_lexer_t lexer;
+    ctu_lexer_init(&lexer, scan, text, size);
+
+    CTUSTYPE value;
+    where_t where;
+    int kind;
+    while ((kind = ctu_lexer_next(&lexer, &value, &where)) != CTUEOF)
+    {
+        lex_token_t token = { kind, where.offset, where.length };
+        typevec_push(tokens, &token);
+    }
+
+    return tokens;
+}
+
+#if CTU_TEST_FLEX
+static typevec_t *lex_flex(scan_t *scan, const char *text, size_t size, arena_t *arena)
+{
+    typevec_t *tokens = typevec_new(sizeof(lex_token_t), 64, arena);
+
+    yyscan_t scanner;
+    ctulex_init_extra(scan, &scanner);
+    YY_BUFFER_STATE buffer = ctu_scan_bytes(text, (int)size, scanner);
+
+    CTUSTYPE value;
+    where_t where;
+    int kind;
+    while ((kind = ctulex(&value, &where, scanner)) != CTUEOF)
+    {
+        lex_token_t token = { kind, where.offset, where.length };
+        typevec_push(tokens, &token);
+    }
+
+    ctu_delete_buffer(buffer, scanner);
+    ctulex_destroy(scanner);
+
+    return tokens;
+}
+#endif
+
+static bool tokens_match(const typevec_t *tokens, const lex_token_t *expected, size_t count)
+{
+    if (typevec_len(tokens) != count)
+        return false;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const lex_token_t *token = typevec_offset(tokens, i);
+        if (token->kind != expected[i].kind
+            || token->offset != expected[i].offset
+            || token->length != expected[i].length)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool spans_ordered(const typevec_t *tokens, size_t size)
+{
+    size_t end = 0;
+    size_t len = typevec_len(tokens);
+    for (size_t i = 0; i < len; i++)
+    {
+        const lex_token_t *token = typevec_offset(tokens, i);
+        if (token->offset < end || token->offset + token->length > size)
+            return false;
+
+        end = token->offset + token->length;
+    }
+
+    return true;
+}
+
+// the files passed on the command line are lexed by every available scanner
+int main(int argc, const char **argv)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("ctu lexer", arena);
+
+    init_global_arena(arena);
+    init_gmp_arena(arena);
+
+    {
+        test_group_t group = test_group(&suite, "tokens");
+        for (size_t i = 0; i < CASES_LEN; i++)
+        {
+            const lex_case_t *test = &kCases[i];
+            size_t size = ctu_strlen(test->text);
+
+            scan_t *scan = lex_scan("case", test->text, size, arena);
+            typevec_t *tokens = lex_hand(scan, test->text, size, arena);
+            GROUP_EXPECT_PASS(group, test->name, tokens_match(tokens, test->tokens, test->count));
+        }
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        test_group_t group = test_group(&suite, argv[i]);
+
+        io_t *io = io_file(argv[i], eOsAccessRead, arena);
+        os_error_t err = io_error(io);
+        GROUP_EXPECT_PASS(group, "opened", err == eOsSuccess);
+
+        size_t size = (err == eOsSuccess) ? io_size(io) : 0;
+        if (size == 0)
+            continue;
+
+        const char *text = io_map(io, eOsProtectRead);
+
+        scan_t *scan = lex_scan(argv[i], text, size, arena);
+        typevec_t *hand = lex_hand(scan, text, size, arena);
+        GROUP_EXPECT_PASS(group, "spans are ordered", spans_ordered(hand, size));
+
+#if CTU_TEST_FLEX
+        typevec_t *flex = lex_flex(scan, text, size, arena);
+        GROUP_EXPECT_PASS(group, "same tokens as flex", tokens_match(hand, typevec_data(flex), typevec_len(flex)));
+#endif
+    }
+
+    return test_suite_finish(&suite);
+}
@@ -0,0 +1,102 @@
+#include "unit/ct-test.h"
+
+#include "arena/arena.h"
+#include "arena/pool.h"
+#include "setup/memory.h"
+
+#include "base/util.h"
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("pool", arena);
+
+    {
+        test_group_t group = test_group(&suite, "construction");
+        arena_t *pool = pool_new("test", 1024, arena);
+        GROUP_EXPECT_PASS(group, "not null", pool != NULL);
+        GROUP_EXPECT_PASS(group, "is pool", arena_is_pool(pool));
+        GROUP_EXPECT_PASS(group, "default is not pool", !arena_is_pool(arena));
+        pool_delete(pool);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "size classes");
+        arena_t *pool = pool_new("test", 1024, arena);
+
+        char *a = arena_malloc(24, pool);
+        char *b = arena_malloc(24, pool);
+        char *c = arena_malloc(100, pool);
+        GROUP_EXPECT_PASS(group, "aligned", ((uintptr_t)a % (sizeof(void*) * 2)) == 0);
+        GROUP_EXPECT_PASS(group, "aligned", ((uintptr_t)c % (sizeof(void*) * 2)) == 0);
+        GROUP_EXPECT_PASS(group, "same class is packed", b > a && (size_t)(b - a) == 32);
+
+        pool_stats_t stats = pool_stats(pool);
+        GROUP_EXPECT_PASS(group, "one slab per class", stats.slabs == 2);
+        GROUP_EXPECT_PASS(group, "used", stats.used == 32 + 32 + 112);
+
+        char *large = arena_malloc(4096, pool);
+        ctu_memset(large, 0, 4096);
+        stats = pool_stats(pool);
+        GROUP_EXPECT_PASS(group, "large is forwarded", stats.slabs == 2);
+        arena_free(large, 4096, pool);
+
+        pool_delete(pool);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "free list");
+        arena_t *pool = pool_new("test", 1024, arena);
+
+        char *a = arena_malloc(16, pool);
+        char *b = arena_malloc(16, pool);
+        arena_free(a, 16, pool);
+        char *c = arena_malloc(16, pool);
+        GROUP_EXPECT_PASS(group, "freed slot is reused", a == c);
+
+        arena_free(b, CT_ALLOC_SIZE_UNKNOWN, pool);
+        char *d = arena_malloc(16, pool);
+        GROUP_EXPECT_PASS(group, "unknown size is found", b == d);
+
+        for (size_t i = 0; i < 256; i++)
+            (void)arena_malloc(16, pool);
+
+        pool_stats_t stats = pool_stats(pool);
+        GROUP_EXPECT_PASS(group, "more slabs", stats.slabs > 1);
+
+        pool_delete(pool);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "realloc");
+        arena_t *pool = pool_new("test", 1024, arena);
+
+        char *a = arena_malloc(12, pool);
+        ctu_memcpy(a, "hello world", 12);
+
+        char *b = arena_realloc(a, 16, 12, pool);
+        GROUP_EXPECT_PASS(group, "same class does not move", a == b);
+
+        char *c = arena_realloc(b, 64, 16, pool);
+        GROUP_EXPECT_PASS(group, "contents kept", str_equal(c, "hello world"));
+
+        char *d = arena_realloc(c, 1024, CT_ALLOC_SIZE_UNKNOWN, pool);
+        GROUP_EXPECT_PASS(group, "grow into parent", str_equal(d, "hello world"));
+
+        char *e = arena_realloc(d, 32, 1024, pool);
+        GROUP_EXPECT_PASS(group, "shrink into class", str_equal(e, "hello world"));
+
+        pool_delete(pool);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        GROUP_EXPECT_PANIC(group, "stats of default", (void)pool_stats(arena));
+        GROUP_EXPECT_PANIC(group, "null parent", (void)pool_new("test", 1024, NULL));
+    }
+
+    return test_suite_finish(&suite);
+}
@@ -0,0 +1,156 @@
+#include "unit/ct-test.h"
+
+#include "arena/arena.h"
+#include "arena/region.h"
+#include "setup/memory.h"
+
+#include "base/util.h"
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("region", arena);
+
+    {
+        test_group_t group = test_group(&suite, "construction");
+        arena_t *region = region_new("test", 1024, arena);
+        GROUP_EXPECT_PASS(group, "not null", region != NULL);
+        GROUP_EXPECT_PASS(group, "is region", arena_is_region(region));
+        GROUP_EXPECT_PASS(group, "default is not region", !arena_is_region(arena));
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "alloc");
+        arena_t *region = region_new("test", 1024, arena);
+
+        char *a = arena_malloc(16, region);
+        char *b = arena_malloc(16, region);
+        GROUP_EXPECT_PASS(group, "distinct", a != b);
+        GROUP_EXPECT_PASS(group, "aligned", ((uintptr_t)a % (sizeof(void*) * 2)) == 0);
+        GROUP_EXPECT_PASS(group, "aligned", ((uintptr_t)b % (sizeof(void*) * 2)) == 0);
+        GROUP_EXPECT_PASS(group, "contiguous", b > a && (size_t)(b - a) <= 64);
+
+        region_stats_t stats = region_stats(region);
+        GROUP_EXPECT_PASS(group, "single chunk", stats.chunks == 1);
+
+        for (size_t i = 0; i < 256; i++)
+        {
+            char *c = arena_malloc(32, region);
+            ctu_memset(c, (int)i, 32);
+        }
+
+        stats = region_stats(region);
+        GROUP_EXPECT_PASS(group, "more chunks", stats.chunks > 1);
+
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "realloc");
+        arena_t *region = region_new("test", 1024, arena);
+
+        char *a = arena_malloc(16, region);
+        ctu_memcpy(a, "hello world", 12);
+
+        char *b = arena_realloc(a, 64, 16, region);
+        GROUP_EXPECT_PASS(group, "grows in place", a == b);
+
+        char *c = arena_malloc(16, region);
+        char *d = arena_realloc(b, 128, 64, region);
+        GROUP_EXPECT_PASS(group, "moves when not last", d != b && d != c);
+        GROUP_EXPECT_PASS(group, "contents kept", str_equal(d, "hello world"));
+
+        char *e = arena_realloc(d, 4096, CT_ALLOC_SIZE_UNKNOWN, region);
+        GROUP_EXPECT_PASS(group, "unknown old size", str_equal(e, "hello world"));
+
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "free");
+        arena_t *region = region_new("test", 1024, arena);
+
+        char *a = arena_malloc(16, region);
+        arena_free(a, 16, region);
+        char *b = arena_malloc(16, region);
+        GROUP_EXPECT_PASS(group, "last is reused", a == b);
+
+        char *large = arena_malloc(4096, region);
+        region_stats_t before = region_stats(region);
+        arena_free(large, 4096, region);
+        region_stats_t after = region_stats(region);
+        GROUP_EXPECT_PASS(group, "large is released", after.chunks + 1 == before.chunks);
+
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "reset");
+        arena_t *region = region_new("test", 1024, arena);
+
+        for (size_t i = 0; i < 256; i++)
+            (void)arena_malloc(64, region);
+
+        (void)arena_malloc(4096, region);
+
+        region_reset(region);
+        region_stats_t stats = region_stats(region);
+        GROUP_EXPECT_PASS(group, "one chunk kept", stats.chunks == 1);
+        GROUP_EXPECT_PASS(group, "nothing used", stats.used == 0);
+
+        GROUP_EXPECT_PASS(group, "usable after reset", arena_malloc(16, region) != NULL);
+
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "marks");
+        arena_t *region = region_new("test", 1024, arena);
+
+        char *a = arena_malloc(16, region);
+        ctu_memcpy(a, "hello world", 12);
+
+        region_stats_t before = region_stats(region);
+        arena_mark_t mark = arena_mark(region);
+
+        char *b = arena_realloc(a, 64, 16, region);
+        GROUP_EXPECT_PASS(group, "marked is not grown in place", a != b);
+
+        for (size_t i = 0; i < 256; i++)
+            (void)arena_malloc(64, region);
+
+        (void)arena_malloc(4096, region);
+
+        arena_release_to(region, mark);
+        region_stats_t after = region_stats(region);
+        GROUP_EXPECT_PASS(group, "chunks released", after.chunks == before.chunks + 1);
+        GROUP_EXPECT_PASS(group, "usage restored", after.used == before.used);
+        GROUP_EXPECT_PASS(group, "marked kept", str_equal(a, "hello world"));
+
+        char *c = arena_malloc(16, region);
+        GROUP_EXPECT_PASS(group, "memory is reused", c == b);
+
+        arena_mark_t outer = arena_mark(region);
+        (void)arena_malloc(512, region);
+        arena_mark_t inner = arena_mark(region);
+        (void)arena_malloc(512, region);
+        arena_release_to(region, inner);
+        arena_release_to(region, outer);
+        GROUP_EXPECT_PASS(group, "nested marks", region_stats(region).used == after.used + 32);
+
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        GROUP_EXPECT_PANIC(group, "reset default", region_reset(arena));
+        GROUP_EXPECT_PANIC(group, "null parent", (void)region_new("test", 1024, NULL));
+        GROUP_EXPECT_PANIC(group, "mark default", (void)arena_mark(arena));
+    }
+
+    return test_suite_finish(&suite);
+}
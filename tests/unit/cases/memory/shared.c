@@ -0,0 +1,119 @@
+#include "unit/ct-test.h"
+
+#include "arena/arena.h"
+#include "arena/region.h"
+#include "arena/shared.h"
+#include "setup/memory.h"
+
+#include "base/util.h"
+
+#include "os/os.h"
+
+#define SHARED_THREADS 4
+#define SHARED_ALLOCS 1024
+
+typedef struct shared_worker_t
+{
+    arena_t *arena;
+    char *allocs[SHARED_ALLOCS];
+} shared_worker_t;
+
+static os_exitcode_t alloc_blocks(void *arg)
+{
+    shared_worker_t *worker = arg;
+
+    for (size_t i = 0; i < SHARED_ALLOCS; i++)
+    {
+        char *ptr = arena_malloc(32, worker->arena);
+        ctu_memset(ptr, (int)(i & 0xFF), 32);
+        worker->allocs[i] = ptr;
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("shared", arena);
+
+    {
+        test_group_t group = test_group(&suite, "construction");
+        arena_t *shared = shared_new("test", arena);
+        GROUP_EXPECT_PASS(group, "not null", shared != NULL);
+        GROUP_EXPECT_PASS(group, "is shared", arena_is_shared(shared));
+        GROUP_EXPECT_PASS(group, "default is not shared", !arena_is_shared(arena));
+        shared_delete(shared);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "forwarding");
+        arena_t *region = region_new("test", 1024, arena);
+        arena_t *shared = shared_new("test", region);
+
+        char *a = arena_malloc(16, shared);
+        ctu_memcpy(a, "hello world", 12);
+        GROUP_EXPECT_PASS(group, "allocated from parent", region_stats(region).used > 0);
+
+        char *b = arena_realloc(a, 64, 16, shared);
+        GROUP_EXPECT_PASS(group, "parent grows in place", a == b);
+        GROUP_EXPECT_PASS(group, "contents kept", str_equal(b, "hello world"));
+
+        char *c = arena_malloc(16, shared);
+        arena_free(c, 16, shared);
+        GROUP_EXPECT_PASS(group, "parent reuses last", arena_malloc(16, shared) == c);
+
+        shared_delete(shared);
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "threads");
+        arena_t *region = region_new("test", 1024, arena);
+        arena_t *shared = shared_new("test", region);
+
+        os_thread_t threads[SHARED_THREADS];
+        shared_worker_t workers[SHARED_THREADS];
+        for (size_t i = 0; i < SHARED_THREADS; i++)
+        {
+            workers[i].arena = shared;
+            GROUP_EXPECT_PASS(group, "started", os_thread_init(&threads[i], "shared", alloc_blocks, &workers[i]) == eOsSuccess);
+        }
+
+        for (size_t i = 0; i < SHARED_THREADS; i++)
+        {
+            os_status_t status = 0;
+            GROUP_EXPECT_PASS(group, "joined", os_thread_join(&threads[i], &status) == eOsSuccess);
+        }
+
+        // every block must still hold what its thread wrote
+        bool intact = true;
+        for (size_t i = 0; i < SHARED_THREADS; i++)
+        {
+            for (size_t j = 0; j < SHARED_ALLOCS; j++)
+            {
+                const char *ptr = workers[i].allocs[j];
+                for (size_t k = 0; k < 32; k++)
+                {
+                    intact = intact && ptr[k] == (char)(j & 0xFF);
+                }
+            }
+        }
+
+        GROUP_EXPECT_PASS(group, "blocks intact", intact);
+
+        shared_delete(shared);
+        region_delete(region);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        GROUP_EXPECT_PANIC(group, "null parent", (void)shared_new("test", NULL));
+        GROUP_EXPECT_PANIC(group, "delete default", shared_delete(arena));
+    }
+
+    return test_suite_finish(&suite);
+}
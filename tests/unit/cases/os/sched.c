@@ -0,0 +1,170 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+
+#include "os/atomic.h"
+#include "os/sched.h"
+
+#define SCHED_WORKERS 4
+#define SCHED_TASKS 256
+#define SCHED_RANGE 100000
+
+static void add_one(void *arg)
+{
+    os_atomic_t *counter = arg;
+    os_atomic_fetch_add(counter, 1);
+}
+
+typedef struct nested_t
+{
+    os_sched_t *sched;
+    os_atomic_t *counter;
+} nested_t;
+
+// spawns and waits on a group from inside a task
+static void spawn_nested(void *arg)
+{
+    nested_t *nested = arg;
+
+    os_task_t tasks[16];
+    os_task_group_t group;
+    os_task_group_init(&group, nested->sched);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        os_task_group_spawn(&group, &tasks[i], add_one, nested->counter);
+    }
+
+    os_task_group_wait(&group);
+}
+
+static void mark_range(size_t first, size_t last, void *arg)
+{
+    os_atomic_t *marks = arg;
+    for (size_t i = first; i < last; i++)
+    {
+        os_atomic_fetch_add(&marks[i], 1);
+    }
+}
+
+typedef struct range_check_t
+{
+    os_atomic_t largest;
+    os_atomic_t total;
+} range_check_t;
+
+static void check_range(size_t first, size_t last, void *arg)
+{
+    range_check_t *check = arg;
+    intptr_t len = (intptr_t)(last - first);
+
+    intptr_t largest = os_atomic_load(&check->largest);
+    while (len > largest && !os_atomic_compare_exchange(&check->largest, &largest, len)) { }
+
+    os_atomic_fetch_add(&check->total, len);
+}
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("sched", arena);
+
+    {
+        test_group_t group = test_group(&suite, "construction");
+        os_sched_t *sched = os_sched_new(SCHED_WORKERS, arena);
+        GROUP_EXPECT_PASS(group, "not null", sched != NULL);
+        GROUP_EXPECT_PASS(group, "workers", os_sched_workers(sched) == SCHED_WORKERS);
+        os_sched_delete(sched);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "tasks");
+        os_sched_t *sched = os_sched_new(SCHED_WORKERS, arena);
+
+        // more tasks than a deque starts with room for
+        os_task_t *tasks = ARENA_MALLOC(sizeof(os_task_t) * SCHED_TASKS, "tasks", NULL, arena);
+        os_atomic_t counter = CT_OS_ATOMIC_INIT(0);
+
+        os_task_group_t tg;
+        os_task_group_init(&tg, sched);
+        for (size_t i = 0; i < SCHED_TASKS; i++)
+        {
+            os_task_group_spawn(&tg, &tasks[i], add_one, &counter);
+        }
+
+        os_task_group_wait(&tg);
+        GROUP_EXPECT_PASS(group, "all ran", os_atomic_load(&counter) == SCHED_TASKS);
+
+        os_task_group_wait(&tg);
+        GROUP_EXPECT_PASS(group, "wait twice", os_atomic_load(&counter) == SCHED_TASKS);
+
+        arena_free(tasks, sizeof(os_task_t) * SCHED_TASKS, arena);
+        os_sched_delete(sched);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "nested");
+        os_sched_t *sched = os_sched_new(2, arena);
+        os_atomic_t counter = CT_OS_ATOMIC_INIT(0);
+
+        nested_t nested = { .sched = sched, .counter = &counter };
+
+        os_task_t tasks[32];
+        os_task_group_t tg;
+        os_task_group_init(&tg, sched);
+        for (size_t i = 0; i < 32; i++)
+        {
+            os_task_group_spawn(&tg, &tasks[i], spawn_nested, &nested);
+        }
+
+        os_task_group_wait(&tg);
+        GROUP_EXPECT_PASS(group, "all ran", os_atomic_load(&counter) == 32 * 16);
+
+        os_sched_delete(sched);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "parallel for");
+        os_sched_t *sched = os_sched_new(SCHED_WORKERS, arena);
+
+        os_atomic_t *marks = ARENA_MALLOC(sizeof(os_atomic_t) * SCHED_RANGE, "marks", NULL, arena);
+        for (size_t i = 0; i < SCHED_RANGE; i++)
+        {
+            os_atomic_store(&marks[i], 0);
+        }
+
+        os_parallel_for(sched, 0, SCHED_RANGE, 1000, mark_range, marks);
+
+        bool once = true;
+        for (size_t i = 0; i < SCHED_RANGE; i++)
+        {
+            once = once && os_atomic_load(&marks[i]) == 1;
+        }
+
+        GROUP_EXPECT_PASS(group, "every index once", once);
+
+        range_check_t check = { .largest = CT_OS_ATOMIC_INIT(0), .total = CT_OS_ATOMIC_INIT(0) };
+        os_parallel_for(sched, 10, 1010, 64, check_range, &check);
+        GROUP_EXPECT_PASS(group, "grain respected", os_atomic_load(&check.largest) <= 64);
+        GROUP_EXPECT_PASS(group, "offset range covered", os_atomic_load(&check.total) == 1000);
+
+        os_atomic_store(&check.total, 0);
+        os_parallel_for(sched, 5, 5, 1, check_range, &check);
+        GROUP_EXPECT_PASS(group, "empty range", os_atomic_load(&check.total) == 0);
+
+        arena_free(marks, sizeof(os_atomic_t) * SCHED_RANGE, arena);
+        os_sched_delete(sched);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        GROUP_EXPECT_PANIC(group, "no workers", (void)os_sched_new(0, arena));
+        GROUP_EXPECT_PANIC(group, "null arena", (void)os_sched_new(1, NULL));
+    }
+
+    return test_suite_finish(&suite);
+}
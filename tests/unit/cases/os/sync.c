@@ -0,0 +1,154 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "base/util.h"
+
+#include "os/atomic.h"
+#include "os/os.h"
+
+#define SYNC_THREADS 4
+#define SYNC_ROUNDS 10000
+
+typedef struct counter_t
+{
+    os_mutex_t mutex;
+    size_t count;
+
+    os_atomic_t atomic;
+} counter_t;
+
+static os_exitcode_t count_up(void *arg)
+{
+    counter_t *counter = arg;
+
+    for (size_t i = 0; i < SYNC_ROUNDS; i++)
+    {
+        os_mutex_lock(&counter->mutex);
+        counter->count += 1;
+        os_mutex_unlock(&counter->mutex);
+
+        os_atomic_fetch_add(&counter->atomic, 1);
+    }
+
+    return 0;
+}
+
+typedef struct signal_t
+{
+    os_mutex_t mutex;
+    os_cond_t cond;
+    bool ready;
+    size_t woken;
+} signal_t;
+
+static os_exitcode_t wait_ready(void *arg)
+{
+    signal_t *signal = arg;
+
+    os_mutex_lock(&signal->mutex);
+    while (!signal->ready)
+    {
+        os_cond_wait(&signal->cond, &signal->mutex);
+    }
+    signal->woken += 1;
+    os_mutex_unlock(&signal->mutex);
+
+    return 0;
+}
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("sync", arena);
+
+    {
+        test_group_t group = test_group(&suite, "atomics");
+        os_atomic_t atomic = CT_OS_ATOMIC_INIT(5);
+
+        GROUP_EXPECT_PASS(group, "init", os_atomic_load(&atomic) == 5);
+
+        os_atomic_store(&atomic, 10);
+        GROUP_EXPECT_PASS(group, "store", os_atomic_load(&atomic) == 10);
+
+        GROUP_EXPECT_PASS(group, "exchange returns old", os_atomic_exchange(&atomic, 20) == 10);
+        GROUP_EXPECT_PASS(group, "exchange stores new", os_atomic_load(&atomic) == 20);
+
+        GROUP_EXPECT_PASS(group, "fetch add returns old", os_atomic_fetch_add(&atomic, -5) == 20);
+        GROUP_EXPECT_PASS(group, "fetch add", os_atomic_load(&atomic) == 15);
+
+        intptr_t expected = 15;
+        GROUP_EXPECT_PASS(group, "cas matches", os_atomic_compare_exchange(&atomic, &expected, 30));
+        GROUP_EXPECT_PASS(group, "cas stores", os_atomic_load(&atomic) == 30);
+
+        expected = 15;
+        GROUP_EXPECT_PASS(group, "cas mismatch", !os_atomic_compare_exchange(&atomic, &expected, 40));
+        GROUP_EXPECT_PASS(group, "cas reports current", expected == 30);
+        GROUP_EXPECT_PASS(group, "cas mismatch keeps", os_atomic_load(&atomic) == 30);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "mutex");
+        counter_t counter = { .count = 0, .atomic = CT_OS_ATOMIC_INIT(0) };
+        GROUP_EXPECT_PASS(group, "init", os_mutex_init(&counter.mutex, "counter") == eOsSuccess);
+        GROUP_EXPECT_PASS(group, "name", str_equal(os_mutex_name(&counter.mutex), "counter"));
+
+        os_thread_t threads[SYNC_THREADS];
+        for (size_t i = 0; i < SYNC_THREADS; i++)
+        {
+            GROUP_EXPECT_PASS(group, "started", os_thread_init(&threads[i], "counter", count_up, &counter) == eOsSuccess);
+        }
+
+        for (size_t i = 0; i < SYNC_THREADS; i++)
+        {
+            os_status_t status = 0;
+            GROUP_EXPECT_PASS(group, "joined", os_thread_join(&threads[i], &status) == eOsSuccess);
+        }
+
+        GROUP_EXPECT_PASS(group, "locked count", counter.count == SYNC_THREADS * SYNC_ROUNDS);
+        GROUP_EXPECT_PASS(group, "atomic count", os_atomic_load(&counter.atomic) == SYNC_THREADS * SYNC_ROUNDS);
+
+        os_mutex_destroy(&counter.mutex);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "condition");
+        signal_t signal = { .ready = false, .woken = 0 };
+        GROUP_EXPECT_PASS(group, "mutex init", os_mutex_init(&signal.mutex, "signal") == eOsSuccess);
+        GROUP_EXPECT_PASS(group, "cond init", os_cond_init(&signal.cond, "signal") == eOsSuccess);
+
+        os_thread_t threads[SYNC_THREADS];
+        for (size_t i = 0; i < SYNC_THREADS; i++)
+        {
+            GROUP_EXPECT_PASS(group, "started", os_thread_init(&threads[i], "waiter", wait_ready, &signal) == eOsSuccess);
+        }
+
+        os_mutex_lock(&signal.mutex);
+        signal.ready = true;
+        os_cond_broadcast(&signal.cond);
+        os_mutex_unlock(&signal.mutex);
+
+        for (size_t i = 0; i < SYNC_THREADS; i++)
+        {
+            os_status_t status = 0;
+            GROUP_EXPECT_PASS(group, "joined", os_thread_join(&threads[i], &status) == eOsSuccess);
+        }
+
+        GROUP_EXPECT_PASS(group, "all woken", signal.woken == SYNC_THREADS);
+
+        os_cond_destroy(&signal.cond);
+        os_mutex_destroy(&signal.mutex);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        GROUP_EXPECT_PANIC(group, "null mutex", (void)os_mutex_init(NULL, "test"));
+        GROUP_EXPECT_PANIC(group, "null cond", (void)os_cond_init(NULL, "test"));
+        GROUP_EXPECT_PANIC(group, "null atomic", (void)os_atomic_load(NULL));
+    }
+
+    return test_suite_finish(&suite);
+}
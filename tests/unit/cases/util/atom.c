@@ -0,0 +1,137 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "core/macros.h"
+#include "base/util.h"
+
+#include "std/atom.h"
+#include "std/map.h"
+#include "std/str.h"
+
+#include "os/os.h"
+
+#define ATOM_THREADS 4
+#define ATOM_NAMES 512
+
+typedef struct atom_worker_t
+{
+    atom_table_t *table;
+    const char *atoms[ATOM_NAMES];
+} atom_worker_t;
+
+static os_exitcode_t intern_names(void *arg)
+{
+    atom_worker_t *worker = arg;
+    char buffer[32];
+
+    for (size_t i = 0; i < ATOM_NAMES; i++)
+    {
+        size_t len = str_sprintf(buffer, sizeof(buffer), "name%zu", i);
+        worker->atoms[i] = atom_intern_text(worker->table, text_view_make(buffer, len));
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("atom", arena);
+
+    {
+        test_group_t group = test_group(&suite, "intern");
+        atom_table_t *table = atom_table_new(4, arena);
+
+        const char *hello = atom_intern(table, "hello");
+        char *copy = arena_strdup("hello", arena);
+        GROUP_EXPECT_PASS(group, "same pointer", atom_intern(table, copy) == hello);
+        GROUP_EXPECT_PASS(group, "not the input", hello != copy);
+        GROUP_EXPECT_PASS(group, "same text", str_equal(hello, "hello"));
+
+        text_view_t prefix = text_view_make("hello world", 5);
+        GROUP_EXPECT_PASS(group, "text view", atom_intern_text(table, prefix) == hello);
+
+        const char *world = atom_intern(table, "world");
+        GROUP_EXPECT_PASS(group, "distinct", world != hello);
+        GROUP_EXPECT_PASS(group, "count", atom_table_count(table) == 2);
+
+        GROUP_EXPECT_PASS(group, "hash", atom_hash(hello) == str_hash("hello"));
+        GROUP_EXPECT_PASS(group, "length", atom_length(world) == 5);
+        GROUP_EXPECT_PASS(group, "empty", atom_length(atom_intern(table, "")) == 0);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "growth");
+        atom_table_t *table = atom_table_new(1, arena);
+        const char *first = atom_intern(table, "first");
+
+        char buffer[32];
+        for (size_t i = 0; i < 1000; i++)
+        {
+            (void)str_sprintf(buffer, sizeof(buffer), "atom%zu", i);
+            (void)atom_intern(table, buffer);
+        }
+
+        GROUP_EXPECT_PASS(group, "count", atom_table_count(table) == 1001);
+        GROUP_EXPECT_PASS(group, "stable", atom_intern(table, "first") == first);
+        GROUP_EXPECT_PASS(group, "contents kept", str_equal(first, "first"));
+    }
+
+    {
+        test_group_t group = test_group(&suite, "map keys");
+        atom_table_t *table = atom_table_new(16, arena);
+        map_t *map = map_new(4, kTypeInfoAtom, arena);
+
+        const char *key = atom_intern(table, "key");
+        map_set(map, key, (void*)key);
+
+        char *copy = arena_strdup("key", arena);
+        GROUP_EXPECT_PASS(group, "found by atom", map_get(map, atom_intern(table, copy)) == key);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "threads");
+        atom_table_t *table = atom_table_new(16, arena);
+
+        os_thread_t threads[ATOM_THREADS];
+        atom_worker_t workers[ATOM_THREADS];
+        for (size_t i = 0; i < ATOM_THREADS; i++)
+        {
+            workers[i].table = table;
+            GROUP_EXPECT_PASS(group, "started", os_thread_init(&threads[i], "atoms", intern_names, &workers[i]) == eOsSuccess);
+        }
+
+        for (size_t i = 0; i < ATOM_THREADS; i++)
+        {
+            os_status_t status = 0;
+            GROUP_EXPECT_PASS(group, "joined", os_thread_join(&threads[i], &status) == eOsSuccess);
+        }
+
+        bool same = true;
+        for (size_t i = 1; i < ATOM_THREADS; i++)
+        {
+            for (size_t j = 0; j < ATOM_NAMES; j++)
+            {
+                same = same && workers[i].atoms[j] == workers[0].atoms[j];
+            }
+        }
+
+        GROUP_EXPECT_PASS(group, "same atoms", same);
+        GROUP_EXPECT_PASS(group, "count", atom_table_count(table) == ATOM_NAMES);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        atom_table_t *table = atom_table_new(1, arena);
+        CT_UNUSED(table);
+
+        GROUP_EXPECT_PANIC(group, "null text", (void)atom_intern(table, NULL));
+        GROUP_EXPECT_PANIC(group, "null arena", (void)atom_table_new(1, NULL));
+    }
+
+    return test_suite_finish(&suite);
+}
@@ -1,9 +1,24 @@
 #include "unit/ct-test.h"
 
 #include "setup/memory.h"
+#include "core/macros.h"
 
 #include "base/bitset.h"
 
+// long enough to take the simd paths
+#define BITSET_LONG 300
+
+// fill a set with a pattern that differs between seeds
+static void fill_pattern(bitset_t set, size_t seed)
+{
+    bitset_reset(set);
+    for (size_t i = 0; i < bitset_len(set); i++)
+    {
+        if (((i * 7 + seed) % 5) < 2 || (i % (seed + 3)) == 0)
+            bitset_set(set, i);
+    }
+}
+
 int main(void)
 {
     test_install_panic_handler();
@@ -46,5 +61,112 @@ int main(void)
         GROUP_EXPECT_PASS(group, "clear bit 2", !bitset_test(a, 2));
     }
 
+    {
+        test_group_t group = test_group(&suite, "bulk");
+        char data_a[BITSET_LONG];
+        char data_b[BITSET_LONG];
+        char data_c[BITSET_LONG];
+        bitset_t a = CT_BITSET_ARRAY(data_a);
+        bitset_t b = CT_BITSET_ARRAY(data_b);
+        bitset_t c = CT_BITSET_ARRAY(data_c);
+
+        bool and_ok = true, or_ok = true, andnot_ok = true, xor_ok = true;
+        fill_pattern(b, 2);
+
+        fill_pattern(a, 1);
+        fill_pattern(c, 1);
+        GROUP_EXPECT_PASS(group, "and changed", bitset_and(c, b));
+        for (size_t i = 0; i < bitset_len(a); i++)
+            and_ok = and_ok && bitset_test(c, i) == (bitset_test(a, i) && bitset_test(b, i));
+
+        fill_pattern(c, 1);
+        GROUP_EXPECT_PASS(group, "or changed", bitset_or(c, b));
+        for (size_t i = 0; i < bitset_len(a); i++)
+            or_ok = or_ok && bitset_test(c, i) == (bitset_test(a, i) || bitset_test(b, i));
+
+        fill_pattern(c, 1);
+        GROUP_EXPECT_PASS(group, "andnot changed", bitset_andnot(c, b));
+        for (size_t i = 0; i < bitset_len(a); i++)
+            andnot_ok = andnot_ok && bitset_test(c, i) == (bitset_test(a, i) && !bitset_test(b, i));
+
+        fill_pattern(c, 1);
+        GROUP_EXPECT_PASS(group, "xor changed", bitset_xor(c, b));
+        for (size_t i = 0; i < bitset_len(a); i++)
+            xor_ok = xor_ok && bitset_test(c, i) == (bitset_test(a, i) != bitset_test(b, i));
+
+        GROUP_EXPECT_PASS(group, "and", and_ok);
+        GROUP_EXPECT_PASS(group, "or", or_ok);
+        GROUP_EXPECT_PASS(group, "andnot", andnot_ok);
+        GROUP_EXPECT_PASS(group, "xor", xor_ok);
+
+        GROUP_EXPECT_PASS(group, "or unchanged", !bitset_or(c, c));
+        GROUP_EXPECT_PASS(group, "and unchanged", !bitset_and(c, c));
+
+        char small[4];
+        CT_UNUSED(small);
+        GROUP_EXPECT_PANIC(group, "size mismatch", (void)bitset_or(a, bitset_of(small, sizeof(small))));
+    }
+
+    {
+        test_group_t group = test_group(&suite, "count");
+        char data[BITSET_LONG];
+        bitset_t a = CT_BITSET_ARRAY(data);
+        bitset_reset(a);
+        GROUP_EXPECT_PASS(group, "empty", bitset_count(a) == 0);
+
+        fill_pattern(a, 3);
+        size_t expected = 0;
+        for (size_t i = 0; i < bitset_len(a); i++)
+            expected += bitset_test(a, i);
+
+        GROUP_EXPECT_PASS(group, "long", bitset_count(a) == expected);
+
+        for (size_t i = 0; i < bitset_len(a); i++)
+            bitset_set(a, i);
+
+        GROUP_EXPECT_PASS(group, "full", bitset_count(a) == bitset_len(a));
+
+        char short_data[3];
+        bitset_t b = CT_BITSET_ARRAY(short_data);
+        bitset_reset(b);
+        bitset_set(b, 0);
+        bitset_set(b, 23);
+        GROUP_EXPECT_PASS(group, "short", bitset_count(b) == 2);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "iter");
+        char data[BITSET_LONG];
+        bitset_t a = CT_BITSET_ARRAY(data);
+        bitset_reset(a);
+
+        bitset_iter_t empty = bitset_iter(a);
+        GROUP_EXPECT_PASS(group, "empty", !bitset_has_next(&empty));
+        GROUP_EXPECT_PASS(group, "find none", bitset_find_next(a, 0) == SIZE_MAX);
+
+        fill_pattern(a, 4);
+
+        bool ordered = true;
+        size_t expected = bitset_find_next(a, 0);
+        size_t count = 0;
+        bitset_iter_t iter = bitset_iter(a);
+        while (bitset_has_next(&iter))
+        {
+            size_t index = bitset_next(&iter);
+            ordered = ordered && index == expected && bitset_test(a, index);
+            expected = bitset_find_next(a, index + 1);
+            count += 1;
+        }
+
+        GROUP_EXPECT_PASS(group, "matches find", ordered);
+        GROUP_EXPECT_PASS(group, "visits all", count == bitset_count(a));
+        GROUP_EXPECT_PASS(group, "exhausted", expected == SIZE_MAX);
+
+        bitset_reset(a);
+        bitset_set(a, bitset_len(a) - 1);
+        GROUP_EXPECT_PASS(group, "last bit", bitset_find_next(a, 1) == bitset_len(a) - 1);
+        GROUP_EXPECT_PASS(group, "past end", bitset_find_next(a, bitset_len(a)) == SIZE_MAX);
+    }
+
     return test_suite_finish(&suite);
 }
@@ -5,6 +5,9 @@
 
 #include "std/map.h"
 #include "std/str.h"
+#include "std/typed/vector.h"
+
+#include "ctu_core_config.h"
 
 static const char *const kSetItems[] = {
     "a", "b", "c", "d", "e", "f",
@@ -17,6 +20,20 @@ static const char *const kSetItems[] = {
 
 #define SET_ITEMS_COUNT (sizeof(kSetItems) / sizeof(char*))
 
+#define COLLIDE_ITEMS (500)
+
+// only a handful of distinct hashes so every probe sequence is long
+static ctu_hash_t collide_hash(const void *key) { return (uintptr_t)key % 7; }
+static bool collide_equal(const void *lhs, const void *rhs) { return lhs == rhs; }
+
+static const hash_info_t kCollideInfo = {
+    .size = sizeof(void*),
+    .hash = collide_hash,
+    .equals = collide_equal,
+};
+
+static void *collide_key(size_t i) { return (void*)(uintptr_t)(i + 1); }
+
 int main(void)
 {
     test_install_panic_handler();
@@ -145,5 +162,109 @@ int main(void)
         }
     }
 
+    // grow from the smallest size and survive heavy collisions
+    {
+        test_group_t group = test_group(&suite, "collisions");
+        map_t *map = map_new(1, kCollideInfo, arena);
+
+        for (size_t i = 0; i < COLLIDE_ITEMS; i++)
+        {
+            map_set(map, collide_key(i), collide_key(i));
+        }
+
+        GROUP_EXPECT_PASS(group, "count", map_count(map) == COLLIDE_ITEMS);
+
+        // overwriting does not add entries
+        map_set(map, collide_key(0), collide_key(1));
+        GROUP_EXPECT_PASS(group, "overwrite", map_get(map, collide_key(0)) == collide_key(1));
+        GROUP_EXPECT_PASS(group, "overwrite count", map_count(map) == COLLIDE_ITEMS);
+
+        // delete every other entry, the rest must still be reachable
+        for (size_t i = 0; i < COLLIDE_ITEMS; i += 2)
+        {
+            GROUP_EXPECT_PASS(group, "deleted", map_delete(map, collide_key(i)));
+        }
+
+        GROUP_EXPECT_PASS(group, "not deleted twice", !map_delete(map, collide_key(0)));
+        GROUP_EXPECT_PASS(group, "count after delete", map_count(map) == COLLIDE_ITEMS / 2);
+
+        bool found = true;
+        for (size_t i = 0; i < COLLIDE_ITEMS; i++)
+        {
+            bool expected = (i % 2) != 0;
+            found = found && (map_contains(map, collide_key(i)) == expected);
+        }
+
+        GROUP_EXPECT_PASS(group, "remaining found", found);
+
+        size_t items = 0;
+        map_iter_t iter = map_iter(map);
+        while (map_has_next(&iter))
+        {
+            map_entry_t entry = map_next(&iter);
+            items += (entry.key == entry.value);
+        }
+
+        GROUP_EXPECT_PASS(group, "iterated", items == COLLIDE_ITEMS / 2);
+
+        map_reset(map);
+        GROUP_EXPECT_PASS(group, "reset", map_count(map) == 0 && map_get(map, collide_key(1)) == NULL);
+    }
+
+#if CTU_MAP_ORDERED
+    {
+        test_group_t group = test_group(&suite, "insertion order");
+        map_t *map = map_new(1, kTypeInfoPtr, arena);
+        for (size_t i = 0; i < COLLIDE_ITEMS; i++)
+        {
+            map_set(map, collide_key(i), collide_key(i));
+        }
+
+        // overwriting a value keeps its position
+        map_set(map, collide_key(0), collide_key(0));
+
+        // deleted keys go to the back when they are set again
+        for (size_t i = 0; i < COLLIDE_ITEMS; i += 2)
+        {
+            map_delete(map, collide_key(i));
+        }
+
+        map_set(map, collide_key(0), collide_key(0));
+
+        bool ordered = true;
+        size_t expected = 1;
+        map_iter_t iter = map_iter(map);
+        while (map_has_next(&iter))
+        {
+            map_entry_t entry = map_next(&iter);
+            if (expected < COLLIDE_ITEMS)
+            {
+                ordered = ordered && entry.key == collide_key(expected);
+                expected += 2;
+            }
+            else
+            {
+                ordered = ordered && entry.key == collide_key(0);
+                expected = SIZE_MAX;
+            }
+        }
+
+        GROUP_EXPECT_PASS(group, "iterated in insertion order", ordered);
+        GROUP_EXPECT_PASS(group, "visited every entry", expected == SIZE_MAX);
+
+        // filling the map again compacts the deleted entries
+        for (size_t i = COLLIDE_ITEMS; i < COLLIDE_ITEMS * 2; i++)
+        {
+            map_set(map, collide_key(i), collide_key(i));
+        }
+
+        typevec_t *entries = map_entries(map);
+        map_entry_t *last = typevec_offset(entries, typevec_len(entries) - 1);
+        GROUP_EXPECT_PASS(group, "count", map_count(map) == (COLLIDE_ITEMS / 2) + 1 + COLLIDE_ITEMS);
+        GROUP_EXPECT_PASS(group, "last entry", last->key == collide_key(COLLIDE_ITEMS * 2 - 1));
+        GROUP_EXPECT_PASS(group, "lookup after compaction", map_get(map, collide_key(1)) == collide_key(1));
+    }
+#endif
+
     return test_suite_finish(&suite);
 }
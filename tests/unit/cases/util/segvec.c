@@ -0,0 +1,106 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "core/macros.h"
+
+#include "std/typed/segvec.h"
+
+#define SEGVEC_COUNT 1000
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("segvec", arena);
+
+    {
+        test_group_t group = test_group(&suite, "push");
+        segvec_t *vec = segvec_new(sizeof(size_t), 4, arena);
+        GROUP_EXPECT_PASS(group, "empty", segvec_len(vec) == 0);
+
+        size_t *first = NULL;
+        size_t *hundredth = NULL;
+        for (size_t i = 0; i < SEGVEC_COUNT; i++)
+        {
+            size_t *item = segvec_push(vec, &i);
+            if (i == 0) first = item;
+            if (i == 100) hundredth = item;
+        }
+
+        GROUP_EXPECT_PASS(group, "length", segvec_len(vec) == SEGVEC_COUNT);
+        GROUP_EXPECT_PASS(group, "first stable", segvec_offset(vec, 0) == first && *first == 0);
+        GROUP_EXPECT_PASS(group, "middle stable", segvec_offset(vec, 100) == hundredth && *hundredth == 100);
+
+        bool ordered = true;
+        for (size_t i = 0; i < SEGVEC_COUNT; i++)
+        {
+            size_t value = 0;
+            segvec_get(vec, i, &value);
+            ordered = ordered && value == i;
+        }
+
+        GROUP_EXPECT_PASS(group, "indexed", ordered);
+
+        size_t replace = 12345;
+        segvec_set(vec, 500, &replace);
+        GROUP_EXPECT_PASS(group, "set", *(size_t*)segvec_offset(vec, 500) == replace);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "iter");
+        segvec_t vec;
+        segvec_init(&vec, sizeof(size_t), 1, arena);
+
+        segvec_iter_t empty = segvec_iter(&vec);
+        GROUP_EXPECT_PASS(group, "empty", !segvec_has_next(&empty));
+
+        for (size_t i = 0; i < SEGVEC_COUNT; i++)
+        {
+            (void)segvec_push(&vec, &i);
+        }
+
+        size_t count = 0;
+        bool ordered = true;
+        segvec_iter_t iter = segvec_iter(&vec);
+        while (segvec_has_next(&iter))
+        {
+            size_t *value = segvec_next(&iter);
+            ordered = ordered && *value == count;
+            count += 1;
+        }
+
+        GROUP_EXPECT_PASS(group, "visits all", count == SEGVEC_COUNT);
+        GROUP_EXPECT_PASS(group, "in order", ordered);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "reset");
+        segvec_t *vec = segvec_new(sizeof(int), 2, arena);
+        int value = 1;
+        int *item = segvec_push(vec, &value);
+        (void)segvec_push(vec, &value);
+        (void)segvec_push(vec, &value);
+
+        segvec_reset(vec);
+        GROUP_EXPECT_PASS(group, "empty", segvec_len(vec) == 0);
+
+        value = 2;
+        GROUP_EXPECT_PASS(group, "reused", segvec_push(vec, &value) == item);
+        GROUP_EXPECT_PASS(group, "length", segvec_len(vec) == 1);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        segvec_t *vec = segvec_new(sizeof(int), 2, arena);
+        CT_UNUSED(vec);
+
+        GROUP_EXPECT_PANIC(group, "out of bounds", (void)segvec_offset(vec, 0));
+        GROUP_EXPECT_PANIC(group, "zero width", (void)segvec_new(0, 1, arena));
+        GROUP_EXPECT_PANIC(group, "null arena", (void)segvec_new(sizeof(int), 1, NULL));
+    }
+
+    return test_suite_finish(&suite);
+}
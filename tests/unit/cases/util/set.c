@@ -6,6 +6,8 @@
 #include "std/str.h"
 #include "std/set.h"
 
+#include <stdint.h>
+
 static const char *const kSetItems[] = {
     "a", "b", "c", "d", "e", "f",
     "g", "h", "i", "j", "k", "l",
@@ -51,5 +53,63 @@ int main(void)
         GROUP_EXPECT_PASS(set_clash_group, name, set_contains(set, kSetItems[i]));
     }
 
+    test_group_t set_bulk_group = test_group(&suite, "bulk");
+    set_t *bulk = set_new(1, kTypeInfoString, arena);
+    set_add_many(bulk, (const void *const *)kSetItems, SET_ITEMS_COUNT);
+    set_add_many(bulk, (const void *const *)kSetItems, SET_ITEMS_COUNT);
+    GROUP_EXPECT_PASS(set_bulk_group, "add many count", set_count(bulk) == SET_ITEMS_COUNT);
+    GROUP_EXPECT_PASS(set_bulk_group, "add many contains", set_contains(bulk, "q"));
+
+    set_t *other = set_new(4, kTypeInfoString, arena);
+    set_add(other, "a");
+    set_add(other, "not in items");
+    set_union(bulk, other);
+    GROUP_EXPECT_PASS(set_bulk_group, "union count", set_count(bulk) == SET_ITEMS_COUNT + 1);
+    GROUP_EXPECT_PASS(set_bulk_group, "union contains", set_contains(bulk, "not in items"));
+    GROUP_EXPECT_PASS(set_bulk_group, "union source kept", set_count(other) == 2);
+
+    test_group_t set_delete_group = test_group(&suite, "delete");
+    set_t *many = set_new(1, kTypeInfoPtr, arena);
+    for (size_t i = 1; i <= 1000; i++)
+    {
+        set_add(many, (void*)(uintptr_t)i);
+    }
+
+    for (size_t i = 1; i <= 1000; i += 2)
+    {
+        set_delete(many, (void*)(uintptr_t)i);
+    }
+
+    bool deleted = true;
+    for (size_t i = 1; i <= 1000; i++)
+    {
+        deleted = deleted && set_contains(many, (void*)(uintptr_t)i) == (i % 2 == 0);
+    }
+
+    GROUP_EXPECT_PASS(set_delete_group, "only odd keys deleted", deleted);
+    GROUP_EXPECT_PASS(set_delete_group, "count", set_count(many) == 500);
+
+    size_t seen = 0;
+    set_iter_t iter = set_iter(many);
+    while (set_has_next(&iter))
+    {
+        uintptr_t key = (uintptr_t)set_next(&iter);
+        if (key % 2 == 0) seen += 1;
+    }
+
+    GROUP_EXPECT_PASS(set_delete_group, "iterate", seen == 500);
+
+    // fill the slots freed by deletion again
+    for (size_t i = 1; i <= 1000; i += 2)
+    {
+        set_add(many, (void*)(uintptr_t)i);
+    }
+
+    GROUP_EXPECT_PASS(set_delete_group, "reinsert", set_count(many) == 1000);
+
+    set_reset(many);
+    GROUP_EXPECT_PASS(set_delete_group, "reset", set_empty(many));
+    GROUP_EXPECT_PASS(set_delete_group, "reset contains", !set_contains(many, (void*)(uintptr_t)2));
+
     return test_suite_finish(&suite);
 }
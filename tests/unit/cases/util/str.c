@@ -1,6 +1,7 @@
 #include "unit/ct-test.h"
 #include "arena/arena.h"
 #include "base/util.h"
+#include "core/macros.h"
 
 #include "setup/memory.h"
 
@@ -323,5 +324,90 @@ int main(void)
     GROUP_EXPECT_PASS(group, "no common", str_equal(no_common_prefix, ""));
     GROUP_EXPECT_PASS(group, "common", str_equal(some_prefix, "hello" CT_NATIVE_PATH_SEPARATOR));
 
+    {
+        test_group_t group = test_group(&suite, "hash");
+        const char *long_text = "a string long enough to take the three lane path through the hash function";
+
+        GROUP_EXPECT_PASS(group, "str matches text", str_hash("hello") == text_hash(text_view_make("hello world", 5)));
+        GROUP_EXPECT_PASS(group, "long str matches text", str_hash(long_text) == text_hash(text_view_from(long_text)));
+        GROUP_EXPECT_PASS(group, "empty", str_hash("") == text_hash(text_view_make("", 0)));
+        GROUP_EXPECT_PASS(group, "different text", str_hash("hello") != str_hash("hellp"));
+        GROUP_EXPECT_PASS(group, "seeded", text_hash_seeded(text_view_from("hello"), 1) != text_hash_seeded(text_view_from("hello"), 2));
+        GROUP_EXPECT_PASS(group, "seed zero", text_hash_seeded(text_view_from("hello"), 0) == str_hash("hello"));
+
+        // similar identifiers should spread over the low bits
+        size_t buckets[64] = { 0 };
+        char buffer[32];
+        for (size_t i = 0; i < 4096; i++)
+        {
+            (void)str_sprintf(buffer, sizeof(buffer), "name%zu", i);
+            buckets[str_hash(buffer) % 64] += 1;
+        }
+
+        size_t worst = 0;
+        for (size_t i = 0; i < 64; i++)
+        {
+            worst = CT_MAX(worst, buckets[i]);
+        }
+
+        GROUP_EXPECT_PASS(group, "low bits distributed", worst < 128);
+    }
+
+    {
+        // every implementation must agree, including on strings
+        // longer than a vector and matches straddling a vector boundary
+        char *haystack = ARENA_MALLOC(200, "haystack", NULL, arena);
+        ctu_memset(haystack, 'a', 199);
+        haystack[199] = '\0';
+        ctu_memcpy(haystack + 30, "needle", 6);
+        ctu_memcpy(haystack + 150, "needle", 6);
+
+        char *dirty = arena_strdup(haystack, arena);
+        dirty[100] = '\n';
+
+        map_t *repl = map_new(4, kTypeInfoString, arena);
+        map_set(repl, "needle", "pin");
+        map_set(repl, "\n", "|");
+
+        map_t *none = map_new(4, kTypeInfoString, arena);
+
+        str_isa_t best = str_get_isa();
+        for (str_isa_t isa = eStrIsaScalar; isa < eStrIsaCount; isa++)
+        {
+            if (!str_set_isa(isa))
+                continue;
+
+            test_group_t group = test_group(&suite, str_isa_name(isa));
+            GROUP_EXPECT_PASS(group, "find", str_find(haystack, "needle") == 30);
+            GROUP_EXPECT_PASS(group, "find miss", str_find(haystack, "needles") == SIZE_MAX);
+            GROUP_EXPECT_PASS(group, "find short", str_find("abc", "c") == 2);
+            GROUP_EXPECT_PASS(group, "find end", str_find(haystack, "aaan") == 27);
+            GROUP_EXPECT_PASS(group, "rfind", str_rfind(haystack, "needle") == 150);
+            GROUP_EXPECT_PASS(group, "rfind start", str_rfind(haystack, "aaaaa") == 194);
+            GROUP_EXPECT_PASS(group, "rfind first", str_rfind(haystack + 31, "needle") == 119);
+            GROUP_EXPECT_PASS(group, "rfind head", str_rfind("needle" "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "needle") == 0);
+            GROUP_EXPECT_PASS(group, "contains", str_contains(haystack, "aneedlea"));
+            GROUP_EXPECT_FAIL(group, "contains miss", str_contains(haystack, "needlee"));
+            GROUP_EXPECT_PASS(group, "char_is_any_of", char_is_any_of('z', "abcdefghijklmnopqrstuvwxyz"));
+            GROUP_EXPECT_FAIL(group, "char_is_any_of miss", char_is_any_of('!', "abcdefghijklmnopqrstuvwxyz"));
+
+            char *replaced = str_replace(haystack, "needle", "pin", arena);
+            GROUP_EXPECT_PASS(group, "replace length", ctu_strlen(replaced) == 193);
+            GROUP_EXPECT_PASS(group, "replace first", str_find(replaced, "pin") == 30);
+            GROUP_EXPECT_PASS(group, "replace last", str_rfind(replaced, "pin") == 147);
+
+            char *many = str_replace_many(dirty, repl, arena);
+            GROUP_EXPECT_PASS(group, "replace_many length", ctu_strlen(many) == 193);
+            GROUP_EXPECT_PASS(group, "replace_many", str_find(many, "|") == 97);
+            GROUP_EXPECT_PASS(group, "replace_many empty map", str_equal(str_replace_many(dirty, none, arena), dirty));
+
+            GROUP_EXPECT_PASS(group, "normalize clean", str_equal(str_normalize(haystack, arena), haystack));
+            char *normal = str_normalize(dirty, arena);
+            GROUP_EXPECT_PASS(group, "normalize dirty", ctu_strlen(normal) == 200 && str_find(normal, "\\n") == 100);
+        }
+
+        (void)str_set_isa(best);
+    }
+
     return test_suite_finish(&suite);
 }
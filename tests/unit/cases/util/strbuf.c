@@ -0,0 +1,80 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "base/util.h"
+
+#include "std/str.h"
+#include "std/strbuf.h"
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("strbuf", arena);
+
+    {
+        test_group_t group = test_group(&suite, "append");
+        strbuf_t *buf = strbuf_new(4, arena);
+        GROUP_EXPECT_PASS(group, "empty", strbuf_len(buf) == 0 && str_equal(strbuf_data(buf), ""));
+
+        strbuf_append(buf, "hello");
+        strbuf_append_char(buf, ' ');
+        strbuf_appendn(buf, "world!!!", 5);
+        GROUP_EXPECT_PASS(group, "contents", str_equal(strbuf_data(buf), "hello world"));
+        GROUP_EXPECT_PASS(group, "length", strbuf_len(buf) == 11);
+
+        text_view_t view = strbuf_view(buf);
+        GROUP_EXPECT_PASS(group, "view", view.length == 11 && view.text == strbuf_data(buf));
+
+        char *copy = strbuf_dup(buf, arena);
+        strbuf_append(buf, " and more");
+        GROUP_EXPECT_PASS(group, "dup is a copy", str_equal(copy, "hello world"));
+
+        GROUP_EXPECT_PANIC(group, "null string", strbuf_append(buf, NULL));
+    }
+
+    {
+        test_group_t group = test_group(&suite, "printf");
+        strbuf_t buf;
+        strbuf_init(&buf, 0, arena);
+
+        size_t len = strbuf_printf(&buf, "%s = %d", "x", 42);
+        GROUP_EXPECT_PASS(group, "length", len == 6);
+        GROUP_EXPECT_PASS(group, "contents", str_equal(strbuf_data(&buf), "x = 42"));
+
+        // longer than the initial capacity so the second attempt is used
+        strbuf_printf(&buf, "; %s", "a string that is much longer than the capacity of the builder");
+        GROUP_EXPECT_PASS(group, "grows", str_equal(strbuf_data(&buf), "x = 42; a string that is much longer than the capacity of the builder"));
+
+        bool all = true;
+        strbuf_reset(&buf);
+        for (size_t i = 0; i < 1000; i++)
+        {
+            strbuf_printf(&buf, "%zu,", i);
+        }
+        all = str_startswith(strbuf_data(&buf), "0,1,2,3,") && str_endswith(strbuf_data(&buf), ",998,999,");
+        GROUP_EXPECT_PASS(group, "many", all);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "truncate");
+        strbuf_t *buf = strbuf_new(16, arena);
+        strbuf_append(buf, "prefix.suffix");
+
+        strbuf_truncate(buf, 6);
+        GROUP_EXPECT_PASS(group, "truncated", str_equal(strbuf_data(buf), "prefix"));
+
+        strbuf_append(buf, "!");
+        GROUP_EXPECT_PASS(group, "append after", str_equal(strbuf_data(buf), "prefix!"));
+
+        strbuf_reset(buf);
+        GROUP_EXPECT_PASS(group, "reset", strbuf_len(buf) == 0 && str_equal(strbuf_data(buf), ""));
+
+        GROUP_EXPECT_PANIC(group, "past end", strbuf_truncate(buf, 1));
+    }
+
+    return test_suite_finish(&suite);
+}
@@ -0,0 +1,81 @@
+#include "unit/ct-test.h"
+
+#include "setup/memory.h"
+#include "arena/arena.h"
+#include "core/macros.h"
+
+#include "std/vector.h"
+
+int main(void)
+{
+    test_install_panic_handler();
+    test_install_electric_fence();
+
+    arena_t *arena = ctu_default_alloc();
+    test_suite_t suite = test_suite_new("vector", arena);
+
+    {
+        test_group_t group = test_group(&suite, "small");
+        smallvec_t storage;
+        vector_t *vec = smallvec_of(&storage, 2, arena);
+
+        GROUP_EXPECT_PASS(group, "inline", (void*)vec == (void*)&storage);
+        GROUP_EXPECT_PASS(group, "length", vector_len(vec) == 2);
+
+        vector_set(vec, 0, "a");
+        vector_set(vec, 1, "b");
+        vector_push(&vec, "c");
+        vector_push(&vec, "d");
+        GROUP_EXPECT_PASS(group, "still inline", (void*)vec == (void*)&storage);
+
+        vector_push(&vec, "e");
+        GROUP_EXPECT_PASS(group, "spilled", (void*)vec != (void*)&storage);
+        GROUP_EXPECT_PASS(group, "spilled length", vector_len(vec) == 5);
+        GROUP_EXPECT_PASS(group, "contents kept", vector_get(vec, 0) == (void*)"a" && vector_get(vec, 3) == (void*)"d");
+        GROUP_EXPECT_PASS(group, "pushed", vector_tail(vec) == (void*)"e");
+
+        vector_delete(vec);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "large");
+        smallvec_t storage;
+        vector_t *vec = smallvec_of(&storage, CT_SMALLVEC_SIZE + 1, arena);
+
+        GROUP_EXPECT_PASS(group, "heap", (void*)vec != (void*)&storage);
+        GROUP_EXPECT_PASS(group, "length", vector_len(vec) == CT_SMALLVEC_SIZE + 1);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "place");
+        vector_t *source = vector_new(4, arena);
+        vector_push(&source, "x");
+        vector_push(&source, "y");
+        vector_push(&source, "z");
+
+        void *buffer = ARENA_MALLOC(vector_place_size(3), "buffer", NULL, arena);
+        vector_t *copy = vector_place_copy(buffer, source, arena);
+        GROUP_EXPECT_PASS(group, "in buffer", (void*)copy == buffer);
+        GROUP_EXPECT_PASS(group, "length", vector_len(copy) == 3);
+        GROUP_EXPECT_PASS(group, "contents", vector_get(copy, 2) == (void*)"z");
+
+        // deleting a placed vector leaves the buffer alone
+        vector_delete(copy);
+        GROUP_EXPECT_PASS(group, "buffer kept", vector_get(copy, 0) == (void*)"x");
+
+        vector_t *empty = vector_place_copy(buffer, &kEmptyVector, arena);
+        GROUP_EXPECT_PASS(group, "empty", vector_len(empty) == 0);
+    }
+
+    {
+        test_group_t group = test_group(&suite, "errors");
+        smallvec_t storage;
+        CT_UNUSED(storage);
+
+        GROUP_EXPECT_PANIC(group, "null storage", (void)smallvec_of(NULL, 1, arena));
+        GROUP_EXPECT_PANIC(group, "too long", (void)vector_place(&storage, CT_SMALLVEC_SIZE, CT_SMALLVEC_SIZE + 1, arena));
+        GROUP_EXPECT_PANIC(group, "null arena", (void)vector_place(&storage, CT_SMALLVEC_SIZE, 0, NULL));
+    }
+
+    return test_suite_finish(&suite);
+}